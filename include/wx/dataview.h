@@ -238,6 +238,14 @@ public:
         return true;
     }
 
+    // Override this if the values of some items are retrieved asynchronously
+    // and are not available yet, a placeholder is shown for them if this
+    // returns false (currently only in the generic version)
+    virtual bool IsItemLoaded(const wxDataViewItem &WXUNUSED(item)) const
+    {
+        return true;
+    }
+
     // define hierarchy
     virtual wxDataViewItem GetParent( const wxDataViewItem &item ) const = 0;
     virtual bool IsContainer( const wxDataViewItem &item ) const = 0;
@@ -325,6 +333,11 @@ public:
         return true;
     }
 
+    virtual bool IsItemLoadedByRow(unsigned int WXUNUSED(row)) const
+    {
+        return true;
+    }
+
 
     // helper methods provided by list models only
     virtual unsigned GetRow( const wxDataViewItem &item ) const = 0;
@@ -370,6 +383,11 @@ public:
         return IsEnabledByRow( GetRow(item), col );
     }
 
+    virtual bool IsItemLoaded(const wxDataViewItem &item) const wxOVERRIDE
+    {
+        return IsItemLoadedByRow( GetRow(item) );
+    }
+
 
     virtual bool IsListModel() const wxOVERRIDE { return true; }
 };
@@ -740,6 +758,11 @@ public:
 
     virtual bool SetRowHeight( int WXUNUSED(rowHeight) ) { return false; }
 
+    // Prefetch hints are only sent by the generic version, the look-ahead is
+    // the number of rows to prefetch, 0 to disable them.
+    virtual bool SetPrefetchLookAhead( int WXUNUSED(count) ) { return false; }
+    virtual int GetPrefetchLookAhead() const { return 0; }
+
     virtual void EditItem(const wxDataViewItem& item, const wxDataViewColumn *column) = 0;
 
     // Use EditItem() instead
@@ -843,6 +866,7 @@ public:
         m_pos(event.m_pos),
         m_cacheFrom(event.m_cacheFrom),
         m_cacheTo(event.m_cacheTo),
+        m_prefetchDirection(event.m_prefetchDirection),
         m_editCancelled(event.m_editCancelled)
 #if wxUSE_DRAG_AND_DROP
         , m_dataObject(event.m_dataObject),
@@ -872,11 +896,15 @@ public:
     wxPoint GetPosition() const { return m_pos; }
     void SetPosition( int x, int y ) { m_pos.x = x; m_pos.y = y; }
 
-    // For wxEVT_DATAVIEW_CACHE_HINT
+    // For wxEVT_DATAVIEW_CACHE_HINT and wxEVT_DATAVIEW_PREFETCH_HINT
     int GetCacheFrom() const { return m_cacheFrom; }
     int GetCacheTo() const { return m_cacheTo; }
     void SetCache(int from, int to) { m_cacheFrom = from; m_cacheTo = to; }
 
+    // For wxEVT_DATAVIEW_PREFETCH_HINT only: 1 if scrolling down, -1 if up or 0
+    int GetPrefetchDirection() const { return m_prefetchDirection; }
+    void SetPrefetchDirection(int direction) { m_prefetchDirection = direction; }
+
 
 #if wxUSE_DRAG_AND_DROP
     // For drag operations
@@ -926,6 +954,7 @@ protected:
     wxPoint             m_pos;
     int                 m_cacheFrom;
     int                 m_cacheTo;
+    int                 m_prefetchDirection;
     bool                m_editCancelled;
 
 #if wxUSE_DRAG_AND_DROP
@@ -969,6 +998,7 @@ wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_DATAVIEW_COLUMN_SORTED, wxData
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_DATAVIEW_COLUMN_REORDERED, wxDataViewEvent );
 
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_DATAVIEW_CACHE_HINT, wxDataViewEvent );
+wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_DATAVIEW_PREFETCH_HINT, wxDataViewEvent );
 
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_DATAVIEW_ITEM_BEGIN_DRAG, wxDataViewEvent );
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_DATAVIEW_ITEM_DROP_POSSIBLE, wxDataViewEvent );
@@ -1001,6 +1031,7 @@ typedef void (wxEvtHandler::*wxDataViewEventFunction)(wxDataViewEvent&);
 #define EVT_DATAVIEW_COLUMN_SORTED(id, fn) wx__DECLARE_DATAVIEWEVT(COLUMN_SORTED, id, fn)
 #define EVT_DATAVIEW_COLUMN_REORDERED(id, fn) wx__DECLARE_DATAVIEWEVT(COLUMN_REORDERED, id, fn)
 #define EVT_DATAVIEW_CACHE_HINT(id, fn) wx__DECLARE_DATAVIEWEVT(CACHE_HINT, id, fn)
+#define EVT_DATAVIEW_PREFETCH_HINT(id, fn) wx__DECLARE_DATAVIEWEVT(PREFETCH_HINT, id, fn)
 
 #define EVT_DATAVIEW_ITEM_BEGIN_DRAG(id, fn) wx__DECLARE_DATAVIEWEVT(ITEM_BEGIN_DRAG, id, fn)
 #define EVT_DATAVIEW_ITEM_DROP_POSSIBLE(id, fn) wx__DECLARE_DATAVIEWEVT(ITEM_DROP_POSSIBLE, id, fn)
@@ -256,6 +256,9 @@ public:
 
     virtual bool SetRowHeight( int rowHeight ) wxOVERRIDE;
 
+    virtual bool SetPrefetchLookAhead( int count ) wxOVERRIDE;
+    virtual int GetPrefetchLookAhead() const wxOVERRIDE;
+
     virtual void Collapse( const wxDataViewItem & item ) wxOVERRIDE;
     virtual bool IsExpanded( const wxDataViewItem & item ) const wxOVERRIDE;
 
@@ -105,6 +105,8 @@ class WXDLLIMPEXP_FWD_CORE wxDatePickerCtrl;
 #endif
 
 class wxGridFixedIndicesSet;
+class wxGridTextExtentCache;
+class wxGridLinesGeometry;
 
 class wxGridOperations;
 class wxGridRowOperations;
@@ -1420,8 +1422,7 @@ public:
 
     wxGridSizesInfo GetColSizes() const
         { return wxGridSizesInfo(GetDefaultColSize(), m_colWidths); }
-    wxGridSizesInfo GetRowSizes() const
-        { return wxGridSizesInfo(GetDefaultRowSize(), m_rowHeights); }
+    wxGridSizesInfo GetRowSizes() const;
 
     void SetColSizes(const wxGridSizesInfo& sizeInfo);
     void SetRowSizes(const wxGridSizesInfo& sizeInfo);
@@ -1487,6 +1488,19 @@ public:
     void     AutoSizeRows( bool setAsMin = true )
         { (void)SetOrCalcRowSizes(false, setAsMin); }
 
+    // limit the number of cells measured by the functions above for big
+    // grids: if sampleSize is positive, only this many cells (chosen among
+    // the visible ones, the ones with the longest values and a uniform sample
+    // of all the others) are measured for each column or row, and if timeLimit
+    // is positive, measuring a column or row stops after this many ms
+    void     SetAutoSizeSampling( int sampleSize, long timeLimit = 0 )
+    {
+        m_autoSizeSampleSize = sampleSize;
+        m_autoSizeTimeLimit = timeLimit;
+    }
+    int      GetAutoSizeSampleSize() const { return m_autoSizeSampleSize; }
+    long     GetAutoSizeTimeLimit() const { return m_autoSizeTimeLimit; }
+
     // auto size the grid, that is make the columns/rows of the "right" size
     // and also set the grid size to just fit its contents
     void     AutoSize();
@@ -1879,6 +1893,11 @@ public:
     // implementation only
     void CancelMouseCapture();
 
+    // implementation only: return the cache of text extents which exists only
+    // while auto-sizing the columns or rows and is NULL the rest of the time
+    wxGridTextExtentCache *GetAutoSizeExtentCache() const
+        { return m_autoSizeExtentCache; }
+
 protected:
     virtual wxSize DoGetBestSize() const wxOVERRIDE;
 
@@ -1927,16 +1946,18 @@ protected:
     wxColour    m_selectionBackground;
     wxColour    m_selectionForeground;
 
-    // NB: *never* access m_row/col arrays directly because they are created
-    //     on demand, *always* use accessor functions instead!
+    // NB: *never* access m_rowsGeometry and m_col arrays directly because
+    //     they are created on demand, *always* use accessor functions instead!
 
-    // init the m_rowHeights/Bottoms arrays with default values
+    // create m_rowsGeometry using the current default row height
     void InitRowHeights();
 
     int        m_defaultRowHeight;
     int        m_minAcceptableRowHeight;
-    wxArrayInt m_rowHeights;
-    wxArrayInt m_rowBottoms;
+
+    // the heights and positions of the rows, NULL if all rows have the
+    // default height
+    wxGridLinesGeometry *m_rowsGeometry;
 
     // init the m_colWidths/Rights arrays
     void InitColWidths();
@@ -2004,6 +2025,17 @@ protected:
     // common part of AutoSizeColumn/Row()
     void AutoSizeColOrRow(int n, bool setAsMin, wxGridDirection direction);
 
+    // return the indices of the cells to measure in AutoSizeColOrRow() when
+    // sampling is used, in order of decreasing importance
+    wxArrayInt GetAutoSizeSample(int colOrRow, wxGridDirection direction);
+
+    // auto-sizing parameters, see SetAutoSizeSampling()
+    int m_autoSizeSampleSize;
+    long m_autoSizeTimeLimit;
+
+    // the cache of text extents used during auto-sizing, NULL otherwise
+    wxGridTextExtentCache *m_autoSizeExtentCache;
+
     // Calculate the minimum acceptable size for labels area
     wxCoord CalcColOrRowLabelAreaMinSize(wxGridDirection direction);
 
@@ -51,6 +51,13 @@ protected:
     wxSize DoGetBestSize(const wxGridCellAttr& attr,
                          wxDC& dc,
                          const wxString& text);
+
+    // same as above but reuses the extents already computed while auto-sizing
+    // the grid columns or rows
+    wxSize DoGetBestSize(const wxGrid& grid,
+                         const wxGridCellAttr& attr,
+                         wxDC& dc,
+                         const wxString& text);
 };
 
 // the default renderer for the cells containing numeric (long) data
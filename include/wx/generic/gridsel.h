@@ -16,12 +16,68 @@
 #if wxUSE_GRID
 
 #include "wx/grid.h"
+#include "wx/vector.h"
+
+class wxGridCellCoordsSet;
+
+// Set of rows or columns ("lines") stored as a sorted array of disjoint
+// ranges, so that selecting a whole block of lines takes constant space and
+// checking whether a line is selected takes logarithmic time.
+class WXDLLIMPEXP_CORE wxGridLineRangeSet
+{
+public:
+    wxGridLineRangeSet() { }
+
+    bool IsEmpty() const { return m_ranges.empty(); }
+
+    // Return true if the given line is contained in one of the ranges.
+    bool Contains(int line) const;
+
+    // Add all lines from "from" to "to", inclusive, merging them with the
+    // existing ranges if they overlap or are adjacent to them.
+    void Add(int from, int to);
+
+    // Remove all lines from "from" to "to", inclusive, splitting the existing
+    // ranges if necessary.
+    void Remove(int from, int to);
+
+    void Clear() { m_ranges.clear(); }
+
+    // Update the line indices after inserting (if numLines > 0) or deleting
+    // (if numLines < 0) lines at the given position.
+    void UpdateLines(size_t pos, int numLines);
+
+    // Access the individual ranges, in increasing order.
+    size_t GetRangesCount() const { return m_ranges.size(); }
+    int GetRangeFrom(size_t n) const { return m_ranges[n].from; }
+    int GetRangeTo(size_t n) const { return m_ranges[n].to; }
+
+    // Return all the lines in the set, in increasing order.
+    wxArrayInt AsArray() const;
+
+private:
+    struct Range
+    {
+        Range(int from_, int to_) : from(from_), to(to_) { }
+
+        int from;
+        int to;
+    };
+
+    // Return the index of the first range which ends at or after the given
+    // line, i.e. the only range which can contain it, or the number of ranges
+    // if there is no such range.
+    size_t FindRange(int line) const;
+
+    wxVector<Range> m_ranges;
+};
 
 class WXDLLIMPEXP_CORE wxGridSelection
 {
 public:
     wxGridSelection(wxGrid *grid,
                     wxGrid::wxGridSelectionModes sel = wxGrid::wxGridSelectCells);
+    ~wxGridSelection();
 
     bool IsSelection();
     bool IsInSelection(int row, int col);
@@ -90,6 +146,28 @@ private:
                  leftCol <= col && col <= rightCol );
     }
 
+    // Add a new selected block, change or remove an existing one.
+    void AddBlock(int topRow, int leftCol, int bottomRow, int rightCol);
+    void SetBlock(size_t n, const wxGridCellCoords& topLeft,
+                  const wxGridCellCoords& bottomRight);
+    void RemoveBlock(size_t n);
+
+    // Return true if the cell is inside one of the selected blocks.
+    bool IsInSelectedBlock(int row, int col);
+
+    // Helpers of IsInSelectedBlock() building and searching the index.
+    int BuildBlocksIndex(size_t node, size_t lo, size_t hi);
+    bool IsInBlocksIndex(size_t node, size_t lo, size_t hi, size_t end,
+                         int row, int col) const;
+
+    // Remove all individually selected cells inside the given block.
+    void RemoveCellsInBlock(int topRow, int leftCol,
+                            int bottomRow, int rightCol);
+
+    // Common part of UpdateRows() and UpdateCols() updating the coordinates
+    // of the individually selected cells.
+    void UpdateCells(size_t pos, int numRowsOrCols, bool isRow);
+
     void SelectBlockNoEvent(int topRow, int leftCol,
                             int bottomRow, int rightCol)
     {
@@ -97,11 +175,20 @@ private:
                     wxKeyboardState(), false);
     }
 
-    wxGridCellCoordsArray               m_cellSelection;
+    wxGridCellCoordsSet                 *m_cellSelection;
     wxGridCellCoordsArray               m_blockSelectionTopLeft;
     wxGridCellCoordsArray               m_blockSelectionBottomRight;
-    wxArrayInt                          m_rowSelection;
-    wxArrayInt                          m_colSelection;
+    wxGridLineRangeSet                  m_rowSelection;
+    wxGridLineRangeSet                  m_colSelection;
+
+    // Index of the selected blocks used to find the blocks containing the
+    // given row without checking all of them: the indices of the blocks
+    // sorted by their top row and the segment tree of the maximal bottom rows
+    // of the blocks in this order. It is rebuilt when it's needed after any
+    // change to the blocks.
+    wxVector<size_t>                    m_blocksByTop;
+    wxVector<int>                       m_blocksMaxBottom;
+    bool                                m_blocksIndexValid;
 
     wxGrid                              *m_grid;
     wxGrid::wxGridSelectionModes        m_selectionMode;
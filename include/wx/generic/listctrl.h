@@ -106,6 +106,12 @@ public:
     virtual bool IsItemChecked(long item) const wxOVERRIDE;
     virtual void CheckItem(long item, bool check) wxOVERRIDE;
 
+    virtual bool HasVariableItemHeight() const wxOVERRIDE;
+    virtual bool EnableVariableItemHeight(bool enable = true) wxOVERRIDE;
+
+    virtual bool SetPrefetchLookAhead(int count) wxOVERRIDE;
+    virtual int GetPrefetchLookAhead() const wxOVERRIDE;
+
     void SetSingleStyle( long style, bool add = true ) ;
     void SetWindowStyleFlag( long style ) wxOVERRIDE;
     void RecreateWindow() {}
@@ -143,6 +149,10 @@ public:
     long InsertItem( long index, const wxString& label, int imageIndex );
     bool ScrollList( int dx, int dy );
     bool SortItems( wxListCtrlCompare fn, wxIntPtr data );
+    virtual bool SortItemsByKey(wxListCtrlStringKey fn, wxIntPtr data,
+                                bool ascending = true) wxOVERRIDE;
+    virtual bool SortItemsByKey(wxListCtrlNumericKey fn, wxIntPtr data,
+                                bool ascending = true) wxOVERRIDE;
 
     // do we have a header window?
     bool HasHeader() const
@@ -224,6 +234,14 @@ protected:
     // return the icon for the given item and column.
     virtual int OnGetItemColumnImage(long item, long column) const;
 
+    // return the height of the given item if variable item height is enabled,
+    // -1 means to use the default height
+    virtual int OnGetItemHeight(long item) const;
+
+    // return false if the data of the given item is not available yet and a
+    // placeholder should be shown for it instead
+    virtual bool OnGetItemIsLoaded(long item) const;
+
     // it calls our OnGetXXX() functions
     friend class WXDLLIMPEXP_FWD_CORE wxListMainWindow;
 
@@ -12,6 +12,7 @@
 #define _WX_GENERIC_GRID_PRIVATE_H_
 
 #include "wx/defs.h"
+#include "wx/hashset.h"
 
 #if wxUSE_GRID
 
@@ -20,62 +21,62 @@
 wxDECLARE_EVENT( wxEVT_GRID_HIDE_EDITOR, wxCommandEvent );
 
 // ----------------------------------------------------------------------------
-// array classes
+// hash map classes
 // ----------------------------------------------------------------------------
 
-WX_DEFINE_ARRAY_WITH_DECL_PTR(wxGridCellAttr *, wxArrayAttrs,
-                                 class WXDLLIMPEXP_ADV);
-
-struct wxGridCellWithAttr
+// hash and comparison functors allowing to use wxGridCellCoords as key of a
+// hash map, used for the sparse storage of the cell attributes, or a hash set,
+// used for storing the selected cells
+struct wxGridCellCoordsHash
 {
-    wxGridCellWithAttr(int row, int col, wxGridCellAttr *attr_)
-        : coords(row, col), attr(attr_)
-    {
-        wxASSERT( attr );
-    }
+    wxGridCellCoordsHash() { }
 
-    wxGridCellWithAttr(const wxGridCellWithAttr& other)
-        : coords(other.coords),
-          attr(other.attr)
+    size_t operator()(const wxGridCellCoords& coords) const
     {
-        attr->IncRef();
-    }
+        // combine row and column in a way which doesn't result in collisions
+        // for the typical case of a dense rectangular block of cells
+        const size_t row = static_cast<unsigned>(coords.GetRow());
+        const size_t col = static_cast<unsigned>(coords.GetCol());
 
-    wxGridCellWithAttr& operator=(const wxGridCellWithAttr& other)
-    {
-        coords = other.coords;
-        if (attr != other.attr)
-        {
-            attr->DecRef();
-            attr = other.attr;
-            attr->IncRef();
-        }
-        return *this;
+        return (row * 0x9E3779B1u) ^ col;
     }
 
-    void ChangeAttr(wxGridCellAttr* new_attr)
-    {
-        if (attr != new_attr)
-        {
-            // "Delete" (i.e. DecRef) the old attribute.
-            attr->DecRef();
-            attr = new_attr;
-            // Take ownership of the new attribute, i.e. no IncRef.
-        }
-    }
+    wxGridCellCoordsHash& operator=(const wxGridCellCoordsHash&) { return *this; }
+};
+
+struct wxGridCellCoordsEqual
+{
+    wxGridCellCoordsEqual() { }
 
-    ~wxGridCellWithAttr()
+    bool operator()(const wxGridCellCoords& a, const wxGridCellCoords& b) const
     {
-        attr->DecRef();
+        return a == b;
     }
 
-    wxGridCellCoords coords;
-    wxGridCellAttr  *attr;
+    wxGridCellCoordsEqual& operator=(const wxGridCellCoordsEqual&) { return *this; }
 };
 
-WX_DECLARE_OBJARRAY_WITH_DECL(wxGridCellWithAttr, wxGridCellWithAttrArray,
+WX_DECLARE_HASH_MAP_WITH_DECL(wxGridCellCoords, wxGridCellAttr *,
+                              wxGridCellCoordsHash, wxGridCellCoordsEqual,
+                              wxGridCellCoordsToAttrMap,
                               class WXDLLIMPEXP_ADV);
 
+WX_DECLARE_HASH_MAP_WITH_DECL(int, wxGridCellAttr *,
+                              wxIntegerHash, wxIntegerEqual,
+                              wxGridRowOrColToAttrMap,
+                              class WXDLLIMPEXP_ADV);
+
+WX_DECLARE_HASH_SET_WITH_DECL(wxGridCellCoords,
+                              wxGridCellCoordsHash, wxGridCellCoordsEqual,
+                              wxGridCellCoordsSetBase,
+                              class WXDLLIMPEXP_ADV);
+
+// This is a class and not a typedef to allow forward declaring it in the
+// public wx/generic/gridsel.h header.
+class wxGridCellCoordsSet : public wxGridCellCoordsSetBase
+{
+};
+
 
 // ----------------------------------------------------------------------------
 // private classes
@@ -408,19 +409,30 @@ private:
 // ----------------------------------------------------------------------------
 
 // this class stores attributes set for cells
+//
+// The attributes are kept in a hash map indexed by the cell coordinates, so
+// that retrieving the attribute of a cell, which is done for every cell being
+// drawn, takes constant time independently of the number of cells having
+// custom attributes.
 class WXDLLIMPEXP_ADV wxGridCellAttrData
 {
 public:
+    wxGridCellAttrData() {}
+    ~wxGridCellAttrData();
+
     void SetAttr(wxGridCellAttr *attr, int row, int col);
     wxGridCellAttr *GetAttr(int row, int col) const;
     void UpdateAttrRows( size_t pos, int numRows );
     void UpdateAttrCols( size_t pos, int numCols );
 
 private:
-    // searches for the attr for given cell, returns wxNOT_FOUND if not found
-    int FindIndex(int row, int col) const;
+    // common part of UpdateAttrRows() and UpdateAttrCols()
+    void UpdateAttrRowsOrCols(size_t pos, int numRowsOrCols, bool isRow);
 
-    wxGridCellWithAttrArray m_attrs;
+    // the map owns a reference to all the attributes stored in it
+    wxGridCellCoordsToAttrMap m_attrs;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridCellAttrData);
 };
 
 // this class stores attributes set for rows or columns
@@ -436,8 +448,10 @@ public:
     void UpdateAttrRowsOrCols( size_t pos, int numRowsOrCols );
 
 private:
-    wxArrayInt m_rowsOrCols;
-    wxArrayAttrs m_attrs;
+    // the map owns a reference to all the attributes stored in it
+    wxGridRowOrColToAttrMap m_attrs;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridRowOrColAttrData);
 };
 
 // NB: this is just a wrapper around 3 objects: one which stores cell
@@ -450,6 +464,247 @@ public:
                            m_colAttrs;
 };
 
+// ----------------------------------------------------------------------------
+// wxGridLinesGeometry: sizes and positions of the grid rows
+// ----------------------------------------------------------------------------
+
+// This class stores the sizes of the lines which differ from the default one
+// only and allows to find the position of any line, or the line at the given
+// position, in logarithmic time, without having to update the positions of
+// all the subsequent lines when the size of one of them changes.
+//
+// The runs of consecutive lines with the same non-default size are kept in a
+// treap (randomized binary search tree) ordered by the index of their first
+// line, with each node storing the sum of the differences between the sizes
+// of the lines in its subtree and the default size. Inserting or deleting
+// lines only needs to shift the indices of the lines after them, which is
+// done lazily, and giving the same size to many consecutive lines only adds
+// a single node.
+//
+// Notice that, as elsewhere in wxGrid, negative sizes are used for the hidden
+// lines and correspond to their size before they were hidden, such lines are
+// considered to have 0 size.
+class wxGridLinesGeometry
+{
+public:
+    // the default size is used for all the lines without a custom size
+    explicit wxGridLinesGeometry(int sizeDefault);
+    ~wxGridLinesGeometry();
+
+    int GetDefaultSize() const { return m_sizeDefault; }
+
+    // change the default size used for the lines inserted from now on while
+    // preserving the sizes of the given number of existing lines, this takes
+    // time proportional to the number of runs of lines with custom sizes
+    void SetDefaultSize(int sizeDefault, int numLines);
+
+    // return true if all lines use the default size
+    bool IsEmpty() const { return m_root == NULL; }
+
+    // get the size of the line as it was set, i.e. possibly negative
+    int GetRawSize(int line) const;
+
+    // get the effective size of the line, i.e. 0 for hidden lines
+    int GetSize(int line) const { return wxMax(GetRawSize(line), 0); }
+
+    // set the size of the line, possibly negative, see above
+    void SetRawSize(int line, int size) { SetRawSizes(line, 1, size); }
+
+    // set the size of all lines in the given range at once
+    void SetRawSizes(int line, int num, int size);
+
+    // get the position of the start or the end of the line
+    int GetStart(int line) const;
+    int GetEnd(int line) const { return GetStart(line) + GetSize(line); }
+
+    // get the line containing the given non-negative position, the returned
+    // value may be greater than the index of the last line if the position is
+    // after it
+    int FindLine(int coord) const;
+
+    // update the line indices when lines are inserted or deleted, the new
+    // lines use the default size
+    void InsertLines(int pos, int num);
+    void DeleteLines(int pos, int num);
+
+    // fill the map with the sizes of all the lines with non-default size
+    void GetCustomSizes(wxUnsignedToIntHashMap& sizes) const;
+
+private:
+    struct Node
+    {
+        Node(int line_, int count_, int size_, unsigned priority_)
+            : line(line_),
+              count(count_),
+              size(size_),
+              priority(priority_),
+              shift(0),
+              sumDelta(0),
+              left(NULL),
+              right(NULL)
+        {
+        }
+
+        // the index of the first line of this run, not taking the pending
+        // shift into account
+        int line;
+
+        // the number of lines in this run
+        int count;
+
+        // the raw size of all lines of this run
+        int size;
+
+        // the heap priority of the node
+        unsigned priority;
+
+        // the shift to apply to the indices of all lines in this subtree
+        int shift;
+
+        // the sum of the size deltas for all lines in this subtree
+        int sumDelta;
+
+        Node *left,
+             *right;
+    };
+
+    // a run of lines, as stored in a node, used by SetDefaultSize()
+    struct Run
+    {
+        Run(int line_, int count_, int size_)
+            : line(line_), count(count_), size(size_) { }
+
+        int line,
+            count,
+            size;
+    };
+
+    // the size delta for a single line of the run
+    int GetLineDelta(const Node *node) const
+        { return wxMax(node->size, 0) - m_sizeDefault; }
+
+    // the size delta for all lines of the run
+    int GetDelta(const Node *node) const
+        { return node->count*GetLineDelta(node); }
+
+    static int GetSumDelta(const Node *node)
+        { return node ? node->sumDelta : 0; }
+
+    void UpdateSumDelta(Node *node) const
+    {
+        node->sumDelta = GetSumDelta(node->left) + GetDelta(node) +
+                            GetSumDelta(node->right);
+    }
+
+    // apply the pending shift of this node to it and its children
+    static void PushShift(Node *node);
+
+    // split the subtree into the lines before the given one and all the rest,
+    // cutting the run containing this line in two if necessary
+    void Split(Node *node, int line, Node*& left, Node*& right);
+
+    // merge two subtrees, all lines of the first one must be before the
+    // lines of the second one
+    Node *Merge(Node *left, Node *right);
+
+    // try to extend the last run of the subtree with the given lines starting
+    // just after it or the first one with the lines ending just before it,
+    // return false if the run doesn't have the same size or isn't adjacent
+    bool ExtendLast(Node *node, int line, int num, int size);
+    bool ExtendFirst(Node *node, int line, int num, int size);
+
+    static void DeleteSubtree(Node *node);
+
+    static void DoGetRuns(const Node *node, int shift, wxVector<Run>& runs);
+
+    unsigned GetNextPriority();
+
+
+    int m_sizeDefault;
+
+    Node *m_root;
+
+    // the state of the pseudo-random generator used for the priorities
+    unsigned m_seed;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridLinesGeometry);
+};
+
+// ----------------------------------------------------------------------------
+// text extents cache used during auto-sizing
+// ----------------------------------------------------------------------------
+
+WX_DECLARE_STRING_HASH_MAP(wxSize, wxGridStringToSizeMap);
+
+// As the same strings often occur in many cells of the same column or row,
+// remember the extents already computed while auto-sizing to avoid measuring
+// them again. The cache is only used for a single font at once and is reset
+// whenever it changes.
+class wxGridTextExtentCache
+{
+public:
+    wxGridTextExtentCache() { }
+
+    // return the extent of the given single line text, measuring it using the
+    // current DC font if it's not in the cache yet
+    wxSize GetTextExtent(wxDC& dc, const wxString& text)
+    {
+        const wxFont& font = dc.GetFont();
+        if ( font != m_font || m_extents.size() >= MAX_ENTRIES )
+        {
+            m_extents.clear();
+            m_font = font;
+        }
+
+        wxGridStringToSizeMap::const_iterator it = m_extents.find(text);
+        if ( it != m_extents.end() )
+            return it->second;
+
+        const wxSize size = dc.GetTextExtent(text);
+        m_extents[text] = size;
+
+        return size;
+    }
+
+private:
+    // don't let the cache grow indefinitely if all strings are different
+    enum { MAX_ENTRIES = 10000 };
+
+    wxFont m_font;
+    wxGridStringToSizeMap m_extents;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridTextExtentCache);
+};
+
+// Create the cache pointed to by the given variable during the lifetime of
+// this object, unless it already exists.
+class wxGridTextExtentCacheUser
+{
+public:
+    explicit wxGridTextExtentCacheUser(wxGridTextExtentCache*& cache)
+        : m_cache(cache),
+          m_cacheOwned(NULL)
+    {
+        if ( !m_cache )
+            m_cache = m_cacheOwned = new wxGridTextExtentCache;
+    }
+
+    ~wxGridTextExtentCacheUser()
+    {
+        if ( m_cacheOwned )
+        {
+            m_cache = NULL;
+            delete m_cacheOwned;
+        }
+    }
+
+private:
+    wxGridTextExtentCache*& m_cache;
+    wxGridTextExtentCache* m_cacheOwned;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridTextExtentCacheUser);
+};
+
 // ----------------------------------------------------------------------------
 // operations classes abstracting the difference between operating on rows and
 // columns
@@ -526,8 +781,10 @@ public:
     // Get the height/width of the given row/column
     virtual int GetLineSize(const wxGrid *grid, int line) const = 0;
 
-    // Get wxGrid::m_rowBottoms/m_colRights array
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const = 0;
+    // Get the position of the row/column containing the given non-negative
+    // coordinate, the returned value is greater than or equal to the number
+    // of lines if the coordinate is after the end of the last one
+    virtual int FindLinePos(const wxGrid *grid, int coord) const = 0;
 
     // Get default height row height or column width
     virtual int GetDefaultLineSize(const wxGrid *grid) const = 0;
@@ -610,8 +867,11 @@ public:
         { return grid->GetRowBottom(line); }
     virtual int GetLineSize(const wxGrid *grid, int line) const wxOVERRIDE
         { return grid->GetRowHeight(line); }
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const wxOVERRIDE
-        { return grid->m_rowBottoms; }
+    virtual int FindLinePos(const wxGrid *grid, int coord) const wxOVERRIDE
+    {
+        return grid->m_rowsGeometry ? grid->m_rowsGeometry->FindLine(coord)
+                                    : coord / grid->m_defaultRowHeight;
+    }
     virtual int GetDefaultLineSize(const wxGrid *grid) const wxOVERRIDE
         { return grid->GetDefaultRowSize(); }
     virtual int GetMinimalAcceptableLineSize(const wxGrid *grid) const wxOVERRIDE
@@ -676,8 +936,7 @@ public:
         { return grid->GetColRight(line); }
     virtual int GetLineSize(const wxGrid *grid, int line) const wxOVERRIDE
         { return grid->GetColWidth(line); }
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const wxOVERRIDE
-        { return grid->m_colRights; }
+    virtual int FindLinePos(const wxGrid *grid, int coord) const wxOVERRIDE;
     virtual int GetDefaultLineSize(const wxGrid *grid) const wxOVERRIDE
         { return grid->GetDefaultColSize(); }
     virtual int GetMinimalAcceptableLineSize(const wxGrid *grid) const wxOVERRIDE
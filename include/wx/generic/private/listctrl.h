@@ -19,6 +19,8 @@
 #include "wx/timer.h"
 #include "wx/settings.h"
 
+#include "wx/generic/private/prefetch.h"
+
 // ============================================================================
 // private classes
 // ============================================================================
@@ -202,6 +204,10 @@ public:
 
     bool m_checked;
 
+    // is this a placeholder for an item whose data is not available yet? [NB:
+    // only used in virtual mode]
+    bool m_placeholder;
+
     // back pointer to the list ctrl
     wxListMainWindow *m_owner;
 
@@ -311,6 +317,14 @@ private:
                            int x,
                            int yMid,    // this is middle, not top, of the text
                            int width);
+
+    // helper of DrawTextFormatted() drawing a single line of text
+    void DrawTextLine(wxDC *dc,
+                      const wxString &text,
+                      int col,
+                      int x,
+                      int yMid,
+                      int width);
 };
 
 class wxListLineDataArray : public wxVector<wxListLineData*>
@@ -326,6 +340,71 @@ public:
     ~wxListLineDataArray() { Clear(); }
 };
 
+//-----------------------------------------------------------------------------
+//  wxListLineHeights (internal)
+//-----------------------------------------------------------------------------
+
+// This class stores the heights of all lines of a virtual control with items
+// of variable height and allows to find the position of any line, or the line
+// at the given position, in logarithmic time. It uses a Fenwick (binary
+// indexed) tree of the heights, so that changing the height of a single line
+// doesn't require updating the positions of all the lines after it.
+//
+// The heights are stored as returned by OnGetItemHeight(), i.e. non-positive
+// values mean that the line uses the default height, so that the latter can
+// be changed without retrieving the heights of all lines again.
+class wxListLineHeights
+{
+public:
+    wxListLineHeights() : m_heightDefault(0), m_total(0) { }
+
+    // replace all the heights with the given ones
+    void Assign(const wxVector<int>& heights, int heightDefault);
+
+    void Clear();
+
+    size_t GetCount() const { return m_heights.size(); }
+
+    int GetDefaultHeight() const { return m_heightDefault; }
+    void SetDefaultHeight(int heightDefault);
+
+    // get the effective height of the line, i.e. the default height if it
+    // doesn't have its own one
+    int GetHeight(size_t line) const { return DoGetHeight(m_heights[line]); }
+
+    // set the height of the line, return true if its effective height changed
+    bool SetHeight(size_t line, int height);
+
+    // get the sum of the heights of all lines before the given one
+    int GetTop(size_t line) const;
+
+    int GetTotalHeight() const { return m_total; }
+
+    // find the line containing the given position, return GetCount() if the
+    // position is after the last line
+    size_t FindLine(int y) const;
+
+private:
+    int DoGetHeight(int height) const
+        { return height > 0 ? height : m_heightDefault; }
+
+    // rebuild the tree from m_heights
+    void Rebuild();
+
+    // the heights of all lines, as passed to Assign() or SetHeight()
+    wxVector<int> m_heights;
+
+    // the height of the lines without their own height
+    int m_heightDefault;
+
+    // the Fenwick tree, its element with (1-based) index i contains the sum
+    // of the heights of the lines in the range [i - (i & -i), i)
+    wxVector<int> m_tree;
+
+    // the sum of all heights
+    int m_total;
+};
+
 //-----------------------------------------------------------------------------
 //  wxListHeaderWindow (internal)
 //-----------------------------------------------------------------------------
@@ -659,6 +738,18 @@ public:
     bool IsItemChecked(long item) const;
     void CheckItem(long item, bool check);
 
+    // variable item height support, only in virtual report mode
+    bool EnableVariableLineHeight(bool enable = true);
+    bool HasVariableLineHeight() const
+        { return m_variableLineHeight && IsVirtual() && InReportView(); }
+
+    // update the heights of the given lines after they changed
+    void UpdateLineHeights(size_t lineFrom, size_t lineTo);
+
+    // prefetch hints support, only in virtual mode
+    void SetPrefetchLookAhead(int count) { m_prefetch.SetLookAhead(count); }
+    int GetPrefetchLookAhead() const { return m_prefetch.GetLookAhead(); }
+
     wxString GetItemText(long item, int col = 0) const
     {
         wxListItem info;
@@ -701,6 +792,8 @@ public:
     long InsertColumn( long col, const wxListItem &item );
     int GetItemWidthWithImage(wxListItem * item);
     void SortItems( wxListCtrlCompare fn, wxIntPtr data );
+    void SortItemsByKey( wxListCtrlStringKey fn, wxIntPtr data, bool ascending );
+    void SortItemsByKey( wxListCtrlNumericKey fn, wxIntPtr data, bool ascending );
 
     size_t GetItemCount() const;
     bool IsEmpty() const { return GetItemCount() == 0; }
@@ -722,7 +815,7 @@ public:
         if ( !wxWindow::SetFont(font) )
             return false;
 
-        m_lineHeight = 0;
+        ResetLineHeight();
 
         return true;
     }
@@ -738,9 +831,17 @@ public:
     // get the height of all lines (assuming they all do have the same height)
     wxCoord GetLineHeight() const;
 
+    // get the height of the given line, which is different from the above
+    // only if the lines have variable height (only for report view)
+    wxCoord GetLineHeight(size_t line) const;
+
     // get the y position of the given line (only for report view)
     wxCoord GetLineY(size_t line) const;
 
+    // get the line at the given y position or GetItemCount() if it's after
+    // the last line (only for report view)
+    size_t GetLineAt(int y) const;
+
     // get the brush to use for the item highlighting
     wxBrush *GetHighlightBrush() const
     {
@@ -868,9 +969,39 @@ private:
     // Always returns false if there are no checkboxes.
     bool IsInsideCheckBox(long item, int x, int y);
 
+    // get the heights of the lines, (re)computing them if necessary
+    const wxListLineHeights& GetLineHeights() const;
+
+    // forget the heights of all lines, they will be retrieved again when
+    // they're needed the next time
+    void InvalidateLineHeights() { m_lineHeightsValid = false; }
+
+    // force the default line height to be recomputed, this also affects the
+    // heights of the lines using it if they're variable, but doesn't require
+    // retrieving the heights of the other lines again
+    void ResetLineHeight() { m_lineHeight = 0; }
+
+    // send wxEVT_LIST_PREFETCH_HINT if the visible lines changed
+    void SendPrefetchHint(size_t visibleFrom, size_t visibleTo);
+
+    // common part of both SortItemsByKey() overloads
+    template <typename Key, typename KeyFunc>
+    void DoSortItemsByKey(KeyFunc fn, wxIntPtr data, bool ascending);
+
     // the height of one line using the current font
     wxCoord m_lineHeight;
 
+    // true if the lines may have different heights, see HasVariableLineHeight()
+    bool m_variableLineHeight;
+
+    // the heights of all lines if m_variableLineHeight is true, only valid if
+    // m_lineHeightsValid is true too
+    wxListLineHeights m_lineHeights;
+    bool m_lineHeightsValid;
+
+    // used to determine the lines to prefetch in virtual mode
+    wxPrefetchTracker m_prefetch;
+
     // the total header width or 0 if not calculated yet
     wxCoord m_headerWidth;
 
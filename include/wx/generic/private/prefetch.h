@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/generic/private/prefetch.h
+// Purpose:     Helpers for prefetching items in the generic virtual controls
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_GENERIC_PRIVATE_PREFETCH_H_
+#define _WX_GENERIC_PRIVATE_PREFETCH_H_
+
+#include "wx/dc.h"
+#include "wx/settings.h"
+
+// ----------------------------------------------------------------------------
+// wxPrefetchTracker: predicts which items will become visible soon
+// ----------------------------------------------------------------------------
+
+// This class remembers the range of the items shown by a control the last time
+// it was painted and, when it changes, determines the direction in which the
+// control is scrolled and the range of items which are going to be shown next.
+class wxPrefetchTracker
+{
+public:
+    wxPrefetchTracker() : m_lookAhead(0) { Reset(); }
+
+    // The number of items to look ahead, 0 disables prefetching.
+    void SetLookAhead(int lookAhead) { m_lookAhead = lookAhead; Reset(); }
+    int GetLookAhead() const { return m_lookAhead; }
+
+    // Forget the previously visible items, e.g. because they have changed.
+    void Reset() { m_visibleFrom = m_visibleTo = -1; }
+
+    // Update the range of visible items, inclusive, out of the given total
+    // number of them. Returns true and fills the output parameters with the
+    // range of the items to prefetch and the direction of scrolling (1 for
+    // down, -1 for up and 0 if unknown) if the visible range changed.
+    bool Update(long visibleFrom, long visibleTo, long count,
+                long* from, long* to, int* direction)
+    {
+        if ( !m_lookAhead || count <= 0 )
+            return false;
+
+        if ( visibleFrom == m_visibleFrom && visibleTo == m_visibleTo )
+            return false;
+
+        if ( m_visibleFrom == -1 || visibleFrom == m_visibleFrom )
+            *direction = 0;
+        else
+            *direction = visibleFrom > m_visibleFrom ? 1 : -1;
+
+        m_visibleFrom = visibleFrom;
+        m_visibleTo = visibleTo;
+
+        // When we don't know in which direction the user is going to scroll,
+        // prefetch the items on both sides of the visible ones.
+        *from = *direction > 0 ? visibleTo + 1 : visibleFrom - m_lookAhead;
+        *to = *direction < 0 ? visibleFrom - 1 : visibleTo + m_lookAhead;
+
+        if ( *from < 0 )
+            *from = 0;
+        if ( *to >= count )
+            *to = count - 1;
+
+        return *from <= *to;
+    }
+
+private:
+    int m_lookAhead;
+
+    long m_visibleFrom,
+         m_visibleTo;
+};
+
+// Draw the placeholder shown instead of the contents of an item which is not
+// available yet in the given rectangle.
+inline void wxDrawItemPlaceholder(wxDC& dc, const wxRect& rect)
+{
+    const int h = dc.GetCharHeight() / 2;
+
+    wxDCPenChanger setPen(dc, *wxTRANSPARENT_PEN);
+    wxDCBrushChanger
+        setBrush(dc, wxSystemSettings::GetColour(wxSYS_COLOUR_GRAYTEXT));
+    dc.DrawRectangle(rect.x, rect.y + (rect.height - h)/2, (2*rect.width)/3, h);
+}
+
+#endif // _WX_GENERIC_PRIVATE_PREFETCH_H_
@@ -15,6 +15,7 @@
 
 #include "wx/scrolwin.h"
 #include "wx/pen.h"
+#include "wx/vector.h"
 
 // -----------------------------------------------------------------------------
 // forward declaration
@@ -191,6 +192,10 @@ public:
 
     wxTreeItemId GetNext(const wxTreeItemId& item) const;
 
+    // return the index of the item among its siblings, this is mostly useful
+    // for the virtual controls (i.e. with wxTR_VIRTUAL style)
+    unsigned int GetItemIndex(const wxTreeItemId& item) const;
+
     // implementation only from now on
 
     // overridden base class virtuals
@@ -320,12 +325,36 @@ protected:
 
     void CalculateLineHeight();
     int  GetLineHeight(wxGenericTreeItem *item) const;
-    void PaintLevel( wxGenericTreeItem *item, wxDC& dc, int level, int &y );
+    void PaintLine( wxGenericTreeItem *item, wxDC& dc, int level, int y );
+    void PaintChildrenLine( wxGenericTreeItem *item, wxDC& dc, int level, int y );
     void PaintItem( wxGenericTreeItem *item, wxDC& dc);
 
-    void CalculateLevel( wxGenericTreeItem *item, wxDC &dc, int level, int &y );
+    // the layout of the items is computed incrementally: each item caches the
+    // height and width of its subtree and its offset from its first sibling,
+    // and only the items marked as dirty, together with all their parents,
+    // are laid out again by CalculatePositions()
+    void MarkLayoutDirty( wxGenericTreeItem *item );
+    void CalculateSubtree( wxGenericTreeItem *item, wxDC &dc );
     void CalculatePositions();
 
+    // the layout uses either rows or pixels as units, depending on whether
+    // all rows have the same height or not
+    bool HasVariableRowHeight() const;
+    int GetLineUnits( const wxGenericTreeItem *item ) const;
+    int UnitsToPixels( int units ) const;
+
+    // get the position of the items at the given level or of the given item
+    int GetLevelX( int level ) const;
+    int GetItemX( const wxGenericTreeItem *item ) const;
+    int GetItemY( const wxGenericTreeItem *item ) const;
+
+    // find the first item whose bottom is below the given position, fill
+    // path with the indices of all its parents and top with its position
+    wxGenericTreeItem *FindItemAtY( int y, wxVector<size_t>& path, int& top ) const;
+
+    // find the item at the given position (in logical coordinates)
+    wxGenericTreeItem *HitTestItem( const wxPoint& point, int& flags ) const;
+
     void RefreshSubtree( wxGenericTreeItem *item );
     void RefreshLine( wxGenericTreeItem *item );
 
@@ -350,6 +379,26 @@ protected:
 
     virtual wxSize DoGetBestSize() const wxOVERRIDE;
 
+    // these functions must be overridden in the derived class for a control
+    // with wxTR_VIRTUAL style, they are never called otherwise
+    virtual unsigned int OnGetChildrenCount(const wxTreeItemId& item) const;
+    virtual wxString OnGetItemText(const wxTreeItemId& item) const;
+
+    // in virtual mode, query the application for whether the item has
+    // children if it hadn't been done yet, does nothing otherwise
+    void UpdateVirtualItem(wxGenericTreeItem *item) const;
+
+    // in virtual mode, create the children of the item if it has none yet
+    void CreateVirtualChildren(wxGenericTreeItem *item);
+
+    // in virtual mode, make the subtrees containing the item wide enough for
+    // it after it was measured
+    void UpdateVirtualSubtreeWidths(wxGenericTreeItem *item);
+
+    // count the children of the item, asking the application about the
+    // children of the virtual items which weren't created yet
+    size_t DoGetChildrenCount(wxGenericTreeItem *item, bool recursively) const;
+
 private:
     // Reset the state of the last find (i.e. keyboard incremental search)
     // operation.
@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/gtk/private/extentcache.h
+// Purpose:     wxGtkTextExtentCache class declaration
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_GTK_PRIVATE_EXTENTCACHE_H_
+#define _WX_GTK_PRIVATE_EXTENTCACHE_H_
+
+#include "wx/string.h"
+#include "wx/vector.h"
+
+#include <pango/pango.h>
+
+// ----------------------------------------------------------------------------
+// wxGtkTextExtentContext: everything the text extents depend on except the
+// font and the text itself
+// ----------------------------------------------------------------------------
+
+struct wxGtkTextExtentContext
+{
+    wxGtkTextExtentContext()
+    {
+        fontMap = NULL;
+        kind = 0;
+        xx = yy = 1.0;
+        xy = yx = 0.0;
+    }
+
+    bool operator==(const wxGtkTextExtentContext& other) const
+    {
+        return fontMap == other.fontMap && kind == other.kind &&
+                xx == other.xx && yx == other.yx &&
+                    xy == other.xy && yy == other.yy;
+    }
+
+    // the Pango font map used for measuring
+    const void *fontMap;
+
+    // identifies the way of measuring (e.g. different rounding is used when
+    // measuring for a window or a DC) and the kind of the target surface,
+    // as it determines the font options
+    int kind;
+
+    // the linear part of the transformation matrix, if any
+    double xx, yx,
+           xy, yy;
+};
+
+// ----------------------------------------------------------------------------
+// wxGtkTextExtentCache: LRU cache of the measured strings extents
+// ----------------------------------------------------------------------------
+
+// Measuring text with Pango requires shaping it, which is relatively slow,
+// while the controls typically measure the same strings (e.g. their items
+// labels) over and over again, so the results of the last measurements are
+// cached in the global object returned by Get().
+//
+// The entries are looked up using the context, the font description and the
+// string itself without allocating any memory.
+//
+// Notice that it's only used from the main thread, so it doesn't need to be
+// protected by a critical section.
+class wxGtkTextExtentCache
+{
+public:
+    wxGtkTextExtentCache();
+    ~wxGtkTextExtentCache();
+
+    static wxGtkTextExtentCache& Get();
+
+    // Return true and fill in the output parameters if the extent of the
+    // string is found.
+    bool Find(const wxGtkTextExtentContext& context,
+              const PangoFontDescription *desc,
+              const wxString& text,
+              int *width, int *height, int *descent);
+
+    // Store the extent of the string, possibly replacing the least recently
+    // used entry.
+    void Add(const wxGtkTextExtentContext& context,
+             const PangoFontDescription *desc,
+             const wxString& text,
+             int width, int height, int descent);
+
+    void Clear();
+
+    unsigned long GetHits() const { return m_hits; }
+    unsigned long GetMisses() const { return m_misses; }
+
+private:
+    // The maximal number of cached strings, must be a power of 2 as it's also
+    // used as the number of hash buckets.
+    enum { MAX_ENTRIES = 4096 };
+
+    // Invalid index used as the end of the lists marker.
+    static const size_t NONE = (size_t)-1;
+
+    // The entries form a doubly linked list in the order of their use, using
+    // indices instead of pointers to keep them in a single vector, and singly
+    // linked lists of the entries in the same hash bucket.
+    struct Entry
+    {
+        wxGtkTextExtentContext context;
+        PangoFontDescription *desc;
+        wxString text;
+        size_t hash;
+
+        int width,
+            height,
+            descent;
+
+        size_t prev,
+               next,
+               nextInBucket;
+    };
+
+    static size_t GetHash(const wxGtkTextExtentContext& context,
+                          const PangoFontDescription *desc,
+                          const wxString& text);
+
+    size_t FindEntry(const wxGtkTextExtentContext& context,
+                     const PangoFontDescription *desc,
+                     const wxString& text,
+                     size_t hash) const;
+
+    void Unlink(size_t n);
+    void LinkAtFront(size_t n);
+    void RemoveFromBucket(size_t n);
+
+    wxVector<Entry> m_entries;
+
+    // The index of the first entry in each hash bucket.
+    wxVector<size_t> m_buckets;
+
+    // The most and least recently used entries.
+    size_t m_head,
+           m_tail;
+
+    unsigned long m_hits,
+                  m_misses;
+
+    wxDECLARE_NO_COPY_CLASS(wxGtkTextExtentCache);
+};
+
+#endif // _WX_GTK_PRIVATE_EXTENTCACHE_H_
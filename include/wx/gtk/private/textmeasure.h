@@ -10,6 +10,8 @@
 #ifndef _WX_GTK_PRIVATE_TEXTMEASURE_H_
 #define _WX_GTK_PRIVATE_TEXTMEASURE_H_
 
+#include "wx/gtk/private/extentcache.h"
+
 // ----------------------------------------------------------------------------
 // wxTextMeasure
 // ----------------------------------------------------------------------------
@@ -31,6 +33,12 @@ public:
         Init();
     }
 
+    // The extents of the strings measured by this class are cached, these
+    // functions allow to retrieve the number of cache hits and misses, for
+    // diagnostic purposes, and to clear the cache.
+    static void GetExtentCacheStats(unsigned long *hits, unsigned long *misses);
+    static void ClearExtentCache();
+
 protected:
     // Common part of both ctors.
     void Init();
@@ -44,6 +52,10 @@ protected:
                                  wxCoord *descent = NULL,
                                  wxCoord *externalLeading = NULL) wxOVERRIDE;
 
+    virtual void DoGetTextExtents(const wxArrayString& strings,
+                                  wxArrayInt& widths,
+                                  wxArrayInt& heights) wxOVERRIDE;
+
     virtual bool DoGetPartialTextExtents(const wxString& text,
                                          wxArrayInt& widths,
                                          double scaleX) wxOVERRIDE;
@@ -58,6 +70,11 @@ protected:
     PangoContext *m_context;
     PangoLayout *m_layout;
 
+    // The context and the font used for the extent cache lookups, set by
+    // BeginMeasuring().
+    wxGtkTextExtentContext m_cacheContext;
+    const PangoFontDescription *m_cacheFontDesc;
+
     wxDECLARE_NO_COPY_CLASS(wxTextMeasure);
 };
 
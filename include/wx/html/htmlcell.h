@@ -24,6 +24,8 @@ class WXDLLIMPEXP_FWD_HTML wxHtmlWindowInterface;
 class WXDLLIMPEXP_FWD_HTML wxHtmlLinkInfo;
 class WXDLLIMPEXP_FWD_HTML wxHtmlCell;
 class WXDLLIMPEXP_FWD_HTML wxHtmlContainerCell;
+class wxHtmlContainerCellIndex;
+struct wxHtmlContainerPartialLayout;
 
 
 // wxHtmlSelection is data holder with information about text selection.
@@ -185,6 +187,13 @@ public:
     wxHtmlCell();
     virtual ~wxHtmlCell();
 
+#if !wxUSE_MEMORY_TRACING
+    // there are typically very many cells, so they are allocated from big
+    // blocks of memory shared by all of them
+    static void* operator new(size_t size);
+    static void operator delete(void* p, size_t size);
+#endif // !wxUSE_MEMORY_TRACING
+
     void SetParent(wxHtmlContainerCell *p) {m_Parent = p;}
     wxHtmlContainerCell *GetParent() const {return m_Parent;}
 
@@ -455,6 +464,13 @@ public:
     virtual void DrawInvisible(wxDC& dc, int x, int y,
                                wxHtmlRenderingInfo& info) wxOVERRIDE;
 
+    // Lays out the container like Layout() but only lays out the children
+    // above the given vertical position, relative to the container, and
+    // estimates the size of the other ones. Returns true if the layout is
+    // complete or false if this function must be called again with a bigger
+    // position, or Layout() called, to finish it.
+    bool LayoutPartially(int w, int yMax);
+
     virtual bool AdjustPagebreak(int *pagebreak, int pageHeight) const wxOVERRIDE;
 
     // insert cell at the end of m_Cells list
@@ -530,6 +546,27 @@ protected:
     void UpdateRenderingStatePost(wxHtmlRenderingInfo& info,
                                   wxHtmlCell *cell) const;
 
+    // draw a single child cell, or just update the rendering state if it's
+    // outside of the visible area
+    void DrawCell(wxHtmlCell *cell, wxDC& dc, int x, int y,
+                  int view_y1, int view_y2, wxHtmlRenderingInfo& info);
+
+    // forget the layout and the index of the child cells positions after
+    // they changed in this container or any of its children
+    void InvalidateLayout();
+
+private:
+    // common part of Layout() and LayoutPartially(), returns true if the
+    // layout was complete
+    bool DoLayout(int w, int yMax);
+
+    // returns our own width if the given width is available
+    int GetWidthFor(int w) const;
+
+    // sets our size to an estimation of its value after laying out with the
+    // given width, without really doing it
+    void EstimateLayout(int w, int defaultHeight);
+
 protected:
     int m_IndentLeft, m_IndentRight, m_IndentTop, m_IndentBottom;
             // indentation of subcells. There is always m_Indent pixels
@@ -552,10 +589,19 @@ protected:
             // borders color of this container
     int m_LastLayout;
             // if != -1 then call to Layout may be no-op
-            // if previous call to Layout has same argument
+            // if previous call to Layout results in the same width
     int m_MaxTotalWidth;
             // Maximum possible length if ignoring line wrap
 
+private:
+    wxHtmlContainerCellIndex *m_index;
+            // index of the child cells by their vertical position allowing to
+            // find the visible ones quickly, built by Layout(), may be NULL
+    wxHtmlContainerPartialLayout *m_partialLayout;
+            // the state of the layout done by LayoutPartially() allowing to
+            // continue it from where it stopped, may be NULL
+
+    friend class wxHtmlContainerCellIndex;
 
     wxDECLARE_ABSTRACT_CLASS(wxHtmlContainerCell);
     wxDECLARE_NO_COPY_CLASS(wxHtmlContainerCell);
@@ -581,6 +627,8 @@ protected:
     wxColour m_Colour;
     unsigned m_Flags;
 
+    friend class wxHtmlContainerCellIndex;
+
     wxDECLARE_ABSTRACT_CLASS(wxHtmlColourCell);
     wxDECLARE_NO_COPY_CLASS(wxHtmlColourCell);
 };
@@ -20,12 +20,14 @@
 #include "wx/fontenc.h"
 
 class WXDLLIMPEXP_FWD_BASE wxMBConv;
+class WXDLLIMPEXP_FWD_BASE wxInputStream;
 class WXDLLIMPEXP_FWD_HTML wxHtmlParser;
 class WXDLLIMPEXP_FWD_HTML wxHtmlTagHandler;
 class WXDLLIMPEXP_FWD_HTML wxHtmlEntitiesParser;
 
 class wxHtmlTextPieces;
 class wxHtmlParserState;
+class wxHtmlStreamingState;
 
 WX_DECLARE_HASH_SET_WITH_DECL_PTR(wxHtmlTagHandler*,
                                   wxPointerHash, wxPointerEqual,
@@ -72,6 +74,33 @@ public:
     // 4. call DoneParser();
     wxObject* Parse(const wxString& source);
 
+    // Parses the document read from the given stream, which must use an
+    // ASCII-compatible encoding, in chunks. This is equivalent to calling
+    // Parse() with the entire document but doesn't require keeping both its
+    // bytes and its text in memory at once. Returns NULL if the document
+    // couldn't be converted using the given conversion.
+    wxObject* Parse(wxInputStream& stream, const wxMBConv& conv = wxConvUTF8);
+
+    // Streaming parsing: instead of passing the entire document to Parse(),
+    // it can be fed to the parser in chunks of arbitrary size by calling
+    // BeginStreaming(), then ParseChunk() as many times as needed and,
+    // finally, EndStreaming() which returns the product of parsing and calls
+    // DoneParser().
+    //
+    // ParseChunk() parses all the parts of the document received so far
+    // which are known to be complete immediately, so the product being built
+    // can be shown before the end of the document is reached.
+    void BeginStreaming();
+    void ParseChunk(const wxString& chunk);
+    // Reads the next chunk of the document from the stream and parses it,
+    // returns false when the end of the stream is reached or if its contents
+    // couldn't be converted, HasStreamingError() returns true in the latter
+    // case.
+    bool ParseChunk(wxInputStream& stream, const wxMBConv& conv = wxConvUTF8);
+    bool HasStreamingError() const;
+    wxObject* EndStreaming();
+    bool IsStreaming() const { return m_streaming != NULL; }
+
     // Sets the source. This must be called before running Parse() method.
     virtual void InitParser(const wxString& source);
     // This must be called after Parse().
@@ -190,6 +219,13 @@ protected:
     wxHtmlTagHandlersSet m_HandlersSet;
     wxHtmlTagHandlersHash m_HandlersHash;
 
+    // the handlers of the standard tags from m_HandlersHash indexed by the
+    // atoms of their names (see wxHtmlTag::GetAtom()) to find them faster
+    wxVector<wxHtmlTagHandler*> m_handlersByAtom;
+
+    // update both m_HandlersHash and m_handlersByAtom
+    void SetTagHandler(const wxString& name, wxHtmlTagHandler *handler);
+
     wxDECLARE_NO_COPY_CLASS(wxHtmlParser);
 
     // class for opening files (file system)
@@ -202,6 +238,9 @@ protected:
 
     // flag indicating that the parser should stop
     bool m_stopParsing;
+
+    // the state of streaming parsing, only non-NULL during it
+    wxHtmlStreamingState *m_streaming;
 };
 
 
@@ -15,6 +15,7 @@
 
 #include "wx/object.h"
 #include "wx/arrstr.h"
+#include "wx/vector.h"
 
 class WXDLLIMPEXP_FWD_CORE wxColour;
 class WXDLLIMPEXP_FWD_HTML wxHtmlEntitiesParser;
@@ -146,10 +147,29 @@ public:
 #endif // WXWIN_COMPATIBILITY_2_8
 
 private:
+    // The standard tag and parameter names are identified by small integers,
+    // called atoms, allowing to compare them quickly. This function returns
+    // the atom for the given name, case-insensitively, or wxNOT_FOUND if it
+    // is not one of them.
+    static int GetAtom(const wxString& name);
+
+    struct Param
+    {
+        int atom;
+        wxString name;
+        wxString value;
+    };
+
+    void AddParam(const wxString& name, const wxString& value);
+
+    // returns the parameter with the given name or NULL if there is none
+    const Param* FindParam(const wxString& par) const;
+
     wxString m_Name;
+    int m_nameAtom;
     bool m_hasEnding;
     wxString::const_iterator m_Begin, m_End1, m_End2;
-    wxArrayString m_ParamNames, m_ParamValues;
+    wxVector<Param> m_params;
 #if WXWIN_COMPATIBILITY_2_8
     wxString::const_iterator m_sourceStart;
 #endif
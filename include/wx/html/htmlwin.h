@@ -281,6 +281,12 @@ public:
     // Loads HTML page from file
     bool LoadFile(const wxFileName& filename);
 
+    // Loads HTML page from the given stream, which must use an
+    // ASCII-compatible encoding, showing the beginning of the page as soon
+    // as it is parsed and before the rest of it is read.
+    bool LoadStream(wxInputStream& stream,
+                    const wxMBConv& conv = wxConvUTF8);
+
     // Returns full location of opened page
     wxString GetOpenedPage() const {return m_OpenedPage;}
     // Returns anchor within opened page
@@ -339,6 +345,15 @@ public:
     // It should be used ONLY when printing
     wxHtmlContainerCell* GetInternalRepresentation() const {return m_Cell;}
 
+    // Enables laying out only the visible part of the page immediately and
+    // the rest of it in idle time, which makes showing and resizing long
+    // pages faster.
+    void EnableIncrementalLayout(bool enable = true);
+    bool IsIncrementalLayoutEnabled() const { return m_incrementalLayout; }
+
+    // Lays out the rest of the page immediately if it's done incrementally.
+    void CompleteLayout();
+
     // Adds input filter
     static void AddFilter(wxHtmlFilter *filter);
 
@@ -516,6 +531,21 @@ private:
     // don't have any background image
     void DoEraseBackground(wxDC& dc);
 
+    // common parts of DoSetPage() and LoadStream(): prepare for parsing a
+    // new page and show it once it's parsed
+    void BeginNewPage(wxDC& dc);
+    void EndNewPage();
+
+    // show the part of the page parsed so far if it fills the window
+    bool ShowPartialPage();
+
+    // lay out the page for the given width, only partially if incremental
+    // layout is enabled
+    void LayoutCell(int width);
+
+    // continue incremental layout until at least the given position
+    void LayoutUpTo(int y);
+
     // window content for double buffered rendering, may be invalid until it is
     // really initialized in OnPaint()
     wxBitmap m_backBuffer;
@@ -531,6 +561,14 @@ private:
     // (in order to avoid ugly blinking)
     int m_tmpCanDrawLocks;
 
+    // true if only the visible part of the page is laid out immediately
+    bool m_incrementalLayout;
+
+    // the width for which the page is laid out and, if the layout is not
+    // complete yet, the position until which it was done or -1 otherwise
+    int m_layoutWidth,
+        m_layoutUpTo;
+
     // list of HTML filters
     static wxList m_Filters;
     // this filter is used when no filter is able to read some file
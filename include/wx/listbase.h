@@ -29,6 +29,12 @@ class WXDLLIMPEXP_FWD_CORE wxImageList;
 typedef
 int (wxCALLBACK *wxListCtrlCompare)(wxIntPtr item1, wxIntPtr item2, wxIntPtr sortData);
 
+// types of functions returning the key of the item for SortItemsByKey()
+typedef
+wxString (wxCALLBACK *wxListCtrlStringKey)(wxIntPtr item, wxIntPtr sortData);
+typedef
+double (wxCALLBACK *wxListCtrlNumericKey)(wxIntPtr item, wxIntPtr sortData);
+
 // ----------------------------------------------------------------------------
 // wxListCtrl constants
 // ----------------------------------------------------------------------------
@@ -420,6 +426,28 @@ public:
     virtual bool IsItemChecked(long WXUNUSED(item)) const { return false; }
     virtual void CheckItem(long WXUNUSED(item), bool WXUNUSED(check)) { }
 
+    // Variable item height support for virtual controls in report view: only
+    // implemented in the generic version currently.
+    virtual bool HasVariableItemHeight() const { return false; }
+    virtual bool EnableVariableItemHeight(bool WXUNUSED(enable) = true) { return false; }
+
+    // Prefetch hints are only sent by the generic virtual controls, the
+    // look-ahead is the number of items to prefetch, 0 to disable them.
+    virtual bool SetPrefetchLookAhead(int WXUNUSED(count)) { return false; }
+    virtual int GetPrefetchLookAhead() const { return 0; }
+
+    // Sort the items using the keys returned by the given function, which is
+    // called only once for each item. This is only implemented in the generic
+    // version currently and returns false if not supported.
+    virtual bool SortItemsByKey(wxListCtrlStringKey WXUNUSED(fn),
+                                wxIntPtr WXUNUSED(data),
+                                bool WXUNUSED(ascending) = true)
+        { return false; }
+    virtual bool SortItemsByKey(wxListCtrlNumericKey WXUNUSED(fn),
+                                wxIntPtr WXUNUSED(data),
+                                bool WXUNUSED(ascending) = true)
+        { return false; }
+
 protected:
     // Real implementations methods to which our public forwards.
     virtual long DoInsertColumn(long col, const wxListItem& info) = 0;
@@ -448,6 +476,7 @@ public:
         , m_pointDrag()
         , m_item()
         , m_editCancelled(false)
+        , m_prefetchDirection(0)
         { }
 
     wxListEvent(const wxListEvent& event)
@@ -459,6 +488,7 @@ public:
         , m_pointDrag(event.m_pointDrag)
         , m_item(event.m_item)
         , m_editCancelled(event.m_editCancelled)
+        , m_prefetchDirection(event.m_prefetchDirection)
         { }
 
     int GetKeyCode() const { return m_code; }
@@ -478,12 +508,16 @@ public:
     void SetPoint(const wxPoint& point) { m_pointDrag = point; }
     void SetItem(const wxListItem& item) { m_item = item; }
 
-    // for wxEVT_LIST_CACHE_HINT only
+    // for wxEVT_LIST_CACHE_HINT and wxEVT_LIST_PREFETCH_HINT only
     long GetCacheFrom() const { return m_oldItemIndex; }
     long GetCacheTo() const { return m_itemIndex; }
     void SetCacheFrom(long cacheFrom) { m_oldItemIndex = cacheFrom; }
     void SetCacheTo(long cacheTo) { m_itemIndex = cacheTo; }
 
+    // for wxEVT_LIST_PREFETCH_HINT only: 1 if scrolling down, -1 if up or 0
+    int GetPrefetchDirection() const { return m_prefetchDirection; }
+    void SetPrefetchDirection(int direction) { m_prefetchDirection = direction; }
+
     // was label editing canceled? (for wxEVT_LIST_END_LABEL_EDIT only)
     bool IsEditCancelled() const { return m_editCancelled; }
     void SetEditCanceled(bool editCancelled) { m_editCancelled = editCancelled; }
@@ -492,7 +526,7 @@ public:
 
 //protected: -- not for backwards compatibility
     int           m_code;
-    long          m_oldItemIndex; // only for wxEVT_LIST_CACHE_HINT
+    long          m_oldItemIndex; // only for wxEVT_LIST_{CACHE,PREFETCH}_HINT
     long          m_itemIndex;
     int           m_col;
     wxPoint       m_pointDrag;
@@ -501,6 +535,7 @@ public:
 
 protected:
     bool          m_editCancelled;
+    int           m_prefetchDirection;
 
 private:
     wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxListEvent);
@@ -526,6 +561,7 @@ wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_LIST_ITEM_RIGHT_CLICK, wxListE
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_LIST_ITEM_MIDDLE_CLICK, wxListEvent );
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_LIST_ITEM_ACTIVATED, wxListEvent );
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_LIST_CACHE_HINT, wxListEvent );
+wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_LIST_PREFETCH_HINT, wxListEvent );
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_LIST_COL_RIGHT_CLICK, wxListEvent );
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_LIST_COL_BEGIN_DRAG, wxListEvent );
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_CORE, wxEVT_LIST_COL_DRAGGING, wxListEvent );
@@ -567,6 +603,7 @@ typedef void (wxEvtHandler::*wxListEventFunction)(wxListEvent&);
 #define EVT_LIST_ITEM_UNCHECKED(id, fn) wx__DECLARE_LISTEVT(ITEM_UNCHECKED, id, fn)
 
 #define EVT_LIST_CACHE_HINT(id, fn) wx__DECLARE_LISTEVT(CACHE_HINT, id, fn)
+#define EVT_LIST_PREFETCH_HINT(id, fn) wx__DECLARE_LISTEVT(PREFETCH_HINT, id, fn)
 
 // old wxEVT_COMMAND_* constants
 #define wxEVT_COMMAND_LIST_BEGIN_DRAG          wxEVT_LIST_BEGIN_DRAG
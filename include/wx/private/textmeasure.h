@@ -45,6 +45,14 @@ public:
                                 wxCoord *height,
                                 wxCoord *heightOneLine = NULL);
 
+    // Measure several single line strings at once, filling the widths and,
+    // optionally, heights arrays with their extents. This is more efficient
+    // than calling GetTextExtent() for each of them as some ports measure all
+    // of them in a single pass.
+    void GetTextExtents(const wxArrayString& strings,
+                        wxArrayInt& widths,
+                        wxArrayInt* heights = NULL);
+
     // Find the dimensions of the largest string.
     wxSize GetLargestStringExtent(size_t n, const wxString* strings);
     wxSize GetLargestStringExtent(const wxArrayString& strings)
@@ -110,6 +118,15 @@ protected:
                                  wxCoord *descent = NULL,
                                  wxCoord *externalLeading = NULL) = 0;
 
+    // The real implementation of GetTextExtents().
+    //
+    // On input, widths and heights arrays contain strings.size() zero
+    // elements and strings is non-empty. The default implementation simply
+    // measures all strings one by one using CallGetTextExtent().
+    virtual void DoGetTextExtents(const wxArrayString& strings,
+                                  wxArrayInt& widths,
+                                  wxArrayInt& heights);
+
     // The real implementation of GetPartialTextExtents().
     //
     // On input, widths array contains text.length() zero elements and the text
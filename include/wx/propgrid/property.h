@@ -1679,8 +1679,8 @@ public:
 
     void SetExpanded( bool expanded )
     {
-        if ( !expanded ) m_flags |= wxPG_PROP_COLLAPSED;
-        else m_flags &= ~wxPG_PROP_COLLAPSED;
+        if ( !expanded ) DoSetFlags(m_flags | wxPG_PROP_COLLAPSED);
+        else DoSetFlags(m_flags & ~wxPG_PROP_COLLAPSED);
     }
 
     // Sets or clears given property flag. Mainly for internal use.
@@ -1691,9 +1691,9 @@ public:
     void ChangeFlag( wxPGPropertyFlags flag, bool set )
     {
         if ( set )
-            m_flags |= flag;
+            DoSetFlags(m_flags | flag);
         else
-            m_flags &= ~flag;
+            DoSetFlags(m_flags & ~flag);
     }
 
     // Sets or clears given property flag, recursively. This function is
@@ -1982,10 +1982,10 @@ protected:
         // NB: While using wxPGPropertyFlags here makes it difficult to
         //     combine different flags, it usefully prevents user from
         //     using incorrect flags (say, wxWindow styles).
-        m_flags |= flag;
+        DoSetFlags(m_flags | flag);
     }
 
-    void ClearFlag( FlagType flag ) { m_flags &= ~(flag); }
+    void ClearFlag( FlagType flag ) { DoSetFlags(m_flags & ~(flag)); }
 
     // Called when the property is being removed from the grid and/or
     // page state (but *not* when it is also deleted).
@@ -2055,6 +2055,22 @@ private:
     // Called in constructors.
     void Init();
     void Init( const wxString& label, const wxString& name );
+
+    // Called after adding, removing or reordering children.
+    void ChildrenChanged();
+
+    // Changes the flags, notifying the state if this affects the visible
+    // rows, i.e. if the property was expanded, collapsed, hidden or shown.
+    void DoSetFlags( FlagType flags )
+    {
+        const FlagType changed = (m_flags ^ flags) &
+                                    (wxPG_PROP_COLLAPSED | wxPG_PROP_HIDDEN);
+        m_flags = flags;
+        if ( changed )
+            RowFlagsChanged(changed);
+    }
+
+    void RowFlagsChanged( FlagType changed );
 };
 
 // -----------------------------------------------------------------------
@@ -178,6 +178,10 @@ public:
     // populating has been finished, you need to call EndAddChildren.
     void BeginAddChildren( wxPGPropArg id );
 
+    // Begins adding many properties at once, which is faster than adding
+    // them one by one. EndBulkLoad() must be called when done.
+    void BeginBulkLoad();
+
     // Deletes all properties.
     virtual void Clear() = 0;
 
@@ -246,6 +250,9 @@ public:
     // Called after population of property with fixed children has finished.
     void EndAddChildren( wxPGPropArg id );
 
+    // Ends adding properties started by BeginBulkLoad().
+    void EndBulkLoad();
+
     // Expands given category or property with children.
     // Returns true if actually expands.
     bool Expand( wxPGPropArg id );
@@ -533,10 +533,10 @@ public:
                               bool fromOnResize = false );
 
     // Recalculates m_virtualHeight.
-    void RecalculateVirtualHeight()
-    {
-        m_virtualHeight = GetActualVirtualHeight();
-    }
+    void RecalculateVirtualHeight();
+
+    // Make sure the visible rows index used by DoGetItemAtY() is up-to-date.
+    void EnsureVisibleRows();
 
     void SetColumnCount( int colCount );
 
@@ -566,11 +566,24 @@ public:
     void VirtualHeightChanged()
     {
         m_vhCalcPending = true;
+        m_visibleRowsValid = false;
     }
 
     // Base append.
     wxPGProperty* DoAppend( wxPGProperty* property );
 
+    // Begins adding many properties at once: until the matching call to
+    // EndBulkLoad(), adding a property doesn't update the names dictionary
+    // nor the values of its composed parents, this is done for all of them
+    // at once at the end. Calls to these functions may be nested.
+    void BeginBulkLoad() { m_bulkLoad++; }
+
+    // Ends adding properties started by BeginBulkLoad().
+    void EndBulkLoad();
+
+    // Returns true if between BeginBulkLoad() and EndBulkLoad() calls.
+    bool IsInBulkLoad() const { return m_bulkLoad > 0; }
+
     // Returns property by its name.
     wxPGProperty* BaseGetPropertyByName( const wxString& name ) const;
 
@@ -625,6 +638,18 @@ protected:
     bool IsChildCategory(wxPGProperty* p,
                          wxPropertyCategory* cat, bool recursive);
 
+    // Returns the index of the property in m_visibleRows or wxNOT_FOUND.
+    int DoGetVisibleRow(const wxPGProperty* p) const;
+
+    // Called by wxPGProperty when its wxPG_PROP_COLLAPSED and/or
+    // wxPG_PROP_HIDDEN flags, as indicated by the second argument, change.
+    void OnPropertyRowFlagsChanged(wxPGProperty* p,
+                                   wxPGProperty::FlagType changed);
+
+    // Performs the updates postponed in bulk load mode, this is done before
+    // doing anything else than adding more properties.
+    void DoFlushBulkLoad();
+
     // If visible, then this is pointer to wxPropertyGrid.
     // This shall *never* be NULL to indicate that this state is not visible.
     wxPropertyGrid*             m_pPropGrid;
@@ -698,6 +723,22 @@ protected:
     // Used to (temporarily) disable splitter centering.
     bool                        m_dontCenterSplitter;
 
+    // All visible properties in the order in which they are shown, one per
+    // row, which allows to find the property at the given position without
+    // walking the tree. Only valid if m_visibleRowsValid is true, but is
+    // updated in place when a property is expanded or collapsed.
+    wxVector<wxPGProperty*>     m_visibleRows;
+    bool                        m_visibleRowsValid;
+
+    // Number of BeginBulkLoad() calls without the matching EndBulkLoad().
+    int                         m_bulkLoad;
+
+    // Properties added in bulk load mode whose names haven't been added to
+    // m_dictName yet and the composed parents whose values haven't been
+    // updated yet.
+    wxVector<wxPGProperty*>     m_bulkNames;
+    wxVector<wxPGProperty*>     m_bulkParents;
+
 private:
     // Only inits arrays, doesn't migrate things or such.
     void InitNonCatMode();
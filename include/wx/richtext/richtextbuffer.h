@@ -66,6 +66,7 @@
 #include "wx/txtstrm.h"
 #include "wx/variant.h"
 #include "wx/position.h"
+#include "wx/vector.h"
 
 #if wxUSE_DATAOBJ
 #include "wx/dataobj.h"
@@ -2405,7 +2406,7 @@ public:
     wxRichTextDrawingContext(wxRichTextBuffer* buffer);
 
     void Init()
-    { m_buffer = NULL; m_enableVirtualAttributes = true; m_enableImages = true; m_layingOut = false; m_enableDelayedImageLoading = false; }
+    { m_buffer = NULL; m_enableVirtualAttributes = true; m_enableImages = true; m_layingOut = false; m_enableDelayedImageLoading = false; m_layoutEstimationStart = wxDefaultCoord; }
 
     /**
         Does this object have virtual attributes?
@@ -2499,6 +2500,27 @@ public:
 
     bool GetDelayedImageLoading() const { return m_enableDelayedImageLoading; }
 
+    /**
+        Sets the y position below which the paragraphs which haven't been laid
+        out yet only get an estimated layout, or wxDefaultCoord to lay out all
+        of them.
+
+        @see wxRichTextParagraph::EstimateLayout()
+
+        @since 3.1.3
+    */
+
+    void SetLayoutEstimationStart(int y) { m_layoutEstimationStart = y; }
+
+    /**
+        Returns the y position below which the layout is only estimated, or
+        wxDefaultCoord.
+
+        @since 3.1.3
+    */
+
+    int GetLayoutEstimationStart() const { return m_layoutEstimationStart; }
+
     /**
         Returns the buffer pointer.
     */
@@ -2510,6 +2532,54 @@ public:
     bool                m_enableImages;
     bool                m_enableDelayedImageLoading;
     bool                m_layingOut;
+    int                 m_layoutEstimationStart;
+};
+
+class wxRichTextSharedAttr;
+class wxRichTextSharedAttrPool;
+
+/*
+    wxRichTextCombinedAttrCache is used internally by wxRichTextObject to keep
+    its combined attributes, shared with all the other objects in the same
+    buffer having the same ones, together with the generation of its own
+    attributes and the cached attributes they were combined with. It is never
+    copied together with the object containing it.
+*/
+
+class WXDLLIMPEXP_RICHTEXT wxRichTextCombinedAttrCache
+{
+public:
+    wxRichTextCombinedAttrCache() { Init(); }
+    wxRichTextCombinedAttrCache(const wxRichTextCombinedAttrCache& WXUNUSED(cache)) { Init(); }
+    ~wxRichTextCombinedAttrCache() { Reset(); }
+
+    wxRichTextCombinedAttrCache& operator=(const wxRichTextCombinedAttrCache& WXUNUSED(cache)) { Reset(); return *this; }
+
+    // Returns true if the cached attributes were combined from the attributes
+    // with the given generation and the given base attributes.
+    bool IsValid(unsigned generation, const wxRichTextSharedAttr* base) const
+    { return m_attr && m_generation == generation && m_base == base; }
+
+    // Returns the cached attributes, only if IsValid() returned true.
+    const wxRichTextAttr& Get() const;
+
+    // Returns the cached attributes to be used as the base of other ones.
+    wxRichTextSharedAttr* GetShared() const { return m_attr; }
+
+    // Caches the attributes combined from the given base ones, sharing them
+    // with the other caches containing the attributes equal to them and
+    // combined from the same base ones if the pool is not NULL.
+    void Set(const wxRichTextAttr& attr, unsigned generation, wxRichTextSharedAttr* base, wxRichTextSharedAttrPool* pool);
+
+    // Forgets the cached attributes.
+    void Reset();
+
+private:
+    void Init() { m_attr = NULL; m_base = NULL; m_generation = 0; }
+
+    wxRichTextSharedAttr*       m_attr;
+    const wxRichTextSharedAttr* m_base;
+    unsigned                    m_generation;
 };
 
 /**
@@ -2922,7 +2992,7 @@ public:
     /**
         Sets the object's attributes.
     */
-    void SetAttributes(const wxRichTextAttr& attr) { m_attributes = attr; }
+    void SetAttributes(const wxRichTextAttr& attr) { m_attributes = attr; m_attributesGeneration++; }
 
     /**
         Returns the object's attributes.
@@ -2930,9 +3000,23 @@ public:
     const wxRichTextAttr& GetAttributes() const { return m_attributes; }
 
     /**
-        Returns the object's attributes.
+        Returns the object's attributes for modifying them in place.
+
+        This invalidates the cached attributes combined from them, so use the
+        const overload if the attributes are only read.
     */
-    wxRichTextAttr& GetAttributes() { return m_attributes; }
+    wxRichTextAttr& GetAttributes() { m_attributesGeneration++; return m_attributes; }
+
+    /**
+        Notifies the object that its attributes were modified in place, so
+        that the cached attributes combined from them are updated.
+
+        This is only needed if the reference returned by GetAttributes() is
+        kept and used for modifying the attributes later.
+
+        @since 3.1.3
+    */
+    void InvalidateCachedAttributes() { m_attributesGeneration++; }
 
     /**
         Returns the object's properties.
@@ -3093,8 +3177,16 @@ protected:
     // Attributes
     wxRichTextAttr          m_attributes;
 
+    // Changed whenever the attributes may be modified
+    unsigned                m_attributesGeneration;
+
+    // The cached attributes combined with those of the parents
+    mutable wxRichTextCombinedAttrCache m_combinedAttributes;
+
     // Properties
     wxRichTextProperties    m_properties;
+
+    friend class wxRichTextParagraph;
 };
 
 WX_DECLARE_LIST_WITH_DECL( wxRichTextObject, wxRichTextObjectList, class WXDLLIMPEXP_RICHTEXT );
@@ -3217,6 +3309,10 @@ public:
 
 protected:
     wxRichTextObjectList    m_children;
+
+    // Incremented whenever children are added or removed by the functions
+    // above, so that the derived classes can update any data depending on them.
+    unsigned                m_childrenGeneration;
 };
 
 /**
@@ -3751,7 +3847,7 @@ public:
         only affects the style currently being applied (for example, setting the default
         style to bold will cause subsequently inserted text to be bold).
     */
-    virtual void SetBasicStyle(const wxRichTextAttr& style) { m_attributes = style; }
+    virtual void SetBasicStyle(const wxRichTextAttr& style) { SetAttributes(style); }
 
     /**
         Returns the basic (overall) style.
@@ -3795,6 +3891,46 @@ public:
     */
     bool IsDirty() const { return m_invalidRange != wxRICHTEXT_NONE; }
 
+    /**
+        Returns @true if the layout of some paragraphs was only estimated.
+
+        @see wxRichTextDrawingContext::SetLayoutEstimationStart()
+
+        @since 3.1.3
+    */
+    bool HasEstimatedLayout() const { return m_hasEstimatedLayout; }
+
+    /**
+        Invalidates up to @a maxCount paragraphs, or all of them if it is -1,
+        starting from the first one whose layout was only estimated, so that
+        the next Layout() lays them out for real. Returns @false if there are
+        no such paragraphs.
+
+        @since 3.1.3
+    */
+    bool InvalidateEstimatedLayout(int maxCount);
+
+    /**
+        Invalidates the paragraphs intersecting the given rectangle whose
+        layout was only estimated. Returns @false if there are no such
+        paragraphs.
+
+        @since 3.1.3
+    */
+    bool InvalidateEstimatedLayout(const wxRect& rect);
+
+    /**
+        Lays out the paragraphs whose layout was only estimated, starting from
+        the first one, for at most @a maxMillis milliseconds. Unlike Layout(),
+        this moves the paragraphs following the ones laid out only once.
+        The buffer must have been laid out before calling this function and
+        @a rect and @a style should be the same as were passed to Layout().
+        Returns @true if there are more paragraphs with estimated layout.
+
+        @since 3.1.3
+    */
+    bool LayoutEstimatedParagraphs(wxDC& dc, wxRichTextDrawingContext& context, const wxRect& rect, int style, int maxMillis);
+
     /**
         Returns the wxRichTextFloatCollector of this object.
     */
@@ -3811,6 +3947,27 @@ public:
     bool GetFloatingObjects(wxRichTextObjectList& objects) const;
 
 protected:
+    /**
+        Returns the node of the child containing the given character position,
+        or an invalid node if there is none.
+    */
+    wxRichTextObjectList::compatibility_iterator GetChildNodeAtPosition(long pos) const;
+
+    /**
+        Returns the node of the first child whose bottom is at or below the
+        given y pixel position, or an invalid node if there is none.
+    */
+    wxRichTextObjectList::compatibility_iterator GetChildNodeAtYPosition(int y) const;
+
+    // Returns the index of the children nodes, rebuilding it if necessary.
+    // Notice that it is rebuilt entirely after adding or removing children,
+    // which is fine as UpdateRanges() visits all of them after it anyhow.
+    const wxVector<wxRichTextObjectList::compatibility_iterator>& GetChildrenIndex() const;
+
+    // Gives the paragraph an estimated layout at the top of the available
+    // space, using the given total height and number of lines laid out before.
+    void EstimateParagraphLayout(wxDC& dc, wxRichTextParagraph* para, const wxRect& availableSpace, int laidOutHeight, int laidOutLines);
+
     wxRichTextCtrl* m_ctrl;
     wxRichTextAttr  m_defaultAttributes;
 
@@ -3822,6 +3979,17 @@ protected:
 
     // The floating layout state
     wxRichTextFloatCollector* m_floatCollector;
+
+    // The children nodes in order, allowing to find the paragraphs by their
+    // position or y coordinate using binary search, and the generation of the
+    // children it was built for
+    mutable wxVector<wxRichTextObjectList::compatibility_iterator> m_childrenIndex;
+    mutable unsigned m_childrenIndexGeneration;
+
+    // Whether some paragraphs may only have an estimated layout and the
+    // position before which there are none of them
+    bool            m_hasEstimatedLayout;
+    long            m_estimatedLayoutStart;
 };
 
 /**
@@ -4618,6 +4786,25 @@ public:
     */
     wxRichTextAttr GetCombinedAttributes(bool includingBoxAttr = false) const;
 
+    /**
+        Returns the combined attributes of the base style and paragraph style,
+        excluding the box attributes, as GetCombinedAttributes() does, but only
+        combines them again if any of these styles changed.
+
+        @since 3.1.3
+    */
+    const wxRichTextAttr& GetCachedCombinedAttributes() const;
+
+    /**
+        Returns the combined attributes of the base style, paragraph style and
+        the style of the given child of this paragraph, excluding the box
+        attributes, as GetCombinedAttributes() does, but only combines them
+        again if any of these styles changed.
+
+        @since 3.1.3
+    */
+    const wxRichTextAttr& GetCachedCombinedAttributes(const wxRichTextObject* child) const;
+
     /**
         Returns the first position from pos that has a line break character.
     */
@@ -4653,6 +4840,23 @@ public:
     */
     void SetImpactedByFloatingObjects(int i) { m_impactedByFloatingObjects = i; }
 
+    /**
+        Gives the paragraph an estimated layout of the given size at the given
+        position, without measuring its contents. The paragraph then consists
+        of a single line and is laid out for real by the next Layout() call
+        affecting it.
+
+        @since 3.1.3
+    */
+    void EstimateLayout(const wxPoint& pos, const wxSize& size);
+
+    /**
+        Returns @true if the paragraph only has an estimated layout.
+
+        @since 3.1.3
+    */
+    bool IsLayoutEstimated() const { return m_layoutEstimated; }
+
 protected:
 
     // The lines that make up the wrapped paragraph
@@ -4661,6 +4865,9 @@ protected:
     // Whether the paragraph is impacted by floating objects from above
     int                 m_impactedByFloatingObjects;
 
+    // Whether the layout of the paragraph is only estimated
+    bool                m_layoutEstimated;
+
     // Default tabstops
     static wxArrayInt  sm_defaultTabs;
 
@@ -5888,6 +6095,9 @@ protected:
     /// Flags to be passed to handlers
     int                     m_handlerFlags;
 
+    /// The combined attributes shared by the objects in this buffer, if any
+    wxRichTextSharedAttrPool* m_sharedAttrPool;
+
     /// File handlers
     static wxList           sm_handlers;
 
@@ -5917,6 +6127,8 @@ protected:
 
     /// Dimension scale for reducing redundant whitespace when editing
     double                  m_dimensionScale;
+
+    friend class wxRichTextParagraph;
 };
 
 /**
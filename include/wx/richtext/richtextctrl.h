@@ -81,6 +81,8 @@ class WXDLLIMPEXP_FWD_RICHTEXT wxRichTextStyleDefinition;
 #define wxRICHTEXT_DEFAULT_LAYOUT_INTERVAL 50
 // Milliseconds before delayed image processing occurs
 #define wxRICHTEXT_DEFAULT_DELAYED_IMAGE_PROCESSING_INTERVAL 200
+// Milliseconds spent on background layout in each idle event
+#define wxRICHTEXT_DEFAULT_BACKGROUND_LAYOUT_DURATION 20
 
 /* Identifiers
  */
@@ -391,6 +393,28 @@ public:
     */
     void ForceDelayedLayout();
 
+    /**
+        Enables or disables background layout.
+
+        If enabled, only the visible part of a buffer bigger than the delayed
+        layout threshold is laid out immediately, while the height of the
+        paragraphs below it is estimated and they are laid out later in idle
+        time. This makes showing big documents much faster. Background layout
+        is disabled by default.
+
+        @see SetDelayedLayoutThreshold()
+
+        @since 3.1.3
+    */
+    void EnableBackgroundLayout(bool b = true) { m_enableBackgroundLayout = b; }
+
+    /**
+        Returns @true if background layout is enabled.
+
+        @since 3.1.3
+    */
+    bool GetBackgroundLayoutEnabled() const { return m_enableBackgroundLayout; }
+
     /**
         Sets the text (normal) cursor.
     */
@@ -1423,6 +1447,18 @@ public:
     */
     virtual void DoLayoutBuffer(wxRichTextBuffer& buffer, wxDC& dc, wxRichTextDrawingContext& context, const wxRect& rect, const wxRect& parentRect, int flags);
 
+    /**
+        Sets up the drawing context to only estimate the layout of the
+        paragraphs below the visible area if background layout is enabled.
+    */
+    void SetupLayoutEstimation(wxRichTextDrawingContext& context);
+
+    /**
+        Lays out some of the paragraphs whose layout was only estimated.
+        Returns @true if there are more of them.
+    */
+    bool DoBackgroundLayout();
+
     /**
         Move the caret to the given character position.
 
@@ -2390,6 +2426,10 @@ protected:
     /// Threshold for doing delayed layout
     long                    m_delayedLayoutThreshold;
 
+    /// Do we lay out the invisible part of the buffer in idle time?
+    bool                    m_enableBackgroundLayout;
+    wxLongLong              m_backgroundLayoutTime;
+
     /// Cursors
     wxCursor                m_textCursor;
     wxCursor                m_urlCursor;
@@ -5178,6 +5178,20 @@ public:
     // Returns the current UseAntiAliasing setting.
     bool GetUseAntiAliasing();
 
+    // Perform the styling which would be done in idle time, see
+    // SetIdleStyling(), in a background thread instead.
+    void EnableBackgroundLexing(bool enable = true);
+
+    // Returns true if background lexing is enabled.
+    bool IsBackgroundLexingEnabled() const;
+
+    // Load the file in a background thread, wxEVT_STC_FILE_LOADED is
+    // generated when it's done.
+    bool LoadFileInBackground(const wxString& filename);
+
+    // Returns true if a file is being loaded by LoadFileInBackground().
+    bool IsLoadingFile() const;
+
     // Clear annotations from the given line.
     void AnnotationClearLine(int line);
 
@@ -5645,6 +5659,7 @@ wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_STC, wxEVT_STC_CLIPBOARD_COPY, wxStyledTex
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_STC, wxEVT_STC_CLIPBOARD_PASTE, wxStyledTextEvent );
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_STC, wxEVT_STC_AUTOCOMP_COMPLETED, wxStyledTextEvent );
 wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_STC, wxEVT_STC_MARGIN_RIGHT_CLICK, wxStyledTextEvent );
+wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_STC, wxEVT_STC_FILE_LOADED, wxStyledTextEvent );
 
 #else
     enum {
@@ -5686,7 +5701,8 @@ wxDECLARE_EXPORTED_EVENT( WXDLLIMPEXP_STC, wxEVT_STC_MARGIN_RIGHT_CLICK, wxStyle
         wxEVT_STC_CLIPBOARD_COPY,
         wxEVT_STC_CLIPBOARD_PASTE,
         wxEVT_STC_AUTOCOMP_COMPLETED,
-        wxEVT_STC_MARGIN_RIGHT_CLICK
+        wxEVT_STC_MARGIN_RIGHT_CLICK,
+        wxEVT_STC_FILE_LOADED
     };
 #endif
 
@@ -5733,6 +5749,7 @@ typedef void (wxEvtHandler::*wxStyledTextEventFunction)(wxStyledTextEvent&);
 #define EVT_STC_CLIPBOARD_PASTE(id, fn)       wxDECLARE_EVENT_TABLE_ENTRY( wxEVT_STC_CLIPBOARD_PASTE,       id, wxID_ANY, wxStyledTextEventHandler( fn ), (wxObject *) NULL ),
 #define EVT_STC_AUTOCOMP_COMPLETED(id, fn)    wxDECLARE_EVENT_TABLE_ENTRY( wxEVT_STC_AUTOCOMP_COMPLETED,    id, wxID_ANY, wxStyledTextEventHandler( fn ), (wxObject *) NULL ),
 #define EVT_STC_MARGIN_RIGHT_CLICK(id, fn)    wxDECLARE_EVENT_TABLE_ENTRY( wxEVT_STC_MARGIN_RIGHT_CLICK,    id, wxID_ANY, wxStyledTextEventHandler( fn ), (wxObject *) NULL ),
+#define EVT_STC_FILE_LOADED(id, fn)           wxDECLARE_EVENT_TABLE_ENTRY( wxEVT_STC_FILE_LOADED,           id, wxID_ANY, wxStyledTextEventHandler( fn ), (wxObject *) NULL ),
 
 #endif
 
@@ -132,6 +132,8 @@ static const int wxTREE_ITEMSTATE_PREV  = -3;   // cycle to the previous state
 #define wxTR_EDIT_LABELS             0x0200     // can edit item labels
 #define wxTR_ROW_LINES               0x0400     // put border around items
 #define wxTR_HIDE_ROOT               0x0800     // don't display root node
+#define wxTR_VIRTUAL                 0x1000     // items are provided by the
+                                                // program (generic only)
 
 #define wxTR_FULL_ROW_HIGHLIGHT      0x2000     // highlight full horz space
 
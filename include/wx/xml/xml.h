@@ -303,6 +303,11 @@ public:
     virtual bool Save(const wxString& filename, int indentstep = 2) const;
     virtual bool Save(wxOutputStream& stream, int indentstep = 2) const;
 
+    // Called by Load() for every element node as soon as it and all its
+    // children are loaded. Returning true deletes the node instead of keeping
+    // it in the document.
+    virtual bool OnElementLoaded(wxXmlNode *WXUNUSED(node)) { return false; }
+
     bool IsOk() const { return GetRoot() != NULL; }
 
     // Returns root node of the document.
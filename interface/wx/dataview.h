@@ -227,6 +227,26 @@ public:
     virtual bool IsEnabled(const wxDataViewItem &item,
                            unsigned int col) const;
 
+    /**
+        Override this to indicate that the values of the item are not
+        available yet.
+
+        This is useful for the models retrieving their data asynchronously,
+        e.g. from a database, in response to @c wxEVT_DATAVIEW_PREFETCH_HINT
+        events. A placeholder is shown instead of the values of the items for
+        which this function returns @false and GetValue() is not called for
+        them. ItemChanged() must be called when the item values become
+        available to show them.
+
+        The base class version always returns @true.
+
+        @note Currently this is only supported by the generic version of
+              wxDataViewCtrl, the native ones always show all the values.
+
+        @since 3.1.3
+    */
+    virtual bool IsItemLoaded(const wxDataViewItem &item) const;
+
     /**
         Override this so the control can query the child items of an item.
         Returns the number of items.
@@ -489,6 +509,17 @@ public:
     virtual bool IsEnabledByRow(unsigned int row,
                                 unsigned int col) const;
 
+    /**
+        Override this to indicate that the values in the given row are not
+        available yet.
+
+        This is the same as wxDataViewModel::IsItemLoaded(), but in a
+        row-based context.
+
+        @since 3.1.3
+    */
+    virtual bool IsItemLoadedByRow(unsigned int row) const;
+
     /**
         Returns the number of items (or rows) in the list.
     */
@@ -867,6 +898,7 @@ wxEventType wxEVT_DATAVIEW_COLUMN_HEADER_RIGHT_CLICK;
 wxEventType wxEVT_DATAVIEW_COLUMN_SORTED;
 wxEventType wxEVT_DATAVIEW_COLUMN_REORDERED;
 wxEventType wxEVT_DATAVIEW_CACHE_HINT;
+wxEventType wxEVT_DATAVIEW_PREFETCH_HINT;
 
 wxEventType wxEVT_DATAVIEW_ITEM_BEGIN_DRAG;
 wxEventType wxEVT_DATAVIEW_ITEM_DROP_POSSIBLE;
@@ -978,6 +1010,11 @@ wxEventType wxEVT_DATAVIEW_ITEM_DROP;
            Process a @c wxEVT_DATAVIEW_ITEM_DROP_POSSIBLE event.
     @event{EVT_DATAVIEW_ITEM_DROP(id, func)}
            Process a @c wxEVT_DATAVIEW_ITEM_DROP event.
+    @event{EVT_DATAVIEW_PREFETCH_HINT(id, func)}
+           Process a @c wxEVT_DATAVIEW_PREFETCH_HINT event generated when the
+           rows likely to be shown next change, see SetPrefetchLookAhead().
+           This event is only generated by the generic version of the
+           control (new since wxWidgets 3.1.3).
     @endEventTable
 
     Notice that this control doesn't allow to process generic mouse events such
@@ -1691,6 +1728,37 @@ public:
     */
     virtual bool SetRowHeight(int rowHeight);
 
+    /**
+        Sets the number of rows for which the prefetch hints are sent.
+
+        If @a count is positive, @c wxEVT_DATAVIEW_PREFETCH_HINT events are
+        generated after the control is scrolled with the range of the rows
+        which are likely to be shown next, i.e. @a count rows following the
+        visible ones when scrolling down or preceding them when scrolling up.
+        The model can use these hints to start retrieving these rows in
+        background and return @false from wxDataViewModel::IsItemLoaded() for
+        them until they are available. Setting @a count to 0, which is the
+        default, disables prefetch hints.
+
+        Currently this is only implemented in the generic version.
+
+        @return @true if prefetch hints are supported, @false otherwise.
+
+        @see GetPrefetchLookAhead()
+
+        @since 3.1.3
+    */
+    virtual bool SetPrefetchLookAhead(int count);
+
+    /**
+        Returns the number of rows for which the prefetch hints are sent.
+
+        @see SetPrefetchLookAhead()
+
+        @since 3.1.3
+    */
+    virtual int GetPrefetchLookAhead() const;
+
     /**
         Toggle sorting by the given column.
 
@@ -3721,6 +3789,8 @@ public:
            Process a @c wxEVT_DATAVIEW_ITEM_DROP event.
     @event{EVT_DATAVIEW_CACHE_HINT(id, func)}
            Process a @c wxEVT_DATAVIEW_CACHE_HINT event.
+    @event{EVT_DATAVIEW_PREFETCH_HINT(id, func)}
+           Process a @c wxEVT_DATAVIEW_PREFETCH_HINT event.
     @endEventTable
 
     @library{wxcore}
@@ -3882,14 +3952,33 @@ public:
 
     /**
         Return the first row that will be displayed.
+
+        For @c wxEVT_DATAVIEW_PREFETCH_HINT events, return the first row that
+        is likely to be displayed soon.
     */
     int GetCacheFrom() const;
 
     /**
         Return the last row that will be displayed.
+
+        For @c wxEVT_DATAVIEW_PREFETCH_HINT events, return the last row that
+        is likely to be displayed soon.
     */
     int GetCacheTo() const;
 
+    /**
+        Return the direction in which the control is being scrolled.
+
+        For @c wxEVT_DATAVIEW_PREFETCH_HINT events only: returns 1 if the
+        control is scrolled down, -1 if it is scrolled up or 0 if the direction
+        is unknown, e.g. when the control is shown for the first time, in
+        which case the rows on both sides of the visible ones are included in
+        the range to prefetch.
+
+        @since 3.1.3
+    */
+    int GetPrefetchDirection() const;
+
 
     /**
         Returns the item affected by the event.
@@ -3903,6 +3992,7 @@ public:
     void SetItem( const wxDataViewItem &item );
     void SetPosition( int x, int y );
     void SetCache(int from, int to);
+    void SetPrefetchDirection(int direction);
     wxDataObject *GetDataObject() const;
     void SetDataFormat( const wxDataFormat &format );
     void SetDataSize( size_t size );
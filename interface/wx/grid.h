@@ -3264,6 +3264,55 @@ public:
     */
     void AutoSizeRows(bool setAsMin = true);
 
+    /**
+        Limits the work done by the auto-sizing functions for big grids.
+
+        By default, all cells of a column or row are measured when
+        auto-sizing it, which can take a long time for grids with many rows
+        or columns. If @a sampleSize is positive, only this many cells are
+        measured for each column or row instead: the currently visible cells,
+        the first and last ones, the ones with the longest values and an
+        evenly spread sample of the others.
+
+        If @a timeLimit is positive, measuring any single column or row stops
+        after this many milliseconds, even if not all cells have been
+        measured yet.
+
+        Using either of these options means that some cells may not fit
+        entirely after auto-sizing.
+
+        @param sampleSize
+            The maximal number of cells to measure per column or row, or 0
+            to measure all of them (default).
+        @param timeLimit
+            The maximal time to spend measuring a column or row, in
+            milliseconds, or 0 for no limit (default).
+
+        @see GetAutoSizeSampleSize(), GetAutoSizeTimeLimit()
+
+        @since 3.1.3
+    */
+    void SetAutoSizeSampling(int sampleSize, long timeLimit = 0);
+
+    /**
+        Returns the number of cells measured per column or row when
+        auto-sizing.
+
+        @see SetAutoSizeSampling()
+
+        @since 3.1.3
+    */
+    int GetAutoSizeSampleSize() const;
+
+    /**
+        Returns the time limit for auto-sizing a column or row.
+
+        @see SetAutoSizeSampling()
+
+        @since 3.1.3
+    */
+    long GetAutoSizeTimeLimit() const;
+
     /**
         Returns @true if the cell value can overflow.
 
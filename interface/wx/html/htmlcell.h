@@ -526,6 +526,31 @@ public:
     */
     void InsertCell(wxHtmlCell* cell);
 
+    /**
+        Lays out the container only partially.
+
+        This function works like Layout() but only lays out the child cells
+        located above the given vertical position and uses estimated sizes for
+        all the other ones, which makes it much faster for the containers with
+        a lot of contents, e.g. the top level container of a long document.
+
+        It can be called repeatedly with increasing values of @a yMax to lay
+        out more and more of the container contents until it returns @true.
+        Calling Layout() completes the layout at once.
+
+        @param w
+            The available width, as for Layout().
+        @param yMax
+            The position, relative to the top of this container, until which
+            the child cells should be laid out.
+        @return
+            @true if the layout is complete or @false if some cells have not
+            been laid out yet.
+
+        @since 3.1.3
+     */
+    bool LayoutPartially(int w, int yMax);
+
     /**
         Sets the container's alignment (both horizontal and vertical) according to
         the values stored in @e tag. (Tags @c ALIGN parameter is extracted.)
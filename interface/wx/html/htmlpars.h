@@ -248,6 +248,108 @@ public:
     */
     wxObject* Parse(const wxString& source);
 
+    /**
+        Parses the document read from the given stream.
+
+        The document is read and parsed in chunks, see ParseChunk(), but the
+        result is the same as if it were read entirely and passed to the
+        overload above.
+
+        @param stream
+            The stream to read the document from.
+        @param conv
+            The conversion used to translate the stream contents to text. Only
+            ASCII-compatible encodings, such as UTF-8 or ISO-8859-x, are
+            supported.
+        @return The product of parsing or @NULL if the stream contents
+            couldn't be converted using @a conv.
+
+        @since 3.1.3
+    */
+    wxObject* Parse(wxInputStream& stream, const wxMBConv& conv = wxConvUTF8);
+
+    /**
+        Starts streaming parsing.
+
+        Streaming parsing allows to pass the document to the parser in parts,
+        e.g. as they are being received, instead of all at once: after calling
+        this function, call ParseChunk() for every part of the document and
+        EndStreaming() at the end of it.
+
+        @since 3.1.3
+    */
+    void BeginStreaming();
+
+    /**
+        Parses the next part of the document during streaming parsing.
+
+        The chunk can be of arbitrary size and doesn't need to end at the tag
+        boundary. All the parts of the document received so far which can't
+        be affected by its remaining parts are parsed immediately, so the
+        product of parsing being built can already be used, e.g. shown to the
+        user, before the rest of the document is available.
+
+        The document is parsed up to the last point where all the elements
+        are closed, except for the elements containing the entire document,
+        such as @c \<body\>, and those whose end tags are often omitted,
+        such as @c \<p\> or @c \<li\>, as their standard handlers don't
+        depend on their end. Elements such as @c \<td\> are implicitly
+        closed by the end tag of the element containing them. Anything
+        following any other element which is not closed is only parsed when
+        EndStreaming() is called.
+
+        @since 3.1.3
+    */
+    void ParseChunk(const wxString& chunk);
+
+    /**
+        Reads the next part of the document from the stream and parses it.
+
+        This is a convenient wrapper for the overload above. Only
+        ASCII-compatible encodings, such as UTF-8 or ISO-8859-x, are supported
+        by this function.
+
+        @return @false if the end of the stream was reached or if its
+            contents couldn't be converted using @a conv. In the latter case,
+            an error is logged and HasStreamingError() returns @true.
+
+        @since 3.1.3
+    */
+    bool ParseChunk(wxInputStream& stream, const wxMBConv& conv = wxConvUTF8);
+
+    /**
+        Returns @true if the stream passed to ParseChunk() couldn't be
+        converted to text.
+
+        The parts of the document before the conversion error are still
+        parsed, but nothing after it is.
+
+        This function can only be used during streaming parsing, i.e. before
+        calling EndStreaming().
+
+        @since 3.1.3
+    */
+    bool HasStreamingError() const;
+
+    /**
+        Finishes streaming parsing.
+
+        Parses the remaining part of the document and returns the product of
+        parsing, see GetProduct(). After this function returns, GetSource()
+        returns the entire document, as if it were passed to Parse().
+
+        @since 3.1.3
+    */
+    wxObject* EndStreaming();
+
+    /**
+        Returns @true if streaming parsing is in progress, i.e. between the
+        calls to BeginStreaming() and EndStreaming().
+
+        @since 3.1.3
+    */
+    bool IsStreaming() const;
+
     /**
         Restores parser's state before last call to PushTagHandler().
     */
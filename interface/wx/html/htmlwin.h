@@ -194,6 +194,37 @@ public:
     */
     bool AppendToPage(const wxString& source);
 
+    /**
+        Lays out the rest of the page immediately.
+
+        This function only does something if incremental layout is enabled and
+        the page has not been completely laid out yet. It can be useful to call
+        it before examining the positions of the cells returned by
+        GetInternalRepresentation().
+
+        @see EnableIncrementalLayout()
+
+        @since 3.1.3
+    */
+    void CompleteLayout();
+
+    /**
+        Enables or disables incremental layout of the pages.
+
+        When it is enabled, only the part of the page which is visible in the
+        window is laid out immediately when the page is loaded or the window
+        is resized and the rest of it is laid out in idle time, using the
+        estimated size for it until then. This makes showing and resizing very
+        long pages much faster.
+
+        Incremental layout is disabled by default.
+
+        @see IsIncrementalLayoutEnabled(), CompleteLayout()
+
+        @since 3.1.3
+    */
+    void EnableIncrementalLayout(bool enable = true);
+
     /**
         Returns pointer to the top-level container.
 
@@ -260,6 +291,15 @@ public:
     */
     bool HistoryForward();
 
+    /**
+        Returns @true if incremental layout is enabled.
+
+        @see EnableIncrementalLayout()
+
+        @since 3.1.3
+    */
+    bool IsIncrementalLayoutEnabled() const;
+
     /**
         Loads an HTML page from a file and displays it.
 
@@ -269,6 +309,28 @@ public:
     */
     bool LoadFile(const wxFileName& filename);
 
+    /**
+        Loads an HTML page from the given stream and displays it.
+
+        Unlike SetPage(), this function shows the beginning of the page as
+        soon as it has been parsed and fills the window, before the rest of
+        the page is read from the stream and parsed.
+
+        @param stream
+            The stream to read the page from.
+        @param conv
+            The conversion used to translate the stream contents to text. Only
+            ASCII-compatible encodings, such as UTF-8 or ISO-8859-x, are
+            supported.
+
+        @return @false if an error occurred, e.g. the stream contents couldn't
+            be converted using @a conv, @true otherwise. In case of
+            conversion error, the part of the page before it is still shown.
+
+        @since 3.1.3
+    */
+    bool LoadStream(wxInputStream& stream, const wxMBConv& conv = wxConvUTF8);
+
     /**
         Unlike SetPage() this function first loads the HTML page from @a location
         and then displays it.
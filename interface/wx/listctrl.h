@@ -255,6 +255,11 @@ enum
     @event{EVT_LIST_CACHE_HINT(id, func)}
            Prepare cache for a virtual list control.
            Processes a @c wxEVT_LIST_CACHE_HINT event type.
+    @event{EVT_LIST_PREFETCH_HINT(id, func)}
+           Start retrieving the items likely to be shown soon in a virtual
+           list control, see SetPrefetchLookAhead().
+           Processes a @c wxEVT_LIST_PREFETCH_HINT event type (new since
+           wxWidgets 3.1.3, only generated by the generic version).
     @event{EVT_LIST_ITEM_CHECKED(id, func)}
            The item has been checked.
            Processes a @c wxEVT_LIST_ITEM_CHECKED event type (new since wxWidgets 3.1.0).
@@ -1256,6 +1261,55 @@ public:
     */
     bool SortItems(wxListCtrlCompare fnSortCallBack, wxIntPtr data);
 
+    /**
+        Sort the items in the list control using their keys.
+
+        Unlike SortItems(), which calls the comparison function many times for
+        each item, this function calls @a fnKey only once for every item to
+        get its key and then sorts the items by comparing their keys, which is
+        much faster for big controls. The keys are compared as strings, using
+        wxString::compare(), or as numbers, depending on the type of the key
+        function.
+
+        The parameters of @a fnKey are the client data associated with the
+        item and the @a data value passed to this function itself. It is
+        always called from the main thread, but the sorting itself may use
+        several threads for controls with many items.
+
+        The sort is stable, i.e. the items with equal keys preserve their
+        relative order, so it can be used to sort the items by several columns
+        by sorting them by each of the columns in turn, starting from the
+        least significant one.
+
+        This function can't be used with @c wxLC_VIRTUAL controls and is
+        currently only implemented in the generic version of the control.
+
+        @param fnKey
+            The function returning the key of the given item.
+        @param data
+            Arbitrary value passed to @a fnKey.
+        @param ascending
+            Sort in ascending order if @true, descending otherwise.
+        @return @true if the items were sorted or @false if this function is
+            not supported.
+
+        @since 3.1.3
+    */
+    bool SortItemsByKey(wxListCtrlStringKey fnKey, wxIntPtr data,
+                        bool ascending = true);
+
+    /**
+        Sort the items in the list control using their numeric keys.
+
+        This overload is the same as the one above, but the items are sorted
+        using the numbers returned by @a fnKey. The items with NaN keys are
+        put after all the other ones, in both ascending and descending order.
+
+        @since 3.1.3
+    */
+    bool SortItemsByKey(wxListCtrlNumericKey fnKey, wxIntPtr data,
+                        bool ascending = true);
+
     /**
         Returns true if checkboxes are enabled for list items.
 
@@ -1299,6 +1353,68 @@ public:
     */
     void CheckItem(long item, bool check);
 
+    /**
+        Returns true if the items of the control can have different heights.
+
+        @see EnableVariableItemHeight()
+
+        @since 3.1.3
+    */
+    bool HasVariableItemHeight() const;
+
+    /**
+        Enable or disable support for items of different heights.
+
+        When this is enabled, OnGetItemHeight() is called to determine the
+        height of each item and the text of the items may span several lines.
+
+        This is currently only supported by the generic implementation and
+        only for the controls with both @c wxLC_VIRTUAL and @c wxLC_REPORT
+        styles. The heights of the items are retrieved when the number of
+        items changes and only updated later for the items passed to
+        RefreshItem() or RefreshItems(), so these functions must be called if
+        the height of an existing item changes.
+
+        @param enable If @true, enable variable item heights, otherwise use
+            the same height for all items.
+        @return @true if variable item heights are supported, @false otherwise.
+
+        @since 3.1.3
+    */
+    bool EnableVariableItemHeight(bool enable = true);
+
+    /**
+        Sets the number of items for which the prefetch hints are sent.
+
+        If @a count is positive, @c wxEVT_LIST_PREFETCH_HINT events are
+        generated after a virtual control is scrolled with the range of the
+        items which are likely to be shown next, i.e. @a count items following
+        the visible ones when scrolling down or preceding them when scrolling
+        up. The application can use these hints to start retrieving these
+        items in background and return @false from OnGetItemIsLoaded() for
+        them until they are available. Setting @a count to 0, which is the
+        default, disables prefetch hints.
+
+        This is currently only supported by the generic implementation and
+        only for the controls with @c wxLC_VIRTUAL style.
+
+        @return @true if prefetch hints are supported, @false otherwise.
+
+        @see GetPrefetchLookAhead()
+
+        @since 3.1.3
+    */
+    bool SetPrefetchLookAhead(int count);
+
+    /**
+        Returns the number of items for which the prefetch hints are sent.
+
+        @see SetPrefetchLookAhead()
+
+        @since 3.1.3
+    */
+    int GetPrefetchLookAhead() const;
+
 protected:
 
     /**
@@ -1362,6 +1478,35 @@ protected:
     */
     virtual int OnGetItemImage(long item) const;
 
+    /**
+        This function may be overridden in the derived class for a control
+        with @c wxLC_VIRTUAL style for which EnableVariableItemHeight() had
+        been called. It should return the height of the given @a item, in
+        pixels, or -1 to use the default height.
+
+        The base class version always returns -1.
+
+        @since 3.1.3
+    */
+    virtual int OnGetItemHeight(long item) const;
+
+    /**
+        This function may be overridden in the derived class for a control
+        with @c wxLC_VIRTUAL style to indicate that the data of the given
+        @a item is not available yet.
+
+        A placeholder is shown for the items for which it returns @false and
+        the other @c OnGetItemXXX() functions are not called for them. When the
+        data becomes available, RefreshItem() or RefreshItems() must be called
+        to show it. This is typically used together with prefetch hints, see
+        SetPrefetchLookAhead().
+
+        The base class version always returns @true.
+
+        @since 3.1.3
+    */
+    virtual bool OnGetItemIsLoaded(long item) const;
+
     /**
         This function @b must be overridden in the derived class for a control with
         @c wxLC_VIRTUAL style. It should return the string containing the text of
@@ -1421,6 +1566,9 @@ protected:
         A column has been resized by the user.
     @event{EVT_LIST_CACHE_HINT(id, func)}
         Prepare cache for a virtual list control
+    @event{EVT_LIST_PREFETCH_HINT(id, func)}
+        Start retrieving the items likely to be shown soon in a virtual list
+        control (new since wxWidgets 3.1.3).
     @event{EVT_LIST_ITEM_CHECKED(id, func)}
         The item has been checked (new since wxWidgets 3.1.0).
     @event{EVT_LIST_ITEM_UNCHECKED(id, func)}
@@ -1444,15 +1592,34 @@ public:
     /**
         For @c EVT_LIST_CACHE_HINT event only: return the first item which the
         list control advises us to cache.
+
+        For @c EVT_LIST_PREFETCH_HINT event, return the first item which is
+        likely to be shown soon.
     */
     long GetCacheFrom() const;
 
     /**
         For @c EVT_LIST_CACHE_HINT event only: return the last item (inclusive)
         which the list control advises us to cache.
+
+        For @c EVT_LIST_PREFETCH_HINT event, return the last item (inclusive)
+        which is likely to be shown soon.
     */
     long GetCacheTo() const;
 
+    /**
+        For @c EVT_LIST_PREFETCH_HINT event only: return the direction in which
+        the control is being scrolled.
+
+        Returns 1 if the control is scrolled down, -1 if it is scrolled up or
+        0 if the direction is unknown, e.g. when the control is shown for the
+        first time, in which case the items on both sides of the visible ones
+        are included in the range to prefetch.
+
+        @since 3.1.3
+    */
+    int GetPrefetchDirection() const;
+
     /**
         The column position: it is only used with @c COL events.
 
@@ -1553,6 +1720,11 @@ public:
     */
     void SetCacheTo(long cacheTo);
 
+    /**
+       @see GetPrefetchDirection()
+    */
+    void SetPrefetchDirection(int direction);
+
 };
 
 
@@ -1571,6 +1743,7 @@ wxEventType wxEVT_LIST_ITEM_RIGHT_CLICK;
 wxEventType wxEVT_LIST_ITEM_MIDDLE_CLICK;
 wxEventType wxEVT_LIST_ITEM_ACTIVATED;
 wxEventType wxEVT_LIST_CACHE_HINT;
+wxEventType wxEVT_LIST_PREFETCH_HINT;
 wxEventType wxEVT_LIST_COL_RIGHT_CLICK;
 wxEventType wxEVT_LIST_COL_BEGIN_DRAG;
 wxEventType wxEVT_LIST_COL_DRAGGING;
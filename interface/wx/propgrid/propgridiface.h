@@ -167,6 +167,24 @@ public:
     */
     void BeginAddChildren( wxPGPropArg id );
 
+    /**
+        Begins adding many properties at once.
+
+        Until the matching EndBulkLoad() call, adding properties doesn't
+        update the values of the properties composed from the values of their
+        children and doesn't refresh the grid: this is done only once, for all
+        the added properties, at the end, which is much faster than doing it
+        after adding each of them when populating big grids.
+
+        Calls to this function may be nested, the grid is updated when the
+        outermost EndBulkLoad() is called.
+
+        @see EndBulkLoad()
+
+        @since 3.1.3
+    */
+    void BeginBulkLoad();
+
     /**
         Deletes all properties.
 
@@ -289,6 +307,15 @@ public:
     */
     void EndAddChildren( wxPGPropArg id );
 
+    /**
+        Ends adding properties started by BeginBulkLoad().
+
+        @see BeginBulkLoad()
+
+        @since 3.1.3
+    */
+    void EndBulkLoad();
+
     /**
         Expands given category or property with children.
 
@@ -325,6 +325,19 @@ public:
     */
     virtual ~wxPropertyGridPageState();
 
+    /**
+        Begins adding many properties at once.
+
+        Until the matching EndBulkLoad() call, adding properties doesn't
+        update the names dictionary nor the values of the properties composed
+        from the values of their children, this is done only once at the end.
+
+        @see wxPropertyGridInterface::BeginBulkLoad()
+
+        @since 3.1.3
+    */
+    void BeginBulkLoad();
+
     /**
         Makes sure all columns have minimum width.
     */
@@ -358,6 +371,13 @@ public:
 
     bool EnableCategories( bool enable );
 
+    /**
+        Ends adding properties started by BeginBulkLoad().
+
+        @since 3.1.3
+    */
+    void EndBulkLoad();
+
     /**
         Make sure virtual height is up-to-date.
     */
@@ -457,6 +477,13 @@ public:
     */
     inline bool IsDisplayed() const;
 
+    /**
+        Returns @true if between BeginBulkLoad() and EndBulkLoad() calls.
+
+        @since 3.1.3
+    */
+    bool IsInBulkLoad() const;
+
     bool IsInNonCatMode() const;
 
     void DoLimitPropertyEditing( wxPGProperty* p, bool limit = true );
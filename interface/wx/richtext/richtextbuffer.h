@@ -2331,11 +2331,33 @@ public:
 
     bool GetDelayedImageLoading() const { return m_enableDelayedImageLoading; }
 
+    /**
+        Sets the y position below which the paragraphs which haven't been laid
+        out yet only get an estimated layout, or wxDefaultCoord to lay out all
+        of them.
+
+        @see wxRichTextParagraph::EstimateLayout()
+
+        @since 3.1.3
+    */
+
+    void SetLayoutEstimationStart(int y) { m_layoutEstimationStart = y; }
+
+    /**
+        Returns the y position below which the layout is only estimated, or
+        wxDefaultCoord.
+
+        @since 3.1.3
+    */
+
+    int GetLayoutEstimationStart() const { return m_layoutEstimationStart; }
+
     wxRichTextBuffer*   m_buffer;
     bool                m_enableVirtualAttributes;
     bool                m_enableImages;
     bool                m_enableDelayedImageLoading;
     bool                m_layingOut;
+    int                 m_layoutEstimationStart;
 };
 
 /**
@@ -2758,10 +2780,26 @@ public:
     const wxRichTextAttr& GetAttributes() const;
 
     /**
-        Returns the object's attributes.
+        Returns the object's attributes for modifying them in place.
+
+        This invalidates the cached attributes combined from them, so use the
+        const overload if the attributes are only read.
     */
     wxRichTextAttr& GetAttributes();
 
+    /**
+        Notifies the object that its attributes were modified in place, so
+        that the cached attributes combined from them are updated.
+
+        This is only needed if the reference returned by GetAttributes() is
+        kept and used for modifying the attributes later.
+
+        @see wxRichTextParagraph::GetCachedCombinedAttributes()
+
+        @since 3.1.3
+    */
+    void InvalidateCachedAttributes();
+
     /**
         Returns the object's properties.
     */
@@ -3630,6 +3668,46 @@ public:
     */
     bool IsDirty() const { return m_invalidRange != wxRICHTEXT_NONE; }
 
+    /**
+        Returns @true if the layout of some paragraphs was only estimated.
+
+        @see wxRichTextDrawingContext::SetLayoutEstimationStart()
+
+        @since 3.1.3
+    */
+    bool HasEstimatedLayout() const { return m_hasEstimatedLayout; }
+
+    /**
+        Invalidates up to @a maxCount paragraphs, or all of them if it is -1,
+        starting from the first one whose layout was only estimated, so that
+        the next Layout() lays them out for real. Returns @false if there are
+        no such paragraphs.
+
+        @since 3.1.3
+    */
+    bool InvalidateEstimatedLayout(int maxCount);
+
+    /**
+        Invalidates the paragraphs intersecting the given rectangle whose
+        layout was only estimated. Returns @false if there are no such
+        paragraphs.
+
+        @since 3.1.3
+    */
+    bool InvalidateEstimatedLayout(const wxRect& rect);
+
+    /**
+        Lays out the paragraphs whose layout was only estimated, starting from
+        the first one, for at most @a maxMillis milliseconds. Unlike Layout(),
+        this moves the paragraphs following the ones laid out only once.
+        The buffer must have been laid out before calling this function and
+        @a rect and @a style should be the same as were passed to Layout().
+        Returns @true if there are more paragraphs with estimated layout.
+
+        @since 3.1.3
+    */
+    bool LayoutEstimatedParagraphs(wxDC& dc, wxRichTextDrawingContext& context, const wxRect& rect, int style, int maxMillis);
+
     /**
         Returns the wxRichTextFloatCollector of this object.
     */
@@ -4444,6 +4522,25 @@ public:
     */
     wxRichTextAttr GetCombinedAttributes(bool includingBoxAttr = false) const;
 
+    /**
+        Returns the combined attributes of the base style and paragraph style,
+        excluding the box attributes, as GetCombinedAttributes() does, but only
+        combines them again if any of these styles changed.
+
+        @since 3.1.3
+    */
+    const wxRichTextAttr& GetCachedCombinedAttributes() const;
+
+    /**
+        Returns the combined attributes of the base style, paragraph style and
+        the style of the given child of this paragraph, excluding the box
+        attributes, as GetCombinedAttributes() does, but only combines them
+        again if any of these styles changed.
+
+        @since 3.1.3
+    */
+    const wxRichTextAttr& GetCachedCombinedAttributes(const wxRichTextObject* child) const;
+
     /**
         Returns the first position from pos that has a line break character.
     */
@@ -4479,6 +4576,23 @@ public:
     */
     void SetImpactedByFloatingObjects(int i) { m_impactedByFloatingObjects = i; }
 
+    /**
+        Gives the paragraph an estimated layout of the given size at the given
+        position, without measuring its contents. The paragraph then consists
+        of a single line and is laid out for real by the next Layout() call
+        affecting it.
+
+        @since 3.1.3
+    */
+    void EstimateLayout(const wxPoint& pos, const wxSize& size);
+
+    /**
+        Returns @true if the paragraph only has an estimated layout.
+
+        @since 3.1.3
+    */
+    bool IsLayoutEstimated() const { return m_layoutEstimated; }
+
 protected:
 
     // The lines that make up the wrapped paragraph
@@ -4487,6 +4601,9 @@ protected:
     // Whether the paragraph is impacted by floating objects from above
     int                 m_impactedByFloatingObjects;
 
+    // Whether the layout of the paragraph is only estimated
+    bool                m_layoutEstimated;
+
     // Default tabstops
     static wxArrayInt  sm_defaultTabs;
 
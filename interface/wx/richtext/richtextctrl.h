@@ -57,6 +57,8 @@
 #define wxRICHTEXT_DEFAULT_LAYOUT_INTERVAL 50
 // Milliseconds before delayed image processing occurs
 #define wxRICHTEXT_DEFAULT_DELAYED_IMAGE_PROCESSING_INTERVAL 200
+// Milliseconds spent on background layout in each idle event
+#define wxRICHTEXT_DEFAULT_BACKGROUND_LAYOUT_DURATION 20
 
 /* Identifiers
  */
@@ -357,6 +359,28 @@ public:
     */
     void ForceDelayedLayout();
 
+    /**
+        Enables or disables background layout.
+
+        If enabled, only the visible part of a buffer bigger than the delayed
+        layout threshold is laid out immediately, while the height of the
+        paragraphs below it is estimated and they are laid out later in idle
+        time. This makes showing big documents much faster. Background layout
+        is disabled by default.
+
+        @see SetDelayedLayoutThreshold()
+
+        @since 3.1.3
+    */
+    void EnableBackgroundLayout(bool b = true);
+
+    /**
+        Returns @true if background layout is enabled.
+
+        @since 3.1.3
+    */
+    bool GetBackgroundLayoutEnabled() const;
+
     /**
         Sets the text (normal) cursor.
     */
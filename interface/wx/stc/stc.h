@@ -2868,6 +2868,10 @@
         Process a @c wxEVT_STC_DWELLEND event.
     @event{EVT_STC_DWELLSTART(id, fn)}
         Process a @c wxEVT_STC_DWELLSTART event.
+    @event{EVT_STC_FILE_LOADED(id, fn)}
+        Process a @c wxEVT_STC_FILE_LOADED event.
+        @since 3.1.3
+
     @event{EVT_STC_HOTSPOT_CLICK(id, fn)}
         Process a @c wxEVT_STC_HOTSPOT_CLICK event.
     @event{EVT_STC_HOTSPOT_DCLICK(id, fn)}
@@ -7408,6 +7412,88 @@ public:
     */
     bool GetUseAntiAliasing();
 
+    /**
+       Perform the styling which would be done in idle time in a background
+       thread instead.
+
+       This only has any effect if idle styling is enabled using
+       SetIdleStyling(), in which case the lexer is run in a worker thread
+       over a copy of the parts of the document which still need to be styled
+       and the results are merged back into the document in the main thread,
+       unless it was modified in the meanwhile. This allows to keep the UI
+       responsive while styling very big documents.
+
+       Notice that the lexer used in the background thread is a separate
+       instance configured using the same SetLexer(), SetProperty() and
+       SetKeyWords() calls as the main one, so background lexing is not used
+       if sub-styles are allocated or PrivateLexerCall() is used, nor with the
+       documents set using SetDocPointer() before calling SetLexer() for them.
+       It is also not used with the DBCS code pages and the container lexer.
+
+       The time spent lexing the document is logged using wxLogTrace() with
+       the @c "stclexing" trace mask.
+
+       @since 3.1.3
+    */
+    void EnableBackgroundLexing(bool enable = true);
+
+    /**
+       Returns true if background lexing is enabled.
+
+       This always returns false if threads are not supported.
+
+       @see EnableBackgroundLexing()
+
+       @since 3.1.3
+    */
+    bool IsBackgroundLexingEnabled() const;
+
+    /**
+       Load the file in a background thread.
+
+       This function is similar to LoadFile() but only starts loading the
+       file and returns immediately. The file is read in chunks and added to
+       a new document in a worker thread, which also finds all the lines in
+       it, and this document replaces the current one, as if SetDocPointer()
+       were called, when it's done, after which @c wxEVT_STC_FILE_LOADED
+       event is generated. This allows to load very big files without
+       blocking the UI and without allocating more memory than needed for
+       the document itself.
+
+       The code page, EOL mode, indentation and read-only settings of the
+       current document are preserved in the new one, as is the lexer if it
+       was configured using SetLexer(), SetProperty() and SetKeyWords() only.
+       Any changes to the current document done while the file is loading are
+       lost.
+
+       Notice that the contents of the file is used as is, without any
+       conversion, so it must use the encoding corresponding to the code page
+       of the control, which is UTF-8 by default. The files starting with a
+       BOM indicating that they use UTF-16 or UTF-32 encoding are loaded
+       synchronously by LoadFile() instead, which is also done if threads are
+       not supported, but @c wxEVT_STC_FILE_LOADED is generated in this case
+       too.
+
+       Calling this function while another file is being loaded cancels
+       loading it.
+
+       The time taken to load the file is logged using wxLogTrace() with the
+       @c "stcloading" trace mask.
+
+       @return @false if the file couldn't be opened, in which case no event
+       is generated, or @true if it's being loaded.
+
+       @since 3.1.3
+    */
+    bool LoadFileInBackground(const wxString& filename);
+
+    /**
+       Returns true if a file is being loaded by LoadFileInBackground().
+
+       @since 3.1.3
+    */
+    bool IsLoadingFile() const;
+
     /**
        Clear annotations from the given line.
     */
@@ -7900,6 +7986,10 @@ public:
         Process a @c wxEVT_STC_DWELLEND event.
     @event{EVT_STC_DWELLSTART(id, fn)}
         Process a @c wxEVT_STC_DWELLSTART event.
+    @event{EVT_STC_FILE_LOADED(id, fn)}
+        Process a @c wxEVT_STC_FILE_LOADED event.
+        @since 3.1.3
+
     @event{EVT_STC_HOTSPOT_CLICK(id, fn)}
         Process a @c wxEVT_STC_HOTSPOT_CLICK event.
     @event{EVT_STC_HOTSPOT_DCLICK(id, fn)}
@@ -8106,6 +8196,18 @@ public:
     @link wxStyledTextEvent::GetX GetX@endlink,
     @link wxStyledTextEvent::GetY GetY@endlink.
 
+    @c wxEVT_STC_FILE_LOADED
+
+    - Generated when loading the file started by
+    @link wxStyledTextCtrl::LoadFileInBackground
+    wxStyledTextCtrl::LoadFileInBackground@endlink finishes.
+
+    - wxCommandEvent::GetInt() returns 1 if the file was loaded successfully
+    or 0 otherwise.
+
+    - Valid event functions:
+    @link wxStyledTextEvent::GetString GetString@endlink.
+
     @c wxEVT_STC_HOTSPOT_CLICK
 
     - Generated when a hotspot has been clicked.
@@ -8889,3 +8991,4 @@ const wxEventType wxEVT_STC_CLIPBOARD_COPY;
 const wxEventType wxEVT_STC_CLIPBOARD_PASTE;
 const wxEventType wxEVT_STC_AUTOCOMP_COMPLETED;
 const wxEventType wxEVT_STC_MARGIN_RIGHT_CLICK;
+const wxEventType wxEVT_STC_FILE_LOADED;
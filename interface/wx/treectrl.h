@@ -56,6 +56,16 @@
         Use this style to cause row heights to be just big enough to fit the
         content. If not set, all rows use the largest row height. The default is
         that this flag is unset. Generic only.
+    @style{wxTR_VIRTUAL}
+        The application provides the items text and the number of children of
+        each item on demand, see OnGetChildrenCount() and OnGetItemText(),
+        instead of inserting them into the control. This allows to show trees
+        with millions of items as only the items of the expanded branches
+        exist in the control and only the visible ones are measured. Notice
+        that the children of an item are created when it is expanded, so the
+        functions iterating over the items only see the expanded ones. Generic
+        only, this style requires using a class deriving from
+        wxGenericTreeCtrl. This style is new since wxWidgets 3.1.3.
     @style{wxTR_SINGLE}
         For convenience to document that only one item may be selected at a
         time. Selecting another item causes the current selection, if any, to be
@@ -422,6 +432,10 @@ public:
         Returns the number of items in the branch. If @a recursively is @true,
         returns the total number of descendants, otherwise only one level of
         children is counted.
+
+        For a control with @c wxTR_VIRTUAL style, the children which haven't
+        been created yet are counted using OnGetChildrenCount(), so counting
+        them recursively calls it for all the descendants of the item.
     */
     virtual size_t GetChildrenCount(const wxTreeItemId& item,
                                     bool recursively = true) const;
@@ -781,6 +795,56 @@ public:
     virtual int OnCompareItems(const wxTreeItemId& item1,
                                const wxTreeItemId& item2);
 
+    /**
+        Returns the index of the item among the children of its parent.
+
+        This function is mostly useful for the controls with @c wxTR_VIRTUAL
+        style, where it can be used by OnGetChildrenCount() and
+        OnGetItemText() to find the element of the application data
+        corresponding to the item. The root item has index 0.
+
+        This method is only available in the generic version of the control.
+
+        @since 3.1.3
+    */
+    unsigned int GetItemIndex(const wxTreeItemId& item) const;
+
+    /**
+        This function must be overridden in the derived class for a control
+        with @c wxTR_VIRTUAL style. It should return the number of children of
+        the given item.
+
+        The function is only called when the control needs to know if the item
+        has children, i.e. when it becomes visible, and when it is expanded,
+        and the result is cached until CollapseAndReset() is called for the
+        item or one of its parents. It is also called by GetChildrenCount()
+        and GetCount() for the items whose children weren't created yet, in
+        which case the item passed to it may be a temporary one and must not
+        be stored.
+
+        This method is only available in the generic version of the control.
+
+        @since 3.1.3
+    */
+    virtual unsigned int OnGetChildrenCount(const wxTreeItemId& item) const;
+
+    /**
+        This function must be overridden in the derived class for a control
+        with @c wxTR_VIRTUAL style. It should return the label of the given
+        item, which is never the root item, as the root is created by AddRoot()
+        as usual.
+
+        As the text is not stored by the control, this function may be called
+        many times for the same item, e.g. whenever it is repainted, so it
+        should be fast. Call SetItemText() to notify the control that the text
+        of an item has changed, the text passed to it is ignored in this case.
+
+        This method is only available in the generic version of the control.
+
+        @since 3.1.3
+    */
+    virtual wxString OnGetItemText(const wxTreeItemId& item) const;
+
     /**
         Appends an item as the first child of @a parent, return a new item id.
 
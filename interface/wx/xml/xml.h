@@ -869,6 +869,22 @@ public:
     */
     virtual bool Save(wxOutputStream& stream, int indentstep = 2) const;
 
+    /**
+        Called by Load() for every element node as soon as the node itself and
+        all of its children are loaded.
+
+        The node is already a child of its parent node and its parent's
+        attributes are already available, but the parent's following children
+        are not. Override this function to process big documents without
+        keeping all of them in memory: returning @true from it deletes the
+        node instead of keeping it in the document.
+
+        The default implementation just returns @false.
+
+        @since 3.1.3
+    */
+    virtual bool OnElementLoaded(wxXmlNode* node);
+
     /**
         Sets the document node of this document.
 
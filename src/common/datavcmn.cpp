@@ -1661,6 +1661,7 @@ wxDEFINE_EVENT( wxEVT_DATAVIEW_COLUMN_SORTED, wxDataViewEvent );
 wxDEFINE_EVENT( wxEVT_DATAVIEW_COLUMN_REORDERED, wxDataViewEvent );
 
 wxDEFINE_EVENT( wxEVT_DATAVIEW_CACHE_HINT, wxDataViewEvent );
+wxDEFINE_EVENT( wxEVT_DATAVIEW_PREFETCH_HINT, wxDataViewEvent );
 
 wxDEFINE_EVENT( wxEVT_DATAVIEW_ITEM_BEGIN_DRAG, wxDataViewEvent );
 wxDEFINE_EVENT( wxEVT_DATAVIEW_ITEM_DROP_POSSIBLE, wxDataViewEvent );
@@ -1678,6 +1679,7 @@ void wxDataViewEvent::Init(wxDataViewCtrlBase* dvc,
     m_pos = wxDefaultPosition;
     m_cacheFrom = 0;
     m_cacheTo = 0;
+    m_prefetchDirection = 0;
     m_editCancelled = false;
 #if wxUSE_DRAG_AND_DROP
     m_dataObject = NULL;
@@ -55,6 +55,7 @@ wxDEFINE_EVENT( wxEVT_LIST_ITEM_FOCUSED, wxListEvent );
 wxDEFINE_EVENT( wxEVT_LIST_ITEM_CHECKED, wxListEvent );
 wxDEFINE_EVENT( wxEVT_LIST_ITEM_UNCHECKED, wxListEvent );
 wxDEFINE_EVENT( wxEVT_LIST_CACHE_HINT, wxListEvent );
+wxDEFINE_EVENT( wxEVT_LIST_PREFETCH_HINT, wxListEvent );
 
 // -----------------------------------------------------------------------------
 // XTI
@@ -110,7 +110,7 @@ void wxTextWrapper::Wrap(wxWindow *win, const wxString& text, int widthMax)
     const wxArrayString ls = wxSplit(text, '\n', '\0');
     for ( wxArrayString::const_iterator i = ls.begin(); i != ls.end(); ++i )
     {
-        wxString line = *i;
+        const wxString& line = *i;
 
         if ( i != ls.begin() )
         {
@@ -125,39 +125,46 @@ void wxTextWrapper::Wrap(wxWindow *win, const wxString& text, int widthMax)
             continue;
         }
 
-        for ( bool newLine = false; !line.empty(); newLine = true )
+        // Measure the entire line just once and use the differences between
+        // the widths of its prefixes to find the width of its remaining part
+        // after chopping off the part which fits.
+        wxArrayInt widths;
+        dc.GetPartialTextExtents(line, widths);
+
+        size_t posStart = 0;
+        int widthStart = 0;
+        for ( bool newLine = false; posStart < line.length(); newLine = true )
         {
             if ( newLine )
                 OnNewLine();
 
-            wxArrayInt widths;
-            dc.GetPartialTextExtents(line, widths);
-
-            const size_t posEnd = std::lower_bound(widths.begin(),
+            const size_t posEnd = std::lower_bound(widths.begin() + posStart,
                                                    widths.end(),
-                                                   widthMax) - widths.begin();
+                                                   widthStart + widthMax)
+                                    - widths.begin();
 
             // Does the entire remaining line fit?
             if ( posEnd == line.length() )
             {
-                DoOutputLine(line);
+                DoOutputLine(line.substr(posStart));
                 break;
             }
 
             // Find the last word to chop off.
             const size_t lastSpace = line.rfind(' ', posEnd);
-            if ( lastSpace == wxString::npos )
+            if ( lastSpace == wxString::npos || lastSpace < posStart )
             {
                 // No spaces, so can't wrap.
-                DoOutputLine(line);
+                DoOutputLine(line.substr(posStart));
                 break;
             }
 
             // Output the part that fits.
-            DoOutputLine(line.substr(0, lastSpace));
+            DoOutputLine(line.substr(posStart, lastSpace - posStart));
 
-            // And redo the layout with the rest.
-            line = line.substr(lastSpace + 1);
+            // And continue with the rest.
+            posStart = lastSpace + 1;
+            widthStart = widths[lastSpace];
         }
     }
 }
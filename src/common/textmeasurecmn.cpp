@@ -100,6 +100,38 @@ void wxTextMeasureBase::GetTextExtent(const wxString& string,
     CallGetTextExtent(string, width, height, descent, externalLeading);
 }
 
+void wxTextMeasureBase::GetTextExtents(const wxArrayString& strings,
+                                       wxArrayInt& widths,
+                                       wxArrayInt* heights)
+{
+    widths.Empty();
+    if ( heights )
+        heights->Empty();
+
+    if ( strings.empty() )
+        return;
+
+    MeasuringGuard guard(*this);
+
+    wxArrayInt heightsUnused;
+    if ( !heights )
+        heights = &heightsUnused;
+
+    widths.Add(0, strings.size());
+    heights->Add(0, strings.size());
+
+    DoGetTextExtents(strings, widths, *heights);
+}
+
+void wxTextMeasureBase::DoGetTextExtents(const wxArrayString& strings,
+                                         wxArrayInt& widths,
+                                         wxArrayInt& heights)
+{
+    const size_t count = strings.size();
+    for ( size_t n = 0; n < count; n++ )
+        CallGetTextExtent(strings[n], &widths[n], &heights[n]);
+}
+
 void wxTextMeasureBase::GetMultiLineTextExtent(const wxString& text,
                                                wxCoord *width,
                                                wxCoord *height,
@@ -107,54 +139,61 @@ void wxTextMeasureBase::GetMultiLineTextExtent(const wxString& text,
 {
     MeasuringGuard guard(*this);
 
-    wxCoord widthTextMax = 0, widthLine,
+    // Measure all the non-empty lines at once first.
+    const wxArrayString lines = wxSplit(text, wxS('\n'), wxS('\0'));
+
+    wxArrayString linesNonEmpty;
+    for ( size_t n = 0; n < lines.size(); n++ )
+    {
+        if ( !lines[n].empty() )
+            linesNonEmpty.push_back(lines[n]);
+    }
+
+    wxArrayInt widths,
+               heights;
+    if ( !linesNonEmpty.empty() )
+    {
+        widths.Add(0, linesNonEmpty.size());
+        heights.Add(0, linesNonEmpty.size());
+        DoGetTextExtents(linesNonEmpty, widths, heights);
+    }
+
+    wxCoord widthTextMax = 0,
             heightTextTotal = 0, heightLineDefault = 0, heightLine = 0;
 
-    wxString curLine;
-    for ( wxString::const_iterator pc = text.begin(); ; ++pc )
+    // wxSplit() returns an empty array for an empty string, but we still
+    // want to account for the height of the single empty line in this case.
+    const size_t numLines = wxMax(lines.size(), 1);
+    for ( size_t n = 0, nonEmpty = 0; n < numLines; n++ )
     {
-        if ( pc == text.end() || *pc == wxS('\n') )
+        if ( n >= lines.size() || lines[n].empty() )
         {
-            if ( curLine.empty() )
-            {
-                // we can't use GetTextExtent - it will return 0 for both width
-                // and height and an empty line should count in height
-                // calculation
-
-                // assume that this line has the same height as the previous
-                // one
-                if ( !heightLineDefault )
-                    heightLineDefault = heightLine;
-
-                if ( !heightLineDefault )
-                {
-                    // but we don't know it yet - choose something reasonable
-                    int dummy;
-                    CallGetTextExtent(wxS("W"), &dummy, &heightLineDefault);
-                }
-
-                heightTextTotal += heightLineDefault;
-            }
-            else
-            {
-                CallGetTextExtent(curLine, &widthLine, &heightLine);
-                if ( widthLine > widthTextMax )
-                    widthTextMax = widthLine;
-                heightTextTotal += heightLine;
-            }
+            // we can't use GetTextExtent - it will return 0 for both width
+            // and height and an empty line should count in height
+            // calculation
 
-            if ( pc == text.end() )
-            {
-               break;
-            }
-            else // '\n'
+            // assume that this line has the same height as the previous
+            // one
+            if ( !heightLineDefault )
+                heightLineDefault = heightLine;
+
+            if ( !heightLineDefault )
             {
-               curLine.clear();
+                // but we don't know it yet - choose something reasonable
+                int dummy;
+                CallGetTextExtent(wxS("W"), &dummy, &heightLineDefault);
             }
+
+            heightTextTotal += heightLineDefault;
         }
         else
         {
-            curLine += *pc;
+            heightLine = heights[nonEmpty];
+            if ( widths[nonEmpty] > widthTextMax )
+                widthTextMax = widths[nonEmpty];
+            heightTextTotal += heightLine;
+
+            nonEmpty++;
         }
     }
 
@@ -169,17 +208,25 @@ void wxTextMeasureBase::GetMultiLineTextExtent(const wxString& text,
 wxSize wxTextMeasureBase::GetLargestStringExtent(size_t n,
                                                  const wxString* strings)
 {
+    if ( !n )
+        return wxSize(0, 0);
+
     MeasuringGuard guard(*this);
 
-    wxCoord w, h, widthMax = 0, heightMax = 0;
+    const wxArrayString stringsArray(n, strings);
+    wxArrayInt widths,
+               heights;
+    widths.Add(0, n);
+    heights.Add(0, n);
+    DoGetTextExtents(stringsArray, widths, heights);
+
+    wxCoord widthMax = 0, heightMax = 0;
     for ( size_t i = 0; i < n; ++i )
     {
-        CallGetTextExtent(strings[i], &w, &h);
-
-        if ( w > widthMax )
-            widthMax = w;
-        if ( h > heightMax )
-            heightMax = h;
+        if ( widths[i] > widthMax )
+            widthMax = widths[i];
+        if ( heights[i] > heightMax )
+            heightMax = heights[i];
     }
 
     return wxSize(widthMax, heightMax);
@@ -53,6 +53,7 @@
 #include "wx/stopwatch.h"
 #include "wx/weakref.h"
 #include "wx/generic/private/markuptext.h"
+#include "wx/generic/private/prefetch.h"
 #include "wx/generic/private/rowheightcache.h"
 #include "wx/generic/private/widthcalc.h"
 #if wxUSE_ACCESSIBILITY
@@ -828,6 +829,9 @@ public:
 
     void SetRowHeight( int lineHeight ) { m_lineHeight = lineHeight; }
     int GetRowHeight() const { return m_lineHeight; }
+
+    void SetPrefetchLookAhead( int count ) { m_prefetch.SetLookAhead(count); }
+    int GetPrefetchLookAhead() const { return m_prefetch.GetLookAhead(); }
     int GetDefaultRowHeight() const;
 
     // Some useful functions for row and item mapping
@@ -899,6 +903,9 @@ private:
     // assumes that all columns were modified, otherwise just this one.
     bool DoItemChanged(const wxDataViewItem& item, int view_column);
 
+    // Send wxEVT_DATAVIEW_PREFETCH_HINT if the visible rows changed.
+    void SendPrefetchHint(unsigned int rowFrom, unsigned int rowTo);
+
 private:
     wxDataViewCtrl             *m_owner;
     int                         m_lineHeight;
@@ -916,6 +923,9 @@ private:
     bool                        m_currentColSetByKeyboard;
     HeightCache                *m_rowHeightCache;
 
+    // Used to determine the rows to prefetch.
+    wxPrefetchTracker           m_prefetch;
+
 #if wxUSE_DRAG_AND_DROP
     int                         m_dragCount;
     wxPoint                     m_dragStart;
@@ -2238,6 +2248,18 @@ void wxDataViewMainWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
     cache_event.SetCache(item_start, item_last - 1);
     m_owner->ProcessWindowEvent(cache_event);
 
+    // And also tell it about the rows which are going to be shown next, this
+    // uses all the visible rows and not just those being repainted.
+    const unsigned int rowCount = GetRowCount();
+    if ( rowCount )
+    {
+        int yTop;
+        m_owner->CalcUnscrolledPosition(0, 0, NULL, &yTop);
+        const unsigned int rowLast = rowCount - 1;
+        SendPrefetchHint(wxMin((unsigned)GetLineAt(yTop), rowLast),
+                         wxMin((unsigned)GetLineAt(yTop + size.y), rowLast));
+    }
+
     // compute which columns needs to be redrawn
     unsigned int cols = GetOwner()->GetColumnCount();
     if ( !cols )
@@ -2517,7 +2539,8 @@ void wxDataViewMainWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
         cell_rect.y = first_line_start;
         for (unsigned int item = item_start; item < item_last; item++)
         {
-            // get the cell value and set it into the renderer
+            // get the cell value and set it into the renderer, unless it's
+            // not available yet and we show a placeholder instead of it
             wxDataViewTreeNode *node = NULL;
             wxDataViewItem dataitem;
             const int line_height = GetLineHeight(item);
@@ -2557,12 +2580,16 @@ void wxDataViewMainWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
             if (m_hasFocus && selected)
                 state |= wxDATAVIEW_CELL_SELECTED;
 
-            cell->SetState(state);
-            cell->PrepareForItem(model, dataitem, col->GetModelColumn());
+            const bool loaded = model->IsItemLoaded(dataitem);
+            if ( loaded )
+            {
+                cell->SetState(state);
+                cell->PrepareForItem(model, dataitem, col->GetModelColumn());
 
-            // draw the background
-            if ( !selected )
-                DrawCellBackground( cell, dc, cell_rect );
+                // draw the background
+                if ( !selected )
+                    DrawCellBackground( cell, dc, cell_rect );
+            }
 
             // deal with the expander
             int indent = 0;
@@ -2624,7 +2651,10 @@ void wxDataViewMainWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
             //       make its own renderer and thus we cannot be sure of that.
             wxDCClipper clip(dc, item_rect);
 
-            cell->WXCallRender(item_rect, &dc, state);
+            if ( loaded )
+                cell->WXCallRender(item_rect, &dc, state);
+            else
+                wxDrawItemPlaceholder(dc, item_rect);
 
             cell_rect.y += line_height;
         }
@@ -2634,6 +2664,25 @@ void wxDataViewMainWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
 }
 
 
+void wxDataViewMainWindow::SendPrefetchHint(unsigned int rowFrom,
+                                            unsigned int rowTo)
+{
+    long from, to;
+    int direction;
+    if ( !m_prefetch.Update(rowFrom, rowTo, GetRowCount(),
+                            &from, &to, &direction) )
+        return;
+
+    // Queue the event instead of processing it immediately to avoid delaying
+    // painting: the model is supposed to retrieve the rows asynchronously and
+    // call ItemChanged() or RowChanged() when they become available.
+    wxDataViewEvent* const event =
+        new wxDataViewEvent(wxEVT_DATAVIEW_PREFETCH_HINT, m_owner, NULL);
+    event->SetCache(from, to);
+    event->SetPrefetchDirection(direction);
+    m_owner->GetEventHandler()->QueueEvent(event);
+}
+
 void wxDataViewMainWindow::DrawCellBackground( wxDataViewRenderer* cell, wxDC& dc, const wxRect& rect )
 {
     wxRect rectBg( rect );
@@ -3037,6 +3086,7 @@ bool wxDataViewMainWindow::Cleared()
     DestroyTree();
     m_selection.Clear();
     m_currentRow = (unsigned)-1;
+    m_prefetch.Reset();
 
     if ( m_rowHeightCache )
         m_rowHeightCache->Clear();
@@ -5457,6 +5507,23 @@ bool wxDataViewCtrl::SetRowHeight( int lineHeight )
     return true;
 }
 
+bool wxDataViewCtrl::SetPrefetchLookAhead( int count )
+{
+    if ( !m_clientArea )
+        return false;
+
+    wxCHECK_MSG( count >= 0, false, "invalid prefetch look-ahead" );
+
+    m_clientArea->SetPrefetchLookAhead(count);
+
+    return true;
+}
+
+int wxDataViewCtrl::GetPrefetchLookAhead() const
+{
+    return m_clientArea ? m_clientArea->GetPrefetchLookAhead() : 0;
+}
+
 wxDataViewColumn* wxDataViewCtrl::GetColumn( unsigned int idx ) const
 {
     return m_cols[idx];
@@ -93,6 +93,7 @@ using namespace std;
 #include "wx/gtk/dc.h"
 #endif
 #include "wx/gtk/private/object.h"
+#include "wx/gtk/private/extentcache.h"
 #endif
 
 #ifdef __WXQT__
@@ -2697,28 +2698,53 @@ void wxCairoContext::GetTextExtent( const wxString &str, wxDouble *width, wxDoub
         // Note that there is no need to call Apply() at all in this case, it
         // just sets the text colour, but we don't care about this when
         // measuring its extent.
-        int w, h;
-
-        wxGtkObject<PangoLayout> layout(pango_cairo_create_layout (m_context));
-        pango_layout_set_font_description(layout, font.GetNativeFontInfo()->description);
-        const wxCharBuffer data = str.utf8_str();
-        if ( !data )
+        int w, h, d;
+
+        const PangoFontDescription* const
+            desc = font.GetNativeFontInfo()->description;
+
+        // The extents depend on the transformation matrix and on the font
+        // options of the target surface, approximated by its type, in
+        // addition to the font and the text.
+        wxGtkTextExtentContext context;
+        context.fontMap = pango_cairo_font_map_get_default();
+        context.kind = cairo_surface_get_type(cairo_get_target(m_context));
+
+        cairo_matrix_t matrix;
+        cairo_get_matrix(m_context, &matrix);
+        context.xx = matrix.xx;
+        context.yx = matrix.yx;
+        context.xy = matrix.xy;
+        context.yy = matrix.yy;
+
+        wxGtkTextExtentCache& cache = wxGtkTextExtentCache::Get();
+        if ( !cache.Find(context, desc, str, &w, &h, &d) )
         {
-            return;
+            wxGtkObject<PangoLayout> layout(pango_cairo_create_layout (m_context));
+            pango_layout_set_font_description(layout, desc);
+            const wxCharBuffer data = str.utf8_str();
+            if ( !data )
+            {
+                return;
+            }
+            pango_layout_set_text(layout, data, data.length());
+            pango_layout_get_pixel_size (layout, &w, &h);
+
+            // Always compute the descent to be able to cache it.
+            PangoLayoutIter *iter = pango_layout_get_iter(layout);
+            int baseline = pango_layout_iter_get_baseline(iter);
+            pango_layout_iter_free(iter);
+            d = h - PANGO_PIXELS(baseline);
+
+            cache.Add(context, desc, str, w, h, d);
         }
-        pango_layout_set_text(layout, data, data.length());
-        pango_layout_get_pixel_size (layout, &w, &h);
+
         if ( width )
             *width = w;
         if ( height )
             *height = h;
-        if (descent)
-        {
-            PangoLayoutIter *iter = pango_layout_get_iter(layout);
-            int baseline = pango_layout_iter_get_baseline(iter);
-            pango_layout_iter_free(iter);
-            *descent = h - PANGO_PIXELS(baseline);
-        }
+        if ( descent )
+            *descent = d;
         return;
     }
 #endif // __WXGTK__
@@ -48,6 +48,7 @@
 #include "wx/renderer.h"
 #include "wx/headerctrl.h"
 #include "wx/hashset.h"
+#include "wx/stopwatch.h"
 
 #include "wx/generic/gridsel.h"
 #include "wx/generic/gridctrl.h"
@@ -59,9 +60,13 @@ const char wxGridNameStr[] = "grid";
 // Required for wxIs... functions
 #include <ctype.h>
 
+#include <algorithm>
+
 WX_DECLARE_HASH_SET_WITH_DECL_PTR(int, wxIntegerHash, wxIntegerEqual,
                                   wxGridFixedIndicesSet, class WXDLLIMPEXP_ADV);
 
+WX_DECLARE_HASH_SET(int, wxIntegerHash, wxIntegerEqual, wxGridIndexSet);
+
 
 // ----------------------------------------------------------------------------
 // globals
@@ -116,7 +121,6 @@ const int DRAG_SENSITIVITY = 3;
 #include "wx/arrimpl.cpp"
 
 WX_DEFINE_OBJARRAY(wxGridCellCoordsArray)
-WX_DEFINE_OBJARRAY(wxGridCellWithAttrArray)
 
 // ----------------------------------------------------------------------------
 // events
@@ -201,6 +205,53 @@ wxGridOperations& wxGridColumnOperations::Dual() const
     return s_rowOper;
 }
 
+int wxGridColumnOperations::FindLinePos(const wxGrid *grid, int coord) const
+{
+    const int numCols = grid->GetNumberCols();
+
+    // check for the simplest case: if we have no explicit column widths
+    // configured, then we already know the column this position falls in
+    const wxArrayInt& colRights = grid->m_colRights;
+    if ( colRights.empty() )
+        return coord / grid->m_defaultColWidth;
+
+    // binary search is quite efficient and we can't really make any
+    // assumptions on where to start here since columns could be of size 0 if
+    // they are hidden
+    int maxPos = numCols - 1,
+        minPos = 0;
+
+    // check if the position is beyond the last column
+    if ( coord >= colRights[grid->GetColAt(maxPos)] )
+        return numCols;
+
+    // or before the first one
+    if ( coord < colRights[grid->GetColAt(0)] )
+        return 0;
+
+    // finally do perform the binary search
+    while ( minPos < maxPos )
+    {
+        wxCHECK_MSG( colRights[grid->GetColAt(minPos)] <= coord &&
+                        coord < colRights[grid->GetColAt(maxPos)],
+                     -1,
+                     "wxGrid: internal error in FindLinePos()" );
+
+        if ( coord >= colRights[grid->GetColAt(maxPos - 1)] )
+            return maxPos;
+        else
+            maxPos--;
+
+        const int median = minPos + (maxPos - minPos + 1) / 2;
+        if ( coord < colRights[grid->GetColAt(median)] )
+            maxPos = median;
+        else
+            minPos = median;
+    }
+
+    return maxPos;
+}
+
 // ----------------------------------------------------------------------------
 // wxGridCellWorker is an (almost) empty common base class for
 // wxGridCellRenderer and wxGridCellEditor managing ref counting
@@ -599,32 +650,47 @@ wxGridCellEditor* wxGridCellAttr::GetEditor(const wxGrid* grid, int row, int col
 // wxGridCellAttrData
 // ----------------------------------------------------------------------------
 
+wxGridCellAttrData::~wxGridCellAttrData()
+{
+    for ( wxGridCellCoordsToAttrMap::iterator it = m_attrs.begin();
+          it != m_attrs.end();
+          ++it )
+    {
+        it->second->DecRef();
+    }
+}
+
 void wxGridCellAttrData::SetAttr(wxGridCellAttr *attr, int row, int col)
 {
-    // Note: contrary to wxGridRowOrColAttrData::SetAttr, we must not
-    //       touch attribute's reference counting explicitly, since this
-    //       is managed by class wxGridCellWithAttr
-    int n = FindIndex(row, col);
-    if ( n == wxNOT_FOUND )
+    // Note: as in wxGridRowOrColAttrData::SetAttr, we take ownership of the
+    //       new attribute and must release the one we had before, if any
+    const wxGridCellCoords coords(row, col);
+
+    wxGridCellCoordsToAttrMap::iterator it = m_attrs.find(coords);
+    if ( it == m_attrs.end() )
     {
         if ( attr )
         {
             // add the attribute
-            m_attrs.Add(new wxGridCellWithAttr(row, col, attr));
+            m_attrs[coords] = attr;
         }
         //else: nothing to do
     }
     else // we already have an attribute for this cell
     {
+        // this works even if the new attribute is the same as the old one,
+        // see the comment in wxGridRowOrColAttrData::SetAttr()
+        it->second->DecRef();
+
         if ( attr )
         {
             // change the attribute
-            m_attrs[(size_t)n].ChangeAttr(attr);
+            it->second = attr;
         }
         else
         {
             // remove this attribute
-            m_attrs.RemoveAt((size_t)n);
+            m_attrs.erase(it);
         }
     }
 }
@@ -633,10 +699,11 @@ wxGridCellAttr *wxGridCellAttrData::GetAttr(int row, int col) const
 {
     wxGridCellAttr *attr = NULL;
 
-    int n = FindIndex(row, col);
-    if ( n != wxNOT_FOUND )
+    wxGridCellCoordsToAttrMap::const_iterator
+        it = m_attrs.find(wxGridCellCoords(row, col));
+    if ( it != m_attrs.end() )
     {
-        attr = m_attrs[(size_t)n].attr;
+        attr = it->second;
         attr->IncRef();
     }
 
@@ -645,85 +712,53 @@ wxGridCellAttr *wxGridCellAttrData::GetAttr(int row, int col) const
 
 void wxGridCellAttrData::UpdateAttrRows( size_t pos, int numRows )
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
-    {
-        wxGridCellCoords& coords = m_attrs[n].coords;
-        wxCoord row = coords.GetRow();
-        if ((size_t)row >= pos)
-        {
-            if (numRows > 0)
-            {
-                // If rows inserted, increment row counter where necessary
-                coords.SetRow(row + numRows);
-            }
-            else if (numRows < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)row >= pos - numRows)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords.SetRow(row + numRows);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
-        }
-    }
+    UpdateAttrRowsOrCols(pos, numRows, true);
 }
 
 void wxGridCellAttrData::UpdateAttrCols( size_t pos, int numCols )
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
-    {
-        wxGridCellCoords& coords = m_attrs[n].coords;
-        wxCoord col = coords.GetCol();
-        if ( (size_t)col >= pos )
-        {
-            if ( numCols > 0 )
-            {
-                // If cols inserted, increment col counter where necessary
-                coords.SetCol(col + numCols);
-            }
-            else if (numCols < 0)
-            {
-                // If cols deleted ...
-                if ((size_t)col >= pos - numCols)
-                {
-                    // ...either decrement col counter (if col still exists)...
-                    coords.SetCol(col + numCols);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
-        }
-    }
+    UpdateAttrRowsOrCols(pos, numCols, false);
 }
 
-int wxGridCellAttrData::FindIndex(int row, int col) const
+void
+wxGridCellAttrData::UpdateAttrRowsOrCols(size_t pos,
+                                         int numRowsOrCols,
+                                         bool isRow)
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
-    {
-        const wxGridCellCoords& coords = m_attrs[n].coords;
-        if ( (coords.GetRow() == row) && (coords.GetCol() == col) )
+    if ( !numRowsOrCols )
+        return;
+
+    // As the keys of the attributes after the insertion or deletion point
+    // change, we need to rebuild the map. This is still linear in the number
+    // of attributes, as the old linear search was, but this operation is much
+    // less frequent than GetAttr().
+    wxGridCellCoordsToAttrMap attrs;
+    for ( wxGridCellCoordsToAttrMap::iterator it = m_attrs.begin();
+          it != m_attrs.end();
+          ++it )
+    {
+        wxGridCellCoords coords = it->first;
+        const int rowOrCol = isRow ? coords.GetRow() : coords.GetCol();
+        if ( (size_t)rowOrCol >= pos )
         {
-            return n;
+            if ( numRowsOrCols < 0 && (size_t)rowOrCol < pos - numRowsOrCols )
+            {
+                // This row or column was deleted, remove the attribute.
+                it->second->DecRef();
+                continue;
+            }
+
+            // Otherwise shift the row or column counter.
+            if ( isRow )
+                coords.SetRow(rowOrCol + numRowsOrCols);
+            else
+                coords.SetCol(rowOrCol + numRowsOrCols);
         }
+
+        attrs[coords] = it->second;
     }
 
-    return wxNOT_FOUND;
+    m_attrs = attrs;
 }
 
 // ----------------------------------------------------------------------------
@@ -732,10 +767,11 @@ int wxGridCellAttrData::FindIndex(int row, int col) const
 
 wxGridRowOrColAttrData::~wxGridRowOrColAttrData()
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    for ( wxGridRowOrColToAttrMap::iterator it = m_attrs.begin();
+          it != m_attrs.end();
+          ++it )
     {
-        m_attrs[n]->DecRef();
+        it->second->DecRef();
     }
 }
 
@@ -743,10 +779,10 @@ wxGridCellAttr *wxGridRowOrColAttrData::GetAttr(int rowOrCol) const
 {
     wxGridCellAttr *attr = NULL;
 
-    int n = m_rowsOrCols.Index(rowOrCol);
-    if ( n != wxNOT_FOUND )
+    wxGridRowOrColToAttrMap::const_iterator it = m_attrs.find(rowOrCol);
+    if ( it != m_attrs.end() )
     {
-        attr = m_attrs[(size_t)n];
+        attr = it->second;
         attr->IncRef();
     }
 
@@ -755,69 +791,438 @@ wxGridCellAttr *wxGridRowOrColAttrData::GetAttr(int rowOrCol) const
 
 void wxGridRowOrColAttrData::SetAttr(wxGridCellAttr *attr, int rowOrCol)
 {
-    int i = m_rowsOrCols.Index(rowOrCol);
-    if ( i == wxNOT_FOUND )
+    wxGridRowOrColToAttrMap::iterator it = m_attrs.find(rowOrCol);
+    if ( it == m_attrs.end() )
     {
         if ( attr )
         {
             // store the new attribute, taking its ownership
-            m_rowsOrCols.Add(rowOrCol);
-            m_attrs.Add(attr);
+            m_attrs[rowOrCol] = attr;
         }
         // nothing to remove
     }
     else // we have an attribute for this row or column
     {
-        size_t n = (size_t)i;
-
         // notice that this code works correctly even when the old attribute is
         // the same as the new one: as we own of it, we must call DecRef() on
         // it in any case and this won't result in destruction of the new
         // attribute if it's the same as old one because it must have ref count
         // of at least 2 to be passed to us while we keep a reference to it too
-        m_attrs[n]->DecRef();
+        it->second->DecRef();
 
         if ( attr )
         {
             // replace the attribute with the new one
-            m_attrs[n] = attr;
+            it->second = attr;
         }
         else // remove the attribute
         {
-            m_rowsOrCols.RemoveAt(n);
-            m_attrs.RemoveAt(n);
+            m_attrs.erase(it);
         }
     }
 }
 
 void wxGridRowOrColAttrData::UpdateAttrRowsOrCols( size_t pos, int numRowsOrCols )
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    if ( !numRowsOrCols )
+        return;
+
+    wxGridRowOrColToAttrMap attrs;
+    for ( wxGridRowOrColToAttrMap::iterator it = m_attrs.begin();
+          it != m_attrs.end();
+          ++it )
     {
-        int & rowOrCol = m_rowsOrCols[n];
+        int rowOrCol = it->first;
         if ( (size_t)rowOrCol >= pos )
         {
-            if ( numRowsOrCols > 0 )
-            {
-                // If rows or cols inserted, increment row/col counter where necessary
-                rowOrCol += numRowsOrCols;
-            }
-            else if ( numRowsOrCols < 0)
+            // If rows/cols deleted, either decrement row/col counter (if
+            // row/col still exists) or remove the attribute
+            if ( numRowsOrCols < 0 && (size_t)rowOrCol < pos - numRowsOrCols )
             {
-                // If rows/cols deleted, either decrement row/col counter (if row/col still exists)
-                if ((size_t)rowOrCol >= pos - numRowsOrCols)
-                    rowOrCol += numRowsOrCols;
-                else
-                {
-                    m_rowsOrCols.RemoveAt(n);
-                    m_attrs[n]->DecRef();
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
+                it->second->DecRef();
+                continue;
             }
+
+            // If rows or cols inserted, increment row/col counter
+            rowOrCol += numRowsOrCols;
+        }
+
+        attrs[rowOrCol] = it->second;
+    }
+
+    m_attrs = attrs;
+}
+
+// ----------------------------------------------------------------------------
+// wxGridLinesGeometry
+// ----------------------------------------------------------------------------
+
+wxGridLinesGeometry::wxGridLinesGeometry(int sizeDefault)
+    : m_sizeDefault(sizeDefault),
+      m_root(NULL),
+      m_seed(0x2545F491)
+{
+}
+
+wxGridLinesGeometry::~wxGridLinesGeometry()
+{
+    DeleteSubtree(m_root);
+}
+
+/* static */
+void wxGridLinesGeometry::DeleteSubtree(Node *node)
+{
+    while ( node )
+    {
+        DeleteSubtree(node->left);
+
+        Node * const right = node->right;
+        delete node;
+        node = right;
+    }
+}
+
+unsigned wxGridLinesGeometry::GetNextPriority()
+{
+    // xorshift generator is more than good enough for balancing the tree
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    return m_seed;
+}
+
+/* static */
+void wxGridLinesGeometry::PushShift(Node *node)
+{
+    if ( !node->shift )
+        return;
+
+    node->line += node->shift;
+    if ( node->left )
+        node->left->shift += node->shift;
+    if ( node->right )
+        node->right->shift += node->shift;
+
+    node->shift = 0;
+}
+
+void
+wxGridLinesGeometry::Split(Node *node, int line, Node*& left, Node*& right)
+{
+    if ( !node )
+    {
+        left =
+        right = NULL;
+        return;
+    }
+
+    PushShift(node);
+
+    if ( node->line < line )
+    {
+        Split(node->right, line, node->right, right);
+
+        // if the run continues after the split position, move its tail into
+        // a separate node belonging to the right part
+        const int end = node->line + node->count;
+        if ( end > line )
+        {
+            Node * const
+                tail = new Node(line, end - line, node->size, GetNextPriority());
+            UpdateSumDelta(tail);
+
+            node->count = line - node->line;
+            right = Merge(tail, right);
+        }
+
+        left = node;
+    }
+    else
+    {
+        Split(node->left, line, left, node->left);
+        right = node;
+    }
+
+    UpdateSumDelta(node);
+}
+
+wxGridLinesGeometry::Node *
+wxGridLinesGeometry::Merge(Node *left, Node *right)
+{
+    if ( !left )
+        return right;
+    if ( !right )
+        return left;
+
+    if ( left->priority > right->priority )
+    {
+        PushShift(left);
+        left->right = Merge(left->right, right);
+        UpdateSumDelta(left);
+        return left;
+    }
+    else
+    {
+        PushShift(right);
+        right->left = Merge(left, right->left);
+        UpdateSumDelta(right);
+        return right;
+    }
+}
+
+bool wxGridLinesGeometry::ExtendLast(Node *node, int line, int num, int size)
+{
+    if ( !node )
+        return false;
+
+    PushShift(node);
+
+    bool extended;
+    if ( node->right )
+    {
+        extended = ExtendLast(node->right, line, num, size);
+    }
+    else
+    {
+        extended = node->line + node->count == line && node->size == size;
+        if ( extended )
+            node->count += num;
+    }
+
+    if ( extended )
+        UpdateSumDelta(node);
+
+    return extended;
+}
+
+bool wxGridLinesGeometry::ExtendFirst(Node *node, int line, int num, int size)
+{
+    if ( !node )
+        return false;
+
+    PushShift(node);
+
+    bool extended;
+    if ( node->left )
+    {
+        extended = ExtendFirst(node->left, line, num, size);
+    }
+    else
+    {
+        extended = node->line == line + num && node->size == size;
+        if ( extended )
+        {
+            node->line = line;
+            node->count += num;
+        }
+    }
+
+    if ( extended )
+        UpdateSumDelta(node);
+
+    return extended;
+}
+
+int wxGridLinesGeometry::GetRawSize(int line) const
+{
+    int shift = 0;
+    for ( const Node *node = m_root; node; )
+    {
+        shift += node->shift;
+
+        const int nodeLine = node->line + shift;
+        if ( line < nodeLine )
+            node = node->left;
+        else if ( line < nodeLine + node->count )
+            return node->size;
+        else
+            node = node->right;
+    }
+
+    return m_sizeDefault;
+}
+
+void wxGridLinesGeometry::SetRawSizes(int line, int num, int size)
+{
+    if ( num <= 0 )
+        return;
+
+    Node *left, *middle, *right;
+    Split(m_root, line, left, right);
+    Split(right, line + num, middle, right);
+
+    DeleteSubtree(middle);
+    middle = NULL;
+
+    // reuse the adjacent runs if they have the same size to keep the tree
+    // small when the lines are resized one by one
+    if ( size != m_sizeDefault &&
+            !ExtendLast(left, line, num, size) &&
+                !ExtendFirst(right, line, num, size) )
+    {
+        middle = new Node(line, num, size, GetNextPriority());
+        UpdateSumDelta(middle);
+    }
+
+    m_root = Merge(Merge(left, middle), right);
+}
+
+void wxGridLinesGeometry::SetDefaultSize(int sizeDefault, int numLines)
+{
+    if ( sizeDefault == m_sizeDefault )
+        return;
+
+    wxVector<Run> runs;
+    DoGetRuns(m_root, 0, runs);
+
+    DeleteSubtree(m_root);
+    m_root = NULL;
+
+    const int sizeOld = m_sizeDefault;
+    m_sizeDefault = sizeDefault;
+
+    // the lines between the runs keep their old default size, which is now
+    // a custom one
+    int next = 0;
+    for ( size_t n = 0; n < runs.size(); n++ )
+    {
+        const Run& run = runs[n];
+
+        SetRawSizes(next, run.line - next, sizeOld);
+        SetRawSizes(run.line, run.count, run.size);
+
+        next = run.line + run.count;
+    }
+
+    SetRawSizes(next, numLines - next, sizeOld);
+}
+
+int wxGridLinesGeometry::GetStart(int line) const
+{
+    int start = line*m_sizeDefault;
+
+    int shift = 0;
+    for ( const Node *node = m_root; node; )
+    {
+        shift += node->shift;
+
+        const int nodeLine = node->line + shift;
+        if ( line <= nodeLine )
+        {
+            node = node->left;
+        }
+        else if ( line < nodeLine + node->count )
+        {
+            // the line is inside this run
+            start += GetSumDelta(node->left) +
+                        (line - nodeLine)*GetLineDelta(node);
+            break;
         }
+        else
+        {
+            start += GetSumDelta(node->left) + GetDelta(node);
+            node = node->right;
+        }
+    }
+
+    return start;
+}
+
+int wxGridLinesGeometry::FindLine(int coord) const
+{
+    // the index of the last line of the last run before the given position
+    // and the end of this run
+    int linePrev = -1,
+        endPrev = 0;
+
+    // the sum of deltas of all the lines before the current subtree
+    int sumDelta = 0;
+
+    int shift = 0;
+    for ( const Node *node = m_root; node; )
+    {
+        shift += node->shift;
+
+        const int line = node->line + shift;
+        const int start = line*m_sizeDefault + sumDelta +
+                            GetSumDelta(node->left);
+        if ( coord < start )
+        {
+            node = node->left;
+            continue;
+        }
+
+        const int sizeLine = wxMax(node->size, 0);
+        const int end = start + node->count*sizeLine;
+        if ( coord < end )
+            return line + (coord - start) / sizeLine;
+
+        linePrev = line + node->count - 1;
+        endPrev = end;
+
+        sumDelta += GetSumDelta(node->left) + GetDelta(node);
+        node = node->right;
+    }
+
+    // the position is inside the lines of default size following the last
+    // run found above
+    if ( m_sizeDefault <= 0 )
+        return linePrev + 1;
+
+    return linePrev + 1 + (coord - endPrev) / m_sizeDefault;
+}
+
+void wxGridLinesGeometry::InsertLines(int pos, int num)
+{
+    Node *left, *right;
+    Split(m_root, pos, left, right);
+
+    if ( right )
+        right->shift += num;
+
+    m_root = Merge(left, right);
+}
+
+void wxGridLinesGeometry::DeleteLines(int pos, int num)
+{
+    Node *left, *middle, *right;
+    Split(m_root, pos, left, right);
+    Split(right, pos + num, middle, right);
+
+    DeleteSubtree(middle);
+
+    if ( right )
+        right->shift -= num;
+
+    m_root = Merge(left, right);
+}
+
+void wxGridLinesGeometry::GetCustomSizes(wxUnsignedToIntHashMap& sizes) const
+{
+    wxVector<Run> runs;
+    DoGetRuns(m_root, 0, runs);
+
+    for ( size_t n = 0; n < runs.size(); n++ )
+    {
+        const Run& run = runs[n];
+        for ( int line = run.line; line < run.line + run.count; line++ )
+            sizes[line] = run.size;
+    }
+}
+
+/* static */
+void wxGridLinesGeometry::DoGetRuns(const Node *node,
+                                    int shift,
+                                    wxVector<Run>& runs)
+{
+    for ( ; node; node = node->right )
+    {
+        shift += node->shift;
+
+        DoGetRuns(node->left, shift, runs);
+
+        runs.push_back(Run(node->line + shift, node->count, node->size));
     }
 }
 
@@ -2178,6 +2583,8 @@ wxGrid::~wxGrid()
     ClearAttrCache();
     wxSafeDecRef(m_defaultCellAttr);
 
+    delete m_rowsGeometry;
+
 #ifdef DEBUG_ATTR_CACHE
     size_t total = gs_nAttrCacheHits + gs_nAttrCacheMisses;
     wxPrintf(wxT("wxGrid attribute cache statistics: "
@@ -2367,8 +2774,7 @@ wxGrid::SetTable(wxGridTableBase *table,
         // kill row and column size arrays
         m_colWidths.Empty();
         m_colRights.Empty();
-        m_rowHeights.Empty();
-        m_rowBottoms.Empty();
+        wxDELETE(m_rowsGeometry);
     }
 
     if (table)
@@ -2461,10 +2867,15 @@ void wxGrid::Init()
 
     m_defaultColWidth  = WXGRID_DEFAULT_COL_WIDTH;
     m_defaultRowHeight = 0; // this will be initialized after creation
+    m_rowsGeometry = NULL;
 
     m_minAcceptableColWidth  = WXGRID_MIN_COL_WIDTH;
     m_minAcceptableRowHeight = WXGRID_MIN_ROW_HEIGHT;
 
+    m_autoSizeSampleSize = 0;
+    m_autoSizeTimeLimit = 0;
+    m_autoSizeExtentCache = NULL;
+
     m_gridLineColour = wxColour( 192,192,192 );
     m_gridLinesEnabled = true;
     m_gridLinesClipHorz =
@@ -2529,27 +2940,15 @@ void wxGrid::Init()
 // default widths/heights are used for all rows/columns, we may not use these
 // arrays at all
 //
-// with some extra code, it should be possible to only store the widths/heights
-// different from default ones (resulting in space savings for huge grids) but
-// this is not done currently
+// rows only store the heights different from the default one (resulting in
+// space savings for huge grids) but the columns still use arrays as there are
+// usually much fewer of them and they can be reordered
 // ----------------------------------------------------------------------------
 
 void wxGrid::InitRowHeights()
 {
-    m_rowHeights.Empty();
-    m_rowBottoms.Empty();
-
-    m_rowHeights.Alloc( m_numRows );
-    m_rowBottoms.Alloc( m_numRows );
-
-    m_rowHeights.Add( m_defaultRowHeight, m_numRows );
-
-    int rowBottom = 0;
-    for ( int i = 0; i < m_numRows; i++ )
-    {
-        rowBottom += m_defaultRowHeight;
-        m_rowBottoms.Add( rowBottom );
-    }
+    delete m_rowsGeometry;
+    m_rowsGeometry = new wxGridLinesGeometry(m_defaultRowHeight);
 }
 
 void wxGrid::InitColWidths()
@@ -2595,25 +2994,25 @@ int wxGrid::GetColRight(int col) const
 int wxGrid::GetRowHeight(int row) const
 {
     // no custom heights / hidden rows
-    if ( m_rowHeights.IsEmpty() )
+    if ( !m_rowsGeometry )
         return m_defaultRowHeight;
 
     // a negative height indicates a hidden row
-    return m_rowHeights[row] > 0 ? m_rowHeights[row] : 0;
+    return m_rowsGeometry->GetSize(row);
 }
 
 int wxGrid::GetRowTop(int row) const
 {
-    if ( m_rowBottoms.IsEmpty() )
+    if ( !m_rowsGeometry )
         return row * m_defaultRowHeight;
 
-    return m_rowBottoms[row] - GetRowHeight(row);
+    return m_rowsGeometry->GetStart(row);
 }
 
 int wxGrid::GetRowBottom(int row) const
 {
-    return m_rowBottoms.IsEmpty() ? (row + 1) * m_defaultRowHeight
-                                  : m_rowBottoms[row];
+    return m_rowsGeometry ? m_rowsGeometry->GetEnd(row)
+                          : (row + 1) * m_defaultRowHeight;
 }
 
 void wxGrid::CalcDimensions()
@@ -2737,20 +3136,9 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
 
             m_numRows += numRows;
 
-            if ( !m_rowHeights.IsEmpty() )
+            if ( m_rowsGeometry )
             {
-                m_rowHeights.Insert( m_defaultRowHeight, pos, numRows );
-                m_rowBottoms.Insert( 0, pos, numRows );
-
-                int bottom = 0;
-                if ( pos > 0 )
-                    bottom = m_rowBottoms[pos - 1];
-
-                for ( i = pos; i < m_numRows; i++ )
-                {
-                    bottom += GetRowHeight(i);
-                    m_rowBottoms[i] = bottom;
-                }
+                m_rowsGeometry->InsertLines(pos, numRows);
             }
 
             if ( m_currentCellCoords == wxGridNoCellCoords )
@@ -2779,24 +3167,10 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
         case wxGRIDTABLE_NOTIFY_ROWS_APPENDED:
         {
             int numRows = msg.GetCommandInt();
-            int oldNumRows = m_numRows;
             m_numRows += numRows;
 
-            if ( !m_rowHeights.IsEmpty() )
-            {
-                m_rowHeights.Add( m_defaultRowHeight, numRows );
-                m_rowBottoms.Add( 0, numRows );
-
-                int bottom = 0;
-                if ( oldNumRows > 0 )
-                    bottom = m_rowBottoms[oldNumRows - 1];
-
-                for ( i = oldNumRows; i < m_numRows; i++ )
-                {
-                    bottom += GetRowHeight(i);
-                    m_rowBottoms[i] = bottom;
-                }
-            }
+            // nothing to do for m_rowsGeometry when appending, all rows after
+            // the last one implicitly have the default size
 
             if ( m_currentCellCoords == wxGridNoCellCoords )
             {
@@ -2821,18 +3195,8 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             int numRows = msg.GetCommandInt2();
             m_numRows -= numRows;
 
-            if ( !m_rowHeights.IsEmpty() )
-            {
-                m_rowHeights.RemoveAt( pos, numRows );
-                m_rowBottoms.RemoveAt( pos, numRows );
-
-                int h = 0;
-                for ( i = 0; i < m_numRows; i++ )
-                {
-                    h += GetRowHeight(i);
-                    m_rowBottoms[i] = h;
-                }
-            }
+            if ( m_rowsGeometry )
+                m_rowsGeometry->DeleteLines(pos, numRows);
 
             if ( !m_numRows )
             {
@@ -6559,8 +6923,8 @@ wxGridCellCoords wxGrid::XYToCell(int x, int y) const
 }
 
 // compute row or column from some (unscrolled) coordinate value, using either
-// m_defaultRowHeight/m_defaultColWidth or binary search on array of
-// m_rowBottoms/m_colRights to do it quickly in O(log n) time.
+// m_defaultRowHeight/m_defaultColWidth or m_rowsGeometry/m_colRights to do it
+// quickly in O(log n) time.
 // NOTE: This may not work correctly for reordered columns.
 int wxGrid::PosToLinePos(int coord,
                          bool clipToMinMax,
@@ -6574,59 +6938,11 @@ int wxGrid::PosToLinePos(int coord,
     const int defaultLineSize = oper.GetDefaultLineSize(this);
     wxCHECK_MSG( defaultLineSize, -1, "can't have 0 default line size" );
 
-    int maxPos = coord / defaultLineSize,
-        minPos = 0;
-
-    // check for the simplest case: if we have no explicit line sizes
-    // configured, then we already know the line this position falls in
-    const wxArrayInt& lineEnds = oper.GetLineEnds(this);
-    if ( lineEnds.empty() )
-    {
-        if ( maxPos < numLines )
-            return maxPos;
-
-        return clipToMinMax ? numLines - 1 : -1;
-    }
-
+    const int pos = oper.FindLinePos(this, coord);
+    if ( pos < numLines )
+        return pos;
 
-    // binary search is quite efficient and we can't really make any assumptions
-    // on where to start here since row and columns could be of size 0 if they are
-    // hidden. While this could be made more efficient, some profiling will be
-    // necessary to determine if it really is a performance bottleneck
-    maxPos = numLines  - 1;
-
-    // check if the position is beyond the last column
-    const int lineAtMaxPos = oper.GetLineAt(this, maxPos);
-    if ( coord >= lineEnds[lineAtMaxPos] )
-        return clipToMinMax ? maxPos : -1;
-
-    // or before the first one
-    const int lineAt0 = oper.GetLineAt(this, 0);
-    if ( coord < lineEnds[lineAt0] )
-        return 0;
-
-
-    // finally do perform the binary search
-    while ( minPos < maxPos )
-    {
-        wxCHECK_MSG( lineEnds[oper.GetLineAt(this, minPos)] <= coord &&
-                        coord < lineEnds[oper.GetLineAt(this, maxPos)],
-                     -1,
-                     "wxGrid: internal error in PosToLinePos()" );
-
-        if ( coord >= lineEnds[oper.GetLineAt(this, maxPos - 1)] )
-            return maxPos;
-        else
-            maxPos--;
-
-        const int median = minPos + (maxPos - minPos + 1) / 2;
-        if ( coord < lineEnds[oper.GetLineAt(this, median)] )
-            maxPos = median;
-        else
-            minPos = median;
-    }
-
-    return maxPos;
+    return clipToMinMax ? numLines - 1 : -1;
 }
 
 int
@@ -8175,14 +8491,18 @@ void wxGrid::SetDefaultRowSize( int height, bool resizeExistingRows )
     if ( resizeExistingRows )
     {
         // since we are resizing all rows to the default row size,
-        // we can simply clear the row heights and row bottoms
-        // arrays (which also allows us to take advantage of
-        // some speed optimisations)
-        m_rowHeights.Empty();
-        m_rowBottoms.Empty();
+        // we can simply forget about the custom row heights (which
+        // also allows us to take advantage of some speed optimisations)
+        wxDELETE(m_rowsGeometry);
         if ( !GetBatchCount() )
             CalcDimensions();
     }
+    else if ( m_rowsGeometry )
+    {
+        // the existing rows keep their heights while the new ones will use
+        // the new default height
+        m_rowsGeometry->SetDefaultSize(m_defaultRowHeight, m_numRows);
+    }
 }
 
 namespace
@@ -8271,20 +8591,18 @@ void wxGrid::DoSetRowSize( int row, int height )
 {
     wxCHECK_RET( row >= 0 && row < m_numRows, wxT("invalid row index") );
 
-    if ( m_rowHeights.IsEmpty() )
+    if ( !m_rowsGeometry )
     {
-        // need to really create the array
+        // need to really create the geometry object
         InitRowHeights();
     }
 
-    const int diff = UpdateRowOrColSize(m_rowHeights[row], height);
+    int heightCurrent = m_rowsGeometry->GetRawSize(row);
+    const int diff = UpdateRowOrColSize(heightCurrent, height);
     if ( !diff )
         return;
 
-    for ( int i = row; i < m_numRows; i++ )
-    {
-        m_rowBottoms[i] += diff;
-    }
+    m_rowsGeometry->SetRawSize(row, heightCurrent);
 
     InvalidateBestSize();
 
@@ -8450,6 +8768,117 @@ int  wxGrid::GetRowMinimalAcceptableHeight() const
 // auto sizing
 // ----------------------------------------------------------------------------
 
+namespace
+{
+
+// add the given index to the sample unless it's already part of it
+void AddToAutoSizeSample(wxArrayInt& sample, wxGridIndexSet& indices, int n)
+{
+    if ( indices.insert(n).second )
+        sample.push_back(n);
+}
+
+// the length of the value of a cell, used to find the longest ones
+struct wxGridValueLength
+{
+    wxGridValueLength(int index_, size_t length_)
+        : index(index_), length(length_)
+    {
+    }
+
+    int index;
+    size_t length;
+};
+
+bool IsLongerValue(const wxGridValueLength& v1, const wxGridValueLength& v2)
+{
+    return v1.length > v2.length;
+}
+
+} // anonymous namespace
+
+wxArrayInt wxGrid::GetAutoSizeSample(int colOrRow, wxGridDirection direction)
+{
+    const bool column = direction == wxGRID_COLUMN;
+    const int max = column ? m_numRows : m_numCols;
+    const size_t sampleSize = wxMin(m_autoSizeSampleSize, max);
+
+    wxArrayInt sample;
+    sample.reserve(sampleSize);
+
+    wxGridIndexSet indices;
+
+    // the cells currently shown on screen come first, as it would be really
+    // bad if they didn't fit
+    int x, y;
+    CalcUnscrolledPosition(0, 0, &x, &y);
+    const wxSize sizeWin = m_gridWin->GetClientSize();
+
+    int posFirst, posLast;
+    if ( column )
+    {
+        posFirst = YToRow(y, true);
+        posLast = YToRow(y + sizeWin.y, true);
+    }
+    else
+    {
+        posFirst = GetColPos(XToCol(x, true));
+        posLast = GetColPos(XToCol(x + sizeWin.x, true));
+    }
+
+    for ( int pos = posFirst; pos <= posLast && sample.size() < sampleSize; pos++ )
+        AddToAutoSizeSample(sample, indices, column ? pos : GetColAt(pos));
+
+    // then the cells at the very beginning and the end, which are likely to
+    // be looked at too
+    const int numEdge = wxMin(8, max / 2);
+    for ( int n = 0; n < numEdge && sample.size() < sampleSize; n++ )
+    {
+        AddToAutoSizeSample(sample, indices, n);
+        AddToAutoSizeSample(sample, indices, max - 1 - n);
+    }
+
+    // then the cells with the longest values among a bigger pool of evenly
+    // spread cells: checking the value length is much cheaper than measuring
+    // it and the longest values are the most likely to be the widest ones
+    const int numPool = wxMin(4*sampleSize, static_cast<size_t>(max));
+    if ( sample.size() < sampleSize && numPool > 0 )
+    {
+        wxVector<wxGridValueLength> lengths;
+        lengths.reserve(numPool);
+
+        const int stepPool = max / numPool;
+        for ( int n = 0; n < max; n += stepPool )
+        {
+            lengths.push_back
+                    (
+                        wxGridValueLength
+                        (
+                            n,
+                            (column ? GetCellValue(n, colOrRow)
+                                    : GetCellValue(colOrRow, n)).length()
+                        )
+                    );
+        }
+
+        std::sort(lengths.begin(), lengths.end(), IsLongerValue);
+
+        const size_t numLongest = wxMin(sampleSize / 4, lengths.size());
+        for ( size_t n = 0; n < numLongest && sample.size() < sampleSize; n++ )
+            AddToAutoSizeSample(sample, indices, lengths[n].index);
+    }
+
+    // and finally fill the rest of the sample uniformly
+    if ( sample.size() < sampleSize )
+    {
+        const int step = wxMax(1, max / static_cast<int>(sampleSize - sample.size()));
+        for ( int n = step / 2; n < max && sample.size() < sampleSize; n += step )
+            AddToAutoSizeSample(sample, indices, n);
+    }
+
+    return sample;
+}
+
 void
 wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
 {
@@ -8470,6 +8899,10 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
 
     wxClientDC dc(m_gridWin);
 
+    // reuse the extents of the strings already measured, this is especially
+    // useful when auto-sizing all columns or rows at once
+    wxGridTextExtentCacheUser cacheUser(m_autoSizeExtentCache);
+
     // cancel editing of cell
     HideCellEditControl();
     SaveEditControlValue();
@@ -8489,10 +8922,32 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
         col = -1;
     }
 
+    // for big grids, only measure a sample of all cells if requested
+    const int max = column ? m_numRows : m_numCols;
+    const bool useSample = m_autoSizeSampleSize > 0 &&
+                                max > m_autoSizeSampleSize;
+    const wxArrayInt sample = useSample ? GetAutoSizeSample(colOrRow, direction)
+                                        : wxArrayInt();
+    const int count = useSample ? static_cast<int>(sample.size()) : max;
+
+#if wxUSE_STOPWATCH
+    // don't use the local time for this as it jumps when DST changes
+    wxStopWatch sw;
+#endif // wxUSE_STOPWATCH
+
     wxCoord extent, extentMax = 0;
-    int max = column ? m_numRows : m_numCols;
-    for ( int rowOrCol = 0; rowOrCol < max; rowOrCol++ )
+    for ( int n = 0; n < count; n++ )
     {
+#if wxUSE_STOPWATCH
+        // don't check the time too often as it's not free either
+        if ( m_autoSizeTimeLimit > 0 && n && !(n % 64) )
+        {
+            if ( sw.Time() > m_autoSizeTimeLimit )
+                break;
+        }
+#endif // wxUSE_STOPWATCH
+
+        const int rowOrCol = useSample ? sample[n] : n;
         if ( column )
         {
             if ( !IsRowShown(rowOrCol) )
@@ -8710,6 +9165,8 @@ int wxGrid::SetOrCalcColumnSizes(bool calcOnly, bool setAsMin)
     if(!calcOnly)
         locker.Create(this);
 
+    wxGridTextExtentCacheUser cacheUser(m_autoSizeExtentCache);
+
     for ( int col = 0; col < m_numCols; col++ )
     {
         if ( !calcOnly )
@@ -8729,6 +9186,8 @@ int wxGrid::SetOrCalcRowSizes(bool calcOnly, bool setAsMin)
     if(!calcOnly)
         locker.Create(this);
 
+    wxGridTextExtentCacheUser cacheUser(m_autoSizeExtentCache);
+
     for ( int row = 0; row < m_numRows; row++ )
     {
         if ( !calcOnly )
@@ -8969,7 +9428,18 @@ wxGridCellCoordsArray wxGrid::GetSelectedCells() const
         return a;
     }
 
-    return m_selection->m_cellSelection;
+    wxGridCellCoordsArray cells;
+    cells.reserve(m_selection->m_cellSelection->size());
+
+    for ( wxGridCellCoordsSet::const_iterator
+            it = m_selection->m_cellSelection->begin();
+          it != m_selection->m_cellSelection->end();
+          ++it )
+    {
+        cells.push_back(*it);
+    }
+
+    return cells;
 }
 
 wxGridCellCoordsArray wxGrid::GetSelectionBlockTopLeft() const
@@ -9002,7 +9472,7 @@ wxArrayInt wxGrid::GetSelectedRows() const
         return a;
     }
 
-    return m_selection->m_rowSelection;
+    return m_selection->m_rowSelection.AsArray();
 }
 
 wxArrayInt wxGrid::GetSelectedCols() const
@@ -9013,7 +9483,7 @@ wxArrayInt wxGrid::GetSelectedCols() const
         return a;
     }
 
-    return m_selection->m_colSelection;
+    return m_selection->m_colSelection.AsArray();
 }
 
 void wxGrid::ClearSelection()
@@ -9187,6 +9657,21 @@ void wxGrid::SetRowSizes(const wxGridSizesInfo& sizeInfo)
     DoSetSizes(sizeInfo, wxGridRowOperations());
 }
 
+wxGridSizesInfo wxGrid::GetRowSizes() const
+{
+    wxGridSizesInfo sizeInfo;
+    sizeInfo.m_sizeDefault = GetDefaultRowSize();
+
+    if ( !m_rowsGeometry )
+        return sizeInfo;
+
+    // only the rows with custom heights need to be stored as the default
+    // height of the geometry object is always the same as ours
+    m_rowsGeometry->GetCustomSizes(sizeInfo.m_customSizes);
+
+    return sizeInfo;
+}
+
 wxGridSizesInfo::wxGridSizesInfo(int defSize, const wxArrayInt& allSizes)
 {
     m_sizeDefault = defSize;
@@ -30,6 +30,9 @@
 
 #include "wx/tokenzr.h"
 #include "wx/renderer.h"
+#include "wx/headerctrl.h"
+
+#include "wx/generic/private/grid.h"
 
 
 // ----------------------------------------------------------------------------
@@ -163,7 +166,7 @@ wxSize wxGridCellDateRenderer::GetBestSize(wxGrid& grid,
                                            wxDC& dc,
                                            int row, int col)
 {
-    return DoGetBestSize(attr, dc, GetString(grid, row, col));
+    return DoGetBestSize(grid, attr, dc, GetString(grid, row, col));
 }
 
 void wxGridCellDateRenderer::SetParameters(const wxString& params)
@@ -261,7 +264,7 @@ wxSize wxGridCellEnumRenderer::GetBestSize(wxGrid& grid,
                                             wxDC& dc,
                                             int row, int col)
 {
-    return DoGetBestSize(attr, dc, GetString(grid, row, col));
+    return DoGetBestSize(grid, attr, dc, GetString(grid, row, col));
 }
 
 void wxGridCellEnumRenderer::SetParameters(const wxString& params)
@@ -555,22 +558,48 @@ void wxGridCellStringRenderer::SetTextColoursAndFont(const wxGrid& grid,
     dc.SetFont( attr.GetFont() );
 }
 
-wxSize wxGridCellStringRenderer::DoGetBestSize(const wxGridCellAttr& attr,
-                                               wxDC& dc,
-                                               const wxString& text)
+namespace
 {
-    wxCoord x = 0, y = 0, max_x = 0;
-    dc.SetFont(attr.GetFont());
+
+// common part of both wxGridCellStringRenderer::DoGetBestSize() overloads
+wxSize
+DoGetMultiLineBestSize(wxDC& dc,
+                       const wxString& text,
+                       wxGridTextExtentCache* cache)
+{
+    wxCoord max_x = 0;
+    wxSize size;
     wxStringTokenizer tk(text, wxT('\n'));
     while ( tk.HasMoreTokens() )
     {
-        dc.GetTextExtent(tk.GetNextToken(), &x, &y);
-        max_x = wxMax(max_x, x);
+        const wxString line = tk.GetNextToken();
+        size = cache ? cache->GetTextExtent(dc, line) : dc.GetTextExtent(line);
+        max_x = wxMax(max_x, size.x);
     }
 
-    y *= 1 + text.Freq(wxT('\n')); // multiply by the number of lines.
+    // multiply by the number of lines.
+    return wxSize(max_x, size.y * (1 + text.Freq(wxT('\n'))));
+}
+
+} // anonymous namespace
+
+wxSize wxGridCellStringRenderer::DoGetBestSize(const wxGridCellAttr& attr,
+                                               wxDC& dc,
+                                               const wxString& text)
+{
+    dc.SetFont(attr.GetFont());
+
+    return DoGetMultiLineBestSize(dc, text, NULL);
+}
+
+wxSize wxGridCellStringRenderer::DoGetBestSize(const wxGrid& grid,
+                                               const wxGridCellAttr& attr,
+                                               wxDC& dc,
+                                               const wxString& text)
+{
+    dc.SetFont(attr.GetFont());
 
-    return wxSize(max_x, y);
+    return DoGetMultiLineBestSize(dc, text, grid.GetAutoSizeExtentCache());
 }
 
 wxSize wxGridCellStringRenderer::GetBestSize(wxGrid& grid,
@@ -578,7 +607,7 @@ wxSize wxGridCellStringRenderer::GetBestSize(wxGrid& grid,
                                              wxDC& dc,
                                              int row, int col)
 {
-    return DoGetBestSize(attr, dc, grid.GetCellValue(row, col));
+    return DoGetBestSize(grid, attr, dc, grid.GetCellValue(row, col));
 }
 
 void wxGridCellStringRenderer::Draw(wxGrid& grid,
@@ -724,7 +753,7 @@ wxSize wxGridCellNumberRenderer::GetBestSize(wxGrid& grid,
                                              wxDC& dc,
                                              int row, int col)
 {
-    return DoGetBestSize(attr, dc, GetString(grid, row, col));
+    return DoGetBestSize(grid, attr, dc, GetString(grid, row, col));
 }
 
 // ----------------------------------------------------------------------------
@@ -839,7 +868,7 @@ wxSize wxGridCellFloatRenderer::GetBestSize(wxGrid& grid,
                                             wxDC& dc,
                                             int row, int col)
 {
-    return DoGetBestSize(attr, dc, GetString(grid, row, col));
+    return DoGetBestSize(grid, attr, dc, GetString(grid, row, col));
 }
 
 void wxGridCellFloatRenderer::SetParameters(const wxString& params)
@@ -25,72 +25,224 @@
 
 #if wxUSE_GRID
 
+#include "wx/dc.h"
+#include "wx/headerctrl.h"
+
 #include "wx/generic/gridsel.h"
+#include "wx/generic/private/grid.h"
+
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+// wxGridLineRangeSet
+// ----------------------------------------------------------------------------
+
+size_t wxGridLineRangeSet::FindRange(int line) const
+{
+    // Binary search for the first range ending at or after the given line.
+    size_t lo = 0,
+           hi = m_ranges.size();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( m_ranges[mid].to < line )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
 
+    return lo;
+}
+
+bool wxGridLineRangeSet::Contains(int line) const
+{
+    const size_t n = FindRange(line);
+
+    return n < m_ranges.size() && m_ranges[n].from <= line;
+}
+
+void wxGridLineRangeSet::Add(int from, int to)
+{
+    wxCHECK_RET( from <= to, "invalid range" );
+
+    // Find the first range which overlaps or is adjacent to the new one.
+    const size_t first = FindRange(from - 1);
+
+    // And merge all the ranges starting not after the end of the new one
+    // (or immediately after it) into it.
+    size_t last = first;
+    while ( last < m_ranges.size() && m_ranges[last].from <= to + 1 )
+    {
+        if ( m_ranges[last].from < from )
+            from = m_ranges[last].from;
+        if ( m_ranges[last].to > to )
+            to = m_ranges[last].to;
+
+        last++;
+    }
+
+    if ( last == first )
+    {
+        m_ranges.insert(m_ranges.begin() + first, Range(from, to));
+    }
+    else
+    {
+        m_ranges[first] = Range(from, to);
+        m_ranges.erase(m_ranges.begin() + first + 1, m_ranges.begin() + last);
+    }
+}
+
+void wxGridLineRangeSet::Remove(int from, int to)
+{
+    wxCHECK_RET( from <= to, "invalid range" );
+
+    size_t n = FindRange(from);
+    while ( n < m_ranges.size() && m_ranges[n].from <= to )
+    {
+        Range& r = m_ranges[n];
+        if ( r.from < from )
+        {
+            if ( r.to > to )
+            {
+                // The removed lines are in the middle of this range, split it.
+                const Range tail(to + 1, r.to);
+                r.to = from - 1;
+                m_ranges.insert(m_ranges.begin() + n + 1, tail);
+                return;
+            }
+
+            // Just truncate this range.
+            r.to = from - 1;
+            n++;
+        }
+        else if ( r.to > to )
+        {
+            // Remove the beginning of this range, it's the last one affected.
+            r.from = to + 1;
+            return;
+        }
+        else // This range is entirely removed.
+        {
+            m_ranges.erase(m_ranges.begin() + n);
+        }
+    }
+}
+
+void wxGridLineRangeSet::UpdateLines(size_t pos, int numLines)
+{
+    if ( !numLines || m_ranges.empty() )
+        return;
+
+    const int start = static_cast<int>(pos);
+
+    if ( numLines < 0 )
+    {
+        // Remove the lines being deleted and then shift the subsequent ones.
+        Remove(start, start - numLines - 1);
+
+        for ( size_t n = FindRange(start); n < m_ranges.size(); n++ )
+        {
+            m_ranges[n].from += numLines;
+            m_ranges[n].to += numLines;
+        }
+
+        // The ranges before and after the deleted lines may have become
+        // adjacent now, merge them in this case.
+        const size_t n = FindRange(start - 1);
+        if ( n + 1 < m_ranges.size() && m_ranges[n].to + 1 == m_ranges[n + 1].from )
+        {
+            m_ranges[n].to = m_ranges[n + 1].to;
+            m_ranges.erase(m_ranges.begin() + n + 1);
+        }
+    }
+    else // lines inserted
+    {
+        size_t n = FindRange(start);
+        if ( n < m_ranges.size() && m_ranges[n].from < start )
+        {
+            // The new lines are inserted in the middle of this range, split
+            // it as they are not selected.
+            const Range tail(start, m_ranges[n].to);
+            m_ranges[n].to = start - 1;
+            m_ranges.insert(m_ranges.begin() + n + 1, tail);
+            n++;
+        }
+
+        for ( ; n < m_ranges.size(); n++ )
+        {
+            m_ranges[n].from += numLines;
+            m_ranges[n].to += numLines;
+        }
+    }
+}
+
+wxArrayInt wxGridLineRangeSet::AsArray() const
+{
+    wxArrayInt lines;
+    for ( size_t n = 0; n < m_ranges.size(); n++ )
+    {
+        for ( int line = m_ranges[n].from; line <= m_ranges[n].to; line++ )
+            lines.Add(line);
+    }
+
+    return lines;
+}
+
+// ----------------------------------------------------------------------------
+// wxGridSelection
+// ----------------------------------------------------------------------------
 
 // Some explanation for the members of the class:
 // m_cellSelection stores individual selected cells
 //   -- this is only used if m_selectionMode == wxGridSelectCells
 // m_blockSelectionTopLeft and m_blockSelectionBottomRight
 //   store the upper left and lower right corner of selected Blocks
-// m_rowSelection and m_colSelection store individual selected
-//   rows and columns; maybe those are superfluous and should be
-//   treated as blocks?
+// m_rowSelection and m_colSelection store selected rows and columns as
+//   ranges, so that even selecting all the rows of a huge grid is cheap
 
 wxGridSelection::wxGridSelection( wxGrid * grid,
                                   wxGrid::wxGridSelectionModes sel )
 {
     m_grid = grid;
     m_selectionMode = sel;
+    m_cellSelection = new wxGridCellCoordsSet;
+    m_blocksIndexValid = true;
+}
+
+wxGridSelection::~wxGridSelection()
+{
+    delete m_cellSelection;
 }
 
 bool wxGridSelection::IsSelection()
 {
-  return ( m_cellSelection.GetCount() || m_blockSelectionTopLeft.GetCount() ||
-           m_rowSelection.GetCount() || m_colSelection.GetCount() );
+  return ( !m_cellSelection->empty() || m_blockSelectionTopLeft.GetCount() ||
+           !m_rowSelection.IsEmpty() || !m_colSelection.IsEmpty() );
 }
 
 bool wxGridSelection::IsInSelection( int row, int col )
 {
-    size_t count;
-
     // First check whether the given cell is individually selected
     // (if m_selectionMode is wxGridSelectCells).
     if ( m_selectionMode == wxGrid::wxGridSelectCells )
     {
-        count = m_cellSelection.GetCount();
-        for ( size_t n = 0; n < count; n++ )
-        {
-            wxGridCellCoords& coords = m_cellSelection[n];
-            if ( row == coords.GetRow() && col == coords.GetCol() )
-                return true;
-        }
+        if ( m_cellSelection->find(wxGridCellCoords(row, col)) !=
+                m_cellSelection->end() )
+            return true;
     }
 
     // Now check whether the given cell is
     // contained in one of the selected blocks.
-    count = m_blockSelectionTopLeft.GetCount();
-    for ( size_t n = 0; n < count; n++ )
-    {
-        wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
-        wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
-        if ( BlockContainsCell(coords1.GetRow(), coords1.GetCol(),
-                               coords2.GetRow(), coords2.GetCol(),
-                               row, col ) )
-            return true;
-    }
+    if ( IsInSelectedBlock(row, col) )
+        return true;
 
     // Now check whether the given cell is
     // contained in one of the selected rows
     // (unless we are in column selection mode).
     if ( m_selectionMode != wxGrid::wxGridSelectColumns )
     {
-        count = m_rowSelection.GetCount();
-        for ( size_t n = 0; n < count; n++ )
-        {
-            if ( row == m_rowSelection[n] )
-              return true;
-        }
+        if ( m_rowSelection.Contains(row) )
+            return true;
     }
 
     // Now check whether the given cell is
@@ -98,12 +250,8 @@ bool wxGridSelection::IsInSelection( int row, int col )
     // (unless we are in row selection mode).
     if ( m_selectionMode != wxGrid::wxGridSelectRows )
     {
-        count = m_colSelection.GetCount();
-        for ( size_t n = 0; n < count; n++ )
-        {
-            if ( col == m_colSelection[n] )
-              return true;
-        }
+        if ( m_colSelection.Contains(col) )
+            return true;
     }
 
     return false;
@@ -129,20 +277,20 @@ void wxGridSelection::SetSelectionMode( wxGrid::wxGridSelectionModes selmode )
     {
         // if changing from cell selection to something else,
         // promote selected cells/blocks to whole rows/columns.
-        size_t n;
-        while ( ( n = m_cellSelection.GetCount() ) > 0 )
+        const wxGridCellCoordsSet cells = *m_cellSelection;
+        m_cellSelection->clear();
+        for ( wxGridCellCoordsSet::const_iterator it = cells.begin();
+              it != cells.end();
+              ++it )
         {
-            n--;
-            wxGridCellCoords& coords = m_cellSelection[n];
-            int row = coords.GetRow();
-            int col = coords.GetCol();
-            m_cellSelection.RemoveAt(n);
             if (selmode == wxGrid::wxGridSelectRows)
-                SelectRow( row );
+                SelectRow( it->GetRow() );
             else // selmode == wxGridSelectColumns)
-                SelectCol( col );
+                SelectCol( it->GetCol() );
         }
 
+        size_t n;
+
         // Note that m_blockSelectionTopLeft's size may be changing!
         for ( n = m_blockSelectionTopLeft.GetCount(); n > 0; )
         {
@@ -158,8 +306,7 @@ void wxGridSelection::SetSelectionMode( wxGrid::wxGridSelectionModes selmode )
             {
                 if (leftCol != 0 || rightCol != m_grid->GetNumberCols() - 1 )
                 {
-                    m_blockSelectionTopLeft.RemoveAt(n);
-                    m_blockSelectionBottomRight.RemoveAt(n);
+                    RemoveBlock(n);
                     SelectBlockNoEvent( topRow, 0,
                                  bottomRow, m_grid->GetNumberCols() - 1);
                 }
@@ -168,8 +315,7 @@ void wxGridSelection::SetSelectionMode( wxGrid::wxGridSelectionModes selmode )
             {
                 if (topRow != 0 || bottomRow != m_grid->GetNumberRows() - 1 )
                 {
-                    m_blockSelectionTopLeft.RemoveAt(n);
-                    m_blockSelectionBottomRight.RemoveAt(n);
+                    RemoveBlock(n);
                     SelectBlockNoEvent(0, leftCol,
                                  m_grid->GetNumberRows() - 1, rightCol);
                 }
@@ -190,18 +336,7 @@ void wxGridSelection::SelectRow(int row, const wxKeyboardState& kbd)
     // Remove single cells contained in newly selected block.
     if ( m_selectionMode == wxGrid::wxGridSelectCells )
     {
-        count = m_cellSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            wxGridCellCoords& coords = m_cellSelection[n];
-            if ( BlockContainsCell( row, 0, row, m_grid->GetNumberCols() - 1,
-                                    coords.GetRow(), coords.GetCol() ) )
-            {
-                m_cellSelection.RemoveAt(n);
-                n--;
-                count--;
-            }
-        }
+        RemoveCellsInBlock( row, 0, row, m_grid->GetNumberCols() - 1 );
     }
 
     // Simplify list of selected blocks (if possible)
@@ -210,14 +345,13 @@ void wxGridSelection::SelectRow(int row, const wxKeyboardState& kbd)
 
     for ( n = 0; n < count; n++ )
     {
-        wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
-        wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
+        const wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
+        const wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
 
         // Remove block if it is a subset of the row
         if ( coords1.GetRow() == row && row == coords2.GetRow() )
         {
-            m_blockSelectionTopLeft.RemoveAt(n);
-            m_blockSelectionBottomRight.RemoveAt(n);
+            RemoveBlock(n);
             n--;
             count--;
         }
@@ -230,12 +364,12 @@ void wxGridSelection::SelectRow(int row, const wxKeyboardState& kbd)
             // expand block, if it touched row
             else if ( coords1.GetRow() == row + 1)
             {
-                coords1.SetRow(row);
+                SetBlock(n, wxGridCellCoords(row, coords1.GetCol()), coords2);
                 done = true;
             }
             else if ( coords2.GetRow() == row - 1)
             {
-                coords2.SetRow(row);
+                SetBlock(n, coords1, wxGridCellCoords(row, coords2.GetCol()));
                 done = true;
             }
         }
@@ -245,15 +379,11 @@ void wxGridSelection::SelectRow(int row, const wxKeyboardState& kbd)
     // check whether row is already selected.
     if ( !done )
     {
-        count = m_rowSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            if ( row == m_rowSelection[n] )
-                return;
-        }
+        if ( m_rowSelection.Contains(row) )
+            return;
 
         // Add row to selection
-        m_rowSelection.Add(row);
+        m_rowSelection.Add(row, row);
     }
 
     // Update View:
@@ -285,18 +415,7 @@ void wxGridSelection::SelectCol(int col, const wxKeyboardState& kbd)
     // Remove single cells contained in newly selected block.
     if ( m_selectionMode == wxGrid::wxGridSelectCells )
     {
-        count = m_cellSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            wxGridCellCoords& coords = m_cellSelection[n];
-            if ( BlockContainsCell( 0, col, m_grid->GetNumberRows() - 1, col,
-                                    coords.GetRow(), coords.GetCol() ) )
-            {
-                m_cellSelection.RemoveAt(n);
-                n--;
-                count--;
-            }
-        }
+        RemoveCellsInBlock( 0, col, m_grid->GetNumberRows() - 1, col );
     }
 
     // Simplify list of selected blocks (if possible)
@@ -304,14 +423,13 @@ void wxGridSelection::SelectCol(int col, const wxKeyboardState& kbd)
     bool done = false;
     for ( n = 0; n < count; n++ )
     {
-        wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
-        wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
+        const wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
+        const wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
 
         // Remove block if it is a subset of the column
         if ( coords1.GetCol() == col && col == coords2.GetCol() )
         {
-            m_blockSelectionTopLeft.RemoveAt(n);
-            m_blockSelectionBottomRight.RemoveAt(n);
+            RemoveBlock(n);
             n--;
             count--;
         }
@@ -324,12 +442,12 @@ void wxGridSelection::SelectCol(int col, const wxKeyboardState& kbd)
             // expand block, if it touched col
             else if ( coords1.GetCol() == col + 1)
             {
-                coords1.SetCol(col);
+                SetBlock(n, wxGridCellCoords(coords1.GetRow(), col), coords2);
                 done = true;
             }
             else if ( coords2.GetCol() == col - 1)
             {
-                coords2.SetCol(col);
+                SetBlock(n, coords1, wxGridCellCoords(coords2.GetRow(), col));
                 done = true;
             }
         }
@@ -339,15 +457,11 @@ void wxGridSelection::SelectCol(int col, const wxKeyboardState& kbd)
     // Check whether col is already selected.
     if ( !done )
     {
-        count = m_colSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            if ( col == m_colSelection[n] )
-                return;
-        }
+        if ( m_colSelection.Contains(col) )
+            return;
 
         // Add col to selection
-        m_colSelection.Add(col);
+        m_colSelection.Add(col, col);
     }
 
     // Update View:
@@ -430,67 +544,22 @@ void wxGridSelection::SelectBlock( int topRow, int leftCol,
 
     if ( m_selectionMode == wxGrid::wxGridSelectRows )
     {
-        // find out which rows are already selected:
-        wxArrayInt alreadyselected;
-        alreadyselected.Add(0,bottomRow-topRow+1);
-        for( n = 0; n < m_rowSelection.GetCount(); n++)
-        {
-            int row = m_rowSelection[n];
-            if( (row >= topRow) && (row <= bottomRow) )
-            {
-                alreadyselected[ row - topRow ]=1;
-            }
-        }
-
-        // add the newly selected rows:
-        for ( int row = topRow; row <= bottomRow; row++ )
-        {
-            if ( alreadyselected[ row - topRow ] == 0 )
-            {
-                m_rowSelection.Add( row );
-            }
-        }
+        // add the newly selected rows, merging them with the already
+        // selected ones
+        m_rowSelection.Add( topRow, bottomRow );
     }
     else if ( m_selectionMode == wxGrid::wxGridSelectColumns )
     {
-        // find out which columns are already selected:
-        wxArrayInt alreadyselected;
-        alreadyselected.Add(0,rightCol-leftCol+1);
-        for( n = 0; n < m_colSelection.GetCount(); n++)
-        {
-            int col = m_colSelection[n];
-            if( (col >= leftCol) && (col <= rightCol) )
-            {
-                alreadyselected[ col - leftCol ]=1;
-            }
-        }
-
-        // add the newly selected columns:
-        for ( int col = leftCol; col <= rightCol; col++ )
-        {
-            if ( alreadyselected[ col - leftCol ] == 0 )
-            {
-                m_colSelection.Add( col );
-            }
-        }
+        // add the newly selected columns, merging them with the already
+        // selected ones
+        m_colSelection.Add( leftCol, rightCol );
     }
     else
     {
         // Remove single cells contained in newly selected block.
         if ( m_selectionMode == wxGrid::wxGridSelectCells )
         {
-            count = m_cellSelection.GetCount();
-            for ( n = 0; n < count; n++ )
-            {
-                wxGridCellCoords& coords = m_cellSelection[n];
-                if ( BlockContainsCell( topRow, leftCol, bottomRow, rightCol,
-                                        coords.GetRow(), coords.GetCol() ) )
-                {
-                    m_cellSelection.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
+            RemoveCellsInBlock( topRow, leftCol, bottomRow, rightCol );
         }
 
         // If a block containing the selection is already selected, return,
@@ -510,8 +579,7 @@ void wxGridSelection::SelectBlock( int topRow, int leftCol,
                     return;
 
                 case -1:
-                    m_blockSelectionTopLeft.RemoveAt(n);
-                    m_blockSelectionBottomRight.RemoveAt(n);
+                    RemoveBlock(n);
                     n--;
                     count--;
                     break;
@@ -522,52 +590,21 @@ void wxGridSelection::SelectBlock( int topRow, int leftCol,
         }
 
         // If a row containing the selection is already selected, return,
-        // if a row contained in newly selected block is found, remove it.
-        count = m_rowSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            switch ( BlockContain( m_rowSelection[n], 0,
-                                   m_rowSelection[n], m_grid->GetNumberCols() - 1,
-                                   topRow, leftCol, bottomRow, rightCol ) )
-            {
-                case 1:
-                    return;
-
-                case -1:
-                    m_rowSelection.RemoveAt(n);
-                    n--;
-                    count--;
-                    break;
+        // if rows contained in newly selected block are found, remove them.
+        if ( topRow == bottomRow && m_rowSelection.Contains(topRow) )
+            return;
 
-                default:
-                    break;
-            }
-        }
+        if ( leftCol == 0 && rightCol == m_grid->GetNumberCols() - 1 )
+            m_rowSelection.Remove( topRow, bottomRow );
 
         // Same for columns.
-        count = m_colSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            switch ( BlockContain( 0, m_colSelection[n],
-                                   m_grid->GetNumberRows() - 1, m_colSelection[n],
-                                   topRow, leftCol, bottomRow, rightCol ) )
-            {
-                case 1:
-                    return;
+        if ( leftCol == rightCol && m_colSelection.Contains(leftCol) )
+            return;
 
-                case -1:
-                    m_colSelection.RemoveAt(n);
-                    n--;
-                    count--;
-                    break;
+        if ( topRow == 0 && bottomRow == m_grid->GetNumberRows() - 1 )
+            m_colSelection.Remove( leftCol, rightCol );
 
-                default:
-                    break;
-            }
-        }
-
-        m_blockSelectionTopLeft.Add( wxGridCellCoords( topRow, leftCol ) );
-        m_blockSelectionBottomRight.Add( wxGridCellCoords( bottomRow, rightCol ) );
+        AddBlock( topRow, leftCol, bottomRow, rightCol );
     }
     // Update View:
     if ( !m_grid->GetBatchCount() )
@@ -601,19 +638,19 @@ void wxGridSelection::SelectCell( int row, int col,
     wxGridCellCoords selectedTopLeft, selectedBottomRight;
     if ( m_selectionMode == wxGrid::wxGridSelectRows )
     {
-        m_rowSelection.Add( row );
+        m_rowSelection.Add( row, row );
         selectedTopLeft = wxGridCellCoords( row, 0 );
         selectedBottomRight = wxGridCellCoords( row, m_grid->GetNumberCols() - 1 );
     }
     else if ( m_selectionMode == wxGrid::wxGridSelectColumns )
     {
-        m_colSelection.Add( col );
+        m_colSelection.Add( col, col );
         selectedTopLeft = wxGridCellCoords( 0, col );
         selectedBottomRight = wxGridCellCoords( m_grid->GetNumberRows() - 1, col );
     }
     else
     {
-        m_cellSelection.Add( wxGridCellCoords( row, col ) );
+        m_cellSelection->insert( wxGridCellCoords( row, col ) );
         selectedTopLeft = wxGridCellCoords( row, col );
         selectedBottomRight = wxGridCellCoords( row, col );
     }
@@ -664,32 +701,26 @@ wxGridSelection::ToggleCellSelection(int row, int col,
 
     if ( m_selectionMode == wxGrid::wxGridSelectCells )
     {
-        count = m_cellSelection.GetCount();
-        for ( n = 0; n < count; n++ )
+        const wxGridCellCoords coords(row, col);
+        if ( m_cellSelection->erase(coords) )
         {
-            const wxGridCellCoords& sel = m_cellSelection[n];
-            if ( row == sel.GetRow() && col == sel.GetCol() )
+            if ( !m_grid->GetBatchCount() )
             {
-                wxGridCellCoords coords = m_cellSelection[n];
-                m_cellSelection.RemoveAt(n);
-                if ( !m_grid->GetBatchCount() )
-                {
-                    wxRect r = m_grid->BlockToDeviceRect( coords, coords );
-                    ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
-                }
+                wxRect r = m_grid->BlockToDeviceRect( coords, coords );
+                ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
+            }
 
-                // Send event
-                wxGridRangeSelectEvent gridEvt( m_grid->GetId(),
-                                                wxEVT_GRID_RANGE_SELECT,
-                                                m_grid,
-                                                wxGridCellCoords( row, col ),
-                                                wxGridCellCoords( row, col ),
-                                                false,
-                                                kbd );
-                m_grid->GetEventHandler()->ProcessEvent( gridEvt );
+            // Send event
+            wxGridRangeSelectEvent gridEvt( m_grid->GetId(),
+                                            wxEVT_GRID_RANGE_SELECT,
+                                            m_grid,
+                                            coords,
+                                            coords,
+                                            false,
+                                            kbd );
+            m_grid->GetEventHandler()->ProcessEvent( gridEvt );
 
-                return;
-            }
+            return;
         }
     }
 
@@ -725,8 +756,7 @@ wxGridSelection::ToggleCellSelection(int row, int col,
         if ( BlockContainsCell( topRow, leftCol, bottomRow, rightCol, row, col ) )
         {
             // remove the block
-            m_blockSelectionTopLeft.RemoveAt(n);
-            m_blockSelectionBottomRight.RemoveAt(n);
+            RemoveBlock(n);
             n--;
             count--;
 
@@ -753,25 +783,19 @@ wxGridSelection::ToggleCellSelection(int row, int col,
     // remove a cell from a row, adding up to two new blocks
     if ( m_selectionMode != wxGrid::wxGridSelectColumns )
     {
-        count = m_rowSelection.GetCount();
-        for ( n = 0; n < count; n++ )
+        if ( m_rowSelection.Contains(row) )
         {
-            if ( m_rowSelection[n] == row )
-            {
-                m_rowSelection.RemoveAt(n);
-                n--;
-                count--;
+            m_rowSelection.Remove(row, row);
 
-                rowSelectionWasChanged = true;
+            rowSelectionWasChanged = true;
 
-                if (m_selectionMode == wxGrid::wxGridSelectCells)
-                {
-                    if ( col > 0 )
-                        SelectBlockNoEvent(row, 0, row, col - 1);
-                    if ( col < m_grid->GetNumberCols() - 1 )
-                        SelectBlockNoEvent( row, col + 1,
-                                     row, m_grid->GetNumberCols() - 1);
-                }
+            if (m_selectionMode == wxGrid::wxGridSelectCells)
+            {
+                if ( col > 0 )
+                    SelectBlockNoEvent(row, 0, row, col - 1);
+                if ( col < m_grid->GetNumberCols() - 1 )
+                    SelectBlockNoEvent( row, col + 1,
+                                 row, m_grid->GetNumberCols() - 1);
             }
         }
     }
@@ -780,25 +804,19 @@ wxGridSelection::ToggleCellSelection(int row, int col,
     // remove a cell from a column, adding up to two new blocks
     if ( m_selectionMode != wxGrid::wxGridSelectRows )
     {
-        count = m_colSelection.GetCount();
-        for ( n = 0; n < count; n++ )
+        if ( m_colSelection.Contains(col) )
         {
-            if ( m_colSelection[n] == col )
-            {
-                m_colSelection.RemoveAt(n);
-                n--;
-                count--;
+            m_colSelection.Remove(col, col);
 
-                colSelectionWasChanged = true;
+            colSelectionWasChanged = true;
 
-                if (m_selectionMode == wxGrid::wxGridSelectCells)
-                {
-                    if ( row > 0 )
-                        SelectBlockNoEvent(0, col, row - 1, col);
-                    if ( row < m_grid->GetNumberRows() - 1 )
-                        SelectBlockNoEvent(row + 1, col,
-                                     m_grid->GetNumberRows() - 1, col);
-                }
+            if (m_selectionMode == wxGrid::wxGridSelectCells)
+            {
+                if ( row > 0 )
+                    SelectBlockNoEvent(0, col, row - 1, col);
+                if ( row < m_grid->GetNumberRows() - 1 )
+                    SelectBlockNoEvent(row + 1, col,
+                                 m_grid->GetNumberRows() - 1, col);
             }
         }
     }
@@ -833,7 +851,7 @@ wxGridSelection::ToggleCellSelection(int row, int col,
             int numCols = m_grid->GetNumberCols();
             for ( int colFrom = 0, colTo = 0; colTo <= numCols; ++colTo )
             {
-                if ( m_colSelection.Index(colTo) >= 0 || colTo == numCols )
+                if ( colTo == numCols || m_colSelection.Contains(colTo) )
                 {
                     if ( colFrom < colTo )
                     {
@@ -866,7 +884,7 @@ wxGridSelection::ToggleCellSelection(int row, int col,
             int numRows = m_grid->GetNumberRows();
             for ( int rowFrom = 0, rowTo = 0; rowTo <= numRows; ++rowTo )
             {
-                if ( m_rowSelection.Index(rowTo) >= 0 || rowTo == numRows )
+                if ( rowTo == numRows || m_rowSelection.Contains(rowTo) )
                 {
                     if (rowFrom < rowTo)
                     {
@@ -904,14 +922,13 @@ void wxGridSelection::ClearSelection()
     // deselect all individual cells and update the screen
     if ( m_selectionMode == wxGrid::wxGridSelectCells )
     {
-        while ( ( n = m_cellSelection.GetCount() ) > 0)
+        if ( !m_grid->GetBatchCount() )
         {
-            n--;
-            coords1 = m_cellSelection[n];
-            m_cellSelection.RemoveAt(n);
-            if ( !m_grid->GetBatchCount() )
+            for ( wxGridCellCoordsSet::const_iterator it = m_cellSelection->begin();
+                  it != m_cellSelection->end();
+                  ++it )
             {
-                r = m_grid->BlockToDeviceRect( coords1, coords1 );
+                r = m_grid->BlockToDeviceRect( *it, *it );
                 ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
 
 #ifdef __WXMAC__
@@ -919,6 +936,8 @@ void wxGridSelection::ClearSelection()
 #endif
             }
         }
+
+        m_cellSelection->clear();
     }
 
     // deselect all blocks and update the screen
@@ -927,8 +946,7 @@ void wxGridSelection::ClearSelection()
         n--;
         coords1 = m_blockSelectionTopLeft[n];
         coords2 = m_blockSelectionBottomRight[n];
-        m_blockSelectionTopLeft.RemoveAt(n);
-        m_blockSelectionBottomRight.RemoveAt(n);
+        RemoveBlock(n);
         if ( !m_grid->GetBatchCount() )
         {
             r = m_grid->BlockToDeviceRect( coords1, coords2 );
@@ -943,15 +961,12 @@ void wxGridSelection::ClearSelection()
     // deselect all rows and update the screen
     if ( m_selectionMode != wxGrid::wxGridSelectColumns )
     {
-        while ( ( n = m_rowSelection.GetCount() ) > 0)
+        if ( !m_grid->GetBatchCount() )
         {
-            n--;
-            int row = m_rowSelection[n];
-            m_rowSelection.RemoveAt(n);
-            if ( !m_grid->GetBatchCount() )
+            for ( n = 0; n < m_rowSelection.GetRangesCount(); n++ )
             {
-                r = m_grid->BlockToDeviceRect( wxGridCellCoords( row, 0 ),
-                                               wxGridCellCoords( row, m_grid->GetNumberCols() - 1 ) );
+                r = m_grid->BlockToDeviceRect( wxGridCellCoords( m_rowSelection.GetRangeFrom(n), 0 ),
+                                               wxGridCellCoords( m_rowSelection.GetRangeTo(n), m_grid->GetNumberCols() - 1 ) );
                 ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
 
 #ifdef __WXMAC__
@@ -959,20 +974,19 @@ void wxGridSelection::ClearSelection()
 #endif
             }
         }
+
+        m_rowSelection.Clear();
     }
 
     // deselect all columns and update the screen
     if ( m_selectionMode != wxGrid::wxGridSelectRows )
     {
-        while ( ( n = m_colSelection.GetCount() ) > 0)
+        if ( !m_grid->GetBatchCount() )
         {
-            n--;
-            int col = m_colSelection[n];
-            m_colSelection.RemoveAt(n);
-            if ( !m_grid->GetBatchCount() )
+            for ( n = 0; n < m_colSelection.GetRangesCount(); n++ )
             {
-                r = m_grid->BlockToDeviceRect( wxGridCellCoords( 0, col ),
-                                               wxGridCellCoords( m_grid->GetNumberRows() - 1, col ) );
+                r = m_grid->BlockToDeviceRect( wxGridCellCoords( 0, m_colSelection.GetRangeFrom(n) ),
+                                               wxGridCellCoords( m_grid->GetNumberRows() - 1, m_colSelection.GetRangeTo(n) ) );
                 ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
 
 #ifdef __WXMAC__
@@ -980,6 +994,8 @@ void wxGridSelection::ClearSelection()
 #endif
             }
         }
+
+        m_colSelection.Clear();
     }
 
     // One deselection event, indicating deselection of _all_ cells.
@@ -1000,39 +1016,10 @@ void wxGridSelection::ClearSelection()
 
 void wxGridSelection::UpdateRows( size_t pos, int numRows )
 {
-    size_t count = m_cellSelection.GetCount();
-    size_t n;
-    for ( n = 0; n < count; n++ )
-    {
-        wxGridCellCoords& coords = m_cellSelection[n];
-        wxCoord row = coords.GetRow();
-        if ((size_t)row >= pos)
-        {
-            if (numRows > 0)
-            {
-                // If rows inserted, increase row counter where necessary
-                coords.SetRow(row + numRows);
-            }
-            else if (numRows < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)row >= pos - numRows)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords.SetRow(row + numRows);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_cellSelection.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
-        }
-    }
+    UpdateCells( pos, numRows, true );
 
-    count = m_blockSelectionTopLeft.GetCount();
+    size_t count = m_blockSelectionTopLeft.GetCount();
+    size_t n;
     for ( n = 0; n < count; n++ )
     {
         wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
@@ -1065,8 +1052,7 @@ void wxGridSelection::UpdateRows( size_t pos, int numRows )
                     if ((size_t)row1 >= pos)
                     {
                         // ...or remove the attribute
-                        m_blockSelectionTopLeft.RemoveAt(n);
-                        m_blockSelectionBottomRight.RemoveAt(n);
+                        RemoveBlock(n);
                         n--;
                         count--;
                     }
@@ -1077,30 +1063,10 @@ void wxGridSelection::UpdateRows( size_t pos, int numRows )
         }
     }
 
-    count = m_rowSelection.GetCount();
-    for ( n = 0; n < count; n++ )
-    {
-    int  rowOrCol_ = m_rowSelection[n];
-
-      if ((size_t) rowOrCol_ >= pos)
-      {
-          if ( numRows > 0 )
-          {
-              m_rowSelection[n] += numRows;
-          }
-          else if ( numRows < 0 )
-          {
-              if ((size_t)rowOrCol_ >= (pos - numRows))
-                  m_rowSelection[n] += numRows;
-              else
-              {
-                  m_rowSelection.RemoveAt( n );
-                  n--;
-                  count--;
-              }
-          }
-      }
-    }
+    // The coordinates of the blocks could have changed.
+    m_blocksIndexValid = false;
+
+    m_rowSelection.UpdateLines( pos, numRows );
     // No need to touch selected columns, unless we removed _all_
     // rows, in this case, we remove all columns from the selection.
 
@@ -1111,40 +1077,10 @@ void wxGridSelection::UpdateRows( size_t pos, int numRows )
 
 void wxGridSelection::UpdateCols( size_t pos, int numCols )
 {
-    size_t count = m_cellSelection.GetCount();
-    size_t n;
-
-    for ( n = 0; n < count; n++ )
-    {
-        wxGridCellCoords& coords = m_cellSelection[n];
-        wxCoord col = coords.GetCol();
-        if ((size_t)col >= pos)
-        {
-            if (numCols > 0)
-            {
-                // If rows inserted, increase row counter where necessary
-                coords.SetCol(col + numCols);
-            }
-            else if (numCols < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)col >= pos - numCols)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords.SetCol(col + numCols);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_cellSelection.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
-        }
-    }
+    UpdateCells( pos, numCols, false );
 
-    count = m_blockSelectionTopLeft.GetCount();
+    size_t count = m_blockSelectionTopLeft.GetCount();
+    size_t n;
     for ( n = 0; n < count; n++ )
     {
         wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
@@ -1177,8 +1113,7 @@ void wxGridSelection::UpdateCols( size_t pos, int numCols )
                     if ((size_t)col1 >= pos)
                     {
                         // ...or remove the attribute
-                        m_blockSelectionTopLeft.RemoveAt(n);
-                        m_blockSelectionBottomRight.RemoveAt(n);
+                        RemoveBlock(n);
                         n--;
                         count--;
                     }
@@ -1189,28 +1124,10 @@ void wxGridSelection::UpdateCols( size_t pos, int numCols )
         }
     }
 
-    count = m_colSelection.GetCount();
-    for ( n = 0; n < count; n++ )
-    {
-        int   rowOrCol = m_colSelection[n];
+    // The coordinates of the blocks could have changed.
+    m_blocksIndexValid = false;
 
-        if ((size_t)rowOrCol >= pos)
-        {
-            if ( numCols > 0 )
-                m_colSelection[n] += numCols;
-            else if ( numCols < 0 )
-            {
-                if ((size_t)rowOrCol >= (pos - numCols))
-                    m_colSelection[n] += numCols;
-                else
-                {
-                    m_colSelection.RemoveAt( n );
-                    n--;
-                    count--;
-                }
-            }
-        }
-    }
+    m_colSelection.UpdateLines( pos, numCols );
 
     // No need to touch selected rows, unless we removed _all_
     // columns, in this case, we remove all rows from the selection.
@@ -1218,6 +1135,187 @@ void wxGridSelection::UpdateCols( size_t pos, int numCols )
         m_rowSelection.Clear();
 }
 
+void wxGridSelection::UpdateCells( size_t pos, int numRowsOrCols, bool isRow )
+{
+    if ( !numRowsOrCols || m_cellSelection->empty() )
+        return;
+
+    // As the coordinates of the selected cells change, rebuild the set.
+    wxGridCellCoordsSet cells;
+    for ( wxGridCellCoordsSet::const_iterator it = m_cellSelection->begin();
+          it != m_cellSelection->end();
+          ++it )
+    {
+        wxGridCellCoords coords = *it;
+        const int rowOrCol = isRow ? coords.GetRow() : coords.GetCol();
+        if ( (size_t)rowOrCol >= pos )
+        {
+            // If rows/cols deleted, either decrement row/col counter (if
+            // row/col still exists) or deselect the cell
+            if ( numRowsOrCols < 0 && (size_t)rowOrCol < pos - numRowsOrCols )
+                continue;
+
+            if ( isRow )
+                coords.SetRow( rowOrCol + numRowsOrCols );
+            else
+                coords.SetCol( rowOrCol + numRowsOrCols );
+        }
+
+        cells.insert( coords );
+    }
+
+    *m_cellSelection = cells;
+}
+
+void wxGridSelection::RemoveCellsInBlock( int topRow, int leftCol,
+                                          int bottomRow, int rightCol )
+{
+    for ( wxGridCellCoordsSet::iterator it = m_cellSelection->begin();
+          it != m_cellSelection->end(); )
+    {
+        if ( BlockContainsCell( topRow, leftCol, bottomRow, rightCol,
+                                it->GetRow(), it->GetCol() ) )
+        {
+            // Note that we can't use the return value of erase() as it's only
+            // available in C++11 std::unordered_set.
+            const wxGridCellCoords coords = *it;
+            ++it;
+            m_cellSelection->erase( coords );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void wxGridSelection::AddBlock( int topRow, int leftCol,
+                                int bottomRow, int rightCol )
+{
+    m_blockSelectionTopLeft.Add( wxGridCellCoords( topRow, leftCol ) );
+    m_blockSelectionBottomRight.Add( wxGridCellCoords( bottomRow, rightCol ) );
+
+    m_blocksIndexValid = false;
+}
+
+void wxGridSelection::SetBlock( size_t n,
+                                const wxGridCellCoords& topLeft,
+                                const wxGridCellCoords& bottomRight )
+{
+    m_blockSelectionTopLeft[n] = topLeft;
+    m_blockSelectionBottomRight[n] = bottomRight;
+
+    m_blocksIndexValid = false;
+}
+
+void wxGridSelection::RemoveBlock( size_t n )
+{
+    m_blockSelectionTopLeft.RemoveAt(n);
+    m_blockSelectionBottomRight.RemoveAt(n);
+
+    m_blocksIndexValid = false;
+}
+
+namespace
+{
+
+// Compares the indices of the blocks by their top rows.
+class wxGridBlockTopRowLess
+{
+public:
+    explicit wxGridBlockTopRowLess(const wxGridCellCoordsArray& topLeft)
+        : m_topLeft(topLeft)
+    {
+    }
+
+    bool operator()(size_t n1, size_t n2) const
+    {
+        return m_topLeft[n1].GetRow() < m_topLeft[n2].GetRow();
+    }
+
+private:
+    const wxGridCellCoordsArray& m_topLeft;
+};
+
+} // anonymous namespace
+
+int wxGridSelection::BuildBlocksIndex( size_t node, size_t lo, size_t hi )
+{
+    int maxBottom;
+    if ( hi - lo == 1 )
+    {
+        maxBottom = m_blockSelectionBottomRight[m_blocksByTop[lo]].GetRow();
+    }
+    else
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        maxBottom = wxMax(BuildBlocksIndex(2*node, lo, mid),
+                          BuildBlocksIndex(2*node + 1, mid, hi));
+    }
+
+    m_blocksMaxBottom[node] = maxBottom;
+
+    return maxBottom;
+}
+
+bool wxGridSelection::IsInBlocksIndex( size_t node, size_t lo, size_t hi,
+                                       size_t end, int row, int col ) const
+{
+    // All blocks in [lo, end) start at or above the row, so we only need to
+    // look at those which end at or below it.
+    if ( lo >= end || m_blocksMaxBottom[node] < row )
+        return false;
+
+    if ( hi - lo == 1 )
+    {
+        const size_t n = m_blocksByTop[lo];
+
+        return m_blockSelectionTopLeft[n].GetCol() <= col &&
+                    col <= m_blockSelectionBottomRight[n].GetCol();
+    }
+
+    const size_t mid = lo + (hi - lo) / 2;
+
+    return IsInBlocksIndex(2*node, lo, mid, end, row, col) ||
+            IsInBlocksIndex(2*node + 1, mid, hi, end, row, col);
+}
+
+bool wxGridSelection::IsInSelectedBlock( int row, int col )
+{
+    const size_t count = m_blockSelectionTopLeft.GetCount();
+    if ( !count )
+        return false;
+
+    if ( !m_blocksIndexValid )
+    {
+        m_blocksByTop.resize(count);
+        for ( size_t n = 0; n < count; n++ )
+            m_blocksByTop[n] = n;
+
+        std::sort(m_blocksByTop.begin(), m_blocksByTop.end(),
+                  wxGridBlockTopRowLess(m_blockSelectionTopLeft));
+
+        m_blocksMaxBottom.resize(4*count);
+        BuildBlocksIndex(1, 0, count);
+
+        m_blocksIndexValid = true;
+    }
+
+    // Find the number of blocks starting at or above this row.
+    size_t lo = 0,
+           hi = count;
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( m_blockSelectionTopLeft[m_blocksByTop[mid]].GetRow() <= row )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return IsInBlocksIndex(1, 0, count, lo, row, col);
+}
+
 int wxGridSelection::BlockContain( int topRow1, int leftCol1,
                                    int bottomRow1, int rightCol1,
                                    int topRow2, int leftCol2,
@@ -41,6 +41,10 @@
 #include "wx/generic/private/listctrl.h"
 #include "wx/generic/private/widthcalc.h"
 
+#if wxUSE_THREADS
+    #include "wx/thread.h"
+#endif
+
 #ifdef __WXMAC__
     #include "wx/osx/private.h"
 #endif
@@ -410,6 +414,7 @@ wxListLineData::wxListLineData( wxListMainWindow *owner )
 
     m_highlighted = false;
     m_checked = false;
+    m_placeholder = false;
 
     InitItems( GetMode() == wxLC_REPORT ? m_owner->GetColumnCount() : 1 );
 }
@@ -826,6 +831,12 @@ void wxListLineData::DrawInReportMode( wxDC *dc,
         const int wText = width;
         wxDCClipper clipper(*dc, xOld, rect.y, wText, rect.height);
 
+        if ( m_placeholder )
+        {
+            wxDrawItemPlaceholder(*dc, wxRect(xOld, rect.y, width, rect.height));
+            continue;
+        }
+
         if ( item->HasImage() )
         {
             int ix, iy;
@@ -850,11 +861,35 @@ void wxListLineData::DrawTextFormatted(wxDC *dc,
                                        int yMid,
                                        int width)
 {
-    // we don't support displaying multiple lines currently (and neither does
+    // if the items can have different heights, show multiple lines of text
+    // one below the other, the item height is supposed to be big enough
+    if ( m_owner->HasVariableLineHeight() && textOrig.find('\n') != wxString::npos )
+    {
+        const wxArrayString lines = wxSplit(textOrig, '\n', '\0');
+        const int hLine = dc->GetCharHeight();
+
+        int y = yMid - (int(lines.size())*hLine)/2 + hLine/2;
+        for ( size_t n = 0; n < lines.size(); n++, y += hLine )
+            DrawTextLine(dc, lines[n], col, x, y, width);
+
+        return;
+    }
+
+    // otherwise we don't support displaying multiple lines (and neither does
     // wxMSW FWIW) so just merge all the lines
     wxString text(textOrig);
     text.Replace(wxT("\n"), wxT(" "));
 
+    DrawTextLine(dc, text, col, x, yMid, width);
+}
+
+void wxListLineData::DrawTextLine(wxDC *dc,
+                                  const wxString& text,
+                                  int col,
+                                  int x,
+                                  int yMid,
+                                  int width)
+{
     wxCoord w, h;
     dc->GetTextExtent(text, &w, &h);
 
@@ -896,20 +931,24 @@ void wxListLineData::DrawTextFormatted(wxDC *dc,
         wxCoord base_w;
         dc->GetTextExtent(ellipsis, &base_w, &h);
 
-        // continue until we have enough space or only one character left
-        wxCoord w_c, h_c;
+        // measure all the prefixes of the string at once instead of doing it
+        // for each character being removed
+        wxArrayInt widths;
         size_t len = text.length();
-        wxString drawntext = text.Left(len);
-        while (len > 1)
+        if ( len > 1 && dc->GetPartialTextExtents(text, widths) )
         {
-            dc->GetTextExtent(drawntext.Last(), &w_c, &h_c);
-            drawntext.RemoveLast();
-            len--;
-            w -= w_c;
-            if (w + base_w <= width)
-                break;
+            // continue until we have enough space or only one character left
+            for ( len--; len > 1; len-- )
+            {
+                if ( widths[len - 1] + base_w <= width )
+                    break;
+            }
+
+            w = widths[len - 1];
         }
 
+        const wxString drawntext = text.Left(len);
+
         // if still not enough space, remove ellipsis characters
         while (ellipsis.length() > 0 && w + base_w > width)
         {
@@ -1578,6 +1617,9 @@ void wxListMainWindow::Init()
     m_headerWidth =
     m_lineHeight = 0;
 
+    m_variableLineHeight = false;
+    m_lineHeightsValid = false;
+
     m_small_image_list = NULL;
     m_normal_image_list = NULL;
 
@@ -1674,14 +1716,25 @@ void wxListMainWindow::CacheLineData(size_t line)
 
     wxListLineData *ld = GetDummyLine();
 
+    // don't ask for the data of the items which are not available yet, only a
+    // placeholder is shown for them anyhow
+    ld->m_placeholder = !listctrl->OnGetItemIsLoaded(line);
+
     size_t countCol = GetColumnCount();
     for ( size_t col = 0; col < countCol; col++ )
     {
+        if ( ld->m_placeholder )
+        {
+            ld->SetText(col, wxString());
+            ld->SetImage(col, -1);
+            continue;
+        }
+
         ld->SetText(col, listctrl->OnGetItemText(line, col));
         ld->SetImage(col, listctrl->OnGetItemColumnImage(line, col));
     }
 
-    ld->SetAttr(listctrl->OnGetItemAttr(line));
+    ld->SetAttr(ld->m_placeholder ? NULL : listctrl->OnGetItemAttr(line));
 }
 
 wxListLineData *wxListMainWindow::GetDummyLine() const
@@ -1713,10 +1766,181 @@ wxListLineData *wxListMainWindow::GetDummyLine() const
     return m_lines[0];
 }
 
+//-----------------------------------------------------------------------------
+//  wxListLineHeights
+//-----------------------------------------------------------------------------
+
+void wxListLineHeights::Assign(const wxVector<int>& heights, int heightDefault)
+{
+    m_heights = heights;
+    m_heightDefault = heightDefault;
+
+    Rebuild();
+}
+
+void wxListLineHeights::Rebuild()
+{
+    // build the tree in linear time by adding each node to its parent
+    const size_t count = m_heights.size();
+    m_tree.assign(count + 1, 0);
+    m_total = 0;
+    for ( size_t i = 1; i <= count; i++ )
+    {
+        const int height = DoGetHeight(m_heights[i - 1]);
+        m_tree[i] += height;
+        m_total += height;
+
+        const size_t parent = i + (i & (0 - i));
+        if ( parent <= count )
+            m_tree[parent] += m_tree[i];
+    }
+}
+
+void wxListLineHeights::Clear()
+{
+    m_heights.clear();
+    m_tree.clear();
+    m_total = 0;
+}
+
+void wxListLineHeights::SetDefaultHeight(int heightDefault)
+{
+    if ( heightDefault == m_heightDefault )
+        return;
+
+    m_heightDefault = heightDefault;
+
+    // the positions of the lines after any line using the default height
+    // change, but there is no need to retrieve the heights again
+    Rebuild();
+}
+
+bool wxListLineHeights::SetHeight(size_t line, int height)
+{
+    wxCHECK_MSG( line < m_heights.size(), false, wxS("invalid line index") );
+
+    const int delta = DoGetHeight(height) - GetHeight(line);
+    m_heights[line] = height;
+    if ( !delta )
+        return false;
+
+    m_total += delta;
+
+    for ( size_t i = line + 1; i < m_tree.size(); i += i & (0 - i) )
+        m_tree[i] += delta;
+
+    return true;
+}
+
+int wxListLineHeights::GetTop(size_t line) const
+{
+    int top = 0;
+    for ( size_t i = line; i > 0; i -= i & (0 - i) )
+        top += m_tree[i];
+
+    return top;
+}
+
+size_t wxListLineHeights::FindLine(int y) const
+{
+    if ( y < 0 )
+        return 0;
+
+    // find the greatest number of lines whose total height is <= y by
+    // descending the tree from the biggest power of 2 not exceeding the count
+    const size_t count = m_heights.size();
+    size_t step = 1;
+    while ( step <= count / 2 )
+        step *= 2;
+
+    size_t pos = 0;
+    for ( ; step; step /= 2 )
+    {
+        if ( pos + step <= count && m_tree[pos + step] <= y )
+        {
+            pos += step;
+            y -= m_tree[pos];
+        }
+    }
+
+    // the line containing y is the one after all these lines
+    return pos;
+}
+
 // ----------------------------------------------------------------------------
 // line geometry (report mode only)
 // ----------------------------------------------------------------------------
 
+const wxListLineHeights& wxListMainWindow::GetLineHeights() const
+{
+    wxListMainWindow * const self = wxConstCast(this, wxListMainWindow);
+
+    // the heights of all lines are only retrieved when the number of lines
+    // changes, see UpdateLineHeights() for updating them later
+    if ( !m_lineHeightsValid || m_lineHeights.GetCount() != GetItemCount() )
+    {
+        wxGenericListCtrl * const listctrl = GetListCtrl();
+
+        const size_t count = GetItemCount();
+        wxVector<int> heights;
+        heights.reserve(count);
+        for ( size_t line = 0; line < count; line++ )
+            heights.push_back(listctrl->OnGetItemHeight(line));
+
+        self->m_lineHeights.Assign(heights, GetLineHeight());
+        self->m_lineHeightsValid = true;
+    }
+    else // only the default height could have changed
+    {
+        self->m_lineHeights.SetDefaultHeight(GetLineHeight());
+    }
+
+    return m_lineHeights;
+}
+
+bool wxListMainWindow::EnableVariableLineHeight(bool enable)
+{
+    m_variableLineHeight = enable;
+
+    InvalidateLineHeights();
+    if ( !enable )
+        m_lineHeights.Clear();
+
+    m_dirty = true;
+    Refresh();
+
+    return true;
+}
+
+void wxListMainWindow::UpdateLineHeights(size_t lineFrom, size_t lineTo)
+{
+    // nothing to do if the heights will be retrieved anew anyhow
+    if ( !HasVariableLineHeight() || !m_lineHeightsValid ||
+            m_lineHeights.GetCount() != GetItemCount() )
+        return;
+
+    wxCHECK_RET( lineFrom <= lineTo && lineTo < GetItemCount(),
+                 wxS("invalid line range") );
+
+    wxGenericListCtrl * const listctrl = GetListCtrl();
+
+    bool changed = false;
+    for ( size_t line = lineFrom; line <= lineTo; line++ )
+    {
+        if ( m_lineHeights.SetHeight(line, listctrl->OnGetItemHeight(line)) )
+            changed = true;
+    }
+
+    if ( changed )
+    {
+        // the positions of all the following lines and the total height
+        // changed too
+        ResetVisibleLinesRange();
+        m_dirty = true;
+        RefreshAfter(lineFrom);
+    }
+}
+
 wxCoord wxListMainWindow::GetLineHeight() const
 {
     // we cache the line height as calling GetTextExtent() is slow
@@ -1744,13 +1968,52 @@ wxCoord wxListMainWindow::GetLineHeight() const
     return m_lineHeight;
 }
 
+wxCoord wxListMainWindow::GetLineHeight(size_t line) const
+{
+    return HasVariableLineHeight() ? GetLineHeights().GetHeight(line)
+                                   : GetLineHeight();
+}
+
 wxCoord wxListMainWindow::GetLineY(size_t line) const
 {
     wxASSERT_MSG( InReportView(), wxT("only works in report mode") );
 
+    if ( HasVariableLineHeight() )
+        return LINE_SPACING + GetLineHeights().GetTop(line);
+
     return LINE_SPACING + line * GetLineHeight();
 }
 
+size_t wxListMainWindow::GetLineAt(int y) const
+{
+    wxASSERT_MSG( InReportView(), wxT("only works in report mode") );
+
+    if ( HasVariableLineHeight() )
+        return GetLineHeights().FindLine(y - LINE_SPACING);
+
+    return y / GetLineHeight();
+}
+
+void wxListMainWindow::SendPrefetchHint(size_t visibleFrom, size_t visibleTo)
+{
+    long from, to;
+    int direction;
+    if ( !m_prefetch.Update(visibleFrom, visibleTo, GetItemCount(),
+                            &from, &to, &direction) )
+        return;
+
+    // queue the event instead of processing it immediately to avoid delaying
+    // painting: the application is supposed to retrieve the items
+    // asynchronously and call RefreshItems() when they become available
+    wxListEvent *event = new wxListEvent(wxEVT_LIST_PREFETCH_HINT,
+                                         GetParent()->GetId());
+    event->SetEventObject( GetParent() );
+    event->SetCacheFrom(from);
+    event->SetCacheTo(to);
+    event->SetPrefetchDirection(direction);
+    GetParent()->GetEventHandler()->QueueEvent(event);
+}
+
 wxRect wxListMainWindow::GetLineRect(size_t line) const
 {
     if ( !InReportView() )
@@ -1760,7 +2023,7 @@ wxRect wxListMainWindow::GetLineRect(size_t line) const
     rect.x = HEADER_OFFSET_X;
     rect.y = GetLineY(line);
     rect.width = GetHeaderWidth();
-    rect.height = GetLineHeight();
+    rect.height = GetLineHeight(line);
 
     return rect;
 }
@@ -1788,7 +2051,7 @@ wxRect wxListMainWindow::GetLineLabelRect(size_t line) const
     rect.x = image_x + HEADER_OFFSET_X;
     rect.y = GetLineY(line);
     rect.width = GetColumnWidth(0) - image_x;
-    rect.height = GetLineHeight();
+    rect.height = GetLineHeight(line);
 
     return rect;
 }
@@ -1960,7 +2223,7 @@ void wxListMainWindow::RefreshLines( size_t lineFrom, size_t lineTo )
         rect.x = 0;
         rect.y = GetLineY(lineFrom);
         rect.width = GetClientSize().x;
-        rect.height = GetLineY(lineTo) - rect.y + GetLineHeight();
+        rect.height = GetLineY(lineTo) - rect.y + GetLineHeight(lineTo);
 
         GetListCtrl()->CalcScrolledPosition( rect.x, rect.y, &rect.x, &rect.y );
         RefreshRect( rect );
@@ -2058,8 +2321,6 @@ void wxListMainWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
 
     if ( InReportView() )
     {
-        int lineHeight = GetLineHeight();
-
         size_t visibleFrom, visibleTo;
         GetVisibleLinesRange(&visibleFrom, &visibleTo);
 
@@ -2077,6 +2338,8 @@ void wxListMainWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
             evCache.m_item.m_itemId =
             evCache.m_itemIndex = visibleTo;
             GetParent()->GetEventHandler()->ProcessEvent( evCache );
+
+            SendPrefetchHint(visibleFrom, visibleTo);
         }
 
         for ( size_t line = visibleFrom; line <= visibleTo; line++ )
@@ -2107,19 +2370,22 @@ void wxListMainWindow::OnPaint( wxPaintEvent &WXUNUSED(event) )
             if (i == 0) i = 1; // Don't draw the first one
             for ( ; i <= visibleTo; i++ )
             {
+                const int y = GetLineY(i) - LINE_SPACING;
+
                 dc.SetPen(pen);
                 dc.SetBrush( *wxTRANSPARENT_BRUSH );
-                dc.DrawLine(0 - dev_x, i * lineHeight,
-                            clientSize.x - dev_x, i * lineHeight);
+                dc.DrawLine(0 - dev_x, y, clientSize.x - dev_x, y);
             }
 
             // Draw last horizontal rule
             if ( visibleTo == GetItemCount() - 1 )
             {
+                const int y = GetLineY(m_lineTo) - LINE_SPACING +
+                                GetLineHeight(m_lineTo);
+
                 dc.SetPen( pen );
                 dc.SetBrush( *wxTRANSPARENT_BRUSH );
-                dc.DrawLine(0 - dev_x, (m_lineTo + 1) * lineHeight,
-                            clientSize.x - dev_x , (m_lineTo + 1) * lineHeight );
+                dc.DrawLine(0 - dev_x, y, clientSize.x - dev_x , y);
             }
         }
 
@@ -2412,7 +2678,7 @@ void wxListMainWindow::OnMouse( wxMouseEvent &event )
 
     if ( InReportView() )
     {
-        current = y / GetLineHeight();
+        current = GetLineAt(y);
         if ( current < count )
             hitResult = HitTestLine(current, x, y);
     }
@@ -2714,6 +2980,11 @@ bool wxListMainWindow::ScrollList(int WXUNUSED(dx), int dy)
 
     int hLine = GetLineHeight();
 
+    // with variable line height the scroll position is not the index of the
+    // top line, but it is still expressed in the default line height units
+    if ( HasVariableLineHeight() )
+        top = GetListCtrl()->GetScrollPos(wxVERTICAL);
+
     GetListCtrl()->Scroll(-1, top + dy / hLine);
 
 #if defined(__WXMAC__) || defined(__WXUNIVERSAL__)
@@ -3147,7 +3418,7 @@ void wxListMainWindow::SetImageList( wxImageList *imageList, int which )
     {
         m_small_image_list = imageList;
         m_small_spacing = width + 14;
-        m_lineHeight = 0;  // ensure that the line height will be recalc'd
+        ResetLineHeight();  // ensure that the line height will be recalc'd
     }
 }
 
@@ -3580,7 +3851,10 @@ void wxListMainWindow::SetItemCount(long count)
     m_selStore.SetItemCount(count);
     m_countVirt = count;
 
+    // the line heights are retrieved again by GetLineHeights() if the number
+    // of lines changed, no need to invalidate them here
     ResetVisibleLinesRange();
+    m_prefetch.Reset();
 
     // scrollbars must be reset
     m_dirty = true;
@@ -3794,8 +4068,14 @@ void wxListMainWindow::RecalculatePositions(bool noRefresh)
 
     if ( InReportView() )
     {
-        // all lines have the same height and we scroll one line per step
-        int entireHeight = count * lineHeight + LINE_SPACING;
+        // all lines have the same height and we scroll one line per step,
+        // unless they have variable height in which case we still scroll by
+        // the default line height
+        int entireHeight = LINE_SPACING;
+        if ( HasVariableLineHeight() )
+            entireHeight += GetLineHeights().GetTotalHeight();
+        else
+            entireHeight += count * lineHeight;
 
         m_linesPerPage = clientHeight / lineHeight;
 
@@ -4290,7 +4570,7 @@ long wxListMainWindow::HitTest( int x, int y, int &flags ) const
 
     if ( InReportView() )
     {
-        size_t current = y / GetLineHeight();
+        size_t current = GetLineAt(y);
         if ( current < count )
         {
             flags = HitTestLine(current, x, y);
@@ -4362,7 +4642,7 @@ void wxListMainWindow::InsertItem( wxListItem &item )
             m_small_image_list->GetSize(image, imageWidth, imageHeight);
 
             if ( imageHeight > m_lineHeight )
-                m_lineHeight = 0;
+                ResetLineHeight();
         }
     }
 
@@ -4493,6 +4773,250 @@ void wxListMainWindow::SortItems( wxListCtrlCompare fn, wxIntPtr data )
     m_dirty = true;
 }
 
+namespace
+{
+
+// Don't bother with using multiple threads for sorting fewer items than this.
+const size_t SORT_PARALLEL_MIN_ITEMS = 10000;
+
+// And don't use more than this number of threads in any case.
+const int SORT_MAX_THREADS = 8;
+
+// NaN numeric keys can't be compared with anything, so they are explicitly
+// put after all the other ones to still have a strict weak ordering.
+inline bool wxListSortIsNaN(const wxString& WXUNUSED(key)) { return false; }
+inline bool wxListSortIsNaN(double key) { return wxIsNaN(key) != 0; }
+
+// Compares the indices of the lines using their keys.
+//
+// Notice that only the indices are copied and moved around during sorting,
+// possibly in several threads, and not the keys themselves: this wouldn't be
+// safe for wxString using reference counting which is not thread-safe.
+template <typename Key>
+class wxListSortIndexLess
+{
+public:
+    wxListSortIndexLess(const wxVector<Key>& keys, bool ascending)
+        : m_keys(&keys),
+          m_ascending(ascending)
+    {
+    }
+
+    bool operator()(size_t n1, size_t n2) const
+    {
+        const Key& k1 = (*m_keys)[n1];
+        const Key& k2 = (*m_keys)[n2];
+
+        const bool nan1 = wxListSortIsNaN(k1),
+                   nan2 = wxListSortIsNaN(k2);
+        if ( nan1 || nan2 )
+            return !nan1;
+
+        return m_ascending ? k1 < k2 : k2 < k1;
+    }
+
+private:
+    const wxVector<Key>* m_keys;
+    bool m_ascending;
+};
+
+// A single step of the merge sort: either sort the given range, if middle is
+// the same as last, or merge its two already sorted parts.
+template <typename Iter, typename Less>
+struct wxListSortTask
+{
+    wxListSortTask(Iter first_, Iter middle_, Iter last_, const Less& less_)
+        : first(first_), middle(middle_), last(last_), less(less_)
+    {
+    }
+
+    void Run() const
+    {
+        if ( middle == last )
+            std::stable_sort(first, last, less);
+        else
+            std::inplace_merge(first, middle, last, less);
+    }
+
+    Iter first,
+         middle,
+         last;
+    Less less;
+};
+
+#if wxUSE_THREADS
+
+template <typename Task>
+class wxListSortThread : public wxThread
+{
+public:
+    explicit wxListSortThread(const Task& task)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_task(task)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        m_task.Run();
+        return NULL;
+    }
+
+private:
+    const Task m_task;
+};
+
+#endif // wxUSE_THREADS
+
+// Run all the given tasks, which must be independent of each other, and wait
+// until they complete. Separate threads are used for all tasks but the first
+// one, if possible.
+template <typename Task>
+void RunSortTasks(const wxVector<Task>& tasks)
+{
+#if wxUSE_THREADS
+    wxVector<wxThread*> threads;
+    for ( size_t n = 1; n < tasks.size(); n++ )
+    {
+        wxThread* const thread = new wxListSortThread<Task>(tasks[n]);
+        if ( thread->Run() == wxTHREAD_NO_ERROR )
+        {
+            threads.push_back(thread);
+        }
+        else
+        {
+            delete thread;
+            tasks[n].Run();
+        }
+    }
+
+    if ( !tasks.empty() )
+        tasks[0].Run();
+
+    for ( size_t n = 0; n < threads.size(); n++ )
+    {
+        threads[n]->Wait();
+        delete threads[n];
+    }
+#else // !wxUSE_THREADS
+    for ( size_t n = 0; n < tasks.size(); n++ )
+        tasks[n].Run();
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+}
+
+// Stable merge sort using several threads for big vectors: the vector is split
+// into chunks which are sorted in parallel and then merged pairwise, also in
+// parallel, until the entire vector is sorted.
+template <typename T, typename Less>
+void ParallelStableSort(wxVector<T>& v, const Less& less)
+{
+    typedef typename wxVector<T>::iterator Iter;
+    typedef wxListSortTask<Iter, Less> Task;
+
+    const size_t count = v.size();
+
+    size_t numChunks = 1;
+#if wxUSE_THREADS
+    if ( count >= SORT_PARALLEL_MIN_ITEMS )
+        numChunks = wxMin(wxMax(wxThread::GetCPUCount(), 1), SORT_MAX_THREADS);
+#endif // wxUSE_THREADS
+
+    // The boundaries of the sorted runs, the last element is always count.
+    wxVector<size_t> bounds;
+    for ( size_t n = 0; n <= numChunks; n++ )
+        bounds.push_back((count*n)/numChunks);
+
+    const Iter begin = v.begin();
+
+    wxVector<Task> tasks;
+    for ( size_t n = 0; n < numChunks; n++ )
+    {
+        tasks.push_back(Task(begin + bounds[n],
+                             begin + bounds[n + 1],
+                             begin + bounds[n + 1],
+                             less));
+    }
+
+    RunSortTasks(tasks);
+
+    while ( bounds.size() > 2 )
+    {
+        tasks.clear();
+
+        wxVector<size_t> boundsMerged;
+
+        size_t n;
+        for ( n = 0; n + 2 < bounds.size(); n += 2 )
+        {
+            tasks.push_back(Task(begin + bounds[n],
+                                 begin + bounds[n + 1],
+                                 begin + bounds[n + 2],
+                                 less));
+            boundsMerged.push_back(bounds[n]);
+        }
+
+        // The last run is left as is if there is an odd number of them.
+        for ( ; n < bounds.size(); n++ )
+            boundsMerged.push_back(bounds[n]);
+
+        RunSortTasks(tasks);
+
+        bounds.swap(boundsMerged);
+    }
+}
+
+} // anonymous namespace
+
+template <typename Key, typename KeyFunc>
+void wxListMainWindow::DoSortItemsByKey(KeyFunc fn, wxIntPtr data, bool ascending)
+{
+    // selections won't make sense any more after sorting the items so reset
+    // them
+    HighlightAll(false);
+    ResetCurrent();
+
+    // Retrieve the keys of all items only once, in this thread, as the key
+    // function may be not thread-safe.
+    const size_t count = m_lines.size();
+
+    wxVector<Key> keys;
+    keys.reserve(count);
+
+    wxVector<size_t> indices(count);
+    for ( size_t n = 0; n < count; n++ )
+    {
+        keys.push_back(fn(m_lines[n]->m_items.GetFirst()->GetData()->m_data, data));
+        indices[n] = n;
+    }
+
+    ParallelStableSort(indices, wxListSortIndexLess<Key>(keys, ascending));
+
+    wxVector<wxListLineData*> lines;
+    lines.reserve(count);
+    for ( size_t n = 0; n < count; n++ )
+        lines.push_back(m_lines[indices[n]]);
+
+    m_lines.swap(lines);
+
+    // the positions of the lines will be recalculated when they're needed
+    m_dirty = true;
+}
+
+void wxListMainWindow::SortItemsByKey(wxListCtrlStringKey fn,
+                                      wxIntPtr data,
+                                      bool ascending)
+{
+    DoSortItemsByKey<wxString>(fn, data, ascending);
+}
+
+void wxListMainWindow::SortItemsByKey(wxListCtrlNumericKey fn,
+                                      wxIntPtr data,
+                                      bool ascending)
+{
+    DoSortItemsByKey<double>(fn, data, ascending);
+}
+
 // ----------------------------------------------------------------------------
 // scrolling
 // ----------------------------------------------------------------------------
@@ -4534,7 +5058,21 @@ void wxListMainWindow::GetVisibleLinesRange(size_t *from, size_t *to)
     if ( m_lineFrom == (size_t)-1 )
     {
         size_t count = GetItemCount();
-        if ( count )
+        if ( count && HasVariableLineHeight() )
+        {
+            // the scroll unit is the default line height, but it doesn't
+            // correspond to a whole number of lines in this case
+            const int y = GetListCtrl()->GetScrollPos(wxVERTICAL)*GetLineHeight();
+
+            m_lineFrom = GetLineAt(y);
+            if ( m_lineFrom >= count )
+                m_lineFrom = count - 1;
+
+            m_lineTo = GetLineAt(y + GetClientSize().y);
+            if ( m_lineTo >= count )
+                m_lineTo = count - 1;
+        }
+        else if ( count )
         {
             m_lineFrom = GetListCtrl()->GetScrollPos(wxVERTICAL);
 
@@ -4800,6 +5338,38 @@ bool wxGenericListCtrl::EnableCheckBoxes(bool enable)
     return m_mainWin->EnableCheckBoxes(enable);
 }
 
+bool wxGenericListCtrl::HasVariableItemHeight() const
+{
+    return m_mainWin->HasVariableLineHeight();
+}
+
+bool wxGenericListCtrl::EnableVariableItemHeight(bool enable)
+{
+    // this is only supported for the virtual controls in report view, as
+    // otherwise the items heights are not known without creating all of them
+    if ( !IsVirtual() || !InReportView() )
+        return false;
+
+    return m_mainWin->EnableVariableLineHeight(enable);
+}
+
+bool wxGenericListCtrl::SetPrefetchLookAhead(int count)
+{
+    if ( !IsVirtual() )
+        return false;
+
+    wxCHECK_MSG( count >= 0, false, wxT("invalid prefetch look-ahead") );
+
+    m_mainWin->SetPrefetchLookAhead(count);
+
+    return true;
+}
+
+int wxGenericListCtrl::GetPrefetchLookAhead() const
+{
+    return m_mainWin->GetPrefetchLookAhead();
+}
+
 void wxGenericListCtrl::CheckItem(long item, bool state)
 {
     if (InReportView())
@@ -5336,6 +5906,26 @@ bool wxGenericListCtrl::SortItems( wxListCtrlCompare fn, wxIntPtr data )
     return true;
 }
 
+bool wxGenericListCtrl::SortItemsByKey(wxListCtrlStringKey fn,
+                                       wxIntPtr data,
+                                       bool ascending)
+{
+    wxCHECK_MSG( !IsVirtual(), false, wxT("can't sort virtual control") );
+
+    m_mainWin->SortItemsByKey(fn, data, ascending);
+    return true;
+}
+
+bool wxGenericListCtrl::SortItemsByKey(wxListCtrlNumericKey fn,
+                                       wxIntPtr data,
+                                       bool ascending)
+{
+    wxCHECK_MSG( !IsVirtual(), false, wxT("can't sort virtual control") );
+
+    m_mainWin->SortItemsByKey(fn, data, ascending);
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // event handlers
 // ----------------------------------------------------------------------------
@@ -5558,6 +6148,16 @@ int wxGenericListCtrl::OnGetItemColumnImage(long item, long column) const
    return -1;
 }
 
+int wxGenericListCtrl::OnGetItemHeight(long WXUNUSED(item)) const
+{
+    return -1;
+}
+
+bool wxGenericListCtrl::OnGetItemIsLoaded(long WXUNUSED(item)) const
+{
+    return true;
+}
+
 void wxGenericListCtrl::SetItemCount(long count)
 {
     wxASSERT_MSG( IsVirtual(), wxT("this is for virtual controls only") );
@@ -5567,11 +6167,13 @@ void wxGenericListCtrl::SetItemCount(long count)
 
 void wxGenericListCtrl::RefreshItem(long item)
 {
+    m_mainWin->UpdateLineHeights(item, item);
     m_mainWin->RefreshLine(item);
 }
 
 void wxGenericListCtrl::RefreshItems(long itemFrom, long itemTo)
 {
+    m_mainWin->UpdateLineHeights(itemFrom, itemTo);
     m_mainWin->RefreshLines(itemFrom, itemTo);
 }
 
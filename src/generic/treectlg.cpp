@@ -61,6 +61,9 @@ static const int NO_IMAGE = -1;
 
 static const int PIXELS_PER_UNIT = 10;
 
+// the vertical offset of the first item
+static const int MARGIN_TOP = 2;
+
 // the margin between the item state image and the item normal image
 static const int MARGIN_BETWEEN_STATE_AND_IMAGE = 2;
 
@@ -153,6 +156,10 @@ public:
                        int selImage,
                        wxTreeItemData *data );
 
+    // ctor for the items of a virtual tree: they don't store their text, but
+    // only their index among their siblings
+    wxGenericTreeItem( wxGenericTreeItem *parent, unsigned int index );
+
     ~wxGenericTreeItem();
 
     // trivial accessors
@@ -163,6 +170,7 @@ public:
         { return m_images[which]; }
     wxTreeItemData *GetData() const { return m_data; }
     int GetState() const { return m_state; }
+    unsigned int GetIndex() const { return m_index; }
 
     // returns the current image for the item (depending on its
     // selected/expanded/whatever state)
@@ -178,13 +186,22 @@ public:
     void SetImage(int image, wxTreeItemIcon which)
     {
         m_images[which] = image;
-        m_width = 0;
+        ResetSize();
     }
 
     void SetData(wxTreeItemData *data) { m_data = data; }
-    void SetState(int state) { m_state = state; m_width = 0; }
+    void SetState(int state) { m_state = state; ResetSize(); }
+
+    void SetHasPlus(bool has = true)
+    {
+        m_hasPlus = has;
+        m_childrenUnknown = false;
+    }
 
-    void SetHasPlus(bool has = true) { m_hasPlus = has; }
+    // for virtual items only: true if the program hadn't been asked about the
+    // number of the children of this item yet
+    bool AreChildrenUnknown() const { return m_childrenUnknown != 0; }
+    void SetChildrenUnknown() { m_childrenUnknown = true; }
 
     void SetBold(bool bold)
     {
@@ -193,6 +210,8 @@ public:
         ResetTextSize();
     }
 
+    // the position of the item is only updated when it is painted or hit
+    // tested, use wxGenericTreeCtrl::GetItemY() to get its current position
     int GetX() const { return m_x; }
     int GetY() const { return m_y; }
 
@@ -202,6 +221,26 @@ public:
     int GetHeight() const { return m_height; }
     int GetWidth() const { return m_width; }
 
+    // the layout of the item subtree, see wxGenericTreeCtrl::CalculateSubtree()
+    bool IsLayoutDirty() const { return m_layoutDirty != 0; }
+    void SetLayoutDirty() { m_layoutDirty = true; }
+    void RecursiveSetLayoutDirty();
+
+    int GetOffset() const { return m_offset; }
+    void SetOffset(int offset) { m_offset = offset; }
+
+    int GetSubtreeHeight() const { return m_subtreeHeight; }
+    int GetSubtreeWidth() const { return m_subtreeWidth; }
+    void SetSubtreeSize(int height, int width)
+    {
+        m_subtreeHeight = height;
+        m_subtreeWidth = width;
+        m_layoutDirty = false;
+    }
+
+    // only update the width without changing the layout dirty flag
+    void SetSubtreeWidth(int width) { m_subtreeWidth = width; }
+
     int GetTextHeight() const
     {
         wxASSERT_MSG( m_heightText != -1, "must call CalculateSize() first" );
@@ -254,20 +293,24 @@ public:
         { DoCalculateSize(control, dc, true /* dc uses normal font */); }
     void CalculateSize(wxGenericTreeCtrl *control);
 
-    void GetSize( int &x, int &y, const wxGenericTreeCtrl* );
+    void ResetSize()
+    {
+        m_width = 0;
 
-    void ResetSize() { m_width = 0; }
-    void ResetTextSize() { m_width = 0; m_widthText = -1; }
+        // the layout of all the parents depends on this item one too
+        for ( wxGenericTreeItem* item = this; item; item = item->m_parent )
+            item->m_layoutDirty = true;
+    }
+    void ResetTextSize() { ResetSize(); m_widthText = -1; }
     void RecursiveResetSize();
     void RecursiveResetTextSize();
 
-        // return the item at given position (or NULL if no item), onButton is
-        // true if the point belongs to the item's button, otherwise it lies
-        // on the item's label
-    wxGenericTreeItem *HitTest( const wxPoint& point,
-                                const wxGenericTreeCtrl *,
-                                int &flags,
-                                int level );
+        // return true if the given point is inside this item, which must have
+        // been positioned before, and fill flags with the part of the item it
+        // lies on
+    bool HitTest( const wxPoint& point,
+                  const wxGenericTreeCtrl *,
+                  int &flags );
 
     void Expand() { m_isCollapsed = false; }
     void Collapse() { m_isCollapsed = true; }
@@ -300,16 +343,13 @@ public:
         if ( m_ownsAttr ) delete m_attr;
         m_attr = attr;
         m_ownsAttr = false;
-        m_width = 0;
-        m_widthText = -1;
+        ResetTextSize();
     }
         // set them and delete when done
     void AssignAttributes(wxItemAttr *attr)
     {
         SetAttributes(attr);
         m_ownsAttr = true;
-        m_width = 0;
-        m_widthText = -1;
     }
 
 private:
@@ -322,6 +362,12 @@ private:
                          wxDC& dc,
                          bool dcUsesNormalFont);
 
+    // common part of all ctors
+    void Init(wxGenericTreeItem *parent,
+              int image,
+              int selImage,
+              wxTreeItemData *data);
+
     // since there can be very many of these, we save size by chosing
     // the smallest representation for the elements and by ordering
     // the members to avoid padding.
@@ -332,6 +378,7 @@ private:
     wxTreeItemData     *m_data;         // user-provided data
 
     int                 m_state;        // item state
+    unsigned int        m_index;        // index in the parent (virtual only)
 
     wxArrayGenericTreeItems m_children; // list of children
     wxGenericTreeItem  *m_parent;       // parent of this item
@@ -347,6 +394,14 @@ private:
     int                 m_width;        // width of this item
     int                 m_height;       // height of this item
 
+    // the layout of this item subtree, valid only if m_layoutDirty is false:
+    // the offset from the first sibling and the total height of this item and
+    // its visible descendants, both in layout units (rows or pixels), and the
+    // width of the subtree relative to this item position
+    int                 m_offset;
+    int                 m_subtreeHeight;
+    int                 m_subtreeWidth;
+
     // use bitfields to save size
     unsigned int        m_isCollapsed :1;
     unsigned int        m_hasHilight  :1; // same as focused
@@ -354,6 +409,9 @@ private:
                                           // children but has a [+] button
     unsigned int        m_isBold      :1; // render the label in bold font
     unsigned int        m_ownsAttr    :1; // delete attribute when done
+    unsigned int        m_childrenUnknown :1; // virtual item which wasn't
+                                              // checked for children yet
+    unsigned int        m_layoutDirty :1; // subtree layout must be recomputed
 
     wxDECLARE_NO_COPY_CLASS(wxGenericTreeItem);
 };
@@ -424,7 +482,7 @@ wxEND_EVENT_TABLE()
 
 wxTreeTextCtrl::wxTreeTextCtrl(wxGenericTreeCtrl *owner,
                                wxGenericTreeItem *itm)
-              : m_itemEdited(itm), m_startValue(itm->GetText())
+              : m_itemEdited(itm), m_startValue(owner->GetItemText(itm))
 {
     m_owner = owner;
     m_aboutToFinish = false;
@@ -582,6 +640,22 @@ wxGenericTreeItem::wxGenericTreeItem(wxGenericTreeItem *parent,
                                      int image, int selImage,
                                      wxTreeItemData *data)
                  : m_text(text)
+{
+    Init(parent, image, selImage, data);
+}
+
+wxGenericTreeItem::wxGenericTreeItem(wxGenericTreeItem *parent,
+                                     unsigned int index)
+{
+    Init(parent, NO_IMAGE, NO_IMAGE, NULL);
+
+    m_index = index;
+    m_childrenUnknown = true;
+}
+
+void wxGenericTreeItem::Init(wxGenericTreeItem *parent,
+                             int image, int selImage,
+                             wxTreeItemData *data)
 {
     m_images[wxTreeItemIcon_Normal] = image;
     m_images[wxTreeItemIcon_Selected] = selImage;
@@ -590,12 +664,14 @@ wxGenericTreeItem::wxGenericTreeItem(wxGenericTreeItem *parent,
 
     m_data = data;
     m_state = wxTREE_ITEMSTATE_NONE;
+    m_index = 0;
     m_x = m_y = 0;
 
     m_isCollapsed = true;
     m_hasHilight = false;
     m_hasPlus = false;
     m_isBold = false;
+    m_childrenUnknown = false;
 
     m_parent = parent;
 
@@ -608,6 +684,11 @@ wxGenericTreeItem::wxGenericTreeItem(wxGenericTreeItem *parent,
 
     m_widthText = -1;
     m_heightText = -1;
+
+    m_offset = 0;
+    m_subtreeHeight = 0;
+    m_subtreeWidth = 0;
+    m_layoutDirty = true;
 }
 
 wxGenericTreeItem::~wxGenericTreeItem()
@@ -652,122 +733,84 @@ size_t wxGenericTreeItem::GetChildrenCount(bool recursively) const
     return total;
 }
 
-void wxGenericTreeItem::GetSize( int &x, int &y,
-                                 const wxGenericTreeCtrl *theButton )
+bool wxGenericTreeItem::HitTest(const wxPoint& point,
+                                const wxGenericTreeCtrl *theCtrl,
+                                int &flags)
 {
-    int bottomY=m_y+theButton->GetLineHeight(this);
-    if ( y < bottomY ) y = bottomY;
-    int width = m_x +  m_width;
-    if ( x < width ) x = width;
+    // evaluate the item
+    int h = theCtrl->GetLineHeight(this);
+    if ( point.y <= m_y || point.y >= m_y + h )
+        return false;
 
-    if (IsExpanded())
-    {
-        size_t count = m_children.GetCount();
-        for ( size_t n = 0; n < count; ++n )
-        {
-            m_children[n]->GetSize( x, y, theButton );
-        }
-    }
-}
+    int y_mid = m_y + h/2;
+    if (point.y < y_mid )
+        flags |= wxTREE_HITTEST_ONITEMUPPERPART;
+    else
+        flags |= wxTREE_HITTEST_ONITEMLOWERPART;
 
-wxGenericTreeItem *wxGenericTreeItem::HitTest(const wxPoint& point,
-                                              const wxGenericTreeCtrl *theCtrl,
-                                              int &flags,
-                                              int level)
-{
-    // for a hidden root node, don't evaluate it, but do evaluate children
-    if ( !(level == 0 && theCtrl->HasFlag(wxTR_HIDE_ROOT)) )
-    {
-        // evaluate the item
-        int h = theCtrl->GetLineHeight(this);
-        if ((point.y > m_y) && (point.y < m_y + h))
-        {
-            int y_mid = m_y + h/2;
-            if (point.y < y_mid )
-                flags |= wxTREE_HITTEST_ONITEMUPPERPART;
-            else
-                flags |= wxTREE_HITTEST_ONITEMLOWERPART;
+    theCtrl->UpdateVirtualItem(this);
 
-            int xCross = m_x - theCtrl->GetSpacing();
+    int xCross = m_x - theCtrl->GetSpacing();
 #ifdef __WXMAC__
-            // according to the drawing code the triangels are drawn
-            // at -4 , -4  from the position up to +10/+10 max
-            if ((point.x > xCross-4) && (point.x < xCross+10) &&
-                (point.y > y_mid-4) && (point.y < y_mid+10) &&
-                HasPlus() && theCtrl->HasButtons() )
+    // according to the drawing code the triangels are drawn
+    // at -4 , -4  from the position up to +10/+10 max
+    if ((point.x > xCross-4) && (point.x < xCross+10) &&
+        (point.y > y_mid-4) && (point.y < y_mid+10) &&
+        HasPlus() && theCtrl->HasButtons() )
 #else
-            // 5 is the size of the plus sign
-            if ((point.x > xCross-6) && (point.x < xCross+6) &&
-                (point.y > y_mid-6) && (point.y < y_mid+6) &&
-                HasPlus() && theCtrl->HasButtons() )
+    // 5 is the size of the plus sign
+    if ((point.x > xCross-6) && (point.x < xCross+6) &&
+        (point.y > y_mid-6) && (point.y < y_mid+6) &&
+        HasPlus() && theCtrl->HasButtons() )
 #endif
-            {
-                flags |= wxTREE_HITTEST_ONITEMBUTTON;
-                return this;
-            }
-
-            if ((point.x >= m_x) && (point.x <= m_x+m_width))
-            {
-                int image_w = -1;
-
-                // assuming every image (normal and selected) has the same size!
-                if ( (GetImage() != NO_IMAGE) && theCtrl->m_imageListNormal )
-                {
-                    int image_h;
-                    theCtrl->m_imageListNormal->GetSize(GetImage(),
-                                                        image_w, image_h);
-                }
-
-                int state_w = -1;
-
-                if ( (GetState() != wxTREE_ITEMSTATE_NONE) &&
-                        theCtrl->m_imageListState )
-                {
-                    int state_h;
-                    theCtrl->m_imageListState->GetSize(GetState(),
-                                                       state_w, state_h);
-                }
+    {
+        flags |= wxTREE_HITTEST_ONITEMBUTTON;
+        return true;
+    }
 
-                if ((state_w != -1) && (point.x <= m_x + state_w + 1))
-                    flags |= wxTREE_HITTEST_ONITEMSTATEICON;
-                else if ((image_w != -1) &&
-                         (point.x <= m_x +
-                            (state_w != -1 ? state_w +
-                                                MARGIN_BETWEEN_STATE_AND_IMAGE
-                                           : 0)
-                                            + image_w + 1))
-                    flags |= wxTREE_HITTEST_ONITEMICON;
-                else
-                    flags |= wxTREE_HITTEST_ONITEMLABEL;
+    if ((point.x >= m_x) && (point.x <= m_x+m_width))
+    {
+        int image_w = -1;
 
-                return this;
-            }
+        // assuming every image (normal and selected) has the same size!
+        if ( (GetImage() != NO_IMAGE) && theCtrl->m_imageListNormal )
+        {
+            int image_h;
+            theCtrl->m_imageListNormal->GetSize(GetImage(),
+                                                image_w, image_h);
+        }
 
-            if (point.x < m_x)
-                flags |= wxTREE_HITTEST_ONITEMINDENT;
-            if (point.x > m_x+m_width)
-                flags |= wxTREE_HITTEST_ONITEMRIGHT;
+        int state_w = -1;
 
-            return this;
+        if ( (GetState() != wxTREE_ITEMSTATE_NONE) &&
+                theCtrl->m_imageListState )
+        {
+            int state_h;
+            theCtrl->m_imageListState->GetSize(GetState(),
+                                               state_w, state_h);
         }
 
-        // if children are expanded, fall through to evaluate them
-        if (m_isCollapsed) return NULL;
-    }
+        if ((state_w != -1) && (point.x <= m_x + state_w + 1))
+            flags |= wxTREE_HITTEST_ONITEMSTATEICON;
+        else if ((image_w != -1) &&
+                 (point.x <= m_x +
+                    (state_w != -1 ? state_w +
+                                        MARGIN_BETWEEN_STATE_AND_IMAGE
+                                   : 0)
+                                    + image_w + 1))
+            flags |= wxTREE_HITTEST_ONITEMICON;
+        else
+            flags |= wxTREE_HITTEST_ONITEMLABEL;
 
-    // evaluate children
-    size_t count = m_children.GetCount();
-    for ( size_t n = 0; n < count; n++ )
-    {
-        wxGenericTreeItem *res = m_children[n]->HitTest( point,
-                                                         theCtrl,
-                                                         flags,
-                                                         level + 1 );
-        if ( res != NULL )
-            return res;
+        return true;
     }
 
-    return NULL;
+    if (point.x < m_x)
+        flags |= wxTREE_HITTEST_ONITEMINDENT;
+    if (point.x > m_x+m_width)
+        flags |= wxTREE_HITTEST_ONITEMRIGHT;
+
+    return true;
 }
 
 int wxGenericTreeItem::GetCurrentImage() const
@@ -838,7 +881,8 @@ wxGenericTreeItem::DoCalculateSize(wxGenericTreeCtrl* control,
            fontChanged = false;
         }
 
-        dc.GetTextExtent( GetText(), &m_widthText, &m_heightText );
+        dc.GetTextExtent( control->GetItemText(this),
+                          &m_widthText, &m_heightText );
 
         // restore normal font if the DC used it previously and we changed it
         if ( fontChanged )
@@ -878,11 +922,19 @@ wxGenericTreeItem::DoCalculateSize(wxGenericTreeCtrl* control,
         control->m_lineHeight = m_height;
 
     m_width = state_w + image_w + m_widthText + 2;
+
+    // the size of the item affects the layout of its parent, but don't lay out
+    // all the siblings of the virtual items again as they're only measured
+    // when they're painted, just update the widths of their parents instead
+    if ( control->HasFlag(wxTR_VIRTUAL) )
+        control->UpdateVirtualSubtreeWidths(this);
+    else
+        control->MarkLayoutDirty(this);
 }
 
 void wxGenericTreeItem::RecursiveResetSize()
 {
-    m_width = 0;
+    ResetSize();
 
     const size_t count = m_children.Count();
     for (size_t i = 0; i < count; i++ )
@@ -891,14 +943,22 @@ void wxGenericTreeItem::RecursiveResetSize()
 
 void wxGenericTreeItem::RecursiveResetTextSize()
 {
-    m_width = 0;
-    m_widthText = -1;
+    ResetTextSize();
 
     const size_t count = m_children.Count();
     for (size_t i = 0; i < count; i++ )
         m_children[i]->RecursiveResetTextSize();
 }
 
+void wxGenericTreeItem::RecursiveSetLayoutDirty()
+{
+    m_layoutDirty = true;
+
+    const size_t count = m_children.Count();
+    for (size_t i = 0; i < count; i++ )
+        m_children[i]->RecursiveSetLayoutDirty();
+}
+
 // -----------------------------------------------------------------------------
 // wxGenericTreeCtrl implementation
 // -----------------------------------------------------------------------------
@@ -1064,7 +1124,7 @@ unsigned int wxGenericTreeCtrl::GetCount() const
         return 0;
     }
 
-    unsigned int count = m_anchor->GetChildrenCount();
+    unsigned int count = DoGetChildrenCount(m_anchor, true);
     if ( !HasFlag(wxTR_HIDE_ROOT) )
     {
         // take the root itself into account
@@ -1078,6 +1138,10 @@ void wxGenericTreeCtrl::SetIndent(unsigned int indent)
 {
     m_indent = (unsigned short) indent;
     m_dirty = true;
+
+    // the subtree widths depend on the indent
+    if ( m_anchor )
+        m_anchor->RecursiveSetLayoutDirty();
 }
 
 size_t
@@ -1086,7 +1150,44 @@ wxGenericTreeCtrl::GetChildrenCount(const wxTreeItemId& item,
 {
     wxCHECK_MSG( item.IsOk(), 0u, wxT("invalid tree item") );
 
-    return ((wxGenericTreeItem*) item.m_pItem)->GetChildrenCount(recursively);
+    return DoGetChildrenCount((wxGenericTreeItem*) item.m_pItem, recursively);
+}
+
+size_t
+wxGenericTreeCtrl::DoGetChildrenCount(wxGenericTreeItem *item,
+                                      bool recursively) const
+{
+    if ( !HasFlag(wxTR_VIRTUAL) )
+        return item->GetChildrenCount(recursively);
+
+    // don't create the children of a virtual item just to count them
+    if ( !item->HasChildren() )
+    {
+        const unsigned int count = OnGetChildrenCount(item);
+        if ( !recursively )
+            return count;
+
+        size_t total = count;
+        for ( unsigned int n = 0; n < count; n++ )
+        {
+            // a temporary item is enough to ask about its own children
+            wxGenericTreeItem child(item, n);
+            total += DoGetChildrenCount(&child, true);
+        }
+
+        return total;
+    }
+
+    const wxArrayGenericTreeItems& children = item->GetChildren();
+    const size_t count = children.GetCount();
+    if ( !recursively )
+        return count;
+
+    size_t total = count;
+    for ( size_t n = 0; n < count; n++ )
+        total += DoGetChildrenCount(children[n], true);
+
+    return total;
 }
 
 void wxGenericTreeCtrl::SetWindowStyleFlag(long styles)
@@ -1095,6 +1196,8 @@ void wxGenericTreeCtrl::SetWindowStyleFlag(long styles)
     if (m_anchor && !HasFlag(wxTR_HIDE_ROOT) && (styles & wxTR_HIDE_ROOT))
     {
         // if we will hide the root, make sure children are visible
+        if ( styles & wxTR_VIRTUAL )
+            CreateVirtualChildren(m_anchor);
         m_anchor->SetHasPlus();
         m_anchor->Expand();
         CalculatePositions();
@@ -1105,6 +1208,10 @@ void wxGenericTreeCtrl::SetWindowStyleFlag(long styles)
     // none of the parents has updatable styles
     m_windowStyle = styles;
     m_dirty = true;
+
+    // the layout depends on wxTR_HIDE_ROOT and wxTR_HAS_VARIABLE_ROW_HEIGHT
+    if ( m_anchor )
+        m_anchor->RecursiveSetLayoutDirty();
 }
 
 // -----------------------------------------------------------------------------
@@ -1115,7 +1222,13 @@ wxString wxGenericTreeCtrl::GetItemText(const wxTreeItemId& item) const
 {
     wxCHECK_MSG( item.IsOk(), wxEmptyString, wxT("invalid tree item") );
 
-    return ((wxGenericTreeItem*) item.m_pItem)->GetText();
+    wxGenericTreeItem * const pItem = (wxGenericTreeItem*) item.m_pItem;
+
+    // only the root of a virtual tree stores its text
+    if ( HasFlag(wxTR_VIRTUAL) && pItem != m_anchor )
+        return OnGetItemText(pItem);
+
+    return pItem->GetText();
 }
 
 int wxGenericTreeCtrl::GetItemImage(const wxTreeItemId& item,
@@ -1172,7 +1285,16 @@ wxGenericTreeCtrl::SetItemText(const wxTreeItemId& item, const wxString& text)
     wxCHECK_RET( item.IsOk(), wxT("invalid tree item") );
 
     wxGenericTreeItem *pItem = (wxGenericTreeItem*) item.m_pItem;
-    pItem->SetText(text);
+    if ( HasFlag(wxTR_VIRTUAL) && pItem != m_anchor )
+    {
+        // the text is not stored but retrieved from OnGetItemText(), so just
+        // forget its old size
+        pItem->ResetTextSize();
+    }
+    else
+    {
+        pItem->SetText(text);
+    }
     pItem->CalculateSize(this);
     RefreshLine(pItem);
 }
@@ -1350,7 +1472,10 @@ bool wxGenericTreeCtrl::ItemHasChildren(const wxTreeItemId& item) const
     // could have them as well and it's better to err on this side rather than
     // disabling some operations which are restricted to the items with
     // children for an item which does have them
-    return ((wxGenericTreeItem*) item.m_pItem)->HasPlus();
+    wxGenericTreeItem * const pItem = (wxGenericTreeItem*) item.m_pItem;
+    UpdateVirtualItem(pItem);
+
+    return pItem->HasPlus();
 }
 
 bool wxGenericTreeCtrl::IsExpanded(const wxTreeItemId& item) const
@@ -1646,6 +1771,9 @@ wxTreeItemId wxGenericTreeCtrl::DoInsertItem(const wxTreeItemId& parentId,
         return AddRoot(text, image, selImage, data);
     }
 
+    wxCHECK_MSG( !HasFlag(wxTR_VIRTUAL), wxTreeItemId(),
+                 "can't insert items into a virtual tree control" );
+
     m_dirty = true;     // do this first so stuff below doesn't cause flicker
 
     wxGenericTreeItem *item =
@@ -1658,6 +1786,7 @@ wxTreeItemId wxGenericTreeCtrl::DoInsertItem(const wxTreeItemId& parentId,
 
     parent->Insert( item, previous == (size_t)-1 ? parent->GetChildren().size()
                                                  : previous );
+    MarkLayoutDirty(parent);
 
     InvalidateBestSize();
     return item;
@@ -1679,10 +1808,18 @@ wxTreeItemId wxGenericTreeCtrl::AddRoot(const wxString& text,
         data->m_pItem = m_anchor;
     }
 
+    if ( HasFlag(wxTR_VIRTUAL) )
+    {
+        // the children of the root are provided by the program too
+        m_anchor->SetChildrenUnknown();
+    }
+
     if (HasFlag(wxTR_HIDE_ROOT))
     {
         // if root is hidden, make sure we can navigate
         // into children
+        if ( HasFlag(wxTR_VIRTUAL) )
+            CreateVirtualChildren(m_anchor);
         m_anchor->SetHasPlus();
         m_anchor->Expand();
         CalculatePositions();
@@ -1765,6 +1902,19 @@ void wxGenericTreeCtrl::DeleteChildren(const wxTreeItemId& itemId)
     wxGenericTreeItem *item = (wxGenericTreeItem*) itemId.m_pItem;
     ChildrenClosing(item);
     item->DeleteChildren(this);
+    MarkLayoutDirty(item);
+
+    if ( HasFlag(wxTR_VIRTUAL) )
+    {
+        // the children of an expanded item, including the hidden root, must
+        // exist, so recreate them immediately, otherwise ask the program about
+        // them again only when it becomes necessary
+        if ( item->IsExpanded() )
+            CreateVirtualChildren(item);
+        else
+            item->SetChildrenUnknown();
+    }
+
     InvalidateBestSize();
 }
 
@@ -1774,6 +1924,10 @@ void wxGenericTreeCtrl::Delete(const wxTreeItemId& itemId)
 
     wxGenericTreeItem *item = (wxGenericTreeItem*) itemId.m_pItem;
 
+    wxCHECK_RET( !HasFlag(wxTR_VIRTUAL) || item == m_anchor,
+                 "can't delete items of a virtual tree control, "
+                 "use DeleteChildren() or CollapseAndReset() instead" );
+
     if (m_textCtrl != NULL && IsDescendantOf(item, m_textCtrl->item()))
     {
         // can't delete the item being edited, cancel editing it first
@@ -1825,6 +1979,7 @@ void wxGenericTreeCtrl::Delete(const wxTreeItemId& itemId)
     if ( parent )
     {
         parent->GetChildren().Remove( item );  // remove by value
+        MarkLayoutDirty(parent);
     }
     else // deleting the root
     {
@@ -1860,6 +2015,8 @@ void wxGenericTreeCtrl::Expand(const wxTreeItemId& itemId)
     wxCHECK_RET( !HasFlag(wxTR_HIDE_ROOT) || itemId != GetRootItem(),
                  wxT("can't expand hidden root") );
 
+    UpdateVirtualItem(item);
+
     if ( !item->HasPlus() )
         return;
 
@@ -1874,7 +2031,11 @@ void wxGenericTreeCtrl::Expand(const wxTreeItemId& itemId)
         return;
     }
 
+    if ( HasFlag(wxTR_VIRTUAL) )
+        CreateVirtualChildren(item);
+
     item->Expand();
+    MarkLayoutDirty(item);
     if ( !IsFrozen() )
     {
         CalculatePositions();
@@ -1909,6 +2070,7 @@ void wxGenericTreeCtrl::Collapse(const wxTreeItemId& itemId)
 
     ChildrenClosing(item);
     item->Collapse();
+    MarkLayoutDirty(item);
 
 #if 0  // TODO why should items be collapsed recursively?
     wxArrayGenericTreeItems& children = item->GetChildren();
@@ -2101,8 +2263,9 @@ wxGenericTreeCtrl::SelectItemRange(wxGenericTreeItem *item1,
 
     // item2 is not necessary after item1
     // choice first' and 'last' between item1 and item2
-    wxGenericTreeItem *first= (item1->GetY()<item2->GetY()) ? item1 : item2;
-    wxGenericTreeItem *last = (item1->GetY()<item2->GetY()) ? item2 : item1;
+    const bool item1First = GetItemY(item1) < GetItemY(item2);
+    wxGenericTreeItem *first = item1First ? item1 : item2;
+    wxGenericTreeItem *last = item1First ? item2 : item1;
 
     bool select = m_current->IsSelected();
 
@@ -2304,7 +2467,7 @@ void wxGenericTreeCtrl::ScrollTo(const wxTreeItemId &item)
 
     wxGenericTreeItem *gitem = (wxGenericTreeItem*) item.m_pItem;
 
-    int itemY = gitem->GetY();
+    int itemY = GetItemY(gitem);
 
     int start_x = 0;
     int start_y = 0;
@@ -2354,6 +2517,8 @@ void wxGenericTreeCtrl::SortChildren(const wxTreeItemId& itemId)
 
     wxCHECK_RET( !s_treeBeingSorted,
                  wxT("wxGenericTreeCtrl::SortChildren is not reentrant") );
+    wxCHECK_RET( !HasFlag(wxTR_VIRTUAL),
+                 "can't sort the items of a virtual tree control" );
 
     wxArrayGenericTreeItems& children = item->GetChildren();
     if ( children.GetCount() > 1 )
@@ -2363,6 +2528,8 @@ void wxGenericTreeCtrl::SortChildren(const wxTreeItemId& itemId)
         s_treeBeingSorted = this;
         children.Sort(tree_ctrl_compare_func);
         s_treeBeingSorted = NULL;
+
+        MarkLayoutDirty(item);
     }
     //else: don't make the tree dirty as nothing changed
 }
@@ -2471,6 +2638,71 @@ void wxGenericTreeCtrl::AssignButtonsImageList(wxImageList *imageList)
     m_ownsImageListButtons = true;
 }
 
+// -----------------------------------------------------------------------------
+// virtual mode support
+// -----------------------------------------------------------------------------
+
+unsigned int wxGenericTreeCtrl::GetItemIndex(const wxTreeItemId& item) const
+{
+    wxCHECK_MSG( item.IsOk(), 0, wxT("invalid tree item") );
+
+    wxGenericTreeItem * const pItem = (wxGenericTreeItem*) item.m_pItem;
+    if ( HasFlag(wxTR_VIRTUAL) )
+        return pItem->GetIndex();
+
+    wxGenericTreeItem * const parent = pItem->GetParent();
+    if ( !parent )
+        return 0;
+
+    return parent->GetChildren().Index(pItem);
+}
+
+unsigned int
+wxGenericTreeCtrl::OnGetChildrenCount(const wxTreeItemId& WXUNUSED(item)) const
+{
+    // this is a pure virtual function, in fact - which is not really pure
+    // because the controls which are not virtual don't need to implement it
+    wxFAIL_MSG( wxT("wxGenericTreeCtrl::OnGetChildrenCount not supposed to be called") );
+
+    return 0;
+}
+
+wxString
+wxGenericTreeCtrl::OnGetItemText(const wxTreeItemId& WXUNUSED(item)) const
+{
+    // this is a pure virtual function, in fact - which is not really pure
+    // because the controls which are not virtual don't need to implement it
+    wxFAIL_MSG( wxT("wxGenericTreeCtrl::OnGetItemText not supposed to be called") );
+
+    return wxEmptyString;
+}
+
+void wxGenericTreeCtrl::UpdateVirtualItem(wxGenericTreeItem *item) const
+{
+    // only virtual items can have unknown children
+    if ( item->AreChildrenUnknown() )
+        item->SetHasPlus(OnGetChildrenCount(item) != 0);
+}
+
+void wxGenericTreeCtrl::CreateVirtualChildren(wxGenericTreeItem *item)
+{
+    if ( item->HasChildren() )
+        return;
+
+    const unsigned int count = OnGetChildrenCount(item);
+    item->SetHasPlus(count != 0);
+
+    // the children are created without any text, which is only retrieved
+    // when they're shown, so this is cheap even for many of them
+    wxArrayGenericTreeItems& children = item->GetChildren();
+    children.Alloc(count);
+    for ( unsigned int n = 0; n < count; n++ )
+        children.Add(new wxGenericTreeItem(item, n));
+
+    MarkLayoutDirty(item);
+    InvalidateBestSize();
+}
+
 // -----------------------------------------------------------------------------
 // helpers
 // -----------------------------------------------------------------------------
@@ -2479,8 +2711,10 @@ void wxGenericTreeCtrl::AdjustMyScrollbars()
 {
     if (m_anchor)
     {
-        int x = 0, y = 0;
-        m_anchor->GetSize( x, y, this );
+        CalculatePositions();
+
+        int x = GetLevelX(0) + m_anchor->GetSubtreeWidth();
+        int y = MARGIN_TOP + UnitsToPixels(m_anchor->GetSubtreeHeight());
         y += PIXELS_PER_UNIT+2; // one more scrollbar unit + 2 pixels
         x += PIXELS_PER_UNIT+2; // one more scrollbar unit + 2 pixels
         int x_pos = GetScrollPos( wxHORIZONTAL );
@@ -2497,7 +2731,7 @@ void wxGenericTreeCtrl::AdjustMyScrollbars()
 
 int wxGenericTreeCtrl::GetLineHeight(wxGenericTreeItem *item) const
 {
-    if (GetWindowStyleFlag() & wxTR_HAS_VARIABLE_ROW_HEIGHT)
+    if ( HasVariableRowHeight() )
         return item->GetHeight();
     else
         return m_lineHeight;
@@ -2676,7 +2910,7 @@ void wxGenericTreeCtrl::PaintItem(wxGenericTreeItem *item, wxDC& dc)
 
     dc.SetBackgroundMode(wxBRUSHSTYLE_TRANSPARENT);
     int extraH = (total_h > text_h) ? (total_h - text_h)/2 : 0;
-    dc.DrawText( item->GetText(),
+    dc.DrawText( GetItemText(item),
                  (wxCoord)(state_w + image_w + item->GetX()),
                  (wxCoord)(item->GetY() + extraH));
 
@@ -2719,41 +2953,16 @@ void wxGenericTreeCtrl::PaintItem(wxGenericTreeItem *item, wxDC& dc)
 }
 
 void
-wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
-                              wxDC &dc,
-                              int level,
-                              int &y)
+wxGenericTreeCtrl::PaintLine(wxGenericTreeItem *item,
+                             wxDC &dc,
+                             int level,
+                             int y)
 {
     int x = level*m_indent;
     if (!HasFlag(wxTR_HIDE_ROOT))
     {
         x += m_indent;
     }
-    else if (level == 0)
-    {
-        // always expand hidden root
-        int origY = y;
-        wxArrayGenericTreeItems& children = item->GetChildren();
-        int count = children.GetCount();
-        if (count > 0)
-        {
-            int n = 0, oldY;
-            do {
-                oldY = y;
-                PaintLevel(children[n], dc, 1, y);
-            } while (++n < count);
-
-            if ( !HasFlag(wxTR_NO_LINES) && HasFlag(wxTR_LINES_AT_ROOT)
-                    && count > 0 )
-            {
-                // draw line down to last child
-                origY += GetLineHeight(children[0])>>1;
-                oldY += GetLineHeight(children[n-1])>>1;
-                dc.DrawLine(3, origY, 3, oldY);
-            }
-        }
-        return;
-    }
 
     item->SetX(x+m_spacing);
     item->SetY(y);
@@ -2768,6 +2977,8 @@ wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
 
     if (IsExposed(exposed_x, exposed_y, 10000, h))  // 10000 = very much
     {
+        UpdateVirtualItem(item);
+
         const wxPen *pen =
 #ifndef __WXMAC__
             // don't draw rect outline if we already have the
@@ -2875,51 +3086,71 @@ wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
         }
     }
 
-    if (item->IsExpanded())
+    PaintChildrenLine(item, dc, level, y_top);
+}
+
+void
+wxGenericTreeCtrl::PaintChildrenLine(wxGenericTreeItem *item,
+                                     wxDC &dc,
+                                     int level,
+                                     int y)
+{
+    if ( HasFlag(wxTR_NO_LINES) || !item->IsExpanded() )
+        return;
+
+    const wxArrayGenericTreeItems& children = item->GetChildren();
+    if ( children.empty() )
+        return;
+
+    const int yChildren = y + UnitsToPixels(GetLineUnits(item));
+
+    int x, y_mid;
+    if ( item == m_anchor && HasFlag(wxTR_HIDE_ROOT) )
     {
-        wxArrayGenericTreeItems& children = item->GetChildren();
-        int count = children.GetCount();
-        if (count > 0)
-        {
-            int n = 0, oldY;
-            ++level;
-            do {
-                oldY = y;
-                PaintLevel(children[n], dc, level, y);
-            } while (++n < count);
-
-            if (!HasFlag(wxTR_NO_LINES) && count > 0)
-            {
-                // draw line down to last child
-                oldY += GetLineHeight(children[n-1])>>1;
-                if (HasButtons()) y_mid += 5;
-
-                // Only draw the portion of the line that is visible, in case
-                // it is huge
-                wxCoord xOrigin=0, yOrigin=0, width, height;
-                dc.GetDeviceOrigin(&xOrigin, &yOrigin);
-                yOrigin = abs(yOrigin);
-                GetClientSize(&width, &height);
-
-                // Move end points to the beginning/end of the view?
-                if (y_mid < yOrigin)
-                    y_mid = yOrigin;
-                if (oldY > yOrigin + height)
-                    oldY = yOrigin + height;
-
-                // after the adjustments if y_mid is larger than oldY then the
-                // line isn't visible at all so don't draw anything
-                if (y_mid < oldY)
-                    dc.DrawLine(x, y_mid, x, oldY);
-            }
-        }
+        if ( !HasFlag(wxTR_LINES_AT_ROOT) )
+            return;
+
+        // the line connecting the top level items
+        x = 3;
+        y_mid = yChildren + (GetLineHeight(children[0])>>1);
     }
+    else
+    {
+        x = GetLevelX(level) - m_spacing;
+        y_mid = y + (GetLineHeight(item)>>1);
+        if (HasButtons()) y_mid += 5;
+    }
+
+    // draw line down to last child
+    wxGenericTreeItem * const last = children.Last();
+    int oldY = yChildren + UnitsToPixels(last->GetOffset()) +
+                (GetLineHeight(last)>>1);
+
+    // Only draw the portion of the line that is visible, in case
+    // it is huge
+    wxCoord xOrigin=0, yOrigin=0, width, height;
+    dc.GetDeviceOrigin(&xOrigin, &yOrigin);
+    yOrigin = abs(yOrigin);
+    GetClientSize(&width, &height);
+
+    // Move end points to the beginning/end of the view?
+    if (y_mid < yOrigin)
+        y_mid = yOrigin;
+    if (oldY > yOrigin + height)
+        oldY = yOrigin + height;
+
+    // after the adjustments if y_mid is larger than oldY then the
+    // line isn't visible at all so don't draw anything
+    if (y_mid < oldY)
+        dc.DrawLine(x, y_mid, x, oldY);
 }
 
 void wxGenericTreeCtrl::DrawDropEffect(wxGenericTreeItem *item)
 {
     if ( item )
     {
+        UpdateVirtualItem(item);
+
         if ( item->HasPlus() )
         {
             // it's a folder, indicate it by a border
@@ -2958,7 +3189,8 @@ void wxGenericTreeCtrl::DrawBorder(const wxTreeItemId &item)
         m_dndEffectItem = NULL;
     }
 
-    wxRect rect( i->GetX()-1, i->GetY()-1, i->GetWidth()+2, GetLineHeight(i)+2 );
+    wxRect rect( GetItemX(i)-1, GetItemY(i)-1,
+                 i->GetWidth()+2, GetLineHeight(i)+2 );
     CalcScrolledPosition( rect.x, rect.y, &rect.x, &rect.y );
     RefreshRect( rect );
 }
@@ -2983,7 +3215,8 @@ void wxGenericTreeCtrl::DrawLine(const wxTreeItemId &item, bool below)
         m_dndEffectItem = NULL;
     }
 
-    wxRect rect( i->GetX()-1, i->GetY()-1, i->GetWidth()+2, GetLineHeight(i)+2 );
+    wxRect rect( GetItemX(i)-1, GetItemY(i)-1,
+                 i->GetWidth()+2, GetLineHeight(i)+2 );
     CalcScrolledPosition( rect.x, rect.y, &rect.x, &rect.y );
     RefreshRect( rect );
 }
@@ -3004,6 +3237,10 @@ void wxGenericTreeCtrl::OnSize( wxSizeEvent &event )
 
 void wxGenericTreeCtrl::OnPaint( wxPaintEvent &WXUNUSED(event) )
 {
+    // update the layout before starting to paint, this is a no-op if nothing
+    // changed since the last time
+    CalculatePositions();
+
     wxPaintDC dc(this);
     PrepareDC( dc );
 
@@ -3017,8 +3254,62 @@ void wxGenericTreeCtrl::OnPaint( wxPaintEvent &WXUNUSED(event) )
     //if(GetImageList() == NULL)
     // m_lineHeight = (int)(dc.GetCharHeight() + 4);
 
-    int y = 2;
-    PaintLevel( m_anchor, dc, 0, y );
+    // only paint the items intersecting the update region: find the first of
+    // them directly and then iterate over the following ones
+    const wxRect rectUpdate = GetUpdateRegion().GetBox();
+    int yTop, yBottom;
+    CalcUnscrolledPosition(0, rectUpdate.GetTop(), NULL, &yTop);
+    CalcUnscrolledPosition(0, rectUpdate.GetBottom(), NULL, &yBottom);
+
+    // path[n] is the index of the item at level n+1 among its siblings
+    wxVector<size_t> path;
+    int y;
+    wxGenericTreeItem *item = FindItemAtY(yTop, path, y);
+    if ( !item )
+        return;
+
+    // the lines connecting the children of the parent items not painted
+    // below may still cross the update region
+    int level = path.size();
+    for ( wxGenericTreeItem *parent = item->GetParent();
+          parent;
+          parent = parent->GetParent() )
+    {
+        PaintChildrenLine(parent, dc, --level, GetItemY(parent));
+    }
+
+    while ( item && y <= yBottom )
+    {
+        PaintLine(item, dc, path.size(), y);
+        y += GetLineHeight(item);
+
+        // advance to the next visible item
+        if ( item->IsExpanded() && item->HasChildren() )
+        {
+            path.push_back(0);
+            item = item->GetChildren()[0];
+            continue;
+        }
+
+        for ( ;; )
+        {
+            wxGenericTreeItem * const parent = item->GetParent();
+            if ( !parent )
+            {
+                item = NULL;
+                break;
+            }
+
+            if ( ++path.back() < parent->GetChildren().size() )
+            {
+                item = parent->GetChildren()[path.back()];
+                break;
+            }
+
+            path.pop_back();
+            item = parent;
+        }
+    }
 }
 
 void wxGenericTreeCtrl::OnSetFocus( wxFocusEvent &event )
@@ -3104,7 +3395,7 @@ void wxGenericTreeCtrl::OnChar( wxKeyEvent &event )
     {
         case '+':
         case WXK_ADD:
-            if (m_current->HasPlus() && !IsExpanded(m_current))
+            if (ItemHasChildren(m_current) && !IsExpanded(m_current))
             {
                 Expand(m_current);
             }
@@ -3397,8 +3688,7 @@ wxGenericTreeCtrl::DoTreeHitTest(const wxPoint& point, int& flags) const
         return wxTreeItemId();
     }
 
-    wxGenericTreeItem *hit =  m_anchor->HitTest(CalcUnscrolledPosition(point),
-                                                this, flags, 0);
+    wxGenericTreeItem *hit = HitTestItem(CalcUnscrolledPosition(point), flags);
     if (hit == NULL)
     {
         flags = wxTREE_HITTEST_NOWHERE;
@@ -3419,6 +3709,10 @@ bool wxGenericTreeCtrl::GetBoundingRect(const wxTreeItemId& item,
 
     if ( textOnly )
     {
+        // virtual items are not measured until they're painted
+        if ( HasFlag(wxTR_VIRTUAL) )
+            i->CalculateSize(wxConstCast(this, wxGenericTreeCtrl));
+
         int image_w = 0;
         int image = ((wxGenericTreeItem*) item.m_pItem)->GetCurrentImage();
         if ( image != NO_IMAGE && m_imageListNormal )
@@ -3440,7 +3734,7 @@ bool wxGenericTreeCtrl::GetBoundingRect(const wxTreeItemId& item,
                 state_w += MARGIN_BETWEEN_IMAGE_AND_TEXT;
         }
 
-        rect.x = i->GetX() + state_w + image_w;
+        rect.x = GetItemX(i) + state_w + image_w;
         rect.width = i->GetWidth() - state_w - image_w;
 
     }
@@ -3450,7 +3744,7 @@ bool wxGenericTreeCtrl::GetBoundingRect(const wxTreeItemId& item,
         rect.width = GetClientSize().x;
     }
 
-    rect.y = i->GetY();
+    rect.y = GetItemY(i);
     rect.height = GetLineHeight(i);
 
     // we have to return the logical coordinates, not physical ones
@@ -3536,7 +3830,7 @@ void wxGenericTreeCtrl::OnMouse( wxMouseEvent &event )
 
     // Is the mouse over a tree item button?
     int flags = 0;
-    wxGenericTreeItem *thisItem = m_anchor->HitTest(pt, this, flags, 0);
+    wxGenericTreeItem *thisItem = HitTestItem(pt, flags);
     wxGenericTreeItem *underMouse = thisItem;
 #if wxUSE_TOOLTIPS
     bool underMouseChanged = (underMouse != m_underMouse) ;
@@ -3621,7 +3915,7 @@ void wxGenericTreeCtrl::OnMouse( wxMouseEvent &event )
 
 
     flags = 0;
-    wxGenericTreeItem *item = m_anchor->HitTest(pt, this, flags, 0);
+    wxGenericTreeItem *item = HitTestItem(pt, flags);
 
     if ( event.Dragging() && !m_isDragging )
     {
@@ -3892,7 +4186,7 @@ void wxGenericTreeCtrl::OnMouse( wxMouseEvent &event )
                     // if the user code didn't process the activate event,
                     // handle it ourselves by toggling the item when it is
                     // double clicked
-                    if ( item->HasPlus() )
+                    if ( ItemHasChildren(item) )
                     {
                         Toggle(item);
                     }
@@ -3924,60 +4218,208 @@ void wxGenericTreeCtrl::OnInternalIdle()
         DoDirtyProcessing();
 }
 
-void
-wxGenericTreeCtrl::CalculateLevel(wxGenericTreeItem *item,
-                                  wxDC &dc,
-                                  int level,
-                                  int &y )
+void wxGenericTreeCtrl::MarkLayoutDirty(wxGenericTreeItem *item)
 {
-    int x = level*m_indent;
-    if (!HasFlag(wxTR_HIDE_ROOT))
+    // the layout of all the parents depends on this item one too
+    for ( ; item; item = item->GetParent() )
+        item->SetLayoutDirty();
+}
+
+void wxGenericTreeCtrl::UpdateVirtualSubtreeWidths(wxGenericTreeItem *item)
+{
+    // all virtual items have the same height, so measuring one of them can
+    // only make the subtrees containing it wider
+    int width = item->GetWidth();
+    for ( ; item; item = item->GetParent() )
     {
+        // no need to do anything if the layout will be recalculated anyhow
+        if ( item->IsLayoutDirty() || item->GetSubtreeWidth() >= width )
+            return;
+
+        item->SetSubtreeWidth(width);
+        width += m_indent;
+    }
+
+    // the whole tree became wider, update the scrollbars
+    m_dirty = true;
+}
+
+bool wxGenericTreeCtrl::HasVariableRowHeight() const
+{
+    // virtual items are measured only when they're shown, so they can't have
+    // variable height
+    return HasFlag(wxTR_HAS_VARIABLE_ROW_HEIGHT) && !HasFlag(wxTR_VIRTUAL);
+}
+
+int wxGenericTreeCtrl::GetLineUnits(const wxGenericTreeItem *item) const
+{
+    // the hidden root doesn't take any space
+    if ( item == m_anchor && HasFlag(wxTR_HIDE_ROOT) )
+        return 0;
+
+    // if all rows have the same height, count them instead of pixels so that
+    // the layout doesn't depend on m_lineHeight
+    return HasVariableRowHeight() ? item->GetHeight() : 1;
+}
+
+int wxGenericTreeCtrl::UnitsToPixels(int units) const
+{
+    return HasVariableRowHeight() ? units : units*m_lineHeight;
+}
+
+int wxGenericTreeCtrl::GetLevelX(int level) const
+{
+    int x = level*m_indent;
+    if ( !HasFlag(wxTR_HIDE_ROOT) )
         x += m_indent;
+
+    return x + m_spacing;
+}
+
+int wxGenericTreeCtrl::GetItemX(const wxGenericTreeItem *item) const
+{
+    int level = 0;
+    for ( item = item->GetParent(); item; item = item->GetParent() )
+        level++;
+
+    return GetLevelX(level);
+}
+
+int wxGenericTreeCtrl::GetItemY(const wxGenericTreeItem *item) const
+{
+    wxConstCast(this, wxGenericTreeCtrl)->CalculatePositions();
+
+    // the item is below all the previous siblings of it and of its parents
+    int units = 0;
+    for ( const wxGenericTreeItem *parent = item->GetParent();
+          parent;
+          item = parent, parent = parent->GetParent() )
+    {
+        units += GetLineUnits(parent) + item->GetOffset();
     }
-    else if (level == 0)
+
+    return MARGIN_TOP + UnitsToPixels(units);
+}
+
+wxGenericTreeItem *
+wxGenericTreeCtrl::FindItemAtY(int y, wxVector<size_t>& path, int& top) const
+{
+    path.clear();
+
+    wxGenericTreeItem *item = m_anchor;
+    top = MARGIN_TOP;
+    if ( y >= top + UnitsToPixels(item->GetSubtreeHeight()) )
+        return NULL;
+
+    for ( ;; )
     {
-        // a hidden root is not evaluated, but its
-        // children are always calculated
-        goto Recurse;
+        const int height = UnitsToPixels(GetLineUnits(item));
+        if ( height && y < top + height )
+            return item;
+
+        // we must have a visible child containing y if we get here
+        const wxArrayGenericTreeItems& children = item->GetChildren();
+        wxCHECK_MSG( item->IsExpanded() && !children.empty(), NULL,
+                     "inconsistent tree layout" );
+
+        top += height;
+
+        int units = y - top;
+        if ( !HasVariableRowHeight() )
+            units /= m_lineHeight;
+
+        // find the last child starting above y using binary search
+        size_t lo = 0,
+               hi = children.size();
+        while ( hi - lo > 1 )
+        {
+            const size_t mid = lo + (hi - lo) / 2;
+            if ( children[mid]->GetOffset() <= units )
+                lo = mid;
+            else
+                hi = mid;
+        }
+
+        item = children[lo];
+        top += UnitsToPixels(item->GetOffset());
+        path.push_back(lo);
     }
+}
 
-    item->CalculateSize(this, dc);
+wxGenericTreeItem *
+wxGenericTreeCtrl::HitTestItem(const wxPoint& point, int& flags) const
+{
+    if ( !m_anchor )
+        return NULL;
 
-    // set its position
-    item->SetX( x+m_spacing );
-    item->SetY( y );
-    y += GetLineHeight(item);
+    wxConstCast(this, wxGenericTreeCtrl)->CalculatePositions();
 
-    if ( !item->IsExpanded() )
+    wxVector<size_t> path;
+    int y;
+    wxGenericTreeItem * const item = FindItemAtY(point.y, path, y);
+    if ( !item )
+        return NULL;
+
+    item->SetX(GetLevelX(path.size()));
+    item->SetY(y);
+
+    return item->HitTest(point, this, flags) ? item : NULL;
+}
+
+void
+wxGenericTreeCtrl::CalculateSubtree(wxGenericTreeItem *item, wxDC& dc)
+{
+    int height = GetLineUnits(item);
+    int width = item->GetWidth();
+
+    // the children of a collapsed item don't need to be laid out as they're
+    // not shown, this will be done when it is expanded and marked as dirty
+    if ( item->IsExpanded() )
     {
-        // we don't need to calculate collapsed branches
-        return;
+        wxArrayGenericTreeItems& children = item->GetChildren();
+        const size_t count = children.GetCount();
+
+        int offset = 0;
+        for ( size_t n = 0; n < count; n++ )
+        {
+            wxGenericTreeItem * const child = children[n];
+
+            // don't measure the virtual items here as this would require
+            // retrieving the text of all of them, this is done in PaintLine()
+            // for the visible items only
+            if ( !HasFlag(wxTR_VIRTUAL) )
+                child->CalculateSize(this, dc);
+
+            // only recurse into the subtrees which changed
+            if ( child->IsLayoutDirty() )
+                CalculateSubtree(child, dc);
+
+            child->SetOffset(offset);
+            offset += child->GetSubtreeHeight();
+
+            const int widthChild = m_indent + child->GetSubtreeWidth();
+            if ( widthChild > width )
+                width = widthChild;
+        }
+
+        height += offset;
     }
 
-  Recurse:
-    wxArrayGenericTreeItems& children = item->GetChildren();
-    size_t n, count = children.GetCount();
-    ++level;
-    for (n = 0; n < count; ++n )
-        CalculateLevel( children[n], dc, level, y );  // recurse
+    item->SetSubtreeSize(height, width);
 }
 
 void wxGenericTreeCtrl::CalculatePositions()
 {
-    if ( !m_anchor ) return;
+    // nothing to do if nothing changed since the last call
+    if ( !m_anchor || !m_anchor->IsLayoutDirty() ) return;
 
     wxClientDC dc(this);
-    PrepareDC( dc );
-
     dc.SetFont( m_normalFont );
 
-    dc.SetPen( m_dottedPen );
-    //if(GetImageList() == NULL)
-    // m_lineHeight = (int)(dc.GetCharHeight() + 4);
+    if ( !HasFlag(wxTR_HIDE_ROOT) )
+        m_anchor->CalculateSize(this, dc);
 
-    int y = 2;
-    CalculateLevel( m_anchor, dc, 0, y ); // start recursion
+    CalculateSubtree( m_anchor, dc );
 }
 
 void wxGenericTreeCtrl::Refresh(bool eraseBackground, const wxRect *rect)
@@ -3994,7 +4436,7 @@ void wxGenericTreeCtrl::RefreshSubtree(wxGenericTreeItem *item)
     wxSize client = GetClientSize();
 
     wxRect rect;
-    CalcScrolledPosition(0, item->GetY(), NULL, &rect.y);
+    CalcScrolledPosition(0, GetItemY(item), NULL, &rect.y);
     rect.width = client.x;
     rect.height = client.y;
 
@@ -4009,7 +4451,7 @@ void wxGenericTreeCtrl::RefreshLine( wxGenericTreeItem *item )
         return;
 
     wxRect rect;
-    CalcScrolledPosition(0, item->GetY(), NULL, &rect.y);
+    CalcScrolledPosition(0, GetItemY(item), NULL, &rect.y);
     rect.width = GetClientSize().x;
     rect.height = GetLineHeight(item); //dc.GetCharHeight() + 6;
 
@@ -4084,10 +4526,10 @@ void wxGenericTreeCtrl::OnGetToolTip( wxTreeEvent &event )
     const wxGenericTreeItem* const pItem = (wxGenericTreeItem*)itemId.m_pItem;
 
     // Check if the item fits into the client area:
-    if ( pItem->GetX() + pItem->GetWidth() > GetClientSize().x )
+    if ( GetItemX(pItem) + pItem->GetWidth() > GetClientSize().x )
     {
         // If it doesn't, show its full text in the tooltip.
-        event.SetLabel(pItem->GetText());
+        event.SetLabel(GetItemText(itemId));
     }
     else
 #endif // wxUSE_TOOLTIPS
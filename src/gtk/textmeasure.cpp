@@ -26,21 +26,270 @@
 #include "wx/private/textmeasure.h"
 
 #include "wx/fontutil.h"
+#include "wx/hashmap.h"
+#include "wx/vector.h"
 #include "wx/gtk/private.h"
+#include "wx/gtk/private/extentcache.h"
 #include "wx/gtk/dc.h"
 
 #ifndef __WXGTK3__
     #include "wx/gtk/dcclient.h"
 #endif
 
+// ============================================================================
+// wxGtkTextExtentCache implementation
+// ============================================================================
+
+const size_t wxGtkTextExtentCache::NONE;
+
+wxGtkTextExtentCache::wxGtkTextExtentCache()
+    : m_buckets(MAX_ENTRIES, NONE)
+{
+    m_head =
+    m_tail = NONE;
+
+    m_hits =
+    m_misses = 0;
+}
+
+wxGtkTextExtentCache::~wxGtkTextExtentCache()
+{
+    Clear();
+}
+
+/* static */
+wxGtkTextExtentCache& wxGtkTextExtentCache::Get()
+{
+    static wxGtkTextExtentCache s_cache;
+
+    return s_cache;
+}
+
+/* static */
+size_t wxGtkTextExtentCache::GetHash(const wxGtkTextExtentContext& context,
+                                     const PangoFontDescription *desc,
+                                     const wxString& text)
+{
+    // The matrix components are not used for hashing as they're almost
+    // always the same, they're still compared by FindEntry().
+    size_t hash = wxStringHash::stringHash(text.wx_str());
+    hash = hash*31 + pango_font_description_hash(desc);
+    hash = hash*31 + wxPtrToUInt(context.fontMap);
+    hash = hash*31 + context.kind;
+
+    return hash;
+}
+
+size_t wxGtkTextExtentCache::FindEntry(const wxGtkTextExtentContext& context,
+                                       const PangoFontDescription *desc,
+                                       const wxString& text,
+                                       size_t hash) const
+{
+    for ( size_t n = m_buckets[hash & (MAX_ENTRIES - 1)];
+          n != NONE;
+          n = m_entries[n].nextInBucket )
+    {
+        const Entry& entry = m_entries[n];
+        if ( entry.hash == hash &&
+                entry.context == context &&
+                    entry.text == text &&
+                        pango_font_description_equal(entry.desc, desc) )
+        {
+            return n;
+        }
+    }
+
+    return NONE;
+}
+
+bool wxGtkTextExtentCache::Find(const wxGtkTextExtentContext& context,
+                                const PangoFontDescription *desc,
+                                const wxString& text,
+                                int *width, int *height, int *descent)
+{
+    const size_t n = FindEntry(context, desc, text,
+                               GetHash(context, desc, text));
+    if ( n == NONE )
+    {
+        m_misses++;
+        return false;
+    }
+
+    m_hits++;
+
+    if ( n != m_head )
+    {
+        Unlink(n);
+        LinkAtFront(n);
+    }
+
+    const Entry& entry = m_entries[n];
+    if ( width )
+        *width = entry.width;
+    if ( height )
+        *height = entry.height;
+    if ( descent )
+        *descent = entry.descent;
+
+    return true;
+}
+
+void wxGtkTextExtentCache::Add(const wxGtkTextExtentContext& context,
+                               const PangoFontDescription *desc,
+                               const wxString& text,
+                               int width, int height, int descent)
+{
+    const size_t hash = GetHash(context, desc, text);
+
+    size_t n = FindEntry(context, desc, text, hash);
+    if ( n != NONE )
+    {
+        // just update the existing entry
+        Unlink(n);
+    }
+    else
+    {
+        if ( m_entries.size() < MAX_ENTRIES )
+        {
+            n = m_entries.size();
+            m_entries.push_back(Entry());
+        }
+        else // reuse the least recently used entry
+        {
+            n = m_tail;
+            Unlink(n);
+            RemoveFromBucket(n);
+            pango_font_description_free(m_entries[n].desc);
+        }
+
+        Entry& entry = m_entries[n];
+        entry.context = context;
+        entry.desc = pango_font_description_copy(desc);
+        entry.text = text;
+        entry.hash = hash;
+
+        size_t& bucket = m_buckets[hash & (MAX_ENTRIES - 1)];
+        entry.nextInBucket = bucket;
+        bucket = n;
+    }
+
+    Entry& entry = m_entries[n];
+    entry.width = width;
+    entry.height = height;
+    entry.descent = descent;
+
+    LinkAtFront(n);
+}
+
+void wxGtkTextExtentCache::Clear()
+{
+    for ( size_t n = 0; n < m_entries.size(); n++ )
+        pango_font_description_free(m_entries[n].desc);
+
+    m_entries.clear();
+
+    for ( size_t n = 0; n < m_buckets.size(); n++ )
+        m_buckets[n] = NONE;
+
+    m_head =
+    m_tail = NONE;
+}
+
+void wxGtkTextExtentCache::Unlink(size_t n)
+{
+    Entry& entry = m_entries[n];
+
+    if ( entry.prev == NONE )
+        m_head = entry.next;
+    else
+        m_entries[entry.prev].next = entry.next;
+
+    if ( entry.next == NONE )
+        m_tail = entry.prev;
+    else
+        m_entries[entry.next].prev = entry.prev;
+}
+
+void wxGtkTextExtentCache::LinkAtFront(size_t n)
+{
+    Entry& entry = m_entries[n];
+    entry.prev = NONE;
+    entry.next = m_head;
+
+    if ( m_head == NONE )
+        m_tail = n;
+    else
+        m_entries[m_head].prev = n;
+
+    m_head = n;
+}
+
+void wxGtkTextExtentCache::RemoveFromBucket(size_t n)
+{
+    size_t* link = &m_buckets[m_entries[n].hash & (MAX_ENTRIES - 1)];
+    while ( *link != n )
+        link = &m_entries[*link].nextInBucket;
+
+    *link = m_entries[n].nextInBucket;
+}
+
+// ============================================================================
+// helpers
+// ============================================================================
+
+namespace
+{
+
+// Return true if the string contains any characters forcing a line break.
+bool HasLineSeparator(const wxString& s)
+{
+    for ( wxString::const_iterator it = s.begin(); it != s.end(); ++it )
+    {
+        switch ( (*it).GetValue() )
+        {
+            case '\n':
+            case '\r':
+            case '\v':
+            case '\f':
+            case 0x85:   // NEXT LINE
+            case 0x2028: // LINE SEPARATOR
+            case 0x2029: // PARAGRAPH SEPARATOR
+                return true;
+        }
+    }
+
+    return false;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // wxTextMeasure implementation
 // ============================================================================
 
+/* static */
+void wxTextMeasure::GetExtentCacheStats(unsigned long *hits,
+                                        unsigned long *misses)
+{
+    const wxGtkTextExtentCache& cache = wxGtkTextExtentCache::Get();
+
+    if ( hits )
+        *hits = cache.GetHits();
+    if ( misses )
+        *misses = cache.GetMisses();
+}
+
+/* static */
+void wxTextMeasure::ClearExtentCache()
+{
+    wxGtkTextExtentCache::Get().Clear();
+}
+
 void wxTextMeasure::Init()
 {
     m_context = NULL;
     m_layout = NULL;
+    m_cacheFontDesc = NULL;
 
 #ifndef __WXGTK3__
     m_wdc = NULL;
@@ -83,8 +332,17 @@ void wxTextMeasure::BeginMeasuring()
     // set the font to use
     if ( m_layout )
     {
-        pango_layout_set_font_description(m_layout,
-                                          GetFont().GetNativeFontInfo()->description);
+        const PangoFontDescription* const
+            desc = GetFont().GetNativeFontInfo()->description;
+
+        pango_layout_set_font_description(m_layout, desc);
+
+        // The extents depend on the font map used by the context as well as
+        // on the font itself and, because of the different rounding used in
+        // DoGetTextExtent(), on whether we measure for a DC or a window.
+        m_cacheContext.fontMap = pango_context_get_font_map(m_context);
+        m_cacheContext.kind = m_dc ? 'd' : 'w';
+        m_cacheFontDesc = desc;
     }
 }
 
@@ -123,6 +381,19 @@ void wxTextMeasure::DoGetTextExtent(const wxString& string,
         return;
     }
 
+    // Check if we had already measured this string recently.
+    wxGtkTextExtentCache& cache = wxGtkTextExtentCache::Get();
+    int descentCached;
+    if ( cache.Find(m_cacheContext, m_cacheFontDesc, string,
+                    width, height, &descentCached) )
+    {
+        if ( descent )
+            *descent = descentCached;
+        if ( externalLeading )
+            *externalLeading = 0;
+        return;
+    }
+
     // Set layout's text
     const wxCharBuffer dataUTF8 = wxGTK_CONV_FONT(string, GetFont());
     if ( !dataUTF8 && !string.empty() )
@@ -147,13 +418,17 @@ void wxTextMeasure::DoGetTextExtent(const wxString& string,
         *height = PANGO_PIXELS(rect.height);
     }
 
+    // Always compute the descent to be able to cache it.
+    PangoLayoutIter *iter = pango_layout_get_iter(m_layout);
+    int baseline = pango_layout_iter_get_baseline(iter);
+    pango_layout_iter_free(iter);
+    descentCached = *height - PANGO_PIXELS(baseline);
+
+    cache.Add(m_cacheContext, m_cacheFontDesc, string,
+              *width, *height, descentCached);
+
     if (descent)
-    {
-        PangoLayoutIter *iter = pango_layout_get_iter(m_layout);
-        int baseline = pango_layout_iter_get_baseline(iter);
-        pango_layout_iter_free(iter);
-        *descent = *height - PANGO_PIXELS(baseline);
-    }
+        *descent = descentCached;
 
     if (externalLeading)
     {
@@ -162,6 +437,96 @@ void wxTextMeasure::DoGetTextExtent(const wxString& string,
     }
 }
 
+void wxTextMeasure::DoGetTextExtents(const wxArrayString& strings,
+                                     wxArrayInt& widths,
+                                     wxArrayInt& heights)
+{
+    if ( !m_layout )
+    {
+        wxTextMeasureBase::DoGetTextExtents(strings, widths, heights);
+        return;
+    }
+
+    wxGtkTextExtentCache& cache = wxGtkTextExtentCache::Get();
+
+    // Find the strings which are not in the cache yet and combine them into
+    // a single text with one string per line to shape all of them at once.
+    wxArrayInt indices;
+    wxString text;
+    const size_t count = strings.size();
+    for ( size_t n = 0; n < count; n++ )
+    {
+        const wxString& s = strings[n];
+
+        if ( cache.Find(m_cacheContext, m_cacheFontDesc, s,
+                        &widths[n], &heights[n], NULL) )
+            continue;
+
+        // Pango would split the strings containing line separators into
+        // several lines, so measure them separately.
+        if ( HasLineSeparator(s) )
+        {
+            DoGetTextExtent(s, &widths[n], &heights[n]);
+            continue;
+        }
+
+        if ( !indices.empty() )
+            text += wxS('\n');
+        text += s;
+
+        indices.push_back(n);
+    }
+
+    if ( indices.empty() )
+        return;
+
+    const wxCharBuffer dataUTF8 = wxGTK_CONV_FONT(text, GetFont());
+    if ( !dataUTF8 )
+    {
+        // Don't lose the extents of all the strings if just one of them
+        // can't be converted, measure them one by one instead.
+        for ( size_t i = 0; i < indices.size(); i++ )
+        {
+            const size_t n = indices[i];
+            DoGetTextExtent(strings[n], &widths[n], &heights[n]);
+        }
+        return;
+    }
+
+    pango_layout_set_text(m_layout, dataUTF8, -1);
+
+    PangoLayoutIter *iter = pango_layout_get_iter(m_layout);
+    for ( size_t i = 0; i < indices.size(); i++ )
+    {
+        const size_t n = indices[i];
+
+        PangoRectangle rect;
+        pango_layout_iter_get_line_extents(iter, NULL, &rect);
+        const int baseline = pango_layout_iter_get_baseline(iter) - rect.y;
+
+        // Use the same rounding as DoGetTextExtent() does for a layout
+        // containing just this line: pango_layout_get_pixel_size() rounds
+        // the size up as the origin of such layout is 0.
+        if ( m_dc )
+        {
+            widths[n] = (rect.width + PANGO_SCALE - 1) / PANGO_SCALE;
+            heights[n] = (rect.height + PANGO_SCALE - 1) / PANGO_SCALE;
+        }
+        else
+        {
+            widths[n] = PANGO_PIXELS(rect.width);
+            heights[n] = PANGO_PIXELS(rect.height);
+        }
+
+        cache.Add(m_cacheContext, m_cacheFontDesc, strings[n],
+                  widths[n], heights[n], heights[n] - PANGO_PIXELS(baseline));
+
+        if ( !pango_layout_iter_next_line(iter) )
+            break;
+    }
+    pango_layout_iter_free(iter);
+}
+
 bool wxTextMeasure::DoGetPartialTextExtents(const wxString& text,
                                             wxArrayInt& widths,
                                             double scaleX)
@@ -24,10 +24,15 @@
     #include "wx/wxcrtvararg.h"
 #endif
 
+#include "wx/thread.h"
+
 #include "wx/html/htmlcell.h"
 #include "wx/html/htmlwin.h"
+#include "wx/vector.h"
 
 #include <stdlib.h>
+#include <limits.h>
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 // Helper classes
@@ -69,6 +74,196 @@ GetSelectedTextBgColour(const wxColour& WXUNUSED(clr))
 }
 
 
+//-----------------------------------------------------------------------------
+// wxHtmlCellsAllocator
+//-----------------------------------------------------------------------------
+
+#if !wxUSE_MEMORY_TRACING
+
+// Parsing a page creates a huge number of small cells, so instead of
+// allocating memory for each of them separately, carve it out of big blocks.
+// The memory of the deleted cells is kept in a free list for each size and
+// reused for the new cells of the same size. When the last cell is deleted,
+// e.g. when the page is replaced with another one, all the blocks except the
+// current one are released at once.
+//
+// This is only done for the cells created in the main thread, so that no
+// locking is needed. The cells created by wxHtmlDCRenderer used from another
+// thread are allocated in the usual way and must be deleted by the same
+// thread.
+class wxHtmlCellsAllocator
+{
+public:
+    // the cells bigger than this are allocated in the usual way
+    enum { MAX_SIZE = 512 };
+
+    // Notice that this class is used as a static object, so it must not have
+    // any ctor or dtor, its fields are just zero-initialized.
+
+    void* Alloc(size_t size)
+    {
+        const size_t n = GetSizeIndex(size);
+
+        m_numCells++;
+
+        FreeCell* const cell = m_freeCells[n];
+        if ( cell )
+        {
+            m_freeCells[n] = cell->next;
+            return cell;
+        }
+
+        const size_t bytes = (n + 1)*GRANULARITY;
+        if ( static_cast<size_t>(m_end - m_pos) < bytes )
+        {
+            // the rest of the current block, if any, is just wasted
+            Block* const block = static_cast<Block*>(::operator new(BLOCK_SIZE));
+            block->prev = m_block;
+            m_block = block;
+            m_pos = reinterpret_cast<char*>(block + 1);
+            m_end = reinterpret_cast<char*>(block) + BLOCK_SIZE;
+        }
+
+        void* const p = m_pos;
+        m_pos += bytes;
+
+        return p;
+    }
+
+    void Free(void* p, size_t size)
+    {
+        if ( !--m_numCells )
+        {
+            // there is no need to remember the free cells individually
+            ReleaseBlocks(true /* keep the current one */);
+            return;
+        }
+
+        FreeCell* const cell = static_cast<FreeCell*>(p);
+        const size_t n = GetSizeIndex(size);
+        cell->next = m_freeCells[n];
+        m_freeCells[n] = cell;
+    }
+
+    // release all the blocks if they're not used any more
+    void Cleanup()
+    {
+        if ( !m_numCells )
+            ReleaseBlocks(false);
+    }
+
+private:
+    enum
+    {
+        GRANULARITY = 16,
+        NUM_SIZES = MAX_SIZE / GRANULARITY,
+        BLOCK_SIZE = 64*1024
+    };
+
+    // the header of each block, linking it to the previously allocated one,
+    // whose size is a multiple of GRANULARITY to preserve the cells alignment
+    union Block
+    {
+        Block *prev;
+        char padding[GRANULARITY];
+    };
+
+    // the deleted cells are linked together using their own memory
+    struct FreeCell
+    {
+        FreeCell *next;
+    };
+
+    static size_t GetSizeIndex(size_t size)
+    {
+        return (size - 1) / GRANULARITY;
+    }
+
+    void ReleaseBlocks(bool keepCurrent)
+    {
+        Block *block = m_block;
+        if ( keepCurrent && block )
+        {
+            block = block->prev;
+            m_block->prev = NULL;
+            m_pos = reinterpret_cast<char*>(m_block + 1);
+        }
+        else
+        {
+            m_block = NULL;
+            m_pos =
+            m_end = NULL;
+        }
+
+        while ( block )
+        {
+            Block* const prev = block->prev;
+            ::operator delete(block);
+            block = prev;
+        }
+
+        for ( size_t n = 0; n < NUM_SIZES; n++ )
+            m_freeCells[n] = NULL;
+    }
+
+    // the number of the cells allocated from the blocks still alive
+    size_t m_numCells;
+
+    // the last allocated block, used for allocating the new cells, and its
+    // free part
+    Block *m_block;
+    char *m_pos,
+         *m_end;
+
+    // the lists of the deleted cells of each size
+    FreeCell *m_freeCells[NUM_SIZES];
+};
+
+static wxHtmlCellsAllocator gs_cellsAllocator;
+
+void* wxHtmlCell::operator new(size_t size)
+{
+    if ( size > wxHtmlCellsAllocator::MAX_SIZE || !wxIsMainThread() )
+        return ::operator new(size);
+
+    return gs_cellsAllocator.Alloc(size);
+}
+
+void wxHtmlCell::operator delete(void* p, size_t size)
+{
+    if ( !p )
+        return;
+
+    if ( size > wxHtmlCellsAllocator::MAX_SIZE || !wxIsMainThread() )
+    {
+        ::operator delete(p);
+        return;
+    }
+
+    gs_cellsAllocator.Free(p, size);
+}
+
+class wxHtmlCellsModule : public wxModule
+{
+public:
+    wxHtmlCellsModule() { }
+
+    virtual bool OnInit() wxOVERRIDE { return true; }
+    virtual void OnExit() wxOVERRIDE
+    {
+        // if some cells are still alive, the blocks will be released, except
+        // for the last one, when they're deleted later
+        gs_cellsAllocator.Cleanup();
+    }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxHtmlCellsModule);
+};
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxHtmlCellsModule, wxModule);
+
+#endif // !wxUSE_MEMORY_TRACING
+
 //-----------------------------------------------------------------------------
 // wxHtmlCell
 //-----------------------------------------------------------------------------
@@ -622,6 +817,310 @@ wxString wxHtmlWordWithTabsCell::GetPartAsText(int begin, int end) const
 
 
 
+//-----------------------------------------------------------------------------
+// wxHtmlContainerCellIndex
+//-----------------------------------------------------------------------------
+
+// The combined effect of drawing some cells on the rendering state: the last
+// cells changing the font and the colours among them.
+struct wxHtmlCellsRenderingState
+{
+    wxHtmlCellsRenderingState()
+    {
+        font = fg = bg = NULL;
+        fgLast = true;
+        hasWidgets = false;
+    }
+
+    // update the state with the effect of the cells following the ones it
+    // corresponds to
+    void Append(const wxHtmlCellsRenderingState& next)
+    {
+        if ( next.font )
+            font = next.font;
+
+        if ( next.fg && next.bg )
+        {
+            fg = next.fg;
+            bg = next.bg;
+            fgLast = next.fgLast;
+        }
+        else if ( next.fg )
+        {
+            fg = next.fg;
+            fgLast = true;
+        }
+        else if ( next.bg )
+        {
+            bg = next.bg;
+            fgLast = false;
+        }
+
+        if ( next.hasWidgets )
+            hasWidgets = true;
+    }
+
+    // change the DC in the same way as drawing the cells invisibly would
+    void Apply(wxDC& dc, wxHtmlRenderingInfo& info) const
+    {
+        wxHtmlCell* const first = fgLast ? bg : fg;
+        wxHtmlCell* const last = fgLast ? fg : bg;
+        if ( first )
+            first->DrawInvisible(dc, 0, 0, info);
+        if ( last )
+            last->DrawInvisible(dc, 0, 0, info);
+        if ( font )
+            font->DrawInvisible(dc, 0, 0, info);
+    }
+
+    wxHtmlCell *font, *fg, *bg;
+
+    // true if the foreground colour was changed after the background one
+    bool fgLast;
+
+    // true if any of the cells is a widget, which must be moved even when
+    // it's not visible
+    bool hasWidgets;
+};
+
+// This class allows to find the child cells of a container intersecting the
+// given vertical range in logarithmic time: as the cells are not necessarily
+// ordered by their position, it keeps the maximal bottom coordinate of the
+// cells up to the given one and the minimal top coordinate of all cells after
+// it, both of which are monotonic and can be searched using binary search.
+//
+// As the skipped cells can still affect the rendering of the visible ones,
+// it also remembers the state after drawing all the cells before each one.
+class wxHtmlContainerCellIndex
+{
+public:
+    wxHtmlContainerCellIndex() { }
+
+    // (re)build the index for the current children of the given container
+    void Build(const wxHtmlContainerCell& container);
+
+    // the effect of drawing all the cells of the container
+    const wxHtmlCellsRenderingState& GetState() const { return m_state; }
+
+    // the positions are only indexed for the containers with many children
+    bool HasPositions() const { return !m_cells.empty(); }
+
+    size_t GetCount() const { return m_cells.size(); }
+    wxHtmlCell *GetCell(size_t n) const { return m_cells[n]; }
+
+    // return the index of the first cell which is not entirely above the
+    // given position, relative to the container
+    size_t FindFirstEndingAfter(int y) const
+    {
+        return std::upper_bound(m_maxBottom.begin(), m_maxBottom.end(), y)
+                - m_maxBottom.begin();
+    }
+
+    // return the index of the first cell such that it and all the following
+    // ones are entirely below the given position
+    size_t FindFirstStartingAfter(int y) const
+    {
+        return std::upper_bound(m_minTop.begin(), m_minTop.end(), y)
+                - m_minTop.begin();
+    }
+
+    // update the rendering state as if the cells in [from, to) range were
+    // drawn, when the state is already the same as after drawing the cells
+    // before "from"
+    void SkipCells(size_t from, size_t to,
+                   wxDC& dc, int x, int y, wxHtmlRenderingInfo& info) const;
+
+    // same as SkipCells(0, GetCount()) but can also be used if the positions
+    // are not indexed, as long as there are no widgets
+    void SkipAllCells(wxDC& dc, int x, int y, wxHtmlRenderingInfo& info) const
+    {
+        if ( HasPositions() )
+            SkipCells(0, GetCount(), dc, x, y, info);
+        else
+            m_state.Apply(dc, info);
+    }
+
+private:
+    // add the effect of the given cell, and all of its children, to the state
+    static void AddCell(wxHtmlCellsRenderingState& state, wxHtmlCell *cell);
+
+    // we only index the positions of the children of containers with at least
+    // this many of them, it's not worth doing it for the smaller ones
+    enum { MIN_CELLS_TO_INDEX = 32 };
+
+    wxHtmlCellsRenderingState m_state;
+
+    wxVector<wxHtmlCell*> m_cells;
+
+    // the maximal bottom coordinate of the cells [0, n]
+    wxVector<int> m_maxBottom;
+
+    // the minimal top coordinate of the cells [n, count)
+    wxVector<int> m_minTop;
+
+    // the state after drawing the cells [0, n)
+    wxVector<wxHtmlCellsRenderingState> m_statesBefore;
+
+    // the indices of the cells containing widgets, in increasing order
+    wxVector<size_t> m_widgetCells;
+
+    wxDECLARE_NO_COPY_CLASS(wxHtmlContainerCellIndex);
+};
+
+/* static */
+void
+wxHtmlContainerCellIndex::AddCell(wxHtmlCellsRenderingState& state,
+                                  wxHtmlCell *cell)
+{
+    if ( !cell->IsTerminalCell() )
+    {
+        wxHtmlContainerCell* const
+            cont = wxDynamicCast(cell, wxHtmlContainerCell);
+        if ( cont && cont->m_index )
+        {
+            state.Append(cont->m_index->m_state);
+            return;
+        }
+
+        for ( wxHtmlCell *c = cell->GetFirstChild(); c; c = c->GetNext() )
+            AddCell(state, c);
+    }
+    else if ( wxHtmlColourCell* const
+                clr = wxDynamicCast(cell, wxHtmlColourCell) )
+    {
+        wxHtmlCellsRenderingState clrState;
+        if ( clr->m_Flags & wxHTML_CLR_FOREGROUND )
+            clrState.fg = clr;
+        if ( clr->m_Flags & (wxHTML_CLR_BACKGROUND |
+                             wxHTML_CLR_TRANSPARENT_BACKGROUND) )
+            clrState.bg = clr;
+
+        state.Append(clrState);
+    }
+    else if ( wxDynamicCast(cell, wxHtmlFontCell) )
+    {
+        state.font = cell;
+    }
+    else if ( wxDynamicCast(cell, wxHtmlWidgetCell) )
+    {
+        state.hasWidgets = true;
+    }
+}
+
+void wxHtmlContainerCellIndex::Build(const wxHtmlContainerCell& container)
+{
+    m_state = wxHtmlCellsRenderingState();
+    m_cells.clear();
+    m_maxBottom.clear();
+    m_minTop.clear();
+    m_statesBefore.clear();
+    m_widgetCells.clear();
+
+    size_t count = 0;
+    wxHtmlCell *cell;
+    for ( cell = container.m_Cells; cell; cell = cell->GetNext() )
+        count++;
+
+    if ( count < MIN_CELLS_TO_INDEX )
+    {
+        for ( cell = container.m_Cells; cell; cell = cell->GetNext() )
+            AddCell(m_state, cell);
+
+        return;
+    }
+
+    m_cells.reserve(count);
+    m_maxBottom.reserve(count);
+    m_minTop.reserve(count);
+    m_statesBefore.reserve(count);
+
+    int maxBottom = INT_MIN;
+    for ( cell = container.m_Cells; cell; cell = cell->GetNext() )
+    {
+        const int top = cell->GetPosY();
+        if ( top + cell->GetHeight() > maxBottom )
+            maxBottom = top + cell->GetHeight();
+
+        m_maxBottom.push_back(maxBottom);
+        m_minTop.push_back(top);
+        m_statesBefore.push_back(m_state);
+
+        wxHtmlCellsRenderingState cellState;
+        AddCell(cellState, cell);
+        if ( cellState.hasWidgets )
+            m_widgetCells.push_back(m_cells.size());
+
+        m_state.Append(cellState);
+        m_cells.push_back(cell);
+    }
+
+    for ( size_t n = count - 1; n > 0; n-- )
+    {
+        if ( m_minTop[n] < m_minTop[n - 1] )
+            m_minTop[n - 1] = m_minTop[n];
+    }
+}
+
+void
+wxHtmlContainerCellIndex::SkipCells(size_t from, size_t to,
+                                    wxDC& dc, int x, int y,
+                                    wxHtmlRenderingInfo& info) const
+{
+    if ( from >= to )
+        return;
+
+    // widgets need to be hidden or moved, even if they're not visible
+    for ( wxVector<size_t>::const_iterator
+            it = std::lower_bound(m_widgetCells.begin(), m_widgetCells.end(), from);
+            it != m_widgetCells.end() && *it < to;
+            ++it )
+    {
+        m_cells[*it]->DrawInvisible(dc, x, y, info);
+    }
+
+    (to < m_statesBefore.size() ? m_statesBefore[to] : m_state).Apply(dc, info);
+}
+
+//-----------------------------------------------------------------------------
+// wxHtmlContainerPartialLayout
+//-----------------------------------------------------------------------------
+
+// The state of the layout of a container which was only done partially, allowing
+// to continue it from the first child which is not completely laid out yet
+// instead of laying out all the children again, which would make laying out the
+// page in many steps quadratic in its size.
+struct wxHtmlContainerPartialLayout
+{
+    // the width of the container this layout is done for
+    int width;
+
+    // the first child not completely laid out and the values of the variables
+    // used when laying out the children at it
+    wxHtmlCell *resume;
+    int ychild,
+        heightLaidOut,
+        countLaidOut;
+
+    // the first child whose size is only estimated and the total height of
+    // such children, which are all the (non terminal) cells after it
+    wxHtmlCell *estimated;
+    int heightEstimated;
+
+    // the first cell of the line containing the "resume" child and the state
+    // of the cells positioning at the start of this line
+    wxHtmlCell *line;
+    long ypos;
+    int maxLineWidth,
+        curLineWidth,
+        maxTotalWidth;
+};
+
+// special value of m_LastLayout indicating that m_partialLayout may be used,
+// it's reset by all the functions setting it to -1 if the layout must be redone
+static const int wxHTML_LAYOUT_PARTIAL = -2;
+
+
+
 //-----------------------------------------------------------------------------
 // wxHtmlContainerCell
 //-----------------------------------------------------------------------------
@@ -631,6 +1130,8 @@ wxIMPLEMENT_ABSTRACT_CLASS(wxHtmlContainerCell, wxHtmlCell);
 wxHtmlContainerCell::wxHtmlContainerCell(wxHtmlContainerCell *parent) : wxHtmlCell()
 {
     m_Cells = m_LastCell = NULL;
+    m_index = NULL;
+    m_partialLayout = NULL;
     m_Parent = parent;
     m_MaxTotalWidth = 0;
     if (m_Parent) m_Parent->InsertCell(this);
@@ -646,6 +1147,9 @@ wxHtmlContainerCell::wxHtmlContainerCell(wxHtmlContainerCell *parent) : wxHtmlCe
 
 wxHtmlContainerCell::~wxHtmlContainerCell()
 {
+    delete m_index;
+    delete m_partialLayout;
+
     wxHtmlCell *cell = m_Cells;
     while ( cell )
     {
@@ -715,11 +1219,46 @@ wxHtmlContainerCell::AdjustPagebreak(int *pagebreak, int pageHeight) const
 
 void wxHtmlContainerCell::Layout(int w)
 {
-    wxHtmlCell::Layout(w);
+    DoLayout(w, INT_MAX);
+}
 
-    if (m_LastLayout == w)
-        return;
-    m_LastLayout = w;
+bool wxHtmlContainerCell::LayoutPartially(int w, int yMax)
+{
+    return DoLayout(w, yMax);
+}
+
+int wxHtmlContainerCell::GetWidthFor(int w) const
+{
+    if (m_WidthFloatUnits == wxHTML_UNITS_PERCENT)
+    {
+        if (m_WidthFloat < 0) return (100 + m_WidthFloat) * w / 100;
+        else return m_WidthFloat * w / 100;
+    }
+    else
+    {
+        if (m_WidthFloat < 0) return w + m_WidthFloat;
+        else return m_WidthFloat;
+    }
+}
+
+void wxHtmlContainerCell::EstimateLayout(int w, int defaultHeight)
+{
+    // assume that the contents is mostly text which will be rewrapped to the
+    // new width, keeping the same area
+    const int width = GetWidthFor(w < 1 ? 1 : w);
+    if (m_Height > 0 && m_Width > 0 && width > 0)
+        m_Height = (int)((double)m_Height * m_Width / width);
+    else
+        m_Height = defaultHeight;
+    m_Width = width;
+
+    // ensure that the real layout is done later
+    m_LastLayout = -1;
+}
+
+bool wxHtmlContainerCell::DoLayout(int w, int yMax)
+{
+    wxHtmlCell::Layout(w);
 
     // VS: Any attempt to layout with negative or zero width leads to hell,
     // but we can't ignore such attempts completely, since it sometimes
@@ -728,6 +1267,37 @@ void wxHtmlContainerCell::Layout(int w)
     if (w < 1)
         w = 1;
 
+    /*
+
+    WIDTH ADJUSTING :
+
+    */
+
+    // the layout only depends on our own width, which may not change even if
+    // the available width does, e.g. if it's fixed
+    const int width = GetWidthFor(w);
+    if (m_LastLayout == width)
+    {
+        // the children may have changed without affecting our layout
+        if (!m_index)
+        {
+            m_index = new wxHtmlContainerCellIndex;
+            m_index->Build(*this);
+        }
+        return true;
+    }
+
+    m_Width = width;
+
+    // continue the previous partial layout if it was done for the same width
+    // and nothing changed since then
+    wxHtmlContainerPartialLayout *partial = NULL;
+    if (m_LastLayout == wxHTML_LAYOUT_PARTIAL &&
+            m_partialLayout && m_partialLayout->width == width)
+        partial = m_partialLayout;
+    else
+        wxDELETE(m_partialLayout);
+
     wxHtmlCell *nextCell;
     long xpos = 0, ypos = m_IndentTop;
     int xdelta = 0, ybasicpos = 0;
@@ -737,30 +1307,140 @@ void wxHtmlContainerCell::Layout(int w)
     int curLineWidth = 0;
     m_MaxTotalWidth = 0;
 
+    // false if some children were not laid out
+    bool complete = true;
 
-    /*
+    // the first child which was not completely laid out, with the values of
+    // the variables below at it, and the first child which was not laid out
+    // at all, but just estimated
+    wxHtmlCell *resume = NULL;
+    int resumeY = 0,
+        resumeHeight = 0,
+        resumeCount = 0;
+    wxHtmlCell *firstNotLaidOut = NULL;
 
-    WIDTH ADJUSTING :
-
-    */
-
-    if (m_WidthFloatUnits == wxHTML_UNITS_PERCENT)
-    {
-        if (m_WidthFloat < 0) m_Width = (100 + m_WidthFloat) * w / 100;
-        else m_Width = m_WidthFloat * w / 100;
-    }
-    else
-    {
-        if (m_WidthFloat < 0) m_Width = w + m_WidthFloat;
-        else m_Width = m_WidthFloat;
-    }
+    // the first estimated child and the total height of the estimated ones
+    wxHtmlCell *estimated = NULL;
+    int heightEstimated = 0;
 
     if (m_Cells)
     {
         int l = (m_IndentLeft < 0) ? (-m_IndentLeft * m_Width / 100) : m_IndentLeft;
         int r = (m_IndentRight < 0) ? (-m_IndentRight * m_Width / 100) : m_IndentRight;
-        for (wxHtmlCell *cell = m_Cells; cell; cell = cell->GetNext())
-            cell->Layout(m_Width - (l + r));
+        const int childWidth = m_Width - (l + r);
+
+        // the approximate position of the next child, as the containers are
+        // usually on their own lines, and the total height of the child
+        // containers laid out so far
+        int ychild = m_IndentTop;
+        int heightLaidOut = 0,
+            countLaidOut = 0;
+
+        // the children before the one where the previous layout stopped are
+        // already laid out and don't need to be looked at again
+        wxHtmlCell *cell = m_Cells;
+        wxHtmlCell *estimatedOld = NULL;
+        if (partial)
+        {
+            cell = partial->resume;
+            ychild = partial->ychild;
+            heightLaidOut = partial->heightLaidOut;
+            countLaidOut = partial->countLaidOut;
+            estimatedOld = partial->estimated;
+            heightEstimated = partial->heightEstimated;
+        }
+
+        // true once we reach the children estimated by the previous layout
+        bool inEstimated = false;
+        for (; cell; cell = cell->GetNext())
+        {
+            if (cell == estimatedOld)
+                inEstimated = true;
+
+            // laying out the terminal cells is cheap, so always do it
+            if (cell->IsTerminalCell())
+            {
+                cell->Layout(childWidth);
+                continue;
+            }
+
+            if (ychild > yMax)
+            {
+                firstNotLaidOut = cell;
+                break;
+            }
+
+            // this child is not estimated any more
+            if (inEstimated)
+                heightEstimated -= cell->GetHeight();
+
+            // the classes deriving from wxHtmlContainerCell have their own
+            // layout logic which can't be done partially
+            bool completeChild = true;
+            if (cell->GetClassInfo() == wxCLASSINFO(wxHtmlContainerCell))
+            {
+                const int yMaxChild = yMax == INT_MAX ? INT_MAX : yMax - ychild;
+                completeChild = static_cast<wxHtmlContainerCell*>(cell)->
+                                    DoLayout(childWidth, yMaxChild);
+            }
+            else
+            {
+                cell->Layout(childWidth);
+            }
+
+            if (!completeChild && !resume)
+            {
+                complete = false;
+
+                resume = cell;
+                resumeY = ychild;
+                resumeHeight = heightLaidOut;
+                resumeCount = countLaidOut;
+            }
+
+            ychild += cell->GetHeight();
+            heightLaidOut += cell->GetHeight();
+            countLaidOut++;
+        }
+
+        if (firstNotLaidOut)
+        {
+            complete = false;
+
+            if (!resume)
+            {
+                resume = firstNotLaidOut;
+                resumeY = ychild;
+                resumeHeight = heightLaidOut;
+                resumeCount = countLaidOut;
+            }
+
+            // estimate the size of the children which were not estimated yet,
+            // i.e. all of them unless we stopped before the previous layout
+            // did, and put them one under another below the laid out ones
+            estimated = firstNotLaidOut;
+            wxHtmlCell * const estimatedEnd = inEstimated ? firstNotLaidOut
+                                                          : estimatedOld;
+
+            const int heightDefault = countLaidOut ? heightLaidOut / countLaidOut
+                                                   : 0;
+            for (cell = firstNotLaidOut; cell != estimatedEnd; cell = cell->GetNext())
+            {
+                if (cell->IsTerminalCell())
+                    continue;
+
+                wxHtmlContainerCell* const
+                    cont = wxDynamicCast(cell, wxHtmlContainerCell);
+                if (cont)
+                    cont->EstimateLayout(childWidth, heightDefault);
+                else
+                    cell->Layout(childWidth);
+
+                cell->SetPos(l, ychild);
+                ychild += cell->GetHeight();
+                heightEstimated += cell->GetHeight();
+            }
+        }
     }
 
     /*
@@ -776,8 +1456,47 @@ void wxHtmlContainerCell::Layout(int w)
     // my own layout:
     wxHtmlCell *cell = m_Cells,
                *line = m_Cells;
+
+    // the lines before the one containing the child where the previous
+    // partial layout stopped didn't change
+    if (partial)
+    {
+        cell =
+        line = partial->line;
+        ypos = partial->ypos;
+        MaxLineWidth = partial->maxLineWidth;
+        curLineWidth = partial->curLineWidth;
+        m_MaxTotalWidth = partial->maxTotalWidth;
+    }
+
+    // the state at the start of the line containing the first child which is
+    // not completely laid out, to be saved if the layout is not complete
+    wxHtmlCell *resumeLine = line;
+    long resumeYPos = ypos;
+    int resumeMaxLineWidth = MaxLineWidth,
+        resumeCurLineWidth = curLineWidth,
+        resumeMaxTotalWidth = m_MaxTotalWidth;
+    bool resumeReached = false;
+
     while (cell != NULL)
     {
+        if (cell == line && !resumeReached)
+        {
+            resumeLine = line;
+            resumeYPos = ypos;
+            resumeMaxLineWidth = MaxLineWidth;
+            resumeCurLineWidth = curLineWidth;
+            resumeMaxTotalWidth = m_MaxTotalWidth;
+        }
+
+        if (cell == resume)
+            resumeReached = true;
+
+        // the cells which were not laid out are positioned at the end of the
+        // next layout, their current positions are just an estimation
+        if (cell == firstNotLaidOut)
+            break;
+
         switch (m_AlignVer)
         {
             case wxHTML_ALIGN_TOP :      ybasicpos = 0; break;
@@ -823,7 +1542,7 @@ void wxHtmlContainerCell::Layout(int w)
         }
 
         // force new line if occurred:
-        if ((cell == NULL) ||
+        if ((cell == NULL) || (cell == firstNotLaidOut) ||
             (xpos + nextWordWidth > s_width && cell->IsLinebreakAllowed()))
         {
             if (xpos > MaxLineWidth) MaxLineWidth = xpos;
@@ -846,7 +1565,7 @@ void wxHtmlContainerCell::Layout(int w)
 
             ypos += ysizeup;
 
-            if (m_AlignHor != wxHTML_ALIGN_JUSTIFY || cell == NULL)
+            if (m_AlignHor != wxHTML_ALIGN_JUSTIFY || cell == firstNotLaidOut)
             {
                 while (line != cell)
                 {
@@ -947,10 +1666,14 @@ void wxHtmlContainerCell::Layout(int w)
 
     // setup height & width, depending on container layout:
     m_Height = ypos + (ysizedown + ysizeup) + m_IndentBottom;
+    if (estimated)
+        m_Height += heightEstimated;
 
     if (m_Height < m_MinHeight)
     {
-        if (m_MinHeightAlign != wxHTML_ALIGN_TOP)
+        // don't move the cells before the layout is complete, as the lines
+        // which are not laid out again would be moved more than once
+        if (m_MinHeightAlign != wxHTML_ALIGN_TOP && complete)
         {
             int diff = m_MinHeight - m_Height;
             if (m_MinHeightAlign == wxHTML_ALIGN_CENTER) diff /= 2;
@@ -970,6 +1693,52 @@ void wxHtmlContainerCell::Layout(int w)
     m_MaxTotalWidth += s_indent + ((m_IndentRight < 0) ? (-m_IndentRight * m_Width / 100) : m_IndentRight);
     MaxLineWidth += s_indent + ((m_IndentRight < 0) ? (-m_IndentRight * m_Width / 100) : m_IndentRight);
     if (m_Width < MaxLineWidth) m_Width = MaxLineWidth;
+
+    if (complete)
+    {
+        m_LastLayout = width;
+        wxDELETE(m_partialLayout);
+
+        // now that the children positions are known, index them
+        if (!m_index)
+            m_index = new wxHtmlContainerCellIndex;
+        m_index->Build(*this);
+    }
+    else // remember where to continue when we're called again
+    {
+        if (!m_partialLayout)
+            m_partialLayout = new wxHtmlContainerPartialLayout;
+
+        m_partialLayout->width = width;
+        m_partialLayout->resume = resume;
+        m_partialLayout->ychild = resumeY;
+        m_partialLayout->heightLaidOut = resumeHeight;
+        m_partialLayout->countLaidOut = resumeCount;
+        m_partialLayout->estimated = estimated;
+        m_partialLayout->heightEstimated = heightEstimated;
+        m_partialLayout->line = resumeLine;
+        m_partialLayout->ypos = resumeYPos;
+        m_partialLayout->maxLineWidth = resumeMaxLineWidth;
+        m_partialLayout->curLineWidth = resumeCurLineWidth;
+        m_partialLayout->maxTotalWidth = resumeMaxTotalWidth;
+
+        m_LastLayout = wxHTML_LAYOUT_PARTIAL;
+
+        // indexing the children each time would make the layout quadratic
+        // again, so only do it once it's complete
+        wxDELETE(m_index);
+    }
+
+    return complete;
+}
+
+void wxHtmlContainerCell::InvalidateLayout()
+{
+    for ( wxHtmlContainerCell *cont = this; cont; cont = cont->GetParent() )
+    {
+        cont->m_LastLayout = -1;
+        wxDELETE(cont->m_index);
+    }
 }
 
 void wxHtmlContainerCell::UpdateRenderingStatePre(wxHtmlRenderingInfo& info,
@@ -1086,35 +1855,74 @@ void wxHtmlContainerCell::Draw(wxDC& dc, int x, int y, int view_y1, int view_y2,
     if (m_Cells)
     {
         // draw container's contents:
-        for (wxHtmlCell *cell = m_Cells; cell; cell = cell->GetNext())
+        if (m_index && m_index->HasPositions() && !info.GetSelection())
         {
-
-            // optimize drawing: don't render off-screen content:
-            if ((ylocal + cell->GetPosY() <= view_y2) &&
-                (ylocal + cell->GetPosY() + cell->GetHeight() > view_y1))
+            // we can avoid even looking at the cells entirely above or below
+            // the visible area, but this can't be done when there is a
+            // selection, as its state depends on all the cells before
+            const size_t count = m_index->GetCount();
+            const size_t first = m_index->FindFirstEndingAfter(view_y1 - ylocal);
+            size_t last = m_index->FindFirstStartingAfter(view_y2 - ylocal);
+            if (last < first)
+                last = first;
+
+            m_index->SkipCells(0, first, dc, xlocal, ylocal, info);
+
+            for (size_t n = first; n < last; n++)
             {
-                // the cell is visible, draw it:
-                UpdateRenderingStatePre(info, cell);
-                cell->Draw(dc,
-                           xlocal, ylocal, view_y1, view_y2,
-                           info);
-                UpdateRenderingStatePost(info, cell);
+                DrawCell(m_index->GetCell(n), dc, xlocal, ylocal,
+                         view_y1, view_y2, info);
             }
-            else
+
+            m_index->SkipCells(last, count, dc, xlocal, ylocal, info);
+        }
+        else
+        {
+            for (wxHtmlCell *cell = m_Cells; cell; cell = cell->GetNext())
             {
-                // the cell is off-screen, proceed with font+color+etc.
-                // changes only:
-                cell->DrawInvisible(dc, xlocal, ylocal, info);
+                DrawCell(cell, dc, xlocal, ylocal, view_y1, view_y2, info);
             }
         }
     }
 }
 
+void wxHtmlContainerCell::DrawCell(wxHtmlCell *cell, wxDC& dc, int x, int y,
+                                   int view_y1, int view_y2,
+                                   wxHtmlRenderingInfo& info)
+{
+    // optimize drawing: don't render off-screen content:
+    if ((y + cell->GetPosY() <= view_y2) &&
+        (y + cell->GetPosY() + cell->GetHeight() > view_y1))
+    {
+        // the cell is visible, draw it:
+        UpdateRenderingStatePre(info, cell);
+        cell->Draw(dc,
+                   x, y, view_y1, view_y2,
+                   info);
+        UpdateRenderingStatePost(info, cell);
+    }
+    else
+    {
+        // the cell is off-screen, proceed with font+color+etc.
+        // changes only:
+        cell->DrawInvisible(dc, x, y, info);
+    }
+}
+
 
 
 void wxHtmlContainerCell::DrawInvisible(wxDC& dc, int x, int y,
                                         wxHtmlRenderingInfo& info)
 {
+    if (m_index && !info.GetSelection() &&
+            (m_index->HasPositions() || !m_index->GetState().hasWidgets))
+    {
+        // no need to iterate over all the cells, we already know how they
+        // change the rendering state
+        m_index->SkipAllCells(dc, x + m_PosX, y + m_PosY, info);
+        return;
+    }
+
     if (m_Cells)
     {
         for (wxHtmlCell *cell = m_Cells; cell; cell = cell->GetNext())
@@ -1156,7 +1964,7 @@ void wxHtmlContainerCell::InsertCell(wxHtmlCell *f)
         if (m_LastCell) while (m_LastCell->GetNext()) m_LastCell = m_LastCell->GetNext();
     }
     f->SetParent(this);
-    m_LastLayout = -1;
+    InvalidateLayout();
 }
 
 
@@ -1194,6 +2002,8 @@ void wxHtmlContainerCell::Detach(wxHtmlCell *cell)
 
     cell->SetParent(NULL);
     cell->SetNext(NULL);
+
+    InvalidateLayout();
 }
 
 
@@ -1255,8 +2065,30 @@ const wxHtmlCell* wxHtmlContainerCell::Find(int condition, const void* param) co
 wxHtmlCell *wxHtmlContainerCell::FindCellByPos(wxCoord x, wxCoord y,
                                                unsigned flags) const
 {
+    // use the index, if we have it, to skip the cells which can't match
+    const bool useIndex = m_index && m_index->HasPositions();
+
     if ( flags & wxHTML_FIND_EXACT )
     {
+        if ( useIndex )
+        {
+            const size_t last = m_index->FindFirstStartingAfter(y);
+            for ( size_t n = m_index->FindFirstEndingAfter(y); n < last; n++ )
+            {
+                const wxHtmlCell* const cell = m_index->GetCell(n);
+                int cx = cell->GetPosX(),
+                    cy = cell->GetPosY();
+
+                if ( (cx <= x) && (cx + cell->GetWidth() > x) &&
+                     (cy <= y) && (cy + cell->GetHeight() > y) )
+                {
+                    return cell->FindCellByPos(x - cx, y - cy, flags);
+                }
+            }
+
+            return NULL;
+        }
+
         for ( const wxHtmlCell *cell = m_Cells; cell; cell = cell->GetNext() )
         {
             int cx = cell->GetPosX(),
@@ -1271,8 +2103,16 @@ wxHtmlCell *wxHtmlContainerCell::FindCellByPos(wxCoord x, wxCoord y,
     }
     else if ( flags & wxHTML_FIND_NEAREST_AFTER )
     {
+        // all the cells entirely above the given position are skipped anyhow
+        const wxHtmlCell *cell = m_Cells;
+        if ( useIndex )
+        {
+            const size_t first = m_index->FindFirstEndingAfter(y);
+            cell = first < m_index->GetCount() ? m_index->GetCell(first) : NULL;
+        }
+
         wxHtmlCell *c;
-        for ( const wxHtmlCell *cell = m_Cells; cell; cell = cell->GetNext() )
+        for ( ; cell; cell = cell->GetNext() )
         {
             if ( cell->IsFormattingCell() )
                 continue;
@@ -1287,6 +2127,39 @@ wxHtmlCell *wxHtmlContainerCell::FindCellByPos(wxCoord x, wxCoord y,
     }
     else if ( flags & wxHTML_FIND_NEAREST_BEFORE )
     {
+        if ( useIndex )
+        {
+            // all the cells entirely above the given position satisfy the
+            // condition below, so start looking for the first one which
+            // doesn't after them and then go backwards to find the last
+            // matching cell
+            const size_t count = m_index->GetCount();
+            size_t end;
+            for ( end = m_index->FindFirstEndingAfter(y); end < count; end++ )
+            {
+                const wxHtmlCell* const cell = m_index->GetCell(end);
+                if ( cell->IsFormattingCell() )
+                    continue;
+                int cellY = cell->GetPosY();
+                if (!( cellY + cell->GetHeight() <= y ||
+                       (y >= cellY && x >= cell->GetPosX()) ))
+                    break;
+            }
+
+            while ( end-- > 0 )
+            {
+                const wxHtmlCell* const cell = m_index->GetCell(end);
+                if ( cell->IsFormattingCell() )
+                    continue;
+                wxHtmlCell * const c = cell->FindCellByPos(x - cell->GetPosX(),
+                                                           y - cell->GetPosY(),
+                                                           flags);
+                if (c) return c;
+            }
+
+            return NULL;
+        }
+
         wxHtmlCell *c2, *c = NULL;
         for ( const wxHtmlCell *cell = m_Cells; cell; cell = cell->GetNext() )
         {
@@ -65,6 +65,203 @@ public:
     wxHtmlParserState *m_nextState;
 };
 
+extern bool wxIsCDATAElement(const wxString& tag);
+
+// The state of streaming parsing: the text received but not parsed yet and
+// the tags in it which are still waiting for their ending tags.
+class wxHtmlStreamingState
+{
+public:
+    wxHtmlStreamingState() : m_failed(false), m_scanPos(0) { }
+
+    // Appends the new text to the pending one and returns the length of its
+    // part which can be parsed on its own, i.e. without any tags in it whose
+    // ending tags could still come later.
+    size_t AddText(const wxString& text);
+
+    // Removes the given number of characters from the start of the pending
+    // text after parsing them.
+    void Consume(size_t len)
+    {
+        m_pending.erase(0, len);
+        m_scanPos -= len;
+    }
+
+    // The entire document, needed to keep it as parser source at the end.
+    wxString m_document;
+
+    // The text received but not parsed yet.
+    wxString m_pending;
+
+    // The bytes read from the stream but not converted to text yet.
+    wxMemoryBuffer m_bytes;
+
+    // Set if the stream contents couldn't be converted to text.
+    bool m_failed;
+
+private:
+    // Checks the tag starting at the given position and updates the list of
+    // unmatched tags. Returns false if the tag is incomplete, otherwise
+    // advances pos to its closing '>'.
+    bool ScanTag(wxString::const_iterator& pos,
+                 const wxString::const_iterator& end);
+
+    // Position in m_pending from which to continue scanning.
+    size_t m_scanPos;
+
+    // Names of the tags without matching ending tags so far, the document can
+    // only be split when there are none of them.
+    wxVector<wxString> m_unmatched;
+};
+
+size_t wxHtmlStreamingState::AddText(const wxString& text)
+{
+    m_document += text;
+    m_pending += text;
+
+    const wxString::const_iterator begin = m_pending.begin();
+    const wxString::const_iterator end = m_pending.end();
+
+    // Notice that chunks are only split before tags, so that text pieces and
+    // entities are never split.
+    wxString::const_iterator safeEnd = begin;
+    wxString::const_iterator pos = begin + m_scanPos;
+    while ( pos < end )
+    {
+        if ( *pos != wxT('<') )
+        {
+            ++pos;
+            continue;
+        }
+
+        if ( m_unmatched.empty() )
+            safeEnd = pos;
+
+        wxString::const_iterator tagEnd = pos;
+        if ( wxHtmlParser::SkipCommentTag(tagEnd, end) )
+        {
+            // wait until we get the end of the comment
+            if ( *tagEnd != wxT('>') )
+                break;
+        }
+        else if ( !ScanTag(tagEnd, end) )
+        {
+            break;
+        }
+
+        pos = tagEnd + 1;
+    }
+
+    m_scanPos = pos - begin;
+
+    return safeEnd - begin;
+}
+
+bool wxHtmlStreamingState::ScanTag(wxString::const_iterator& pos,
+                                   const wxString::const_iterator& end)
+{
+    // Find the tag name and its end in the same way as wxHtmlTagsCache does.
+    wxString::const_iterator i = pos + 1;
+    wxString name;
+    for ( ; i < end && *i != wxT('>') && !wxIsspace(*i); ++i )
+        name += (wxChar)wxToupper(*i);
+
+    while ( i < end && *i != wxT('>') )
+        ++i;
+
+    if ( i == end )
+        return false;
+
+    if ( name.StartsWith(wxT("/")) )
+    {
+        // the ending tag matches the last unmatched tag with the same name and
+        // also implicitly closes all the tags opened after it, e.g. the cells
+        // of a table or the items of a list whose ending tags were omitted
+        name.erase(0, 1);
+        for ( size_t n = m_unmatched.size(); n > 0; n-- )
+        {
+            if ( m_unmatched[n - 1] == name )
+            {
+                m_unmatched.erase(m_unmatched.begin() + n - 1,
+                                  m_unmatched.end());
+                break;
+            }
+        }
+    }
+    else if ( wxIsCDATAElement(name) )
+    {
+        // skip the element contents until its ending tag
+        const wxString endTag = wxT("</") + name;
+        for ( ;; )
+        {
+            while ( i < end && *i != wxT('<') )
+                ++i;
+
+            wxString::const_iterator j = i;
+            size_t n = 0;
+            while ( j < end && n < endTag.length() &&
+                        (wxChar)wxToupper(*j) == endTag[n] )
+            {
+                ++j;
+                ++n;
+            }
+
+            if ( j == end )
+                return false;
+
+            if ( n == endTag.length() )
+            {
+                while ( j < end && *j != wxT('>') )
+                    ++j;
+
+                if ( j == end )
+                    return false;
+
+                i = j;
+                break;
+            }
+
+            i = j == i ? i + 1 : j;
+        }
+    }
+    else if ( !name.empty() && name[0] != wxT('!') && name[0] != wxT('?') &&
+                *(i - 1) != wxT('/') )
+    {
+        // Don't wait for the ending tags of the tags which never have them
+        // and of those whose standard handlers parse their contents in place
+        // without doing anything after it, so that splitting the document
+        // with them open gives the same result as parsing it all at once. The
+        // latter include the tags whose ending tags are often omitted (the
+        // other ones, such as <td>, are implicitly closed by the ending tag
+        // of their parent, see above).
+        static const wxChar* const untrackedTags[] =
+        {
+            wxT("AREA"), wxT("BASE"), wxT("BR"), wxT("COL"), wxT("HR"),
+            wxT("IMG"), wxT("INPUT"), wxT("LINK"), wxT("META"), wxT("PARAM"),
+            wxT("WBR"),
+
+            wxT("BODY"), wxT("DD"), wxT("DT"), wxT("HTML"), wxT("LI"),
+            wxT("P"),
+        };
+
+        bool untracked = false;
+        for ( size_t n = 0; n < WXSIZEOF(untrackedTags); n++ )
+        {
+            if ( name == untrackedTags[n] )
+            {
+                untracked = true;
+                break;
+            }
+        }
+
+        if ( !untracked )
+            m_unmatched.push_back(name);
+    }
+
+    pos = i;
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 // wxHtmlParser
 //-----------------------------------------------------------------------------
@@ -82,6 +279,7 @@ wxHtmlParser::wxHtmlParser()
     m_TextPieces = NULL;
     m_CurTextPiece = 0;
     m_SavedStates = NULL;
+    m_streaming = NULL;
 }
 
 wxHtmlParser::~wxHtmlParser()
@@ -93,6 +291,7 @@ wxHtmlParser::~wxHtmlParser()
     WX_CLEAR_HASH_SET(wxHtmlTagHandlersSet, m_HandlersSet);
     delete m_entitiesParser;
     delete m_Source;
+    delete m_streaming;
 }
 
 wxObject* wxHtmlParser::Parse(const wxString& source)
@@ -104,6 +303,23 @@ wxObject* wxHtmlParser::Parse(const wxString& source)
     return result;
 }
 
+wxObject* wxHtmlParser::Parse(wxInputStream& stream, const wxMBConv& conv)
+{
+    BeginStreaming();
+    while ( ParseChunk(stream, conv) && !m_stopParsing )
+        ;
+
+    const bool ok = !HasStreamingError();
+    wxObject* const result = EndStreaming();
+    if ( !ok )
+    {
+        delete result;
+        return NULL;
+    }
+
+    return result;
+}
+
 void wxHtmlParser::InitParser(const wxString& source)
 {
     SetSource(source);
@@ -113,6 +329,105 @@ void wxHtmlParser::InitParser(const wxString& source)
 void wxHtmlParser::DoneParser()
 {
     DestroyDOMTree();
+    wxDELETE(m_streaming);
+}
+
+void wxHtmlParser::BeginStreaming()
+{
+    InitParser(wxString());
+    m_streaming = new wxHtmlStreamingState;
+}
+
+void wxHtmlParser::ParseChunk(const wxString& chunk)
+{
+    wxCHECK_RET( m_streaming, "BeginStreaming() must be called first" );
+
+    const size_t len = m_streaming->AddText(chunk);
+    if ( !len || m_stopParsing )
+        return;
+
+    SetSource(m_streaming->m_pending.substr(0, len));
+    DoParsing();
+
+    m_streaming->Consume(len);
+}
+
+bool wxHtmlParser::ParseChunk(wxInputStream& stream, const wxMBConv& conv)
+{
+    wxCHECK_MSG( m_streaming, false, "BeginStreaming() must be called first" );
+
+    if ( m_streaming->m_failed )
+        return false;
+
+    static const size_t CHUNK_SIZE = 64*1024;
+
+    wxMemoryBuffer& bytes = m_streaming->m_bytes;
+    stream.Read(bytes.GetAppendBuf(CHUNK_SIZE), CHUNK_SIZE);
+    const size_t lastRead = stream.LastRead();
+    bytes.UngetAppendBuf(lastRead);
+
+    const char* const data = static_cast<const char*>(bytes.GetData());
+    size_t len = bytes.GetDataLen();
+
+    // Unless this is the end of the document, only convert the bytes before
+    // the last tag start: as '<' can't be a part of a multibyte character in
+    // the ASCII-compatible encodings, this ensures that we never cut one.
+    if ( lastRead )
+    {
+        while ( len && data[len - 1] != '<' )
+            len--;
+
+        if ( len )
+            len--;
+    }
+
+    if ( len )
+    {
+        const wxString text(data, conv, len);
+        if ( text.empty() )
+        {
+            wxLogError(_("Failed to convert HTML document to Unicode."));
+            m_streaming->m_failed = true;
+            return false;
+        }
+
+        ParseChunk(text);
+
+        wxMemoryBuffer rest;
+        rest.AppendData(data + len, bytes.GetDataLen() - len);
+        bytes = rest;
+    }
+
+    return lastRead != 0;
+}
+
+bool wxHtmlParser::HasStreamingError() const
+{
+    return m_streaming && m_streaming->m_failed;
+}
+
+wxObject* wxHtmlParser::EndStreaming()
+{
+    wxCHECK_MSG( m_streaming, NULL, "BeginStreaming() must be called first" );
+
+    // parse whatever remains, even if it's incomplete
+    if ( !m_stopParsing && !m_streaming->m_pending.empty() )
+    {
+        SetSource(m_streaming->m_pending);
+        DoParsing();
+    }
+
+    // preserve the full document source, as if it had been parsed at once
+    wxString document;
+    document.swap(m_streaming->m_document);
+
+    wxObject* const result = GetProduct();
+    DoneParser();
+
+    delete m_Source;
+    m_Source = new wxString(document);
+
+    return result;
 }
 
 void wxHtmlParser::SetSource(const wxString& src)
@@ -140,8 +455,6 @@ void wxHtmlParser::CreateDOMTree()
     m_CurTextPiece = 0;
 }
 
-extern bool wxIsCDATAElement(const wxString& tag);
-
 void wxHtmlParser::CreateDOMSubTree(wxHtmlTag *cur,
                                     const wxString::const_iterator& begin_pos,
                                     const wxString::const_iterator& end_pos,
@@ -305,10 +618,22 @@ void wxHtmlParser::AddTag(const wxHtmlTag& tag)
 {
     bool inner = false;
 
-    wxHtmlTagHandlersHash::const_iterator h = m_HandlersHash.find(tag.GetName());
-    if (h != m_HandlersHash.end())
+    wxHtmlTagHandler *handler = NULL;
+    if ( tag.m_nameAtom != wxNOT_FOUND )
+    {
+        if ( static_cast<size_t>(tag.m_nameAtom) < m_handlersByAtom.size() )
+            handler = m_handlersByAtom[tag.m_nameAtom];
+    }
+    else // not a standard tag
+    {
+        wxHtmlTagHandlersHash::const_iterator h = m_HandlersHash.find(tag.GetName());
+        if (h != m_HandlersHash.end())
+            handler = h->second;
+    }
+
+    if (handler)
     {
-        inner = h->second->HandleTag(tag);
+        inner = handler->HandleTag(tag);
         if (m_stopParsing)
             return;
     }
@@ -332,7 +657,7 @@ void wxHtmlParser::AddTagHandler(wxHtmlTagHandler *handler)
     wxStringTokenizer tokenizer(s, wxT(", "));
 
     while (tokenizer.HasMoreTokens())
-        m_HandlersHash[tokenizer.GetNextToken()] = handler;
+        SetTagHandler(tokenizer.GetNextToken(), handler);
 
     m_HandlersSet.insert(handler);
 
@@ -349,7 +674,7 @@ void wxHtmlParser::PushTagHandler(wxHtmlTagHandler *handler, const wxString& tag
     while (tokenizer.HasMoreTokens())
     {
         key = tokenizer.GetNextToken();
-        m_HandlersHash[key] = handler;
+        SetTagHandler(key, handler);
     }
 }
 
@@ -362,6 +687,29 @@ void wxHtmlParser::PopTagHandler()
     m_HandlersStack.pop_back();
     m_HandlersHash = *prev;
     delete prev;
+
+    m_handlersByAtom.clear();
+    for ( wxHtmlTagHandlersHash::const_iterator it = m_HandlersHash.begin();
+          it != m_HandlersHash.end();
+          ++it )
+    {
+        SetTagHandler(it->first, it->second);
+    }
+}
+
+void wxHtmlParser::SetTagHandler(const wxString& name, wxHtmlTagHandler *handler)
+{
+    m_HandlersHash[name] = handler;
+
+    // notice that the tag names are always in upper case, so the handlers
+    // using lower case names are never used and must not be found by atom
+    const int atom = wxHtmlTag::GetAtom(name);
+    if ( atom == wxNOT_FOUND || name != name.Upper() )
+        return;
+
+    if ( static_cast<size_t>(atom) >= m_handlersByAtom.size() )
+        m_handlersByAtom.resize(atom + 1, NULL);
+    m_handlersByAtom[atom] = handler;
 }
 
 void wxHtmlParser::SetSourceAndSaveState(const wxString& src)
@@ -291,6 +291,59 @@ void wxHtmlTagsCache::QueryTag(const wxString::const_iterator& at,
 
 
 
+//-----------------------------------------------------------------------------
+// known names
+//-----------------------------------------------------------------------------
+
+// The names of the standard tags and their parameters, sorted in upper case:
+// these names are identified by their index in this array, which allows to
+// compare them quickly. Notice that this array is never modified, so it can
+// be used from any thread.
+static const wxChar* const gs_htmlKnownNames[] =
+{
+    wxT("A"), wxT("ADDRESS"), wxT("ALIGN"), wxT("ALINK"), wxT("ALT"),
+    wxT("AREA"), wxT("B"), wxT("BACKGROUND"), wxT("BASE"), wxT("BGCOLOR"),
+    wxT("BIG"), wxT("BLOCKQUOTE"), wxT("BODY"), wxT("BORDER"), wxT("BR"),
+    wxT("CAPTION"), wxT("CELLPADDING"), wxT("CELLSPACING"), wxT("CENTER"),
+    wxT("CHARSET"), wxT("CITE"), wxT("CLASS"), wxT("CLEAR"), wxT("CODE"),
+    wxT("COL"), wxT("COLOR"), wxT("COLS"), wxT("COLSPAN"), wxT("CONTENT"),
+    wxT("COORDS"), wxT("DD"), wxT("DEL"), wxT("DFN"), wxT("DIV"), wxT("DL"),
+    wxT("DT"), wxT("EM"), wxT("FACE"), wxT("FONT"), wxT("FORM"), wxT("FRAME"),
+    wxT("FRAMESET"), wxT("H1"), wxT("H2"), wxT("H3"), wxT("H4"), wxT("H5"),
+    wxT("H6"), wxT("HEAD"), wxT("HEIGHT"), wxT("HR"), wxT("HREF"),
+    wxT("HSPACE"), wxT("HTML"), wxT("HTTP-EQUIV"), wxT("I"), wxT("ID"),
+    wxT("IMG"), wxT("INPUT"), wxT("INS"), wxT("KBD"), wxT("LANG"), wxT("LI"),
+    wxT("LINK"), wxT("MAP"), wxT("META"), wxT("NAME"), wxT("NOWRAP"),
+    wxT("OL"), wxT("OPTION"), wxT("P"), wxT("PARAM"), wxT("PRE"), wxT("ROWS"),
+    wxT("ROWSPAN"), wxT("S"), wxT("SAMP"), wxT("SCRIPT"), wxT("SELECT"),
+    wxT("SHAPE"), wxT("SIZE"), wxT("SMALL"), wxT("SPAN"), wxT("SRC"),
+    wxT("START"), wxT("STRIKE"), wxT("STRONG"), wxT("STYLE"), wxT("SUB"),
+    wxT("SUP"), wxT("TABLE"), wxT("TARGET"), wxT("TBODY"), wxT("TD"),
+    wxT("TEXT"), wxT("TEXTAREA"), wxT("TFOOT"), wxT("TH"), wxT("THEAD"),
+    wxT("TITLE"), wxT("TR"), wxT("TT"), wxT("TYPE"), wxT("U"), wxT("UL"),
+    wxT("USEMAP"), wxT("VALIGN"), wxT("VALUE"), wxT("VAR"), wxT("VLINK"),
+    wxT("VSPACE"), wxT("WBR"), wxT("WIDTH"),
+};
+
+// Compare the given name, case-insensitively, with the known one in upper
+// case.
+static int CompareWithKnownName(const wxString& name, const wxChar* known)
+{
+    const wxString::const_iterator end = name.end();
+    for ( wxString::const_iterator i = name.begin(); ; ++i, ++known )
+    {
+        if ( i == end )
+            return *known ? -1 : 0;
+
+        if ( !*known )
+            return 1;
+
+        const wxChar c = (wxChar)wxToupper(*i);
+        if ( c != *known )
+            return c < *known ? -1 : 1;
+    }
+}
+
 //-----------------------------------------------------------------------------
 // wxHtmlTag
 //-----------------------------------------------------------------------------
@@ -337,6 +390,8 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
         m_Name << c;
     }
 
+    m_nameAtom = GetAtom(m_Name);
+
     // if the tag has parameters, read them and "normalize" them,
     // i.e. convert to uppercase, replace whitespaces by spaces and
     // remove whitespaces around '=':
@@ -365,16 +420,12 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
             {
                 if (state == ST_BEFORE_EQ || state == ST_NAME)
                 {
-                    m_ParamNames.Add(pname);
-                    m_ParamValues.Add(wxGetEmptyString());
+                    AddParam(pname, wxGetEmptyString());
                 }
                 else if (state == ST_VALUE && quote == 0)
                 {
-                    m_ParamNames.Add(pname);
-                    if (entParser)
-                        m_ParamValues.Add(entParser->Parse(pvalue));
-                    else
-                        m_ParamValues.Add(pvalue);
+                    AddParam(pname, entParser ? entParser->Parse(pvalue)
+                                              : pvalue);
                 }
                 break;
             }
@@ -400,8 +451,7 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
                         state = ST_BEFORE_VALUE;
                     else if (!IS_WHITE(c))
                     {
-                        m_ParamNames.Add(pname);
-                        m_ParamValues.Add(wxGetEmptyString());
+                        AddParam(pname, wxGetEmptyString());
                         pname = c;
                         state = ST_NAME;
                     }
@@ -420,17 +470,14 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
                     if ((quote != 0 && c == quote) ||
                         (quote == 0 && IS_WHITE(c)))
                     {
-                        m_ParamNames.Add(pname);
                         if (quote == 0)
                         {
                             // VS: backward compatibility, no real reason,
                             //     but wxHTML code relies on this... :(
                             pvalue.MakeUpper();
                         }
-                        if (entParser)
-                            m_ParamValues.Add(entParser->Parse(pvalue));
-                        else
-                            m_ParamValues.Add(pvalue);
+                        AddParam(pname, entParser ? entParser->Parse(pvalue)
+                                                  : pvalue);
                         state = ST_BEFORE_NAME;
                     }
                     else
@@ -469,15 +516,15 @@ wxHtmlTag::wxHtmlTag(wxHtmlTag *parent,
         { "face",               "FACE"          },
     };
 
+    if ( !HasParam(wxS("STYLE")) )
+        return;
+
     wxHtmlStyleParams styleParams(*this);
     for ( unsigned n = 0; n < WXSIZEOF(equivAttrs); n++ )
     {
         const EquivAttr& ea = equivAttrs[n];
         if ( styleParams.HasParam(ea.style) && !HasParam(ea.attr) )
-        {
-            m_ParamNames.Add(ea.attr);
-            m_ParamValues.Add(styleParams.GetParam(ea.style));
-        }
+            AddParam(ea.attr, styleParams.GetParam(ea.style));
     }
 }
 
@@ -493,36 +540,86 @@ wxHtmlTag::~wxHtmlTag()
     }
 }
 
+/* static */
+int wxHtmlTag::GetAtom(const wxString& name)
+{
+    size_t lo = 0,
+           hi = WXSIZEOF(gs_htmlKnownNames);
+    while ( lo < hi )
+    {
+        const size_t mid = (lo + hi) / 2;
+        const int rc = CompareWithKnownName(name, gs_htmlKnownNames[mid]);
+        if ( !rc )
+            return mid;
+
+        if ( rc < 0 )
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+
+    return wxNOT_FOUND;
+}
+
+void wxHtmlTag::AddParam(const wxString& name, const wxString& value)
+{
+    Param param;
+    param.atom = GetAtom(name);
+    param.name = name;
+    param.value = value;
+
+    m_params.push_back(param);
+}
+
+const wxHtmlTag::Param* wxHtmlTag::FindParam(const wxString& par) const
+{
+    // The standard parameters are found by just comparing their atoms, the
+    // others can't have the same names as them.
+    const int atom = GetAtom(par);
+    for ( wxVector<Param>::const_iterator i = m_params.begin();
+          i != m_params.end();
+          ++i )
+    {
+        if ( i->atom != atom )
+            continue;
+
+        if ( atom != wxNOT_FOUND || i->name.IsSameAs(par, false) )
+            return &*i;
+    }
+
+    return NULL;
+}
+
 bool wxHtmlTag::HasParam(const wxString& par) const
 {
-    return (m_ParamNames.Index(par, false) != wxNOT_FOUND);
+    return FindParam(par) != NULL;
 }
 
 wxString wxHtmlTag::GetParam(const wxString& par, bool with_quotes) const
 {
-    int index = m_ParamNames.Index(par, false);
-    if (index == wxNOT_FOUND)
+    const Param* const param = FindParam(par);
+    if (!param)
         return wxGetEmptyString();
     if (with_quotes)
     {
         // VS: backward compatibility, seems to be never used by wxHTML...
         wxString s;
-        s << wxT('"') << m_ParamValues[index] << wxT('"');
+        s << wxT('"') << param->value << wxT('"');
         return s;
     }
     else
-        return m_ParamValues[index];
+        return param->value;
 }
 
 bool wxHtmlTag::GetParamAsString(const wxString& par, wxString *str) const
 {
     wxCHECK_MSG( str, false, wxT("NULL output string argument") );
 
-    int index = m_ParamNames.Index(par, false);
-    if (index == wxNOT_FOUND)
+    const Param* const param = FindParam(par);
+    if (!param)
         return false;
 
-    *str = m_ParamValues[index];
+    *str = param->value;
 
     return true;
 }
@@ -591,11 +688,12 @@ bool wxHtmlTag::GetParamAsColour(const wxString& par, wxColour *clr) const
 
 bool wxHtmlTag::GetParamAsInt(const wxString& par, int *clr) const
 {
-    if ( !HasParam(par) )
+    const Param* const param = FindParam(par);
+    if ( !param )
         return false;
 
     long i;
-    if ( !GetParam(par).ToLong(&i) )
+    if ( !param->value.ToLong(&i) )
         return false;
 
     *clr = (int)i;
@@ -643,15 +741,16 @@ wxString wxHtmlTag::GetAllParams() const
     // VS: this function is for backward compatibility only,
     //     never used by wxHTML
     wxString s;
-    size_t cnt = m_ParamNames.GetCount();
-    for (size_t i = 0; i < cnt; i++)
+    for ( wxVector<Param>::const_iterator i = m_params.begin();
+          i != m_params.end();
+          ++i )
     {
-        s << m_ParamNames[i];
+        s << i->name;
         s << wxT('=');
-        if (m_ParamValues[i].Find(wxT('"')) != wxNOT_FOUND)
-            s << wxT('\'') << m_ParamValues[i] << wxT('\'');
+        if (i->value.Find(wxT('"')) != wxNOT_FOUND)
+            s << wxT('\'') << i->value << wxT('\'');
         else
-            s << wxT('"') << m_ParamValues[i] << wxT('"');
+            s << wxT('"') << i->value << wxT('"');
     }
     return s;
 }
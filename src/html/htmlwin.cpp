@@ -25,12 +25,15 @@
     #include "wx/settings.h"
     #include "wx/dataobj.h"
     #include "wx/statusbr.h"
+    #include "wx/app.h"
+    #include "wx/stopwatch.h"
 #endif
 
 #include "wx/html/htmlwin.h"
 #include "wx/html/htmlproc.h"
 #include "wx/clipbrd.h"
 #include "wx/recguard.h"
+#include "wx/mstream.h"
 
 #include "wx/arrimpl.cpp"
 #include "wx/listimpl.cpp"
@@ -303,6 +306,9 @@ void wxHtmlWindow::CleanUpStatics()
 void wxHtmlWindow::Init()
 {
     m_tmpCanDrawLocks = 0;
+    m_incrementalLayout = false;
+    m_layoutWidth = 0;
+    m_layoutUpTo = -1;
     m_FS = new wxFileSystem();
 #if wxUSE_STATUSBAR
     m_RelatedStatusBar = NULL;
@@ -445,11 +451,6 @@ bool wxHtmlWindow::DoSetPage(const wxString& source)
 {
     wxString newsrc(source);
 
-    wxDELETE(m_selection);
-
-    // we will soon delete all the cells, so clear pointers to them:
-    m_tmpSelFromCell = NULL;
-
     // pass HTML through registered processors:
     if (m_Processors || m_GlobalProcessors)
     {
@@ -487,6 +488,90 @@ bool wxHtmlWindow::DoSetPage(const wxString& source)
 
     // ...and run the parser on it:
     wxClientDC dc(this);
+    BeginNewPage(dc);
+
+    m_Cell = (wxHtmlContainerCell*) m_Parser->Parse(newsrc);
+
+    EndNewPage();
+    return true;
+}
+
+bool wxHtmlWindow::LoadStream(wxInputStream& stream, const wxMBConv& conv)
+{
+    // as with SetPage(), the new page doesn't come from any location
+    m_OpenedPage.clear();
+    m_OpenedAnchor.clear();
+    m_OpenedPageTitle.clear();
+
+    // processors work on the entire page source, so read all of it first
+    if ( m_Processors || m_GlobalProcessors )
+    {
+        wxMemoryOutputStream out;
+        stream.Read(out);
+
+        const size_t len = out.GetSize();
+        wxCharBuffer buf(len);
+        out.CopyTo(buf.data(), len);
+
+        return DoSetPage(wxString(buf, conv, len));
+    }
+
+    wxClientDC dc(this);
+    BeginNewPage(dc);
+
+    m_Parser->BeginStreaming();
+
+    bool shown = false;
+    while ( m_Parser->ParseChunk(stream, conv) )
+    {
+        if ( !shown )
+            shown = ShowPartialPage();
+    }
+
+    const bool ok = !m_Parser->HasStreamingError();
+    m_Cell = (wxHtmlContainerCell*) m_Parser->EndStreaming();
+
+    EndNewPage();
+    return ok;
+}
+
+bool wxHtmlWindow::ShowPartialPage()
+{
+    wxHtmlContainerCell* top = m_Parser->GetContainer();
+    if ( !top )
+        return false;
+
+    while ( top->GetParent() )
+        top = top->GetParent();
+
+    const wxSize clientSize = GetClientSize();
+    top->SetIndent(m_Borders, wxHTML_INDENT_ALL, wxHTML_UNITS_PIXELS);
+    top->SetAlignHor(wxHTML_ALIGN_CENTER);
+
+    // wait until the parsed part of the page fills the window
+    if ( top->LayoutPartially(clientSize.x, clientSize.y) &&
+            top->GetHeight() < clientSize.y )
+        return false;
+
+    m_Cell = top;
+    CreateLayout();
+
+    if ( m_tmpCanDrawLocks == 0 )
+    {
+        Refresh();
+        Update();
+    }
+
+    return true;
+}
+
+void wxHtmlWindow::BeginNewPage(wxDC& dc)
+{
+    wxDELETE(m_selection);
+
+    // we will soon delete all the cells, so clear pointers to them:
+    m_tmpSelFromCell = NULL;
+
     dc.SetMapMode(wxMM_TEXT);
     SetBackgroundColour(wxColour(0xFF, 0xFF, 0xFF));
     SetBackgroundImage(wxNullBitmap);
@@ -503,9 +588,11 @@ bool wxHtmlWindow::DoSetPage(const wxString& source)
     // without this we may crash if it's used from inside Parse(), so use
     // wxDELETE() and not just delete here
     wxDELETE(m_Cell);
+    m_layoutUpTo = -1;
+}
 
-    m_Cell = (wxHtmlContainerCell*) m_Parser->Parse(newsrc);
-
+void wxHtmlWindow::EndNewPage()
+{
     // The parser doesn't need the DC any more, so ensure it's not left with a
     // dangling pointer after the DC object goes out of scope.
     m_Parser->SetDC(NULL);
@@ -515,7 +602,6 @@ bool wxHtmlWindow::DoSetPage(const wxString& source)
     CreateLayout();
     if (m_tmpCanDrawLocks == 0)
         Refresh();
-    return true;
 }
 
 bool wxHtmlWindow::AppendToPage(const wxString& source)
@@ -689,6 +775,9 @@ bool wxHtmlWindow::ScrollToAnchor(const wxString& anchor)
     }
     else
     {
+        // We need to know the real position of the anchor.
+        CompleteLayout();
+
         // Go to next visible cell in current container, if it exists. This
         // yields a bit better (even though still imperfect) results in that
         // there's better chance of using a suitable cell for upper Y
@@ -736,7 +825,7 @@ void wxHtmlWindow::CreateLayout()
 
     if ( HasFlag(wxHW_SCROLLBAR_NEVER) )
     {
-        m_Cell->Layout(GetClientSize().GetWidth());
+        LayoutCell(GetClientSize().GetWidth());
     }
     else // Do show scrollbars if necessary.
     {
@@ -748,19 +837,68 @@ void wxHtmlWindow::CreateLayout()
         // Let wxScrolledWindow decide whether it needs to show the vertical
         // scrollbar for the given contents size.
         ShowScrollbars(wxSHOW_SB_DEFAULT, wxSHOW_SB_DEFAULT);
-        m_Cell->Layout(widthWithVScrollbar);
+        LayoutCell(widthWithVScrollbar);
         SetVirtualSize(m_Cell->GetWidth(), m_Cell->GetHeight());
 
         // Check if the vertical scrollbar was hidden.
         const int newClientWidth = GetClientSize().GetWidth();
         if ( newClientWidth != widthWithVScrollbar )
         {
-            m_Cell->Layout(newClientWidth);
+            LayoutCell(newClientWidth);
             SetVirtualSize(m_Cell->GetWidth(), m_Cell->GetHeight());
         }
     }
 }
 
+void wxHtmlWindow::LayoutCell(int width)
+{
+    m_layoutWidth = width;
+
+    if ( !m_incrementalLayout )
+    {
+        m_layoutUpTo = -1;
+        m_Cell->Layout(width);
+        return;
+    }
+
+    // Lay out just the part of the page shown now, with some margin for
+    // scrolling, the rest of it will be done in idle time.
+    int x, y;
+    GetViewStart(&x, &y);
+
+    m_layoutUpTo = y * wxHTML_SCROLL_STEP + 2*GetClientSize().y;
+    if ( m_Cell->LayoutPartially(width, m_layoutUpTo) )
+        m_layoutUpTo = -1;
+}
+
+void wxHtmlWindow::LayoutUpTo(int y)
+{
+    if ( m_layoutUpTo == -1 || y <= m_layoutUpTo )
+        return;
+
+    m_layoutUpTo = y;
+    if ( m_Cell->LayoutPartially(m_layoutWidth, m_layoutUpTo) )
+        m_layoutUpTo = -1;
+}
+
+void wxHtmlWindow::EnableIncrementalLayout(bool enable)
+{
+    m_incrementalLayout = enable;
+
+    if ( !enable )
+        CompleteLayout();
+}
+
+void wxHtmlWindow::CompleteLayout()
+{
+    if ( !m_Cell || m_layoutUpTo == -1 )
+        return;
+
+    m_layoutUpTo = -1;
+    m_Cell->Layout(m_layoutWidth);
+    SetVirtualSize(m_Cell->GetWidth(), m_Cell->GetHeight());
+}
+
 #if wxUSE_CONFIG
 void wxHtmlWindow::ReadCustomization(wxConfigBase *cfg, wxString path)
 {
@@ -1137,6 +1275,11 @@ void wxHtmlWindow::OnPaint(wxPaintEvent& WXUNUSED(event))
     dc->SetBackgroundMode(wxBRUSHSTYLE_TRANSPARENT);
     dc->SetLayoutDirection(GetLayoutDirection());
 
+    // if the page is laid out incrementally, ensure that at least the part
+    // of it which we're going to draw is, the virtual size will be updated
+    // later in idle time
+    LayoutUpTo(y * wxHTML_SCROLL_STEP + rect.GetBottom() + sz.y);
+
     wxHtmlRenderingInfo rinfo;
     wxDefaultHtmlRenderingStyle rstyle;
     rinfo.SetSelection(m_selection);
@@ -1291,6 +1434,25 @@ void wxHtmlWindow::OnInternalIdle()
 {
     wxWindow::OnInternalIdle();
 
+    if ( m_Cell != NULL && m_layoutUpTo != -1 )
+    {
+        // Continue the incremental layout, a few pages at once, but without
+        // blocking the UI for too long.
+        const int step = 10*wxMax(GetClientSize().y, wxHTML_SCROLL_STEP);
+
+        wxStopWatch sw;
+        do
+        {
+            LayoutUpTo(m_layoutUpTo + step);
+        }
+        while ( m_layoutUpTo != -1 && sw.Time() < 20 );
+
+        SetVirtualSize(m_Cell->GetWidth(), m_Cell->GetHeight());
+
+        if ( m_layoutUpTo != -1 )
+            wxWakeUpIdle();
+    }
+
     if (m_Cell != NULL && DidMouseMove())
     {
 #ifdef DEBUG_HTML_SELECTION
@@ -1980,7 +1980,7 @@ void wxPGProperty::SetFlagsFromString( const wxString& str )
         }
     WX_PG_TOKENIZER1_END()
 
-    m_flags = (m_flags & ~wxPG_STRING_STORED_FLAGS) | flags;
+    DoSetFlags((m_flags & ~wxPG_STRING_STORED_FLAGS) | flags);
 }
 
 wxValidator* wxPGProperty::DoGetValidator() const
@@ -2347,6 +2347,8 @@ void wxPGProperty::DoAddChild( wxPGProperty* prop, int index,
     }
 
     prop->m_parent = this;
+
+    ChildrenChanged();
 }
 
 void wxPGProperty::DoPreAddChild( int index, wxPGProperty* prop )
@@ -2364,6 +2366,8 @@ void wxPGProperty::DoPreAddChild( int index, wxPGProperty* prop )
         prop->m_flags |= wxPG_PROP_CUSTOMIMAGE;
 
     prop->m_parent = this;
+
+    ChildrenChanged();
 }
 
 void wxPGProperty::AddPrivateChild( wxPGProperty* prop )
@@ -2415,17 +2419,39 @@ wxPGProperty* wxPGProperty::InsertChild( int index,
 void wxPGProperty::RemoveChild( wxPGProperty* p )
 {
     wxPGRemoveItemFromVector<wxPGProperty*>(m_children, p);
+
+    ChildrenChanged();
 }
 
 void wxPGProperty::RemoveChild(unsigned int index)
 {
     m_children.erase(m_children.begin()+index);
+
+    ChildrenChanged();
 }
 
 void wxPGProperty::SortChildren(int (*fCmp)(wxPGProperty**, wxPGProperty**))
 {
     wxArray_SortFunction<wxPGProperty*> sf(fCmp);
     std::sort(m_children.begin(), m_children.end(), sf);
+
+    ChildrenChanged();
+}
+
+void wxPGProperty::ChildrenChanged()
+{
+    // The state caches the visible properties, so it must be told about any
+    // changes to them, even those not done via its own functions.
+    if ( m_parentState )
+        m_parentState->VirtualHeightChanged();
+}
+
+void wxPGProperty::RowFlagsChanged( FlagType changed )
+{
+    // Also tell the state about expanding, collapsing, hiding or showing the
+    // property, even when not done via the state or without any grid.
+    if ( m_parentState )
+        m_parentState->OnPropertyRowFlagsChanged(this, changed);
 }
 
 void wxPGProperty::AdaptListToValue( wxVariant& list, wxVariant* value ) const
@@ -2806,6 +2832,9 @@ void wxPGProperty::SubPropsChanged( int oldSelInd )
     wxPropertyGridPageState* state = GetParentState();
     wxPropertyGrid* grid = state->GetGrid();
 
+    // The old children were deleted.
+    state->VirtualHeightChanged();
+
     //
     // Re-repare children (recursively)
     for ( unsigned int i=0; i<GetChildCount(); i++ )
@@ -1851,12 +1851,11 @@ bool wxPropertyGrid::IsSmallScreen()
 
 wxPGProperty* wxPropertyGrid::DoGetItemAtY( int y ) const
 {
-    // Outside?
-    if ( y < 0 )
-        return NULL;
+    // This doesn't change the logical state of the grid, so it's fine to do
+    // even from this const function.
+    m_pState->EnsureVisibleRows();
 
-    unsigned int a = 0;
-    return m_pState->DoGetRoot()->GetItemAtY(y, m_lineHeight, &a);
+    return m_pState->DoGetItemAtY(y);
 }
 
 // -----------------------------------------------------------------------
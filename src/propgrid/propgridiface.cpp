@@ -79,7 +79,8 @@ void wxPropertyGridInterface::RefreshGrid( wxPropertyGridPageState* state )
         state = m_pState;
 
     wxPropertyGrid* grid = state->GetGrid();
-    if ( grid->GetState() == state && !grid->IsFrozen() )
+    if ( grid->GetState() == state && !grid->IsFrozen() &&
+            !state->IsInBulkLoad() )
     {
         grid->Refresh();
     }
@@ -319,6 +320,10 @@ bool wxPropertyGridInterface::ExpandAll( bool doExpand )
         pg->DoClearSelection();
     }
 
+    // Rebuild the visible rows index once after changing all properties
+    // instead of updating it for each of them.
+    state->VirtualHeightChanged();
+
     wxPGVIterator it;
 
     for ( it = GetVIterator( wxPG_ITERATE_ALL ); !it.AtEnd(); it.Next() )
@@ -849,6 +854,13 @@ void wxPropertyGridInterface::BeginAddChildren( wxPGPropArg id )
 
 // -----------------------------------------------------------------------
 
+void wxPropertyGridInterface::BeginBulkLoad()
+{
+    m_pState->BeginBulkLoad();
+}
+
+// -----------------------------------------------------------------------
+
 bool wxPropertyGridInterface::EditorValidate()
 {
     return GetPropertyGrid()->DoEditorValidate();
@@ -856,6 +868,15 @@ bool wxPropertyGridInterface::EditorValidate()
 
 // -----------------------------------------------------------------------
 
+void wxPropertyGridInterface::EndBulkLoad()
+{
+    m_pState->EndBulkLoad();
+
+    RefreshGrid();
+}
+
+// -----------------------------------------------------------------------
+
 void wxPropertyGridInterface::EndAddChildren( wxPGPropArg id )
 {
     wxPG_PROP_ARG_CALL_PROLOG()
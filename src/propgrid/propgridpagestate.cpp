@@ -212,6 +212,8 @@ wxPropertyGridPageState::wxPropertyGridPageState()
     m_itemsAdded = false;
     m_anyModified = false;
     m_vhCalcPending = false;
+    m_visibleRowsValid = true;
+    m_bulkLoad = 0;
     m_colWidths.push_back( wxPG_DEFAULT_SPLITTERX );
     m_colWidths.push_back( wxPG_DEFAULT_SPLITTERX );
     m_fSplitterX = wxPG_DEFAULT_SPLITTERX;
@@ -318,6 +320,12 @@ void wxPropertyGridPageState::DoClear()
 
         m_virtualHeight = 0;
         m_vhCalcPending = false;
+
+        m_visibleRows.clear();
+        m_visibleRowsValid = true;
+
+        m_bulkNames.clear();
+        m_bulkParents.clear();
     }
 }
 
@@ -485,6 +493,11 @@ wxPGProperty* wxPropertyGridPageState::BaseGetPropertyByLabel
 
 wxPGProperty* wxPropertyGridPageState::BaseGetPropertyByName( const wxString& name ) const
 {
+    // The dictionary is logically a part of the state even if some names
+    // haven't been added to it yet.
+    if ( !m_bulkNames.empty() )
+        const_cast<wxPropertyGridPageState*>(this)->DoFlushBulkLoad();
+
     wxPGHashMapS2P::const_iterator it;
     it = m_dictName.find(name);
     if ( it != m_dictName.end() )
@@ -499,6 +512,8 @@ void wxPropertyGridPageState::DoSetPropertyName( wxPGProperty* p,
 {
     wxCHECK_RET( p, wxS("invalid property id") );
 
+    DoFlushBulkLoad();
+
     wxPGProperty* parent = p->GetParent();
 
     if ( parent->IsCategory() || parent->IsRoot() )
@@ -752,8 +767,116 @@ wxPGProperty* wxPropertyGridPageState::DoGetItemAtY( int y ) const
     if ( y < 0 )
         return NULL;
 
+    const int lh = GetGrid()->GetRowHeight();
+
+    // All rows have the same height, so we can find the property directly if
+    // the index of visible rows is up-to-date.
+    if ( m_visibleRowsValid && lh > 0 )
+    {
+        const size_t row = y / lh;
+        return row < m_visibleRows.size() ? m_visibleRows[row] : NULL;
+    }
+
     unsigned int a = 0;
-    return m_properties->GetItemAtY(y, GetGrid()->GetRowHeight(), &a);
+    return m_properties->GetItemAtY(y, lh, &a);
+}
+
+// Appends all visible descendants of the given property to the vector, in the
+// order in which they're shown. This must be consistent with
+// wxPGProperty::GetItemAtY() and GetChildrenHeight().
+static void wxPGAddVisibleRows(const wxPGProperty* p,
+                               wxVector<wxPGProperty*>& rows)
+{
+    for ( unsigned int i = 0; i < p->GetChildCount(); i++ )
+    {
+        wxPGProperty* const child = p->Item(i);
+        if ( child->HasFlag(wxPG_PROP_HIDDEN) )
+            continue;
+
+        rows.push_back(child);
+
+        if ( child->IsExpanded() && child->GetChildCount() > 0 )
+            wxPGAddVisibleRows(child, rows);
+    }
+}
+
+void wxPropertyGridPageState::EnsureVisibleRows()
+{
+    if ( m_visibleRowsValid )
+        return;
+
+    m_visibleRows.clear();
+    wxPGAddVisibleRows(m_properties, m_visibleRows);
+    m_visibleRowsValid = true;
+}
+
+void wxPropertyGridPageState::RecalculateVirtualHeight()
+{
+    EnsureVisibleRows();
+
+    m_virtualHeight = m_visibleRows.size() * GetGrid()->GetRowHeight();
+}
+
+// Notice that this is a linear search: keeping the row in each property
+// wouldn't help much as all the following rows would need to be updated after
+// inserting or removing rows, which is linear in any case.
+int wxPropertyGridPageState::DoGetVisibleRow(const wxPGProperty* p) const
+{
+    for ( size_t row = 0; row < m_visibleRows.size(); row++ )
+    {
+        if ( m_visibleRows[row] == p )
+            return row;
+    }
+
+    return wxNOT_FOUND;
+}
+
+void wxPropertyGridPageState::OnPropertyRowFlagsChanged(wxPGProperty* p,
+                                                        wxPGProperty::FlagType changed)
+{
+    // Hiding or showing properties is typically done for many of them at
+    // once, e.g. recursively, so just rebuild the index when it's needed.
+    if ( changed & wxPG_PROP_HIDDEN )
+    {
+        VirtualHeightChanged();
+        return;
+    }
+
+    m_vhCalcPending = true;
+
+    if ( !m_visibleRowsValid || !p->GetChildCount() )
+        return;
+
+    // If the property itself is not shown, neither are its descendants, so
+    // nothing changes.
+    const int row = DoGetVisibleRow(p);
+    if ( row == wxNOT_FOUND )
+        return;
+
+    if ( p->IsExpanded() )
+    {
+        // Insert the rows of the now visible descendants of the property
+        // after it into the index instead of rebuilding it.
+        wxVector<wxPGProperty*> rows;
+        wxPGAddVisibleRows(p, rows);
+
+        m_visibleRows.insert(m_visibleRows.begin() + row + 1,
+                             rows.size(), NULL);
+        for ( size_t n = 0; n < rows.size(); n++ )
+            m_visibleRows[row + 1 + n] = rows[n];
+    }
+    else
+    {
+        // Remove the rows of all the visible descendants of the property,
+        // which immediately follow it.
+        size_t last = row + 1;
+        while ( last < m_visibleRows.size() &&
+                    m_visibleRows[last]->IsSomeParent(p) )
+            last++;
+
+        m_visibleRows.erase(m_visibleRows.begin() + row + 1,
+                            m_visibleRows.begin() + last);
+    }
 }
 
 // -----------------------------------------------------------------------
@@ -1367,10 +1490,9 @@ bool wxPropertyGridPageState::DoCollapse( wxPGProperty* p )
 
     if ( !p->IsExpanded() ) return false;
 
+    // This updates the visible rows via OnPropertyRowFlagsChanged().
     p->SetExpanded(false);
 
-    VirtualHeightChanged();
-
     return true;
 }
 
@@ -1384,10 +1506,9 @@ bool wxPropertyGridPageState::DoExpand( wxPGProperty* p )
 
     if ( p->IsExpanded() ) return false;
 
+    // This updates the visible rows via OnPropertyRowFlagsChanged().
     p->SetExpanded(true);
 
-    VirtualHeightChanged();
-
     return true;
 }
 
@@ -1634,6 +1755,17 @@ void wxPropertyGridPageState::DoSetPropertyValues( const wxVariantList& list, wx
 // wxPropertyGridPageState property adding and removal
 // -----------------------------------------------------------------------
 
+#if wxDEBUG_LEVEL
+static void wxPGWarnDuplicateName( const wxPGProperty* property )
+{
+    wxFAIL_MSG(wxString::Format(
+        wxS("wxPropertyGrid item with name \"%s\" already exists"),
+        property->GetName()));
+
+    wxPGGlobalVars->m_warnings++;
+}
+#endif // wxDEBUG_LEVEL
+
 bool wxPropertyGridPageState::PrepareToAddItem( wxPGProperty* property,
                                                 wxPGProperty* scheduledParent )
 {
@@ -1662,11 +1794,14 @@ bool wxPropertyGridPageState::PrepareToAddItem( wxPGProperty* property,
                  wxS("Parent of a category must be either root or another category."));
 
         // If we already have category with same name, delete given property
-        // and use it instead as most recent caption item.
-        wxPGProperty* found_id = BaseGetPropertyByName( property->GetBaseName() );
-        if ( found_id )
+        // and use it instead as most recent caption item. Notice that names
+        // of categories are added to the dictionary immediately even in bulk
+        // load mode, so there is no need to flush it here.
+        wxPGHashMapS2P::const_iterator it =
+            m_dictName.find( property->GetBaseName() );
+        if ( it != m_dictName.end() )
         {
-            wxPropertyCategory* pwc = (wxPropertyCategory*) found_id;
+            wxPropertyCategory* pwc = (wxPropertyCategory*) it->second;
             if ( pwc->IsCategory() ) // Must be a category.
             {
                 delete property;
@@ -1677,15 +1812,13 @@ bool wxPropertyGridPageState::PrepareToAddItem( wxPGProperty* property,
     }
 
 #if wxDEBUG_LEVEL
-    // Warn for identical names in debug mode.
-    if ( BaseGetPropertyByName(property->GetName()) &&
+    // Warn for identical names in debug mode (in bulk load mode this is done
+    // when the name is really added to the dictionary).
+    if ( !IsInBulkLoad() &&
+         BaseGetPropertyByName(property->GetName()) &&
          (!scheduledParent || scheduledParent->IsCategory()) )
     {
-        wxFAIL_MSG(wxString::Format(
-            wxS("wxPropertyGrid item with name \"%s\" already exists"),
-            property->GetName()));
-
-        wxPGGlobalVars->m_warnings++;
+        wxPGWarnDuplicateName(property);
     }
 #endif // wxDEBUG_LEVEL
 
@@ -1713,6 +1846,28 @@ bool wxPropertyGridPageState::PrepareToAddItem( wxPGProperty* property,
 
 // -----------------------------------------------------------------------
 
+// Returns true if the value of this property is composed from the values of
+// its children.
+static bool wxPGIsComposedParent( const wxPGProperty* p )
+{
+    return p && !p->IsRoot() && !p->IsCategory() &&
+                p->HasFlag(wxPG_PROP_COMPOSED_VALUE);
+}
+
+// Updates the values and the editors of all the parents of the given property
+// which are containers of composed values.
+static void wxPGUpdateComposedParents( wxPGProperty* property )
+{
+    property->UpdateParentValues();
+
+    for ( wxPGProperty* p = property->GetParent();
+          wxPGIsComposedParent(p);
+          p = p->GetParent() )
+    {
+        p->RefreshEditor();
+    }
+}
+
 wxPGProperty* wxPropertyGridPageState::DoAppend( wxPGProperty* property )
 {
     wxPropertyCategory* cur_cat = m_currentCategory;
@@ -1797,19 +1952,27 @@ wxPGProperty* wxPropertyGridPageState::DoInsert( wxPGProperty* parent, int index
     // Only add name to hashmap if parent is root or category
     if ( !property->GetBaseName().empty() &&
         (parentIsCategory || parentIsRoot) )
-        m_dictName[property->GetBaseName()] = (void*) property;
+    {
+        // Categories must be always found by PrepareToAddItem(), see there.
+        if ( IsInBulkLoad() && !property->IsCategory() )
+            m_bulkNames.push_back(property);
+        else
+            m_dictName[property->GetBaseName()] = (void*) property;
+    }
 
     VirtualHeightChanged();
 
-    // Update values of all parents if they are containers of composed values.
-    property->UpdateParentValues();
-
-    // Update editor controls of all parents if they are containers of composed values.
-    for( wxPGProperty *p = property->GetParent();
-         p && !p->IsRoot() && !p->IsCategory() && p->HasFlag(wxPG_PROP_COMPOSED_VALUE);
-         p = p->GetParent() )
+    if ( IsInBulkLoad() )
     {
-        p->RefreshEditor();
+        // Composing the value of the parent takes time proportional to the
+        // number of its children, so do it only once for all of them.
+        if ( wxPGIsComposedParent(parent) &&
+                (m_bulkParents.empty() || m_bulkParents.back() != parent) )
+            m_bulkParents.push_back(parent);
+    }
+    else
+    {
+        wxPGUpdateComposedParents(property);
     }
 
     m_itemsAdded = true;
@@ -1819,6 +1982,43 @@ wxPGProperty* wxPropertyGridPageState::DoInsert( wxPGProperty* parent, int index
 
 // -----------------------------------------------------------------------
 
+void wxPropertyGridPageState::EndBulkLoad()
+{
+    wxCHECK_RET( m_bulkLoad > 0,
+                 wxS("EndBulkLoad() without matching BeginBulkLoad()") );
+
+    if ( --m_bulkLoad == 0 )
+        DoFlushBulkLoad();
+}
+
+void wxPropertyGridPageState::DoFlushBulkLoad()
+{
+    for ( size_t n = 0; n < m_bulkNames.size(); n++ )
+    {
+        wxPGProperty* const p = m_bulkNames[n];
+
+#if wxDEBUG_LEVEL
+        if ( m_dictName.find(p->GetBaseName()) != m_dictName.end() )
+            wxPGWarnDuplicateName(p);
+#endif // wxDEBUG_LEVEL
+
+        m_dictName[p->GetBaseName()] = (void*) p;
+    }
+
+    m_bulkNames.clear();
+
+    for ( size_t n = 0; n < m_bulkParents.size(); n++ )
+    {
+        wxPGProperty* const parent = m_bulkParents[n];
+        if ( parent->GetChildCount() )
+            wxPGUpdateComposedParents(parent->Item(0));
+    }
+
+    m_bulkParents.clear();
+}
+
+// -----------------------------------------------------------------------
+
 void wxPropertyGridPageState::DoRemoveChildrenFromSelection(wxPGProperty* p,
                                                             bool recursive,
                                                             int selFlags)
@@ -1930,6 +2130,8 @@ void wxPropertyGridPageState::DoDelete( wxPGProperty* item, bool doDelete )
     wxCHECK_RET( !parent->HasFlag(wxPG_PROP_AGGREGATE),
         wxS("wxPropertyGrid: Do not attempt to remove sub-properties.") );
 
+    DoFlushBulkLoad();
+
     wxASSERT( item->GetParentState() == this );
 
     wxPropertyGrid* pg = GetGrid();
@@ -37,6 +37,7 @@
 #include "wx/hashmap.h"
 #include "wx/dynarray.h"
 #include "wx/math.h"
+#include "wx/time.h"
 
 #include "wx/richtext/richtextctrl.h"
 #include "wx/richtext/richtextstyles.h"
@@ -517,6 +518,184 @@ inline void wxCheckSetBrush(wxDC& dc, const wxBrush& brush)
     dc.SetBrush(brush);
 }
 
+/*!
+ * wxRichTextSharedAttr
+ * Combined attributes shared by all the objects in a buffer having the same
+ * ones, as most of the objects in a buffer typically do.
+ */
+
+class wxRichTextSharedAttr;
+
+WX_DECLARE_HASH_MAP(unsigned long, wxRichTextSharedAttr*, wxIntegerHash, wxIntegerEqual, wxRichTextSharedAttrHashMap);
+
+// The shared attributes of a buffer. It is referenced by the buffer and by all
+// the shared attributes in it, so that it's only destroyed after all of them.
+class wxRichTextSharedAttrPool
+{
+public:
+    wxRichTextSharedAttrPool() : m_refCount(1) {}
+
+    void IncRef() { m_refCount ++; }
+    void DecRef() { if (--m_refCount == 0) delete this; }
+
+    wxRichTextSharedAttrHashMap m_attrs;
+
+private:
+    int                     m_refCount;
+
+    wxDECLARE_NO_COPY_CLASS(wxRichTextSharedAttrPool);
+};
+
+class wxRichTextSharedAttr
+{
+public:
+    // Returns the shared attributes equal to the given ones and combined from
+    // the given base ones, creating them if necessary. If the pool is NULL,
+    // the attributes are not shared.
+    static wxRichTextSharedAttr* Get(const wxRichTextAttr& attr, wxRichTextSharedAttr* base, wxRichTextSharedAttrPool* pool);
+
+    void IncRef() { m_refCount ++; }
+    void DecRef();
+
+    const wxRichTextAttr& GetAttributes() const { return m_attr; }
+
+    wxRichTextSharedAttrPool* GetPool() const { return m_pool; }
+
+private:
+    wxRichTextSharedAttr(const wxRichTextAttr& attr, unsigned long hash, wxRichTextSharedAttr* base, wxRichTextSharedAttrPool* pool)
+        : m_attr(attr), m_hash(hash), m_base(base), m_pool(pool), m_refCount(1), m_next(NULL)
+    {
+        if (m_base)
+            m_base->IncRef();
+        if (m_pool)
+            m_pool->IncRef();
+    }
+
+    static unsigned long Hash(const wxRichTextAttr& attr, const wxRichTextSharedAttr* base);
+
+    wxRichTextAttr          m_attr;
+    unsigned long           m_hash;
+
+    // The attributes not specified by the flags come from the base ones, so
+    // only the attributes combined from the same base ones can be shared. The
+    // base attributes are referenced, so that their address is not reused.
+    wxRichTextSharedAttr*   m_base;
+
+    wxRichTextSharedAttrPool* m_pool;
+
+    int                     m_refCount;
+
+    // The next shared attributes with the same hash
+    wxRichTextSharedAttr*   m_next;
+
+    wxDECLARE_NO_COPY_CLASS(wxRichTextSharedAttr);
+};
+
+unsigned long wxRichTextSharedAttr::Hash(const wxRichTextAttr& attr, const wxRichTextSharedAttr* base)
+{
+    // Only use the attributes which are cheap to get and likely to differ.
+    unsigned long hash = (unsigned long) wxPtrToUInt(base);
+    hash = hash*31 + attr.GetFlags();
+    hash = hash*31 + attr.GetFontSize();
+    hash = hash*31 + attr.GetFontWeight();
+    hash = hash*31 + attr.GetFontStyle();
+    hash = hash*31 + attr.GetAlignment();
+    hash = hash*31 + attr.GetLeftIndent();
+    hash = hash*31 + attr.GetBulletStyle();
+    if (attr.GetTextColour().IsOk())
+        hash = hash*31 + attr.GetTextColour().GetRGB();
+    if (attr.GetBackgroundColour().IsOk())
+        hash = hash*31 + attr.GetBackgroundColour().GetRGB();
+    hash = hash*31 + wxStringHash::stringHash(attr.GetFontFaceName().wx_str());
+    hash = hash*31 + wxStringHash::stringHash(attr.GetCharacterStyleName().wx_str());
+    hash = hash*31 + wxStringHash::stringHash(attr.GetParagraphStyleName().wx_str());
+    return hash;
+}
+
+wxRichTextSharedAttr* wxRichTextSharedAttr::Get(const wxRichTextAttr& attr, wxRichTextSharedAttr* base, wxRichTextSharedAttrPool* pool)
+{
+    if (!pool)
+        return new wxRichTextSharedAttr(attr, 0, base, NULL);
+
+    const unsigned long hash = Hash(attr, base);
+
+    wxRichTextSharedAttr*& first = pool->m_attrs[hash];
+    for (wxRichTextSharedAttr* shared = first; shared; shared = shared->m_next)
+    {
+        if (shared->m_base == base && shared->m_attr == attr)
+        {
+            shared->IncRef();
+            return shared;
+        }
+    }
+
+    wxRichTextSharedAttr* const shared = new wxRichTextSharedAttr(attr, hash, base, pool);
+    shared->m_next = first;
+    first = shared;
+    return shared;
+}
+
+void wxRichTextSharedAttr::DecRef()
+{
+    if (--m_refCount > 0)
+        return;
+
+    if (m_pool)
+    {
+        wxRichTextSharedAttrHashMap::iterator it = m_pool->m_attrs.find(m_hash);
+        wxCHECK_RET(it != m_pool->m_attrs.end(), wxT("Shared attributes not found"));
+
+        wxRichTextSharedAttr** prev = &it->second;
+        while (*prev != this)
+            prev = &(*prev)->m_next;
+        *prev = m_next;
+
+        if (!it->second)
+            m_pool->m_attrs.erase(it);
+
+        m_pool->DecRef();
+    }
+
+    if (m_base)
+        m_base->DecRef();
+
+    delete this;
+}
+
+/*!
+ * wxRichTextCombinedAttrCache
+ * Caches the combined attributes of an object.
+ */
+
+const wxRichTextAttr& wxRichTextCombinedAttrCache::Get() const
+{
+    return m_attr->GetAttributes();
+}
+
+void wxRichTextCombinedAttrCache::Set(const wxRichTextAttr& attr, unsigned generation, wxRichTextSharedAttr* base, wxRichTextSharedAttrPool* pool)
+{
+    // The objects combining their attributes with ours don't need to combine
+    // them again if ours didn't really change.
+    if (!m_attr || m_base != base || !(m_attr->GetAttributes() == attr))
+    {
+        wxRichTextSharedAttr* const shared = wxRichTextSharedAttr::Get(attr, base, pool);
+        Reset();
+        m_attr = shared;
+        m_base = base;
+    }
+
+    m_generation = generation;
+}
+
+void wxRichTextCombinedAttrCache::Reset()
+{
+    if (m_attr)
+    {
+        m_attr->DecRef();
+        Init();
+    }
+}
+
 /*!
  * wxRichTextObject
  * This is the base for drawable objects.
@@ -530,6 +709,7 @@ wxRichTextObject::wxRichTextObject(wxRichTextObject* parent)
     m_parent = parent;
     m_descent = 0;
     m_show = true;
+    m_attributesGeneration = 0;
 }
 
 wxRichTextObject::~wxRichTextObject()
@@ -553,6 +733,7 @@ void wxRichTextObject::Copy(const wxRichTextObject& obj)
     m_range = obj.m_range;
     m_ownRange = obj.m_ownRange;
     m_attributes = obj.m_attributes;
+    m_attributesGeneration++;
     m_properties = obj.m_properties;
     m_descent = obj.m_descent;
     m_show = obj.m_show;
@@ -1352,6 +1533,7 @@ wxIMPLEMENT_CLASS(wxRichTextCompositeObject, wxRichTextObject);
 wxRichTextCompositeObject::wxRichTextCompositeObject(wxRichTextObject* parent):
     wxRichTextObject(parent)
 {
+    m_childrenGeneration = 0;
 }
 
 wxRichTextCompositeObject::~wxRichTextCompositeObject()
@@ -1371,6 +1553,7 @@ wxRichTextObject* wxRichTextCompositeObject::GetChild(size_t n) const
 size_t wxRichTextCompositeObject::AppendChild(wxRichTextObject* child)
 {
     m_children.Append(child);
+    m_childrenGeneration++;
     child->SetParent(this);
     return m_children.GetCount() - 1;
 }
@@ -1385,6 +1568,7 @@ bool wxRichTextCompositeObject::InsertChild(wxRichTextObject* child, wxRichTextO
     }
     else
         m_children.Insert(child);
+    m_childrenGeneration++;
     child->SetParent(this);
 
     return true;
@@ -1398,6 +1582,7 @@ bool wxRichTextCompositeObject::RemoveChild(wxRichTextObject* child, bool delete
     {
         wxRichTextObject* obj = node->GetData();
         m_children.Erase(node);
+        m_childrenGeneration++;
         if (deleteChild)
             delete obj;
 
@@ -1421,6 +1606,8 @@ bool wxRichTextCompositeObject::DeleteChildren()
         m_children.Erase(oldNode);
     }
 
+    m_childrenGeneration++;
+
     return true;
 }
 
@@ -1447,6 +1634,8 @@ void wxRichTextCompositeObject::Copy(const wxRichTextCompositeObject& obj)
 
         node = node->GetNext();
     }
+
+    m_childrenGeneration++;
 }
 
 /// Hit-testing: returns a flag indicating hit test details, plus
@@ -1662,6 +1851,7 @@ bool wxRichTextCompositeObject::Defragment(wxRichTextDrawingContext& context, co
                         {
                             nextChild->Dereference();
                             m_children.Erase(node->GetNext());
+                            m_childrenGeneration++;
                         }
                         else
                             node = node->GetNext();
@@ -1708,6 +1898,7 @@ bool wxRichTextCompositeObject::Defragment(wxRichTextDrawingContext& context, co
                         {
                             nextChild->Dereference();
                             m_children.Erase(node->GetNext());
+                            m_childrenGeneration++;
 
                             // Don't set node -- we'll see if we can merge again with the next
                             // child. UNLESS we split this or the next child, in which case we know we have to
@@ -1746,6 +1937,7 @@ bool wxRichTextCompositeObject::Defragment(wxRichTextDrawingContext& context, co
                 {
                     child->Dereference();
                     m_children.Erase(node);
+                    m_childrenGeneration++;
                 }
                 node = next;
             }
@@ -1957,6 +2149,11 @@ void wxRichTextParagraphLayoutBox::Init()
 
     m_partialParagraph = false;
     m_floatCollector = NULL;
+
+    m_childrenIndexGeneration = 0;
+
+    m_hasEstimatedLayout = false;
+    m_estimatedLayoutStart = 0;
 }
 
 void wxRichTextParagraphLayoutBox::Clear()
@@ -1967,6 +2164,7 @@ void wxRichTextParagraphLayoutBox::Clear()
         delete m_floatCollector;
     m_floatCollector = NULL;
     m_partialParagraph = false;
+    m_hasEstimatedLayout = false;
 }
 
 /// Copy
@@ -2055,7 +2253,30 @@ int wxRichTextParagraphLayoutBox::HitTest(wxDC& dc, wxRichTextDrawingContext& co
     }
 
     if (ret == wxRICHTEXT_HITTEST_NONE)
-        return wxRichTextCompositeObject::HitTest(dc, context, pt, textPosition, obj, contextObj, flags);
+    {
+        // The paragraphs only return a hit for the points above their last
+        // line, so the ones entirely above this point can be skipped, but only
+        // if the floating objects which can extend below their paragraphs are
+        // tested separately above.
+        if (!wxRichTextBuffer::GetFloatingLayoutMode() || (flags & wxRICHTEXT_HITTEST_NO_NESTED_OBJECTS))
+            return wxRichTextCompositeObject::HitTest(dc, context, pt, textPosition, obj, contextObj, flags);
+
+        wxRichTextObjectList::compatibility_iterator node = GetChildNodeAtYPosition(pt.y);
+        while (node)
+        {
+            wxRichTextObject* child = node->GetData();
+            if (child->IsShown())
+            {
+                ret = child->HitTest(dc, context, pt, textPosition, obj, contextObj, flags);
+                if (ret != wxRICHTEXT_HITTEST_NONE)
+                    return ret;
+            }
+
+            node = node->GetNext();
+        }
+
+        return wxRICHTEXT_HITTEST_NONE;
+    }
     else
     {
         *contextObj = this;
@@ -2089,7 +2310,7 @@ bool wxRichTextParagraphLayoutBox::Draw(wxDC& dc, wxRichTextDrawingContext& cont
 
     wxRect thisRect(GetPosition(), GetCachedSize());
 
-    wxRichTextAttr attr(GetAttributes());
+    wxRichTextAttr attr(m_attributes);
     AdjustAttributes(attr, context);
 
     int flags = style;
@@ -2108,7 +2329,12 @@ bool wxRichTextParagraphLayoutBox::Draw(wxDC& dc, wxRichTextDrawingContext& cont
     if (wxRichTextBuffer::GetFloatingLayoutMode())
         DrawFloats(dc, context, range, selection, rect, descent, style);
 
-    wxRichTextObjectList::compatibility_iterator node = m_children.GetFirst();
+    // Skip all the children above the area being drawn at once.
+    wxRichTextObjectList::compatibility_iterator node;
+    if ((style & wxRICHTEXT_DRAW_IGNORE_CACHE) == 0)
+        node = GetChildNodeAtYPosition(rect.GetTop());
+    else
+        node = m_children.GetFirst();
     while (node)
     {
         wxRichTextObject* child = node->GetData();
@@ -2153,7 +2379,9 @@ bool wxRichTextParagraphLayoutBox::Layout(wxDC& dc, wxRichTextDrawingContext& co
     wxRect availableSpace;
     bool formatRect = (style & wxRICHTEXT_LAYOUT_SPECIFIED_RECT) == wxRICHTEXT_LAYOUT_SPECIFIED_RECT;
 
-    wxRichTextAttr attr(GetAttributes());
+    // Don't use the non-const GetAttributes() here and below, as this would
+    // invalidate the cached combined attributes of all our paragraphs.
+    wxRichTextAttr attr(m_attributes);
     AdjustAttributes(attr, context);
 
     // If only laying out a specific area, the passed rect has a different meaning:
@@ -2228,7 +2456,7 @@ bool wxRichTextParagraphLayoutBox::Layout(wxDC& dc, wxRichTextDrawingContext& co
         wxRichTextParagraph* firstParagraph = GetParagraphAtPosition(invalidRange.GetStart());
         if (firstParagraph)
         {
-            wxRichTextObjectList::compatibility_iterator firstNode = m_children.Find(firstParagraph);
+            wxRichTextObjectList::compatibility_iterator firstNode = GetChildNodeAtPosition(invalidRange.GetStart());
             wxRichTextObjectList::compatibility_iterator previousNode;
             if ( firstNode )
                 previousNode = firstNode->GetPrevious();
@@ -2256,6 +2484,12 @@ bool wxRichTextParagraphLayoutBox::Layout(wxDC& dc, wxRichTextDrawingContext& co
     // A way to force speedy rest-of-buffer layout (the 'else' below)
     bool forceQuickLayout = false;
 
+    // The paragraphs which haven't been laid out yet below this position only
+    // get an estimated layout, based on the height of the lines laid out.
+    const int estimationStart = GetParent() ? wxDefaultCoord : context.GetLayoutEstimationStart();
+    int laidOutHeight = 0;
+    int laidOutLines = 0;
+
     // First get the size of the paragraphs we won't be laying out
     wxRichTextObjectList::compatibility_iterator n = m_children.GetFirst();
     while (n && n != node)
@@ -2286,10 +2520,20 @@ bool wxRichTextParagraphLayoutBox::Layout(wxDC& dc, wxRichTextDrawingContext& co
                         child->GetLines().IsEmpty() ||
                             !child->GetRange().IsOutside(invalidRange)) )
             {
-                // Lays out the object first with a given amount of space, and then if no width was specified in attr,
-                // lays out the object again using the minimum size
-                child->LayoutToBestSize(dc, context, GetBuffer(),
-                        attr, child->GetAttributes(), availableSpace, rect, style&~wxRICHTEXT_LAYOUT_SPECIFIED_RECT);
+                if (estimationStart != wxDefaultCoord && availableSpace.y > estimationStart && child->GetLines().IsEmpty())
+                {
+                    EstimateParagraphLayout(dc, child, availableSpace, laidOutHeight, laidOutLines);
+                }
+                else
+                {
+                    // Lays out the object first with a given amount of space, and then if no width was specified in attr,
+                    // lays out the object again using the minimum size
+                    child->LayoutToBestSize(dc, context, GetBuffer(),
+                            attr, ((const wxRichTextParagraph*) child)->GetAttributes(), availableSpace, rect, style&~wxRICHTEXT_LAYOUT_SPECIFIED_RECT);
+
+                    laidOutHeight += child->GetCachedSize().y;
+                    laidOutLines += child->GetLines().GetCount();
+                }
 
                 // Layout must set the cached size
                 availableSpace.y += child->GetCachedSize().y;
@@ -2323,7 +2567,7 @@ bool wxRichTextParagraphLayoutBox::Layout(wxDC& dc, wxRichTextDrawingContext& co
                             child->SetImpactedByFloatingObjects(-1);
 
                             child->LayoutToBestSize(dc, context, GetBuffer(),
-                                attr, child->GetAttributes(), availableSpace, rect, style&~wxRICHTEXT_LAYOUT_SPECIFIED_RECT);
+                                attr, ((const wxRichTextParagraph*) child)->GetAttributes(), availableSpace, rect, style&~wxRICHTEXT_LAYOUT_SPECIFIED_RECT);
 
                             availableSpace.y += child->GetCachedSize().y;
                             maxWidth = wxMax(maxWidth, child->GetCachedSize().x);
@@ -2356,14 +2600,19 @@ bool wxRichTextParagraphLayoutBox::Layout(wxDC& dc, wxRichTextDrawingContext& co
                     wxRichTextParagraph* nodeChild = wxDynamicCast(node->GetData(), wxRichTextParagraph);
                     if (nodeChild)
                     {
-                        if (nodeChild->GetLines().GetCount() == 0)
+                        if (nodeChild->GetLines().GetCount() == 0 &&
+                                estimationStart != wxDefaultCoord && availableSpace.y > estimationStart)
+                        {
+                            EstimateParagraphLayout(dc, nodeChild, availableSpace, laidOutHeight, laidOutLines);
+                        }
+                        else if (nodeChild->GetLines().GetCount() == 0)
                         {
                             nodeChild->SetImpactedByFloatingObjects(-1);
 
                             // Lays out the object first with a given amount of space, and then if no width was specified in attr,
                             // lays out the object again using the minimum size
                             nodeChild->LayoutToBestSize(dc, context, GetBuffer(),
-                                        attr, nodeChild->GetAttributes(), availableSpace, rect, style&~wxRICHTEXT_LAYOUT_SPECIFIED_RECT);
+                                        attr, ((const wxRichTextParagraph*) nodeChild)->GetAttributes(), availableSpace, rect, style&~wxRICHTEXT_LAYOUT_SPECIFIED_RECT);
                         }
                         else
                         {
@@ -2497,6 +2746,209 @@ bool wxRichTextParagraphLayoutBox::Layout(wxDC& dc, wxRichTextDrawingContext& co
     return true;
 }
 
+/// Give the paragraph an estimated layout at the given position
+void wxRichTextParagraphLayoutBox::EstimateParagraphLayout(wxDC& dc, wxRichTextParagraph* para, const wxRect& availableSpace, int laidOutHeight, int laidOutLines)
+{
+    // Use the average height of the lines laid out so far, if any, and assume
+    // that the lines are filled with average width characters.
+    int lineHeight = laidOutLines > 0 ? laidOutHeight / laidOutLines : dc.GetCharHeight();
+    if (lineHeight <= 0)
+        lineHeight = 1;
+
+    long charsPerLine = availableSpace.width / wxMax(dc.GetCharWidth(), 1);
+    if (charsPerLine <= 0)
+        charsPerLine = 1;
+
+    const long numLines = 1 + wxMax(para->GetRange().GetLength() - 2, 0L) / charsPerLine;
+
+    para->EstimateLayout(availableSpace.GetPosition(),
+                         wxSize(availableSpace.width, numLines*lineHeight));
+
+    if (!m_hasEstimatedLayout || para->GetRange().GetStart() < m_estimatedLayoutStart)
+        m_estimatedLayoutStart = para->GetRange().GetStart();
+    m_hasEstimatedLayout = true;
+}
+
+/// Invalidate the first paragraphs with estimated layout
+bool wxRichTextParagraphLayoutBox::InvalidateEstimatedLayout(int maxCount)
+{
+    if (!m_hasEstimatedLayout)
+        return false;
+
+    wxRichTextObjectList::compatibility_iterator node = GetChildNodeAtPosition(m_estimatedLayoutStart);
+    if (!node)
+        node = m_children.GetFirst();
+
+    // Find the first paragraph with estimated layout.
+    wxRichTextParagraph* para = NULL;
+    while (node)
+    {
+        para = wxDynamicCast(node->GetData(), wxRichTextParagraph);
+        if (para && para->IsLayoutEstimated())
+            break;
+
+        node = node->GetNext();
+    }
+
+    if (!node)
+    {
+        m_hasEstimatedLayout = false;
+        return false;
+    }
+
+    const long start = para->GetRange().GetStart();
+    long end = para->GetRange().GetEnd();
+    for (int n = 1; (maxCount == -1 || n < maxCount) && node->GetNext(); n++)
+    {
+        node = node->GetNext();
+        end = node->GetData()->GetRange().GetEnd();
+    }
+
+    Invalidate(wxRichTextRange(start, end));
+
+    // All the paragraphs before the next one will have been laid out.
+    m_estimatedLayoutStart = end + 1;
+
+    return true;
+}
+
+/// Lay out the paragraphs with estimated layout for at most the given time
+bool wxRichTextParagraphLayoutBox::LayoutEstimatedParagraphs(wxDC& dc, wxRichTextDrawingContext& context, const wxRect& rect, int style, int maxMillis)
+{
+    if (!m_hasEstimatedLayout)
+        return false;
+
+    // The paragraphs affected by floating objects or vertical alignment can't
+    // be laid out independently of the others, so lay out the next ones in the
+    // usual way, moving all the following paragraphs each time.
+    if ((wxRichTextBuffer::GetFloatingLayoutMode() && GetFloatCollector() && GetFloatCollector()->HasFloats()) ||
+        m_attributes.GetTextBoxAttr().HasVerticalAlignment() || IsDirty())
+    {
+        const wxMilliClock_t stopTime = wxGetLocalTimeMillis() + maxMillis;
+        while (wxGetLocalTimeMillis() < stopTime && InvalidateEstimatedLayout(100))
+            Layout(dc, context, rect, rect, style);
+
+        return m_hasEstimatedLayout;
+    }
+
+    wxRichTextObjectList::compatibility_iterator node = GetChildNodeAtPosition(m_estimatedLayoutStart);
+    if (!node)
+        node = m_children.GetFirst();
+
+    // Skip to the first paragraph with estimated layout.
+    while (node)
+    {
+        wxRichTextParagraph* para = wxDynamicCast(node->GetData(), wxRichTextParagraph);
+        if (para && para->IsLayoutEstimated())
+            break;
+
+        node = node->GetNext();
+    }
+
+    if (!node)
+    {
+        m_hasEstimatedLayout = false;
+        return false;
+    }
+
+    wxRichTextAttr attr(m_attributes);
+    AdjustAttributes(attr, context);
+    if (!GetParent())
+        attr.GetTextBoxAttr().GetWidth().SetValue(rect.GetWidth(), wxTEXT_ATTR_UNITS_PIXELS);
+
+    wxRect availableSpace = GetAvailableContentArea(dc, context, rect);
+    availableSpace.y = node->GetData()->GetPosition().y;
+
+    int maxWidth = 0;
+
+    // The change of the height of the paragraphs laid out so far.
+    int inc = 0;
+
+    // Lay out the paragraphs one after another without moving the following
+    // ones, which are all moved only once below.
+    const wxMilliClock_t stopTime = wxGetLocalTimeMillis() + maxMillis;
+    do
+    {
+        wxRichTextParagraph* para = wxDynamicCast(node->GetData(), wxRichTextParagraph);
+        if (para && para->IsShown())
+        {
+            if (para->IsLayoutEstimated())
+            {
+                const int oldHeight = para->GetCachedSize().y;
+
+                para->LayoutToBestSize(dc, context, GetBuffer(),
+                        attr, ((const wxRichTextParagraph*) para)->GetAttributes(), availableSpace, rect, style&~wxRICHTEXT_LAYOUT_SPECIFIED_RECT);
+
+                inc += para->GetCachedSize().y - oldHeight;
+            }
+            else if (inc != 0)
+            {
+                para->Move(wxPoint(para->GetPosition().x, availableSpace.y));
+            }
+
+            availableSpace.y += para->GetCachedSize().y;
+            maxWidth = wxMax(maxWidth, para->GetCachedSize().x);
+
+            m_estimatedLayoutStart = para->GetRange().GetEnd() + 1;
+        }
+
+        node = node->GetNext();
+    }
+    while (node && wxGetLocalTimeMillis() < stopTime);
+
+    if (!node)
+        m_hasEstimatedLayout = false;
+
+    if (inc != 0)
+    {
+        while (node)
+        {
+            wxRichTextObject* child = node->GetData();
+            child->Move(wxPoint(child->GetPosition().x, child->GetPosition().y + inc));
+
+            node = node->GetNext();
+        }
+    }
+
+    // Update our own size in the same way as Layout() would.
+    wxSize size(GetCachedSize());
+    size.y += inc;
+    if (maxWidth > size.x)
+        size.x = maxWidth;
+    SetCachedSize(size);
+    SetMaxSize(wxSize(wxMax(GetMaxSize().x, maxWidth), GetMaxSize().y + inc));
+    SetMinSize(wxSize(GetMinSize().x, GetMinSize().y + inc));
+
+    return m_hasEstimatedLayout;
+}
+
+/// Invalidate the paragraphs with estimated layout in the given rectangle
+bool wxRichTextParagraphLayoutBox::InvalidateEstimatedLayout(const wxRect& rect)
+{
+    if (!m_hasEstimatedLayout)
+        return false;
+
+    bool found = false;
+    wxRichTextObjectList::compatibility_iterator node = GetChildNodeAtYPosition(rect.GetTop());
+    while (node)
+    {
+        wxRichTextObject* child = node->GetData();
+        if (child->IsShown() && child->GetPosition().y > rect.GetBottom())
+            break;
+
+        wxRichTextParagraph* para = wxDynamicCast(child, wxRichTextParagraph);
+        if (para && para->IsLayoutEstimated())
+        {
+            Invalidate(para->GetRange());
+            found = true;
+        }
+
+        node = node->GetNext();
+    }
+
+    return found;
+}
+
 /// Get/set the size for the given range.
 bool wxRichTextParagraphLayoutBox::GetRangeSize(const wxRichTextRange& range, wxSize& size, int& descent, wxDC& dc, wxRichTextDrawingContext& context, int flags, const wxPoint& position, const wxSize& parentSize, wxArrayInt* WXUNUSED(partialExtents)) const
 {
@@ -2573,31 +3025,113 @@ bool wxRichTextParagraphLayoutBox::GetRangeSize(const wxRichTextRange& range, wx
     return true;
 }
 
-/// Get the paragraph at the given position
-wxRichTextParagraph* wxRichTextParagraphLayoutBox::GetParagraphAtPosition(long pos, bool caretPosition) const
+/// Get the index of the children, rebuilding it if they changed.
+const wxVector<wxRichTextObjectList::compatibility_iterator>& wxRichTextParagraphLayoutBox::GetChildrenIndex() const
 {
-    if (caretPosition)
-        pos ++;
+    if (m_childrenIndexGeneration != m_childrenGeneration ||
+            m_childrenIndex.size() != m_children.GetCount())
+    {
+        m_childrenIndex.clear();
+        m_childrenIndex.reserve(m_children.GetCount());
 
-    // First find the first paragraph whose starting position is within the range.
+        wxRichTextObjectList::compatibility_iterator node = m_children.GetFirst();
+        while (node)
+        {
+            m_childrenIndex.push_back(node);
+            node = node->GetNext();
+        }
+
+        m_childrenIndexGeneration = m_childrenGeneration;
+    }
+
+    return m_childrenIndex;
+}
+
+/// Get the node of the child containing the given position
+wxRichTextObjectList::compatibility_iterator wxRichTextParagraphLayoutBox::GetChildNodeAtPosition(long pos) const
+{
+    const wxVector<wxRichTextObjectList::compatibility_iterator>& index = GetChildrenIndex();
+
+    // The ranges of the children follow each other, so find the first child
+    // ending at or after this position using binary search.
+    size_t lo = 0,
+           hi = index.size();
+    while (lo < hi)
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (index[mid]->GetData()->GetRange().GetEnd() < pos)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < index.size() && index[lo]->GetData()->GetRange().Contains(pos))
+        return index[lo];
+
+    // The ranges may be out of date if they haven't been updated yet after
+    // changing the children, so fall back to checking all of them.
     wxRichTextObjectList::compatibility_iterator node = m_children.GetFirst();
     while (node)
     {
-        // child is a paragraph
-        wxRichTextParagraph* child = wxDynamicCast(node->GetData(), wxRichTextParagraph);
-        // wxASSERT (child != NULL);
+        if (node->GetData()->GetRange().Contains(pos))
+            break;
 
-        if (child)
-        {
-            // Return first child in buffer if position is -1
-            // if (pos == -1)
-            //    return child;
+        node = node->GetNext();
+    }
 
-            if (child->GetRange().Contains(pos))
-                return child;
+    return node;
+}
+
+/// Get the node of the first child at or below the given y position
+wxRichTextObjectList::compatibility_iterator wxRichTextParagraphLayoutBox::GetChildNodeAtYPosition(int y) const
+{
+    const wxVector<wxRichTextObjectList::compatibility_iterator>& index = GetChildrenIndex();
+
+    // The shown children are laid out one below another, so find the first
+    // one whose bottom is not above this position using binary search. The
+    // hidden children keep the position they had when they were last laid out,
+    // so the nearest shown child following them is checked instead. The node
+    // returned may be a hidden one, but the callers skip those anyhow.
+    size_t lo = 0,
+           hi = index.size();
+    while (lo < hi)
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+
+        size_t n = mid;
+        while (n < hi && !index[n]->GetData()->IsShown())
+            n++;
+
+        if (n == hi)
+        {
+            hi = mid;
+            continue;
         }
 
-        node = node->GetNext();
+        const wxRichTextObject* const child = index[n]->GetData();
+        if (child->GetPosition().y + child->GetCachedSize().y <= y)
+            lo = n + 1;
+        else
+            hi = n;
+    }
+
+    if (lo < index.size())
+        return index[lo];
+
+    return wxRichTextObjectList::compatibility_iterator();
+}
+
+/// Get the paragraph at the given position
+wxRichTextParagraph* wxRichTextParagraphLayoutBox::GetParagraphAtPosition(long pos, bool caretPosition) const
+{
+    if (caretPosition)
+        pos ++;
+
+    wxRichTextObjectList::compatibility_iterator node = GetChildNodeAtPosition(pos);
+    if (node)
+    {
+        // child is a paragraph
+        return wxDynamicCast(node->GetData(), wxRichTextParagraph);
     }
     return NULL;
 }
@@ -2608,39 +3142,33 @@ wxRichTextLine* wxRichTextParagraphLayoutBox::GetLineAtPosition(long pos, bool c
     if (caretPosition)
         pos ++;
 
-    // First find the first paragraph whose starting position is within the range.
-    wxRichTextObjectList::compatibility_iterator node = m_children.GetFirst();
-    while (node)
+    // First find the paragraph whose range contains the position.
+    wxRichTextObjectList::compatibility_iterator node = GetChildNodeAtPosition(pos);
+    if (node)
     {
-        wxRichTextObject* obj = (wxRichTextObject*) node->GetData();
-        if (obj->GetRange().Contains(pos))
-        {
-            // child is a paragraph
-            wxRichTextParagraph* child = wxDynamicCast(obj, wxRichTextParagraph);
-            // wxASSERT (child != NULL);
+        // child is a paragraph
+        wxRichTextParagraph* child = wxDynamicCast(node->GetData(), wxRichTextParagraph);
+        // wxASSERT (child != NULL);
 
-            if (child)
+        if (child)
+        {
+            wxRichTextLineList::compatibility_iterator node2 = child->GetLines().GetFirst();
+            while (node2)
             {
-                wxRichTextLineList::compatibility_iterator node2 = child->GetLines().GetFirst();
-                while (node2)
-                {
-                    wxRichTextLine* line = node2->GetData();
+                wxRichTextLine* line = node2->GetData();
 
-                    wxRichTextRange range = line->GetAbsoluteRange();
+                wxRichTextRange range = line->GetAbsoluteRange();
 
-                    if (range.Contains(pos) ||
+                if (range.Contains(pos) ||
 
-                        // If the position is end-of-paragraph, then return the last line of
-                        // of the paragraph.
-                        ((range.GetEnd() == child->GetRange().GetEnd()-1) && (pos == child->GetRange().GetEnd())))
-                        return line;
+                    // If the position is end-of-paragraph, then return the last line of
+                    // of the paragraph.
+                    ((range.GetEnd() == child->GetRange().GetEnd()-1) && (pos == child->GetRange().GetEnd())))
+                    return line;
 
-                    node2 = node2->GetNext();
-                }
+                node2 = node2->GetNext();
             }
         }
-
-        node = node->GetNext();
     }
 
     int lineCount = GetLineCount();
@@ -2653,7 +3181,8 @@ wxRichTextLine* wxRichTextParagraphLayoutBox::GetLineAtPosition(long pos, bool c
 /// Get the line at the given y pixel position, or the last line.
 wxRichTextLine* wxRichTextParagraphLayoutBox::GetLineAtYPosition(int y) const
 {
-    wxRichTextObjectList::compatibility_iterator node = m_children.GetFirst();
+    // The lines of the paragraphs above this one can't be at this position.
+    wxRichTextObjectList::compatibility_iterator node = GetChildNodeAtYPosition(y);
     while (node)
     {
         wxRichTextParagraph* child = wxDynamicCast(node->GetData(), wxRichTextParagraph);
@@ -3714,7 +4243,7 @@ void wxRichTextParagraphLayoutBox::SetStyle(wxRichTextObject* obj, const wxRichT
         action->GetAttributes() = newAttr;
     }
     else
-        obj->GetAttributes() = newAttr;
+        obj->SetAttributes(newAttr);
 
     if (haveControl && withUndo)
         buffer->SubmitAction(action);
@@ -3735,7 +4264,8 @@ bool wxRichTextParagraphLayoutBox::GetUncombinedStyle(long position, wxRichTextA
 /// context attributes.
 bool wxRichTextParagraphLayoutBox::DoGetStyle(long position, wxRichTextAttr& style, bool combineStyles)
 {
-    wxRichTextObject* obj wxDUMMY_INITIALIZE(NULL);
+    // Only read the attributes, without invalidating the cached ones.
+    const wxRichTextObject* obj wxDUMMY_INITIALIZE(NULL);
 
     if (style.IsParagraphStyle())
     {
@@ -3745,7 +4275,7 @@ bool wxRichTextParagraphLayoutBox::DoGetStyle(long position, wxRichTextAttr& sty
             if (combineStyles)
             {
                 // Start with the base style
-                style = GetAttributes();
+                style = m_attributes;
                 style.GetTextBoxAttr().Reset();
 
                 // Apply the paragraph style
@@ -3764,7 +4294,7 @@ bool wxRichTextParagraphLayoutBox::DoGetStyle(long position, wxRichTextAttr& sty
         {
             if (combineStyles)
             {
-                wxRichTextParagraph* para = wxDynamicCast(obj->GetParent(), wxRichTextParagraph);
+                const wxRichTextParagraph* para = wxDynamicCast(obj->GetParent(), wxRichTextParagraph);
                 style = para ? para->GetCombinedAttributes(obj->GetAttributes()) : obj->GetAttributes();
             }
             else
@@ -3827,7 +4357,7 @@ bool wxRichTextParagraphLayoutBox::GetStyleForRange(const wxRichTextRange& range
 
                 while (childNode)
                 {
-                    wxRichTextObject* child = childNode->GetData();
+                    const wxRichTextObject* child = childNode->GetData();
                     if (!(child->GetRange().GetStart() > range.GetEnd() || child->GetRange().GetEnd() < range.GetStart()))
                     {
                         wxRichTextAttr childStyle = para->GetCombinedAttributes(child->GetAttributes(), true /* include box attributes */);
@@ -3881,7 +4411,7 @@ bool wxRichTextParagraphLayoutBox::HasCharacterAttributes(const wxRichTextRange&
 
                 while (node2)
                 {
-                    wxRichTextObject* child = node2->GetData();
+                    const wxRichTextObject* child = node2->GetData();
                     // Allow for empty string if no buffer
                     wxRichTextRange childRange = child->GetRange();
                     if (childRange.GetLength() == 0 && GetRange().GetLength() == 1)
@@ -3933,7 +4463,7 @@ bool wxRichTextParagraphLayoutBox::HasParagraphAttributes(const wxRichTextRange&
             {
                 wxRichTextAttr textAttr = GetAttributes();
                 // Apply the paragraph style
-                wxRichTextApplyStyle(textAttr, para->GetAttributes());
+                wxRichTextApplyStyle(textAttr, ((const wxRichTextParagraph*) para)->GetAttributes());
 
                 // These flags can mess up EqPartial because they don't represent existence of the attributes,
                 // only the attributes.
@@ -4148,6 +4678,16 @@ void wxRichTextParagraphLayoutBox::Invalidate(const wxRichTextRange& invalidRang
 // Do the (in)validation for this object only
 void wxRichTextParagraphLayoutBox::DoInvalidate(const wxRichTextRange& invalidRange)
 {
+    // The paragraphs with estimated layout may have moved before the start of
+    // the changed range.
+    if (m_hasEstimatedLayout && invalidRange != wxRICHTEXT_NONE)
+    {
+        if (invalidRange == wxRICHTEXT_ALL)
+            m_estimatedLayoutStart = 0;
+        else
+            m_estimatedLayoutStart = wxMin(m_estimatedLayoutStart, invalidRange.GetStart());
+    }
+
     if (invalidRange == wxRICHTEXT_ALL)
     {
         m_invalidRange = wxRICHTEXT_ALL;
@@ -4806,6 +5346,7 @@ wxRichTextParagraph::wxRichTextParagraph(const wxString& text, wxRichTextObject*
 void wxRichTextParagraph::Init()
 {
     m_impactedByFloatingObjects = -1;
+    m_layoutEstimated = false;
 }
 
 wxRichTextParagraph::~wxRichTextParagraph()
@@ -4824,7 +5365,7 @@ bool wxRichTextParagraph::Draw(wxDC& dc, wxRichTextDrawingContext& context, cons
     // for all paragraphs). But generally box attributes are likely to be
     // different for different objects.
     wxRect paraRect = GetRect();
-    wxRichTextAttr attr = GetCombinedAttributes();
+    wxRichTextAttr attr(GetCachedCombinedAttributes());
     AdjustAttributes(attr, context);
 
     DrawBoxAttributes(dc, GetBuffer(), attr, paraRect, 0);
@@ -4981,6 +5522,8 @@ static int wxRichTextGetRangeWidth(const wxRichTextParagraph& para, const wxRich
 /// Lay the item out
 bool wxRichTextParagraph::Layout(wxDC& dc, wxRichTextDrawingContext& context, const wxRect& rect, const wxRect& parentRect, int style)
 {
+    m_layoutEstimated = false;
+
     // Deal with floating objects firstly before the normal layout
     wxRichTextBuffer* buffer = GetBuffer();
     wxASSERT(buffer);
@@ -5004,7 +5547,7 @@ bool wxRichTextParagraph::Layout(wxDC& dc, wxRichTextDrawingContext& context, co
         }
     }
 
-    wxRichTextAttr attr = GetCombinedAttributes();
+    wxRichTextAttr attr(GetCachedCombinedAttributes());
     AdjustAttributes(attr, context);
 
     // Increase the size of the paragraph due to spacing
@@ -5153,7 +5696,7 @@ bool wxRichTextParagraph::Layout(wxDC& dc, wxRichTextDrawingContext& context, co
             // The position will be determined by its location in its line,
             // and not by the child's actual position.
             child->LayoutToBestSize(dc, context, buffer,
-                    attr, child->GetAttributes(), availableRect, parentRect, style);
+                    attr, ((const wxRichTextObject*) child)->GetAttributes(), availableRect, parentRect, style);
 
             if (oldSize != child->GetCachedSize())
             {
@@ -5242,7 +5785,7 @@ bool wxRichTextParagraph::Layout(wxDC& dc, wxRichTextDrawingContext& context, co
                     // lays out the object again using the minimum size
                     child->Invalidate(wxRICHTEXT_ALL);
                     child->LayoutToBestSize(dc, context, buffer,
-                                attr, child->GetAttributes(), availableRect, parentRect.GetSize(), style);
+                                attr, ((const wxRichTextObject*) child)->GetAttributes(), availableRect, parentRect.GetSize(), style);
                     childSize = child->GetCachedSize();
                     childDescent = child->GetDescent();
 
@@ -5692,6 +6235,27 @@ void wxRichTextParagraph::Copy(const wxRichTextParagraph& obj)
 {
     wxRichTextCompositeObject::Copy(obj);
     m_impactedByFloatingObjects = obj.m_impactedByFloatingObjects;
+    m_layoutEstimated = false;
+}
+
+/// Give the paragraph an estimated layout without measuring its contents
+void wxRichTextParagraph::EstimateLayout(const wxPoint& pos, const wxSize& size)
+{
+    // A single line covers the entire paragraph, except for the final newline
+    // unless there is nothing else in it.
+    wxRichTextLine* line = AllocateLine(0);
+    line->SetRange(0, wxMax(GetRange().GetLength() - 2, 0L));
+    line->SetPosition(wxPoint(0, 0));
+    line->SetSize(size);
+    ClearUnusedLines(1);
+
+    SetPosition(pos);
+    SetCachedSize(size);
+    SetMinSize(wxSize(0, size.y));
+    SetMaxSize(size);
+
+    m_impactedByFloatingObjects = 0;
+    m_layoutEstimated = true;
 }
 
 /// Clear the cached lines
@@ -6463,61 +7027,61 @@ bool wxRichTextParagraph::FindWrapPosition(const wxRichTextRange& range, wxDC& d
 /// Get the bullet text for this paragraph.
 wxString wxRichTextParagraph::GetBulletText()
 {
-    if (GetAttributes().GetBulletStyle() == wxTEXT_ATTR_BULLET_STYLE_NONE ||
-        (GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_BITMAP))
+    if (m_attributes.GetBulletStyle() == wxTEXT_ATTR_BULLET_STYLE_NONE ||
+        (m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_BITMAP))
         return wxEmptyString;
 
-    int number = GetAttributes().GetBulletNumber();
+    int number = m_attributes.GetBulletNumber();
 
     wxString text;
-    if ((GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_ARABIC) || (GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_OUTLINE))
+    if ((m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_ARABIC) || (m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_OUTLINE))
     {
         text.Printf(wxT("%d"), number);
     }
-    else if (GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_LETTERS_UPPER)
+    else if (m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_LETTERS_UPPER)
     {
         // TODO: Unicode, and also check if number > 26
         text.Printf(wxT("%c"), (wxChar) (number+64));
     }
-    else if (GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_LETTERS_LOWER)
+    else if (m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_LETTERS_LOWER)
     {
         // TODO: Unicode, and also check if number > 26
         text.Printf(wxT("%c"), (wxChar) (number+96));
     }
-    else if (GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_ROMAN_UPPER)
+    else if (m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_ROMAN_UPPER)
     {
         text = wxRichTextDecimalToRoman(number);
     }
-    else if (GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_ROMAN_LOWER)
+    else if (m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_ROMAN_LOWER)
     {
         text = wxRichTextDecimalToRoman(number);
         text.MakeLower();
     }
-    else if (GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_SYMBOL)
+    else if (m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_SYMBOL)
     {
-        text = GetAttributes().GetBulletText();
+        text = m_attributes.GetBulletText();
     }
 
-    if (GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_OUTLINE)
+    if (m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_OUTLINE)
     {
         // The outline style relies on the text being computed statically,
         // since it depends on other levels points (e.g. 1.2.1.1). So normally the bullet text
         // should be stored in the attributes; if not, just use the number for this
         // level, as previously computed.
-        if (!GetAttributes().GetBulletText().IsEmpty())
-            text = GetAttributes().GetBulletText();
+        if (!m_attributes.GetBulletText().IsEmpty())
+            text = m_attributes.GetBulletText();
     }
 
-    if (GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_PARENTHESES)
+    if (m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_PARENTHESES)
     {
         text = wxT("(") + text + wxT(")");
     }
-    else if (GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_RIGHT_PARENTHESIS)
+    else if (m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_RIGHT_PARENTHESIS)
     {
         text = text + wxT(")");
     }
 
-    if (GetAttributes().GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_PERIOD)
+    if (m_attributes.GetBulletStyle() & wxTEXT_ATTR_BULLET_STYLE_PERIOD)
     {
         text += wxT(".");
     }
@@ -6615,6 +7179,68 @@ wxRichTextAttr wxRichTextParagraph::GetCombinedAttributes(bool includingBoxAttr)
     return attr;
 }
 
+const wxRichTextAttr& wxRichTextParagraph::GetCachedCombinedAttributes() const
+{
+    // The base style of the container is cached in it, without sharing it with
+    // the other containers, as all of its attributes are used and not only the
+    // ones specified by its flags.
+    wxRichTextParagraphLayoutBox* buf = wxDynamicCast(GetParent(), wxRichTextParagraphLayoutBox);
+    wxRichTextSharedAttr* base = NULL;
+    if (buf)
+    {
+        if (!buf->m_combinedAttributes.IsValid(buf->m_attributesGeneration, NULL))
+        {
+            wxRichTextAttr attr(buf->GetBasicStyle());
+            attr.GetTextBoxAttr().Reset();
+            if (attr.HasBackgroundColour())
+            {
+                attr.SetBackgroundColour(wxColour());
+                attr.SetFlags(attr.GetFlags() & ~wxTEXT_ATTR_BACKGROUND_COLOUR);
+            }
+            buf->m_combinedAttributes.Set(attr, buf->m_attributesGeneration, NULL, NULL);
+        }
+
+        base = buf->m_combinedAttributes.GetShared();
+    }
+
+    if (!m_combinedAttributes.IsValid(m_attributesGeneration, base))
+    {
+        wxRichTextSharedAttrPool* pool = NULL;
+        wxRichTextBuffer* buffer = GetBuffer();
+        if (buffer)
+        {
+            if (!buffer->m_sharedAttrPool)
+                buffer->m_sharedAttrPool = new wxRichTextSharedAttrPool;
+            pool = buffer->m_sharedAttrPool;
+        }
+
+        wxRichTextAttr attr(base ? base->GetAttributes() : m_attributes);
+        if (base)
+            wxRichTextApplyStyle(attr, m_attributes);
+
+        m_combinedAttributes.Set(attr, m_attributesGeneration, base, pool);
+    }
+
+    return m_combinedAttributes.Get();
+}
+
+const wxRichTextAttr& wxRichTextParagraph::GetCachedCombinedAttributes(const wxRichTextObject* child) const
+{
+    wxCHECK_MSG(child && child->GetParent() == this, GetCachedCombinedAttributes(), wxT("Not a child of this paragraph"));
+
+    const wxRichTextAttr& attr = GetCachedCombinedAttributes();
+    wxRichTextSharedAttr* const base = m_combinedAttributes.GetShared();
+    wxRichTextCombinedAttrCache& cache = child->m_combinedAttributes;
+    if (!cache.IsValid(child->m_attributesGeneration, base))
+    {
+        wxRichTextAttr childAttr(attr);
+        wxRichTextApplyStyle(childAttr, child->m_attributes);
+        cache.Set(childAttr, child->m_attributesGeneration, base, base->GetPool());
+    }
+
+    return cache.Get();
+}
+
 // Create default tabstop array
 void wxRichTextParagraph::InitDefaultTabs()
 {
@@ -6642,14 +7268,15 @@ void wxRichTextParagraph::LayoutFloat(wxDC& dc, wxRichTextDrawingContext& contex
         if (anchored && anchored->IsFloating() && !floatCollector->HasFloat(anchored))
         {
             int x = 0;
-            wxRichTextAttr parentAttr(GetAttributes());
+            const wxRichTextAttr& anchoredAttr = ((const wxRichTextObject*) anchored)->GetAttributes();
+            wxRichTextAttr parentAttr(m_attributes);
             AdjustAttributes(parentAttr, context);
 #if 1
             // 27-09-2012
             wxRect availableSpace = GetParent()->GetAvailableContentArea(dc, context, rect);
 
             anchored->LayoutToBestSize(dc, context, GetBuffer(),
-                parentAttr, anchored->GetAttributes(),
+                parentAttr, anchoredAttr,
                 parentRect, availableSpace,
                 style);
             wxSize size = anchored->GetCachedSize();
@@ -6660,10 +7287,10 @@ void wxRichTextParagraph::LayoutFloat(wxDC& dc, wxRichTextDrawingContext& contex
 #endif
 
             int offsetY = 0;
-            if (anchored->GetAttributes().GetTextBoxAttr().GetTop().IsValid())
-                offsetY = converter.GetPixels(anchored->GetAttributes().GetTextBoxAttr().GetTop(), wxVERTICAL);
+            if (anchoredAttr.GetTextBoxAttr().GetTop().IsValid())
+                offsetY = converter.GetPixels(anchoredAttr.GetTextBoxAttr().GetTop(), wxVERTICAL);
 
-            int pos = floatCollector->GetFitPosition(anchored->GetAttributes().GetTextBoxAttr().GetFloatMode(), rect.y + offsetY, size.y);
+            int pos = floatCollector->GetFitPosition(anchoredAttr.GetTextBoxAttr().GetFloatMode(), rect.y + offsetY, size.y);
 
             // I can't remember why we tried to update the top offset here, but anyhow it results in
             // a wrong position being computed, so don't.
@@ -6684,9 +7311,9 @@ void wxRichTextParagraph::LayoutFloat(wxDC& dc, wxRichTextDrawingContext& contex
                 }
             }
 #endif
-            if (anchored->GetAttributes().GetTextBoxAttr().GetFloatMode() == wxTEXT_BOX_ATTR_FLOAT_LEFT)
+            if (anchoredAttr.GetTextBoxAttr().GetFloatMode() == wxTEXT_BOX_ATTR_FLOAT_LEFT)
                 x = rect.x;
-            else if (anchored->GetAttributes().GetTextBoxAttr().GetFloatMode() == wxTEXT_BOX_ATTR_FLOAT_RIGHT)
+            else if (anchoredAttr.GetTextBoxAttr().GetFloatMode() == wxTEXT_BOX_ATTR_FLOAT_RIGHT)
                 x = rect.x + rect.width - size.x;
 
             //anchored->SetPosition(wxPoint(x, pos));
@@ -6796,7 +7423,7 @@ bool wxRichTextPlainText::Draw(wxDC& dc, wxRichTextDrawingContext& context, cons
     wxRichTextParagraph* para = wxDynamicCast(GetParent(), wxRichTextParagraph);
     wxASSERT (para != NULL);
 
-    wxRichTextAttr textAttr(para ? para->GetCombinedAttributes(GetAttributes(), false /* no box attributes */) : GetAttributes());
+    wxRichTextAttr textAttr(para ? para->GetCachedCombinedAttributes(this) : GetAttributes());
     AdjustAttributes(textAttr, context);
 
     // Let's make the assumption for now that for content in a paragraph, including
@@ -7174,7 +7801,7 @@ bool wxRichTextPlainText::GetRangeSize(const wxRichTextRange& range, wxSize& siz
 
     int relativeX = position.x - GetParent()->GetPosition().x;
 
-    wxRichTextAttr textAttr(para ? para->GetCombinedAttributes(GetAttributes()) : GetAttributes());
+    wxRichTextAttr textAttr(para ? para->GetCachedCombinedAttributes(this) : GetAttributes());
     ((wxRichTextObject*) this)->AdjustAttributes(textAttr, context);
 
     // Always assume unformatted text, since at this level we have no knowledge
@@ -7380,7 +8007,7 @@ wxRichTextObject* wxRichTextPlainText::DoSplit(long pos)
     m_text = firstPart;
 
     wxRichTextPlainText* newObject = new wxRichTextPlainText(secondPart);
-    newObject->SetAttributes(GetAttributes());
+    newObject->SetAttributes(m_attributes);
     newObject->SetProperties(GetProperties());
 
     newObject->SetRange(wxRichTextRange(pos, GetRange().GetEnd()));
@@ -7436,7 +8063,7 @@ bool wxRichTextPlainText::CanMerge(wxRichTextObject* object, wxRichTextDrawingCo
     if (!context.GetVirtualAttributesEnabled())
     {
         return object->GetClassInfo() == wxCLASSINFO(wxRichTextPlainText) &&
-            (m_text.empty() || (wxTextAttrEq(GetAttributes(), object->GetAttributes()) && m_properties == object->GetProperties()));
+            (m_text.empty() || (wxTextAttrEq(GetAttributes(), ((const wxRichTextObject*) object)->GetAttributes()) && m_properties == object->GetProperties()));
     }
     else
     {
@@ -7444,7 +8071,7 @@ bool wxRichTextPlainText::CanMerge(wxRichTextObject* object, wxRichTextDrawingCo
         if (!otherObj || m_text.empty())
             return false;
 
-        if (!wxTextAttrEq(GetAttributes(), object->GetAttributes()) || !(m_properties == object->GetProperties()))
+        if (!wxTextAttrEq(GetAttributes(), ((const wxRichTextObject*) object)->GetAttributes()) || !(m_properties == object->GetProperties()))
             return false;
 
         // Check if differing virtual attributes makes it impossible to merge
@@ -7565,7 +8192,7 @@ wxRichTextObject* wxRichTextPlainText::Split(wxRichTextDrawingContext& context)
                                     {
                                         wxRichTextPlainText* obj = new wxRichTextPlainText;
                                         lastPlainText = obj;
-                                        obj->SetAttributes(GetAttributes());
+                                        obj->SetAttributes(m_attributes);
                                         obj->SetProperties(GetProperties());
                                         obj->SetParent(parent);
 
@@ -7607,7 +8234,7 @@ wxRichTextObject* wxRichTextPlainText::Split(wxRichTextDrawingContext& context)
                                 {
                                     wxRichTextPlainText* obj = new wxRichTextPlainText;
                                     lastPlainText = obj;
-                                    obj->SetAttributes(GetAttributes());
+                                    obj->SetAttributes(m_attributes);
                                     obj->SetProperties(GetProperties());
                                     obj->SetParent(parent);
 
@@ -7648,7 +8275,7 @@ wxRichTextObject* wxRichTextPlainText::Split(wxRichTextDrawingContext& context)
                         {
                             wxRichTextPlainText* obj = new wxRichTextPlainText;
                             lastPlainText = obj;
-                            obj->SetAttributes(GetAttributes());
+                            obj->SetAttributes(m_attributes);
                             obj->SetProperties(GetProperties());
                             obj->SetParent(parent);
 
@@ -7669,7 +8296,7 @@ wxRichTextObject* wxRichTextPlainText::Split(wxRichTextDrawingContext& context)
                         wxASSERT(runStart != 0);
 
                         wxRichTextPlainText* obj = new wxRichTextPlainText;
-                        obj->SetAttributes(GetAttributes());
+                        obj->SetAttributes(m_attributes);
                         obj->SetProperties(GetProperties());
                         obj->SetParent(parent);
 
@@ -7739,6 +8366,7 @@ void wxRichTextBuffer::Init()
     m_batchedCommand = NULL;
     m_suppressUndo = 0;
     m_handlerFlags = 0;
+    m_sharedAttrPool = NULL;
     m_scale = 1.0;
     m_dimensionScale = 1.0;
     m_fontScale = 1.0;
@@ -7753,6 +8381,10 @@ wxRichTextBuffer::~wxRichTextBuffer()
 
     ClearStyleStack();
     ClearEventHandlers();
+
+    // The pool is destroyed only when the objects still using it are.
+    if (m_sharedAttrPool)
+        m_sharedAttrPool->DecRef();
 }
 
 void wxRichTextBuffer::ResetAndClearCommands()
@@ -8138,7 +8770,7 @@ bool wxRichTextParagraphLayoutBox::SetObjectPropertiesWithUndo(wxRichTextObject&
 /// style.
 wxRichTextAttr wxRichTextParagraphLayoutBox::GetStyleForNewParagraph(wxRichTextBuffer* buffer, long pos, bool caretPosition, bool lookUpNewParaStyle) const
 {
-    wxRichTextParagraph* para = GetParagraphAtPosition(pos, caretPosition);
+    const wxRichTextParagraph* para = GetParagraphAtPosition(pos, caretPosition);
     if (para)
     {
         wxRichTextAttr attr;
@@ -9781,7 +10413,7 @@ bool wxRichTextCell::AdjustAttributes(wxRichTextAttr& attr, wxRichTextDrawingCon
 {
     wxRichTextObject::AdjustAttributes(attr, context);
 
-    wxRichTextTable* table = wxDynamicCast(GetParent(), wxRichTextTable);
+    const wxRichTextTable* table = wxDynamicCast(GetParent(), wxRichTextTable);
     if (IsShown() && table && table->GetAttributes().GetTextBoxAttr().HasCollapseBorders() &&
         table->GetAttributes().GetTextBoxAttr().GetCollapseBorders() == wxTEXT_BOX_ATTR_COLLAPSE_FULL)
     {
@@ -9816,7 +10448,7 @@ bool wxRichTextCell::AdjustAttributes(wxRichTextAttr& attr, wxRichTextDrawingCon
             // We need to explicitly look at the spans, not just whether
             // the cell is visible, because that doesn't tell us which
             // cell to look at for border information.
-            wxRichTextCell* adjacentCellRight = NULL;
+            const wxRichTextCell* adjacentCellRight = NULL;
 
             int nextCol = col + GetColSpan();
             if  (nextCol >= table->GetColumnCount())
@@ -9825,7 +10457,7 @@ bool wxRichTextCell::AdjustAttributes(wxRichTextAttr& attr, wxRichTextDrawingCon
             }
             else
             {
-                wxRichTextCell* nextRightCell = table->GetCell(row, nextCol);
+                const wxRichTextCell* nextRightCell = table->GetCell(row, nextCol);
                 if (nextRightCell->IsShown())
                 {
                     adjacentCellRight = nextRightCell;
@@ -9863,7 +10495,7 @@ bool wxRichTextCell::AdjustAttributes(wxRichTextAttr& attr, wxRichTextDrawingCon
             }
 
             // Compute bottom border
-            wxRichTextCell* adjacentCellBelow = NULL;
+            const wxRichTextCell* adjacentCellBelow = NULL;
 
             int nextRow = row + GetRowSpan();
             if  (nextRow >= table->GetRowCount())
@@ -9872,7 +10504,7 @@ bool wxRichTextCell::AdjustAttributes(wxRichTextAttr& attr, wxRichTextDrawingCon
             }
             else
             {
-                wxRichTextCell* nextBottomCell = table->GetCell(nextRow, col);
+                const wxRichTextCell* nextBottomCell = table->GetCell(nextRow, col);
                 if (nextBottomCell->IsShown())
                 {
                     adjacentCellBelow = nextBottomCell;
@@ -10057,8 +10689,8 @@ bool wxRichTextTable::Draw(wxDC& dc, wxRichTextDrawingContext& context, const wx
     // If the table is not collapsed (in which case the outer table box provides the border),
     // draw the overall border again using cell borders in case it has been overwritten by
     // adjacent cell borders of different colours.
-    if (!GetAttributes().GetTextBoxAttr().HasCollapseBorders() ||
-        GetAttributes().GetTextBoxAttr().GetCollapseBorders() != wxTEXT_BOX_ATTR_COLLAPSE_FULL)
+    if (!m_attributes.GetTextBoxAttr().HasCollapseBorders() ||
+        m_attributes.GetTextBoxAttr().GetCollapseBorders() != wxTEXT_BOX_ATTR_COLLAPSE_FULL)
     {
         int colCount = GetColumnCount();
         int rowCount = GetRowCount();
@@ -10073,7 +10705,7 @@ bool wxRichTextTable::Draw(wxDC& dc, wxRichTextDrawingContext& context, const wx
                     if (cell && cell->IsShown() && !cell->GetRange().IsOutside(range))
                     {
                         wxRect childRect(cell->GetPosition(), cell->GetCachedSize());
-                        wxRichTextAttr attr(cell->GetAttributes());
+                        wxRichTextAttr attr(((const wxRichTextCell*) cell)->GetAttributes());
                         cell->AdjustAttributes(attr, context);
                         if (row != 0)
                             attr.GetTextBoxAttr().GetBorder().GetTop().Reset();
@@ -10272,7 +10904,7 @@ bool wxRichTextTable::Layout(wxDC& dc, wxRichTextDrawingContext& context, const
     wxRect availableSpace = GetAvailableContentArea(dc, context, rect);
     wxTextAttrDimensionConverter converter(dc, scale, availableSpace.GetSize());
 
-    wxRichTextAttr attr(GetAttributes());
+    wxRichTextAttr attr(m_attributes);
     AdjustAttributes(attr, context);
 
     bool tableHasPercentWidth = (attr.GetTextBoxAttr().GetWidth().GetUnits() == wxTEXT_ATTR_UNITS_PERCENTAGE);
@@ -10466,6 +11098,7 @@ bool wxRichTextTable::Layout(wxDC& dc, wxRichTextDrawingContext& context, const
         for (i = 0; i < m_colCount; i++)
         {
             wxRichTextCell* cell = GetCell(j, i);
+            const wxRichTextAttr& cellAttr = ((const wxRichTextCell*) cell)->GetAttributes();
             if (cell->IsShown())
             {
                 int colSpan = cell->GetColSpan();
@@ -10479,10 +11112,10 @@ bool wxRichTextTable::Layout(wxDC& dc, wxRichTextDrawingContext& context, const
                     int absoluteCellWidth = -1;
                     int percentageCellWidth = -1;
 
-                    if (cell->GetAttributes().GetTextBoxAttr().GetWidth().IsValid())
+                    if (cellAttr.GetTextBoxAttr().GetWidth().IsValid())
                     {
-                        int w = cellConverter.GetPixels(cell->GetAttributes().GetTextBoxAttr().GetWidth(), wxHORIZONTAL);
-                        if (cell->GetAttributes().GetTextBoxAttr().GetWidth().GetUnits() == wxTEXT_ATTR_UNITS_PERCENTAGE)
+                        int w = cellConverter.GetPixels(cellAttr.GetTextBoxAttr().GetWidth(), wxHORIZONTAL);
+                        if (cellAttr.GetTextBoxAttr().GetWidth().GetUnits() == wxTEXT_ATTR_UNITS_PERCENTAGE)
                         {
                             percentageCellWidth = w;
                         }
@@ -10515,8 +11148,8 @@ bool wxRichTextTable::Layout(wxDC& dc, wxRichTextDrawingContext& context, const
                     if (cell->GetMaxSize().x && cell->GetMaxSize().x > maxColWidths[i])
                         maxColWidths[i] = cell->GetMaxSize().x;
 
-                    if (cell->GetAttributes().GetTextBoxAttr().HasWhitespaceMode() &&
-                        (cell->GetAttributes().GetTextBoxAttr().GetWhitespaceMode() == wxTEXT_BOX_ATTR_WHITESPACE_NO_WRAP))
+                    if (cellAttr.GetTextBoxAttr().HasWhitespaceMode() &&
+                        (cellAttr.GetTextBoxAttr().GetWhitespaceMode() == wxTEXT_BOX_ATTR_WHITESPACE_NO_WRAP))
                     {
                         if (cell->GetMaxSize().x > minColWidthsNoWrap[i])
                             minColWidthsNoWrap[i] = cell->GetMaxSize().x;
@@ -10564,6 +11197,7 @@ bool wxRichTextTable::Layout(wxDC& dc, wxRichTextDrawingContext& context, const
         for (i = 0; i < m_colCount; i++)
         {
             wxRichTextCell* cell = GetCell(j, i);
+            const wxRichTextAttr& cellAttr = ((const wxRichTextCell*) cell)->GetAttributes();
             if (cell->IsShown())
             {
                 int colSpan = cell->GetColSpan();
@@ -10573,9 +11207,9 @@ bool wxRichTextTable::Layout(wxDC& dc, wxRichTextDrawingContext& context, const
                     int cellWidth = 0;
                     if (spans > 0)
                     {
-                        if (cell->GetAttributes().GetTextBoxAttr().GetWidth().IsValid())
+                        if (cellAttr.GetTextBoxAttr().GetWidth().IsValid())
                         {
-                            cellWidth = cellConverter.GetPixels(cell->GetAttributes().GetTextBoxAttr().GetWidth(), wxHORIZONTAL);
+                            cellWidth = cellConverter.GetPixels(cellAttr.GetTextBoxAttr().GetWidth(), wxHORIZONTAL);
                             // Override absolute width with minimum width if necessary
                             if (cell->GetMinSize().x > 0 && cellWidth != -1 && cell->GetMinSize().x > cellWidth)
                                 cellWidth = cell->GetMinSize().x;
@@ -10825,13 +11459,14 @@ bool wxRichTextTable::Layout(wxDC& dc, wxRichTextDrawingContext& context, const
         for (i = 0; i < m_colCount; i++)
         {
             wxRichTextCell* cell = GetCell(j, i);
+            const wxRichTextAttr& cellAttr = ((const wxRichTextCell*) cell)->GetAttributes();
             if (cell->IsShown())
             {
                 // Get max specified cell height
                 // Don't handle percentages for height
-                if (cell->GetAttributes().GetTextBoxAttr().GetHeight().IsValid() && cell->GetAttributes().GetTextBoxAttr().GetHeight().GetUnits() != wxTEXT_ATTR_UNITS_PERCENTAGE)
+                if (cellAttr.GetTextBoxAttr().GetHeight().IsValid() && cellAttr.GetTextBoxAttr().GetHeight().GetUnits() != wxTEXT_ATTR_UNITS_PERCENTAGE)
                 {
-                    int h = cellConverter.GetPixels(cell->GetAttributes().GetTextBoxAttr().GetHeight());
+                    int h = cellConverter.GetPixels(cellAttr.GetTextBoxAttr().GetHeight());
                     if (h > maxSpecifiedCellHeight)
                         maxSpecifiedCellHeight = h;
                 }
@@ -11984,7 +12619,7 @@ bool wxRichTextAction::Do()
             if (obj)
             {
                 wxRichTextAttr oldAttr = obj->GetAttributes();
-                obj->GetAttributes() = m_attributes;
+                obj->SetAttributes(m_attributes);
                 m_attributes = oldAttr;
             }
 
@@ -12488,7 +13123,7 @@ bool wxRichTextImage::LoadImageCache(wxDC& dc, wxRichTextDrawingContext& context
         return true;
     }
 
-    wxRichTextAttr attr(GetAttributes());
+    wxRichTextAttr attr(m_attributes);
     AdjustAttributes(attr, context);
 
     if (!context.GetImagesEnabled())
@@ -12553,7 +13188,7 @@ bool wxRichTextImage::LoadImageCache(wxDC& dc, wxRichTextDrawingContext& context
             marginRect = wxRect(0, 0, sz.x, sz.y);
             if (GetParent() && GetParent()->GetParent())
             {
-                buffer->GetBoxRects(dc, buffer, GetParent()->GetParent()->GetAttributes(), marginRect, borderRect, contentRect, paddingRect, outlineRect);
+                buffer->GetBoxRects(dc, buffer, ((const wxRichTextObject*) GetParent()->GetParent())->GetAttributes(), marginRect, borderRect, contentRect, paddingRect, outlineRect);
                 sz = contentRect.GetSize();
             }
 
@@ -12562,7 +13197,7 @@ bool wxRichTextImage::LoadImageCache(wxDC& dc, wxRichTextDrawingContext& context
                 // Find the actual space available when margin is taken into account
                 wxRect imgMarginRect, imgBorderRect, imgContentRect, imgPaddingRect, imgOutlineRect;
                 imgMarginRect = wxRect(0, 0, 100, 100); // To force GetBoxRects to return content rect
-                GetBoxRects(dc, buffer, GetAttributes(), imgMarginRect, imgBorderRect, imgContentRect, imgPaddingRect, imgOutlineRect);
+                GetBoxRects(dc, buffer, m_attributes, imgMarginRect, imgBorderRect, imgContentRect, imgPaddingRect, imgOutlineRect);
                 sz += (imgContentRect.GetSize() - wxSize(100, 100));
             }
 
@@ -12724,7 +13359,7 @@ bool wxRichTextImage::Draw(wxDC& dc, wxRichTextDrawingContext& context, const wx
     if (!IsShown())
         return true;
 
-    wxRichTextAttr attr(GetAttributes());
+    wxRichTextAttr attr(m_attributes);
     AdjustAttributes(attr, context);
 
     wxPoint position = rect.GetPosition();
@@ -12790,7 +13425,7 @@ bool wxRichTextImage::Layout(wxDC& dc, wxRichTextDrawingContext& context, const
     wxRect marginRect, borderRect, contentRect, paddingRect, outlineRect;
     contentRect = wxRect(wxPoint(0,0), imageSize);
 
-    wxRichTextAttr attr(GetAttributes());
+    wxRichTextAttr attr(m_attributes);
     AdjustAttributes(attr, context);
 
     GetBoxRects(dc, GetBuffer(), attr, marginRect, borderRect, contentRect, paddingRect, outlineRect);
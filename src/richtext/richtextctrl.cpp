@@ -33,6 +33,7 @@
 #include "wx/arrimpl.cpp"
 #include "wx/fontenum.h"
 #include "wx/accel.h"
+#include "wx/math.h"
 
 #if defined (__WXGTK__) || defined(__WXX11__) || defined(__WXMOTIF__)
 #define wxHAVE_PRIMARY_SELECTION 1
@@ -378,6 +379,8 @@ void wxRichTextCtrl::Init()
     m_fullLayoutTime = 0;
     m_fullLayoutSavedPosition = 0;
     m_delayedLayoutThreshold = wxRICHTEXT_DEFAULT_DELAYED_LAYOUT_THRESHOLD;
+    m_enableBackgroundLayout = false;
+    m_backgroundLayoutTime = 0;
     m_caretPositionForDefaultStyle = -2;
     m_focusObject = & m_buffer;
     m_scale = 1.0;
@@ -469,10 +472,17 @@ void wxRichTextCtrl::OnPaint(wxPaintEvent& WXUNUSED(event))
 
         wxRect availableSpace(GetUnscaledSize(GetClientSize()));
         wxRichTextDrawingContext context(& GetBuffer());
+
+        // Lay out the paragraphs being drawn if their layout was only estimated.
+        if (GetBuffer().HasEstimatedLayout())
+            GetBuffer().InvalidateEstimatedLayout(drawingArea);
+
         if (GetBuffer().IsDirty())
         {
             dc.SetUserScale(GetScale(), GetScale());
 
+            SetupLayoutEstimation(context);
+
             GetBuffer().Defragment(context);
             GetBuffer().UpdateRanges();     // If items were deleted, ranges need recalculation
 
@@ -1866,7 +1876,7 @@ bool wxRichTextCtrl::ScrollIntoView(long position, int keyCode)
 
     {
         wxClientDC dc(this);
-        wxRichTextObject::GetTotalMargin(dc, & GetBuffer(), GetBuffer().GetAttributes(), leftMargin, rightMargin,
+        wxRichTextObject::GetTotalMargin(dc, & GetBuffer(), GetBuffer().GetBasicStyle(), leftMargin, rightMargin,
             topMargin, bottomMargin);
     }
     clientSize.y -= (int) (0.5 + bottomMargin * GetScale());
@@ -2873,6 +2883,13 @@ void wxRichTextCtrl::ForceDelayedLayout()
         Refresh(false);
         Update();
     }
+
+    if (GetBuffer().HasEstimatedLayout() && GetBuffer().InvalidateEstimatedLayout(-1))
+    {
+        LayoutContent();
+        Refresh(false);
+        Update();
+    }
 }
 
 /// Idle-time processing
@@ -2899,6 +2916,15 @@ void wxRichTextCtrl::OnIdle(wxIdleEvent& event)
         Refresh(false);
     }
 
+    // Continue laying out the buffer in the background, unless it was laid
+    // out very recently, e.g. because the user is typing.
+    if (m_enableBackgroundLayout && !m_fullLayoutRequired && GetBuffer().HasEstimatedLayout() &&
+        !IsFrozen() && (wxGetLocalTimeMillis() > (m_backgroundLayoutTime + layoutInterval)))
+    {
+        if (DoBackgroundLayout())
+            event.RequestMore();
+    }
+
     const int imageProcessingInterval = wxRICHTEXT_DEFAULT_DELAYED_IMAGE_PROCESSING_INTERVAL;
 
     if (m_enableDelayedImageLoading && m_delayedImageProcessingRequired && (wxGetLocalTimeMillis() > (m_delayedImageProcessingTime + imageProcessingInterval)))
@@ -4134,7 +4160,7 @@ bool wxRichTextCtrl::SetFont(const wxFont& font)
 {
     wxControl::SetFont(font);
 
-    wxRichTextAttr attr = GetBuffer().GetAttributes();
+    wxRichTextAttr attr = GetBuffer().GetBasicStyle();
     attr.SetFont(font);
     GetBuffer().SetBasicStyle(attr);
 
@@ -4313,6 +4339,9 @@ bool wxRichTextCtrl::LayoutContent(bool onlyVisibleRect)
         dc.SetUserScale(GetScale(), GetScale());
 
         wxRichTextDrawingContext context(& GetBuffer());
+        SetupLayoutEstimation(context);
+        m_backgroundLayoutTime = wxGetLocalTimeMillis();
+
         GetBuffer().Defragment(context);
         GetBuffer().UpdateRanges();     // If items were deleted, ranges need recalculation
         DoLayoutBuffer(GetBuffer(), dc, context, availableSpace, availableSpace, flags);
@@ -4335,6 +4364,74 @@ void wxRichTextCtrl::DoLayoutBuffer(wxRichTextBuffer& buffer, wxDC& dc, wxRichTe
     buffer.Layout(dc, context, rect, parentRect, flags);
 }
 
+void wxRichTextCtrl::SetupLayoutEstimation(wxRichTextDrawingContext& context)
+{
+    // Only the paragraphs below the visible area get estimated layout, the
+    // rest of them will be laid out in idle time.
+    if (m_enableBackgroundLayout && GetBuffer().GetOwnRange().GetEnd() > m_delayedLayoutThreshold)
+    {
+        wxPoint bottom(GetUnscaledPoint(GetLogicalPoint(wxPoint(0, GetClientSize().y))));
+        context.SetLayoutEstimationStart(bottom.y);
+    }
+}
+
+bool wxRichTextCtrl::DoBackgroundLayout()
+{
+    // Laying out is not an edit, so don't delay the next background layout.
+    const wxLongLong backgroundLayoutTime = m_backgroundLayoutTime;
+
+    // Only the paragraphs with estimated layout are laid out below, so lay
+    // out any other changes first.
+    LayoutContent();
+
+    // Keep the first visible paragraph in place if the paragraphs above it
+    // change their height.
+    wxRichTextParagraph* para = GetBuffer().GetParagraphAtPosition(GetFirstVisiblePosition());
+    const int oldY = para ? para->GetPosition().y : 0;
+
+    wxRect availableSpace(GetUnscaledSize(GetClientSize()));
+    if (availableSpace.width == 0)
+        availableSpace.width = 10;
+    if (availableSpace.height == 0)
+        availableSpace.height = 10;
+
+    wxClientDC dc(this);
+
+    PrepareDC(dc);
+    dc.SetFont(GetFont());
+    dc.SetUserScale(GetScale(), GetScale());
+
+    wxRichTextDrawingContext context(& GetBuffer());
+    SetupLayoutEstimation(context);
+
+    const bool more = GetBuffer().LayoutEstimatedParagraphs(dc, context, availableSpace,
+                                                            wxRICHTEXT_FIXED_WIDTH|wxRICHTEXT_VARIABLE_HEIGHT,
+                                                            wxRICHTEXT_DEFAULT_BACKGROUND_LAYOUT_DURATION);
+
+    dc.SetUserScale(1.0, 1.0);
+
+    m_backgroundLayoutTime = backgroundLayoutTime;
+
+    if (!IsFrozen())
+        SetupScrollbars();
+
+    if (GetDelayedImageLoading())
+        RequestDelayedImageProcessing();
+
+    if (para && para->GetPosition().y != oldY)
+    {
+        int ppuX, ppuY;
+        GetScrollPixelsPerUnit(& ppuX, & ppuY);
+
+        int startX, startY;
+        GetViewStart(& startX, & startY);
+        if (ppuY > 0 && startY > 0)
+            Scroll(startX, startY + wxRound(GetScale() * (para->GetPosition().y - oldY) / ppuY));
+    }
+
+    return more;
+}
+
 /// Is all of the selection, or the current caret position, bold?
 bool wxRichTextCtrl::IsSelectionBold()
 {
@@ -5293,7 +5390,7 @@ bool wxRichTextCtrl::ProcessDelayedImageLoading(const wxRect& screenRect, wxRich
                             if (marginRect.GetSize() != wxDefaultSize)
                             {
                                 wxClientDC dc(this);
-                                wxRichTextAttr attr(imageObj->GetAttributes());
+                                wxRichTextAttr attr(((const wxRichTextImage*) imageObj)->GetAttributes());
                                 imageObj->AdjustAttributes(attr, context);
                                 imageObj->GetBoxRects(dc, & GetBuffer(), attr, marginRect, borderRect, contentRect, paddingRect, outlineRect);
 
@@ -69,6 +69,53 @@ void wxRichTextXMLHandler::Init()
 }
 
 #if wxUSE_STREAMS
+
+namespace
+{
+
+// This document imports the objects of the buffer, i.e. its paragraphs, as
+// soon as they're loaded, instead of keeping them in memory until the entire
+// document is loaded.
+class wxRichTextXMLLoadingDocument : public wxXmlDocument
+{
+public:
+    wxRichTextXMLLoadingDocument(wxRichTextXMLHandler* handler, wxRichTextBuffer* buffer)
+        : m_handler(handler), m_buffer(buffer)
+    {
+    }
+
+    virtual bool OnElementLoaded(wxXmlNode* node) wxOVERRIDE
+    {
+        // Only handle the children of the buffer node, which is a child of the
+        // root "richtext" node, and leave the rest to DoLoadFile().
+        wxXmlNode* const bufferNode = node->GetParent();
+        wxXmlNode* const rootNode = bufferNode ? bufferNode->GetParent() : NULL;
+        if (!rootNode || rootNode->GetName() != wxT("richtext") ||
+                !rootNode->GetParent() || rootNode->GetParent()->GetType() != wxXML_DOCUMENT_NODE)
+            return false;
+
+        if (node->GetName() == wxT("stylesheet"))
+            return false;
+
+        wxRichTextObject* const obj = m_handler->CreateObjectForXMLName(m_buffer, node->GetName());
+        if (!obj)
+            return false;
+
+        m_buffer->AppendChild(obj);
+        m_handler->ImportXML(m_buffer, obj, node);
+
+        return true;
+    }
+
+private:
+    wxRichTextXMLHandler* const m_handler;
+    wxRichTextBuffer* const m_buffer;
+
+    wxDECLARE_NO_COPY_CLASS(wxRichTextXMLLoadingDocument);
+};
+
+} // anonymous namespace
+
 bool wxRichTextXMLHandler::DoLoadFile(wxRichTextBuffer *buffer, wxInputStream& stream)
 {
     if (!stream.IsOk())
@@ -79,7 +126,9 @@ bool wxRichTextXMLHandler::DoLoadFile(wxRichTextBuffer *buffer, wxInputStream& s
     buffer->ResetAndClearCommands();
     buffer->Clear();
 
-    wxXmlDocument* xmlDoc = new wxXmlDocument;
+    // The paragraphs are imported while loading the document, so only the
+    // buffer node itself and its attributes remain to be imported below.
+    wxXmlDocument* xmlDoc = new wxRichTextXMLLoadingDocument(this, buffer);
     bool success = true;
 
     // This is the encoding to convert to (memory encoding rather than file encoding)
@@ -91,6 +140,8 @@ bool wxRichTextXMLHandler::DoLoadFile(wxRichTextBuffer *buffer, wxInputStream& s
 
     if (!xmlDoc->Load(stream, encoding))
     {
+        // Don't leave the paragraphs imported before the error in the buffer.
+        buffer->Clear();
         buffer->ResetAndClearCommands();
         success = false;
     }
@@ -256,61 +307,67 @@ bool wxRichTextXMLHandler::DoSaveFile(wxRichTextBuffer *buffer, wxOutputStream&
 #else
     // !(wxRICHTEXT_HAVE_XMLDOCUMENT_OUTPUT && wxRICHTEXT_USE_XMLDOCUMENT_OUTPUT)
 
+    // Avoid writing all the small strings below to the stream one by one.
+    wxBufferedOutputStream bufferedStream(stream);
+
     wxString s ;
     s.Printf(wxT("<?xml version=\"%s\" encoding=\"%s\"?>\n"),
              version.c_str(), fileEncoding.c_str());
-    m_helper.OutputString(stream, s);
-    m_helper.OutputString(stream, wxT("<richtext version=\"1.0.0.0\" xmlns=\"http://www.wxwidgets.org\">"));
+    m_helper.OutputString(bufferedStream, s);
+    m_helper.OutputString(bufferedStream, wxT("<richtext version=\"1.0.0.0\" xmlns=\"http://www.wxwidgets.org\">"));
 
     int level = 1;
 
     if (buffer->GetStyleSheet() && (GetFlags() & wxRICHTEXT_HANDLER_INCLUDE_STYLESHEET))
     {
-        m_helper.OutputIndentation(stream, level);
+        m_helper.OutputIndentation(bufferedStream, level);
         wxString nameAndDescr;
         if (!buffer->GetStyleSheet()->GetName().empty())
             nameAndDescr << wxT(" name=\"") << buffer->GetStyleSheet()->GetName() << wxT("\"");
         if (!buffer->GetStyleSheet()->GetDescription().empty())
             nameAndDescr << wxT(" description=\"") << buffer->GetStyleSheet()->GetDescription() << wxT("\"");
-        m_helper.OutputString(stream, wxString(wxT("<stylesheet")) + nameAndDescr + wxT(">"));
+        m_helper.OutputString(bufferedStream, wxString(wxT("<stylesheet")) + nameAndDescr + wxT(">"));
 
         int i;
 
         for (i = 0; i < (int) buffer->GetStyleSheet()->GetCharacterStyleCount(); i++)
         {
             wxRichTextCharacterStyleDefinition* def = buffer->GetStyleSheet()->GetCharacterStyle(i);
-            m_helper.ExportStyleDefinition(stream, def, level + 1);
+            m_helper.ExportStyleDefinition(bufferedStream, def, level + 1);
         }
 
         for (i = 0; i < (int) buffer->GetStyleSheet()->GetParagraphStyleCount(); i++)
         {
             wxRichTextParagraphStyleDefinition* def = buffer->GetStyleSheet()->GetParagraphStyle(i);
-            m_helper.ExportStyleDefinition(stream, def, level + 1);
+            m_helper.ExportStyleDefinition(bufferedStream, def, level + 1);
         }
 
         for (i = 0; i < (int) buffer->GetStyleSheet()->GetListStyleCount(); i++)
         {
             wxRichTextListStyleDefinition* def = buffer->GetStyleSheet()->GetListStyle(i);
-            m_helper.ExportStyleDefinition(stream, def, level + 1);
+            m_helper.ExportStyleDefinition(bufferedStream, def, level + 1);
         }
 
         for (i = 0; i < (int) buffer->GetStyleSheet()->GetBoxStyleCount(); i++)
         {
             wxRichTextBoxStyleDefinition* def = buffer->GetStyleSheet()->GetBoxStyle(i);
-            m_helper.ExportStyleDefinition(stream, def, level + 1);
+            m_helper.ExportStyleDefinition(bufferedStream, def, level + 1);
         }
 
-        m_helper.WriteProperties(stream, buffer->GetStyleSheet()->GetProperties(), level);
+        m_helper.WriteProperties(bufferedStream, buffer->GetStyleSheet()->GetProperties(), level);
 
-        m_helper.OutputIndentation(stream, level);
-        m_helper.OutputString(stream, wxT("</stylesheet>"));
+        m_helper.OutputIndentation(bufferedStream, level);
+        m_helper.OutputString(bufferedStream, wxT("</stylesheet>"));
     }
 
 
-    bool success = ExportXML(stream, *buffer, level);
+    bool success = ExportXML(bufferedStream, *buffer, level);
 
-    m_helper.OutputString(stream, wxT("\n</richtext>"));
-    m_helper.OutputString(stream, wxT("\n"));
+    m_helper.OutputString(bufferedStream, wxT("\n</richtext>"));
+    m_helper.OutputString(bufferedStream, wxT("\n"));
+
+    if (!bufferedStream.Close())
+        success = false;
 #endif
 
     return success;
@@ -1926,12 +1983,12 @@ void wxRichTextXMLHelper::OutputString(wxOutputStream& stream, const wxString& s
     if (convFile)
     {
         const wxWX2MBbuf buf(str.mb_str(*convFile));
-        stream.Write((const char*)buf, strlen((const char*)buf));
+        stream.Write((const char*)buf, buf.length());
     }
     else
     {
         const wxWX2MBbuf buf(str.mb_str(wxConvUTF8));
-        stream.Write((const char*)buf, strlen((const char*)buf));
+        stream.Write((const char*)buf, buf.length());
     }
 #else
     if ( convFile == NULL )
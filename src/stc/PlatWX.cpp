@@ -40,6 +40,17 @@
 #include "wx/dcgraph.h"
 #endif
 
+// With GTK+ 3 window and memory DCs draw using Cairo and Pango, so the UTF-8
+// text used by Scintilla can be measured directly, without converting it.
+#if defined(__WXGTK3__) && wxUSE_UNICODE && wxUSE_GRAPHICS_CONTEXT
+#define wxSTC_USE_PANGO_MEASURE
+#include "wx/dcclient.h"
+#include "wx/fontutil.h"
+#include "wx/graphics.h"
+#include "wx/gtk/private/wrapgtk.h"
+#include "wx/gtk/private/object.h"
+#endif
+
 #include "Platform.h"
 #include "PlatWX.h"
 #include "wx/stc/stc.h"
@@ -195,6 +206,9 @@ private:
     int         y;
     bool        unicodeMode;
 
+    // Reused by MeasureWidths() to avoid allocating it for every call.
+    wxArrayInt  tpos;
+
 public:
     SurfaceImpl();
     ~SurfaceImpl();
@@ -555,6 +569,66 @@ void SurfaceImpl::Copy(PRectangle rc, Point from, Surface &surfaceSource) {
               wxRound(from.x), wxRound(from.y), wxCOPY);
 }
 
+#if wxUSE_UNICODE
+// Returns true if the text consists of 7 bit ASCII characters only, which
+// are encoded using a single byte each in UTF-8.
+static bool IsASCII(const char *s, int len) {
+    for (int i = 0; i < len; i++) {
+        if (static_cast<unsigned char>(s[i]) >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+// Converts the text to wxString, avoiding the UTF-8 decoding if possible.
+static wxString stc2wxFast(const char *s, int len) {
+    return IsASCII(s, len) ? wxString::FromAscii(s, len) : stc2wx(s, len);
+}
+#else // !wxUSE_UNICODE
+#define stc2wxFast(s, len) stc2wx(s, len)
+#endif // wxUSE_UNICODE/!wxUSE_UNICODE
+
+#ifdef wxSTC_USE_PANGO_MEASURE
+// Measures the UTF-8 text directly with Pango if the DC uses Cairo, filling
+// in the positions for all of its bytes. Returns false if this can't be done
+// and the text must be measured using the DC instead.
+static bool MeasureWidthsPango(wxDC *dc, const char *s, int len, XYPOSITION *positions) {
+    // Other DCs, e.g. the printer ones, don't use the Cairo context for text.
+    if (!wxDynamicCast(dc, wxWindowDC) && !wxDynamicCast(dc, wxMemoryDC))
+        return false;
+
+    wxGraphicsContext* const gc = dc->GetGraphicsContext();
+    cairo_t* const cr = gc ? static_cast<cairo_t*>(gc->GetNativeContext()) : NULL;
+    const wxNativeFontInfo* const info = dc->GetFont().GetNativeFontInfo();
+    if (!cr || !info || !g_utf8_validate(s, len, NULL))
+        return false;
+
+    // Measure in the same way as wxCairoContext::GetPartialTextExtents() does.
+    wxGtkObject<PangoLayout> layout(pango_cairo_create_layout(cr));
+    pango_layout_set_font_description(layout, info->description);
+    pango_layout_set_text(layout, s, len);
+
+    // All bytes of a cluster get the position of its end.
+    PangoLayoutIter *iter = pango_layout_get_iter(layout);
+    PangoRectangle rect;
+    int w = 0;
+    int i = 0;
+    bool more = true;
+    while (more) {
+        pango_layout_iter_get_cluster_extents(iter, NULL, &rect);
+        w += rect.width;
+        more = pango_layout_iter_next_cluster(iter) != FALSE;
+
+        const int end = more ? pango_layout_iter_get_index(iter) : len;
+        while (i < end)
+            positions[i++] = PANGO_PIXELS(w);
+    }
+    pango_layout_iter_free(iter);
+
+    return true;
+}
+#endif // wxSTC_USE_PANGO_MEASURE
+
 void SurfaceImpl::DrawTextNoClip(PRectangle rc, Font &font, XYPOSITION ybase,
                                  const char *s, int len,
                                  ColourDesired fore, ColourDesired back) {
@@ -565,7 +639,7 @@ void SurfaceImpl::DrawTextNoClip(PRectangle rc, Font &font, XYPOSITION ybase,
 
     // ybase is where the baseline should be, but wxWin uses the upper left
     // corner, so I need to calculate the real position for the text...
-    hdc->DrawText(stc2wx(s, len), wxRound(rc.left), wxRound(ybase - GetAscent(font)));
+    hdc->DrawText(stc2wxFast(s, len), wxRound(rc.left), wxRound(ybase - GetAscent(font)));
 }
 
 void SurfaceImpl::DrawTextClipped(PRectangle rc, Font &font, XYPOSITION ybase,
@@ -578,7 +652,7 @@ void SurfaceImpl::DrawTextClipped(PRectangle rc, Font &font, XYPOSITION ybase,
     hdc->SetClippingRegion(wxRectFromPRectangle(rc));
 
     // see comments above
-    hdc->DrawText(stc2wx(s, len), wxRound(rc.left), wxRound(ybase - GetAscent(font)));
+    hdc->DrawText(stc2wxFast(s, len), wxRound(rc.left), wxRound(ybase - GetAscent(font)));
     hdc->DestroyClippingRegion();
 }
 
@@ -593,7 +667,7 @@ void SurfaceImpl::DrawTextTransparent(PRectangle rc, Font &font, XYPOSITION ybas
 
     // ybase is where the baseline should be, but wxWin uses the upper left
     // corner, so I need to calculate the real position for the text...
-    hdc->DrawText(stc2wx(s, len), wxRound(rc.left), wxRound(ybase - GetAscent(font)));
+    hdc->DrawText(stc2wxFast(s, len), wxRound(rc.left), wxRound(ybase - GetAscent(font)));
 
     hdc->SetBackgroundMode(wxBRUSHSTYLE_SOLID);
 }
@@ -601,14 +675,28 @@ void SurfaceImpl::DrawTextTransparent(PRectangle rc, Font &font, XYPOSITION ybas
 
 void SurfaceImpl::MeasureWidths(Font &font, const char *s, int len, XYPOSITION *positions) {
 
-    wxString   str = stc2wx(s, len);
-    wxArrayInt tpos;
-
     SetFont(font);
 
-    hdc->GetPartialTextExtents(str, tpos);
+#ifdef wxSTC_USE_PANGO_MEASURE
+    if (MeasureWidthsPango(hdc, s, len, positions))
+        return;
+#endif // wxSTC_USE_PANGO_MEASURE
 
 #if wxUSE_UNICODE
+    // Most of the text is usually ASCII and then the bytes of the input
+    // correspond to the characters one to one, so there is no need to decode
+    // it nor to map the positions back to it.
+    if (IsASCII(s, len)) {
+        hdc->GetPartialTextExtents(wxString::FromAscii(s, len), tpos);
+        for (int i = 0; i < len; i++) {
+            positions[i] = tpos[i];
+        }
+        return;
+    }
+
+    wxString   str = stc2wx(s, len);
+    hdc->GetPartialTextExtents(str, tpos);
+
     // Map the widths back to the UTF-8 input string
     size_t utf8i = 0;
     for (size_t wxi = 0; wxi < str.size(); ++wxi) {
@@ -636,6 +724,8 @@ void SurfaceImpl::MeasureWidths(Font &font, const char *s, int len, XYPOSITION *
             positions[utf8i++] = tpos[wxi];
     }
 #else // !wxUSE_UNICODE
+    hdc->GetPartialTextExtents(stc2wx(s, len), tpos);
+
     // If not unicode then just use the widths we have
     for (int i = 0; i < len; i++) {
         positions[i] = tpos[i];
@@ -649,7 +739,7 @@ XYPOSITION SurfaceImpl::WidthText(Font &font, const char *s, int len) {
     int w;
     int h;
 
-    hdc->GetTextExtent(stc2wx(s, len), &w, &h);
+    hdc->GetTextExtent(stc2wxFast(s, len), &w, &h);
     return w;
 }
 
@@ -660,7 +750,7 @@ XYPOSITION SurfaceImpl::WidthChar(Font &font, char ch) {
     int h;
     char s[2] = { ch, 0 };
 
-    hdc->GetTextExtent(stc2wx(s, 1), &w, &h);
+    hdc->GetTextExtent(stc2wxFast(s, 1), &w, &h);
     return w;
 }
 
@@ -27,6 +27,7 @@
     #include "wx/math.h"
     #include "wx/menu.h"
     #include "wx/timer.h"
+    #include "wx/log.h"
 #endif // WX_PRECOMP
 
 #include "wx/textbuf.h"
@@ -35,6 +36,8 @@
 #include "wx/dnd.h"
 #include "wx/image.h"
 #include "wx/scopedarray.h"
+#include "wx/scopedptr.h"
+#include "wx/stopwatch.h"
 
 #if !wxUSE_STD_CONTAINERS && !wxUSE_STD_IOSTREAM && !wxUSE_STD_STRING
     #include "wx/beforestd.h"
@@ -48,6 +51,16 @@
 #include "wx/stc/private.h"
 #include "PlatWX.h"
 
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+    #include "Catalogue.h"
+    #include "UniConversion.h"
+    #include "UnicodeFromUTF8.h"
+#endif
+
+#ifdef wxHAS_STC_BACKGROUND_LOADING
+    #include "wx/convauto.h"
+#endif
+
 #ifdef __WXMSW__
     // GetHwndOf()
     #include "wx/msw/private.h"
@@ -72,6 +85,640 @@ private:
     ScintillaWX::TickReason m_reason;
 };
 
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+
+#define TRACE_STC_LEXING wxT("stclexing")
+
+namespace
+{
+
+// The amount of text lexed by the background thread at once: it is big enough
+// for the overhead of starting the thread to be negligible but small enough
+// for the styles to appear progressively while a big document is lexed.
+const int LEXER_CHUNK_SIZE = 1024*1024;
+
+// The lexers may look at the text around the part being lexed, so copy this
+// much of it before and after this part too.
+const int LEXER_CONTEXT_SIZE = 64*1024;
+
+} // anonymous namespace
+
+// A copy of a part of the document which the lexer can use in the background
+// thread while the document itself is modified in the main thread.
+//
+// Only the text around the part being lexed is copied, so the lexers looking
+// further away than LEXER_CONTEXT_SIZE before or after it see empty text and
+// default line states and fold levels there.
+class wxSTCLexerDocument : public IDocumentWithLineEnd {
+public:
+    // Copy the text needed to lex the given range, which must start at the
+    // beginning of a line and end at the beginning of a line or the document
+    // end.
+    wxSTCLexerDocument(Document* pdoc, int start, int end);
+    virtual ~wxSTCLexerDocument() { }
+
+    int GetStart() const { return m_start; }
+    int GetEnd() const { return m_end; }
+
+    // Return the start of the line containing the given position.
+    int GetLineStartOf(int position) const {
+        return LineStart(LineFromPosition(position));
+    }
+
+    // Lex and fold the range, this is called from the background thread.
+    void Colourise(ILexer* lexer);
+
+    // Copy the results of lexing the range up to the given line start into
+    // the document, which must not have been modified before it.
+    void Merge(Document* pdoc, int upTo) const;
+
+    // IDocument
+    virtual int SCI_METHOD Version() const wxOVERRIDE { return dvLineEnd; }
+    virtual void SCI_METHOD SetErrorStatus(int status) wxOVERRIDE { m_errorStatus = status; }
+    virtual Sci_Position SCI_METHOD Length() const wxOVERRIDE { return m_length; }
+    virtual void SCI_METHOD GetCharRange(char *buffer, Sci_Position position, Sci_Position lengthRetrieve) const wxOVERRIDE;
+    virtual char SCI_METHOD StyleAt(Sci_Position position) const wxOVERRIDE;
+    virtual Sci_Position SCI_METHOD LineFromPosition(Sci_Position position) const wxOVERRIDE;
+    virtual Sci_Position SCI_METHOD LineStart(Sci_Position line) const wxOVERRIDE;
+    virtual int SCI_METHOD GetLevel(Sci_Position line) const wxOVERRIDE;
+    virtual int SCI_METHOD SetLevel(Sci_Position line, int level) wxOVERRIDE;
+    virtual int SCI_METHOD GetLineState(Sci_Position line) const wxOVERRIDE;
+    virtual int SCI_METHOD SetLineState(Sci_Position line, int state) wxOVERRIDE;
+    virtual void SCI_METHOD StartStyling(Sci_Position position, char mask) wxOVERRIDE;
+    virtual bool SCI_METHOD SetStyleFor(Sci_Position length, char style) wxOVERRIDE;
+    virtual bool SCI_METHOD SetStyles(Sci_Position length, const char *styles) wxOVERRIDE;
+    virtual void SCI_METHOD DecorationSetCurrentIndicator(int indicator) wxOVERRIDE;
+    virtual void SCI_METHOD DecorationFillRange(Sci_Position position, int value, Sci_Position fillLength) wxOVERRIDE;
+    virtual void SCI_METHOD ChangeLexerState(Sci_Position start, Sci_Position end) wxOVERRIDE;
+    virtual int SCI_METHOD CodePage() const wxOVERRIDE { return m_codePage; }
+    virtual bool SCI_METHOD IsDBCSLeadByte(char WXUNUSED(ch)) const wxOVERRIDE { return false; }
+    virtual const char * SCI_METHOD BufferPointer() wxOVERRIDE;
+    virtual int SCI_METHOD GetLineIndentation(Sci_Position line) wxOVERRIDE;
+
+    // IDocumentWithLineEnd
+    virtual Sci_Position SCI_METHOD LineEnd(Sci_Position line) const wxOVERRIDE;
+    virtual Sci_Position SCI_METHOD GetRelativePosition(Sci_Position positionStart, Sci_Position characterOffset) const wxOVERRIDE;
+    virtual int SCI_METHOD GetCharacterAndWidth(Sci_Position position, Sci_Position *pWidth) const wxOVERRIDE;
+
+private:
+    // Return the index of the position in m_text or -1 if it wasn't copied.
+    int TextIndex(int position) const {
+        position -= m_textStart;
+        return position >= 0 && position < static_cast<int>(m_text.size())
+                ? position : -1;
+    }
+
+    // Same for the line in m_lineStarts, m_levels and m_lineStates.
+    int LineIndex(int line) const {
+        line -= m_firstLine;
+        return line >= 0 && line < static_cast<int>(m_levels.size())
+                ? line : -1;
+    }
+
+    char CharAt(int position) const {
+        const int n = TextIndex(position);
+        return n == -1 ? '\0' : m_text[n];
+    }
+
+    // Return the position of the next or previous UTF-8 character.
+    int NextPosition(int position, int direction) const;
+
+    // The range being lexed and the length of the whole document.
+    const int m_start,
+              m_end,
+              m_length;
+
+    const int m_codePage;
+    const int m_tabInChars;
+
+    // The text and its styles copied from the document, starting at the
+    // beginning of a line.
+    int m_textStart;
+    std::string m_text;
+    std::string m_styles;
+
+    // The position of the next style set by the lexer.
+    int m_endStyled;
+
+    // The total number of lines in the document and the starts, fold levels
+    // and states of the lines starting with m_firstLine and covering all the
+    // copied text (m_lineStarts has one more element for the next line).
+    int m_linesTotal;
+    int m_firstLine;
+    std::vector<int> m_lineStarts;
+    std::vector<int> m_levels;
+    std::vector<int> m_lineStates;
+
+    // The indicators set by the lexer, which is rarely done.
+    struct Decoration {
+        int indicator;
+        int position;
+        int value;
+        int length;
+    };
+    std::vector<Decoration> m_decorations;
+    int m_indicator;
+
+    // The range passed to ChangeLexerState(), if it was called.
+    int m_lexerStateStart;
+    int m_lexerStateEnd;
+
+    int m_errorStatus;
+};
+
+wxSTCLexerDocument::wxSTCLexerDocument(Document* pdoc, int start, int end)
+    : m_start(start),
+      m_end(end),
+      m_length(pdoc->Length()),
+      m_codePage(pdoc->dbcsCodePage),
+      m_tabInChars(pdoc->tabInChars) {
+    m_linesTotal = pdoc->LinesTotal();
+    m_firstLine = pdoc->LineFromPosition(wxMax(start - LEXER_CONTEXT_SIZE, 0));
+    m_textStart = pdoc->LineStart(m_firstLine);
+
+    const int textEnd = wxMin(end + LEXER_CONTEXT_SIZE, m_length);
+    const int textLength = textEnd - m_textStart;
+    m_text.resize(textLength);
+    m_styles.resize(textLength);
+    if ( textLength ) {
+        pdoc->GetCharRange(&m_text[0], m_textStart, textLength);
+        pdoc->GetStyleRange(reinterpret_cast<unsigned char *>(&m_styles[0]),
+                            m_textStart, textLength);
+    }
+
+    const int lastLine = pdoc->LineFromPosition(textEnd);
+    const int numLines = lastLine - m_firstLine + 1;
+    m_lineStarts.reserve(numLines + 1);
+    m_levels.reserve(numLines);
+    m_lineStates.reserve(numLines);
+    for ( int line = m_firstLine; line <= lastLine; line++ ) {
+        m_lineStarts.push_back(pdoc->LineStart(line));
+        m_levels.push_back(pdoc->GetLevel(line));
+        m_lineStates.push_back(pdoc->GetLineState(line));
+    }
+    m_lineStarts.push_back(pdoc->LineStart(lastLine + 1));
+
+    m_endStyled = start;
+    m_indicator = 0;
+    m_lexerStateStart =
+    m_lexerStateEnd = -1;
+    m_errorStatus = 0;
+}
+
+void wxSTCLexerDocument::Colourise(ILexer* lexer) {
+    // This is the same thing as LexInterface::Colourise() does.
+    int styleStart = 0;
+    if ( m_start > 0 )
+        styleStart = StyleAt(m_start - 1);
+
+    if ( m_end > m_start ) {
+        lexer->Lex(m_start, m_end - m_start, styleStart, this);
+        lexer->Fold(m_start, m_end - m_start, styleStart, this);
+    }
+}
+
+void wxSTCLexerDocument::Merge(Document* pdoc, int upTo) const {
+    // Don't overwrite the styles already set by the lexer running in the main
+    // thread, e.g. when showing a part of the document we hadn't got to yet.
+    const int from = wxMax(m_start,
+                           pdoc->LineStart(pdoc->LineFromPosition(pdoc->GetEndStyled())));
+    if ( from >= upTo )
+        return;
+
+    pdoc->StartStyling(from, '\377');
+    if ( !pdoc->SetStyles(upTo - from, &m_styles[TextIndex(from)]) )
+        return;
+
+    const int lineFrom = LineFromPosition(from);
+    const int lineTo = upTo == m_length ? m_linesTotal : LineFromPosition(upTo);
+    for ( int line = lineFrom; line < lineTo; line++ ) {
+        const int n = LineIndex(line);
+        if ( n == -1 )
+            break;
+
+        pdoc->SetLineState(line, m_lineStates[n]);
+        pdoc->SetLevel(line, m_levels[n]);
+    }
+
+    for ( std::vector<Decoration>::const_iterator it = m_decorations.begin();
+          it != m_decorations.end();
+          ++it ) {
+        if ( it->position >= upTo )
+            continue;
+
+        pdoc->DecorationSetCurrentIndicator(it->indicator);
+        pdoc->DecorationFillRange(it->position, it->value,
+                                  wxMin(it->length, upTo - it->position));
+    }
+
+    if ( m_lexerStateStart != -1 )
+        pdoc->ChangeLexerState(m_lexerStateStart, m_lexerStateEnd);
+
+    if ( m_errorStatus )
+        pdoc->SetErrorStatus(m_errorStatus);
+}
+
+void SCI_METHOD
+wxSTCLexerDocument::GetCharRange(char *buffer,
+                                 Sci_Position position,
+                                 Sci_Position lengthRetrieve) const {
+    for ( Sci_Position i = 0; i < lengthRetrieve; i++ )
+        buffer[i] = CharAt(position + i);
+}
+
+char SCI_METHOD wxSTCLexerDocument::StyleAt(Sci_Position position) const {
+    const int n = TextIndex(position);
+    return n == -1 ? 0 : m_styles[n];
+}
+
+Sci_Position SCI_METHOD
+wxSTCLexerDocument::LineFromPosition(Sci_Position position) const {
+    // Don't use the start of the line after the last one, it's only used for
+    // computing the end of the last line.
+    const std::vector<int>::const_iterator last = m_lineStarts.end() - 1;
+    const std::vector<int>::const_iterator
+        it = std::upper_bound(m_lineStarts.begin(), last, position);
+    if ( it == m_lineStarts.begin() )
+        return m_firstLine;
+
+    return m_firstLine + (it - m_lineStarts.begin()) - 1;
+}
+
+Sci_Position SCI_METHOD wxSTCLexerDocument::LineStart(Sci_Position line) const {
+    if ( line >= m_linesTotal )
+        return m_length;
+
+    const int n = line - m_firstLine;
+    if ( n < 0 )
+        return m_lineStarts.front();
+    if ( n >= static_cast<int>(m_lineStarts.size()) )
+        return m_lineStarts.back();
+
+    return m_lineStarts[n];
+}
+
+int SCI_METHOD wxSTCLexerDocument::GetLevel(Sci_Position line) const {
+    const int n = LineIndex(line);
+    return n == -1 ? SC_FOLDLEVELBASE : m_levels[n];
+}
+
+int SCI_METHOD wxSTCLexerDocument::SetLevel(Sci_Position line, int level) {
+    const int n = LineIndex(line);
+    if ( n == -1 )
+        return SC_FOLDLEVELBASE;
+
+    const int prev = m_levels[n];
+    m_levels[n] = level;
+    return prev;
+}
+
+int SCI_METHOD wxSTCLexerDocument::GetLineState(Sci_Position line) const {
+    const int n = LineIndex(line);
+    return n == -1 ? 0 : m_lineStates[n];
+}
+
+int SCI_METHOD wxSTCLexerDocument::SetLineState(Sci_Position line, int state) {
+    const int n = LineIndex(line);
+    if ( n == -1 )
+        return 0;
+
+    const int prev = m_lineStates[n];
+    m_lineStates[n] = state;
+    return prev;
+}
+
+void SCI_METHOD wxSTCLexerDocument::StartStyling(Sci_Position position, char) {
+    m_endStyled = position;
+}
+
+bool SCI_METHOD wxSTCLexerDocument::SetStyleFor(Sci_Position length, char style) {
+    for ( Sci_Position i = 0; i < length; i++, m_endStyled++ ) {
+        const int n = TextIndex(m_endStyled);
+        if ( n != -1 )
+            m_styles[n] = style;
+    }
+
+    return true;
+}
+
+bool SCI_METHOD wxSTCLexerDocument::SetStyles(Sci_Position length, const char *styles) {
+    for ( Sci_Position i = 0; i < length; i++, m_endStyled++ ) {
+        const int n = TextIndex(m_endStyled);
+        if ( n != -1 )
+            m_styles[n] = styles[i];
+    }
+
+    return true;
+}
+
+void SCI_METHOD wxSTCLexerDocument::DecorationSetCurrentIndicator(int indicator) {
+    m_indicator = indicator;
+}
+
+void SCI_METHOD
+wxSTCLexerDocument::DecorationFillRange(Sci_Position position,
+                                        int value,
+                                        Sci_Position fillLength) {
+    const Decoration decoration = { m_indicator, position, value, fillLength };
+    m_decorations.push_back(decoration);
+}
+
+void SCI_METHOD wxSTCLexerDocument::ChangeLexerState(Sci_Position start, Sci_Position end) {
+    if ( m_lexerStateStart == -1 || start < m_lexerStateStart )
+        m_lexerStateStart = start;
+    if ( end > m_lexerStateEnd )
+        m_lexerStateEnd = end;
+}
+
+const char * SCI_METHOD wxSTCLexerDocument::BufferPointer() {
+    // We don't have the entire document text, but this is not used by any
+    // lexers anyhow.
+    return NULL;
+}
+
+int SCI_METHOD wxSTCLexerDocument::GetLineIndentation(Sci_Position line) {
+    // This is the same thing as Document::GetLineIndentation() does.
+    int indent = 0;
+    for ( int i = LineStart(line); TextIndex(i) != -1; i++ ) {
+        const char ch = CharAt(i);
+        if ( ch == ' ' )
+            indent++;
+        else if ( ch == '\t' )
+            indent = ((indent / m_tabInChars) + 1) * m_tabInChars;
+        else
+            break;
+    }
+
+    return indent;
+}
+
+Sci_Position SCI_METHOD wxSTCLexerDocument::LineEnd(Sci_Position line) const {
+    // This is the same thing as Document::LineEnd() does.
+    if ( line >= m_linesTotal - 1 )
+        return LineStart(line + 1);
+
+    int position = LineStart(line + 1);
+    if ( m_codePage == SC_CP_UTF8 ) {
+        const unsigned char bytes[] = {
+            static_cast<unsigned char>(CharAt(position-3)),
+            static_cast<unsigned char>(CharAt(position-2)),
+            static_cast<unsigned char>(CharAt(position-1)),
+        };
+        if ( UTF8IsSeparator(bytes) )
+            return position - UTF8SeparatorLength;
+        if ( UTF8IsNEL(bytes+1) )
+            return position - UTF8NELLength;
+    }
+
+    position--; // Back over CR or LF
+    // When line terminator is CR+LF, may need to go back one more
+    if ( (position > LineStart(line)) && (CharAt(position - 1) == '\r') )
+        position--;
+
+    return position;
+}
+
+int wxSTCLexerDocument::NextPosition(int position, int direction) const {
+    // This is a simplified version of Document::NextPosition() which only
+    // needs to handle UTF-8.
+    if ( position + direction <= 0 )
+        return 0;
+    if ( position + direction >= m_length )
+        return m_length;
+
+    if ( direction > 0 ) {
+        const unsigned char leadByte = static_cast<unsigned char>(CharAt(position));
+        if ( UTF8IsAscii(leadByte) )
+            return position + 1;
+
+        const int widthCharBytes = UTF8BytesOfLead[leadByte];
+        unsigned char charBytes[UTF8MaxBytes] = { leadByte, 0, 0, 0 };
+        for ( int b = 1; b < widthCharBytes; b++ )
+            charBytes[b] = static_cast<unsigned char>(CharAt(position + b));
+        const int utf8status = UTF8Classify(charBytes, widthCharBytes);
+        return position + (utf8status & UTF8MaskInvalid
+                                ? 1 : utf8status & UTF8MaskWidth);
+    }
+
+    position--;
+    if ( !UTF8IsTrailByte(static_cast<unsigned char>(CharAt(position))) )
+        return position;
+
+    // Find the lead byte of the character this trail byte belongs to, if it
+    // is a part of a valid one.
+    int start = position;
+    while ( start > 0 && position - start < UTF8MaxBytes &&
+                UTF8IsTrailByte(static_cast<unsigned char>(CharAt(start))) )
+        start--;
+
+    const unsigned char leadByte = static_cast<unsigned char>(CharAt(start));
+    const int widthCharBytes = UTF8BytesOfLead[leadByte];
+    if ( widthCharBytes == 1 || position - start >= widthCharBytes )
+        return position;
+
+    unsigned char charBytes[UTF8MaxBytes] = { leadByte, 0, 0, 0 };
+    for ( int b = 1; b < widthCharBytes; b++ )
+        charBytes[b] = static_cast<unsigned char>(CharAt(start + b));
+    if ( UTF8Classify(charBytes, widthCharBytes) & UTF8MaskInvalid )
+        return position;
+
+    return start;
+}
+
+Sci_Position SCI_METHOD
+wxSTCLexerDocument::GetRelativePosition(Sci_Position positionStart,
+                                        Sci_Position characterOffset) const {
+    // This is the same thing as Document::GetRelativePosition() does.
+    int pos = positionStart;
+    if ( m_codePage ) {
+        const int increment = (characterOffset > 0) ? 1 : -1;
+        while ( characterOffset != 0 ) {
+            const int posNext = NextPosition(pos, increment);
+            if ( posNext == pos )
+                return INVALID_POSITION;
+            pos = posNext;
+            characterOffset -= increment;
+        }
+    } else {
+        pos = positionStart + characterOffset;
+        if ( (pos < 0) || (pos > m_length) )
+            return INVALID_POSITION;
+    }
+
+    return pos;
+}
+
+int SCI_METHOD
+wxSTCLexerDocument::GetCharacterAndWidth(Sci_Position position,
+                                         Sci_Position *pWidth) const {
+    // This is the same thing as Document::GetCharacterAndWidth() does for
+    // the single byte and UTF-8 encodings.
+    int character;
+    int bytesInCharacter = 1;
+    const unsigned char leadByte = static_cast<unsigned char>(CharAt(position));
+    if ( m_codePage == SC_CP_UTF8 && !UTF8IsAscii(leadByte) ) {
+        const int widthCharBytes = UTF8BytesOfLead[leadByte];
+        unsigned char charBytes[UTF8MaxBytes] = { leadByte, 0, 0, 0 };
+        for ( int b = 1; b < widthCharBytes; b++ )
+            charBytes[b] = static_cast<unsigned char>(CharAt(position + b));
+        const int utf8status = UTF8Classify(charBytes, widthCharBytes);
+        if ( utf8status & UTF8MaskInvalid ) {
+            // Report as singleton surrogate values which are invalid Unicode
+            character = 0xDC80 + leadByte;
+        } else {
+            bytesInCharacter = utf8status & UTF8MaskWidth;
+            character = UnicodeFromUTF8(charBytes);
+        }
+    } else {
+        character = leadByte;
+    }
+
+    if ( pWidth )
+        *pWidth = bytesInCharacter;
+
+    return character;
+}
+
+// The thread running the lexer on wxSTCLexerDocument and notifying the main
+// thread about it by sending wxThreadEvent with the time taken, in ms, to the
+// given handler when it's done.
+class wxSTCLexerThread : public wxThread {
+public:
+    wxSTCLexerThread(wxEvtHandler* handler, ILexer* lexer, wxSTCLexerDocument* doc)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler),
+          m_lexer(lexer),
+          m_doc(doc) {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE {
+        wxStopWatch sw;
+        m_doc->Colourise(m_lexer);
+
+        wxThreadEvent* const event = new wxThreadEvent;
+        event->SetInt(sw.Time());
+        wxQueueEvent(m_handler, event);
+
+        return 0;
+    }
+
+private:
+    wxEvtHandler* const m_handler;
+    ILexer* const m_lexer;
+    wxSTCLexerDocument* const m_doc;
+
+    wxDECLARE_NO_COPY_CLASS(wxSTCLexerThread);
+};
+
+#endif // wxHAS_STC_BACKGROUND_LEXING
+
+#ifdef wxHAS_STC_BACKGROUND_LOADING
+
+#define TRACE_STC_LOADING wxT("stcloading")
+
+namespace
+{
+
+// The amount of data read from the file at once, which is also all the memory
+// needed for loading it in addition to the document itself.
+const size_t LOADER_CHUNK_SIZE = 1024*1024;
+
+} // anonymous namespace
+
+// The thread reading the file in chunks and adding them to the document being
+// loaded, which is not used by anything else until it's done. Scintilla
+// computes the line starts as the data is added, so this is done in this
+// thread too. When it's done, wxThreadEvent with the result, 1 or 0, and the
+// time taken, in ms, as extra long is sent to the given handler.
+class wxSTCLoaderThread : public wxThread {
+public:
+    // Takes ownership of the file, which must be positioned at its start.
+    wxSTCLoaderThread(wxEvtHandler* handler, ILoader* loader, wxFile& file)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler),
+          m_loader(loader),
+          m_eolMode(-1) {
+        m_file.Attach(file.Detach());
+    }
+
+    // Return the EOL mode used by the first line of the file or -1 if it
+    // doesn't have any EOLs, this can only be called once the thread exited.
+    int GetEOLMode() const { return m_eolMode; }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE {
+        wxStopWatch sw;
+        const bool ok = Load();
+
+        wxThreadEvent* const event = new wxThreadEvent;
+        event->SetInt(ok);
+        event->SetExtraLong(sw.Time());
+        wxQueueEvent(m_handler, event);
+
+        return 0;
+    }
+
+private:
+    bool Load();
+
+    wxEvtHandler* const m_handler;
+    ILoader* const m_loader;
+    wxFile m_file;
+    int m_eolMode;
+
+    wxDECLARE_NO_COPY_CLASS(wxSTCLoaderThread);
+};
+
+bool wxSTCLoaderThread::Load() {
+    wxScopedArray<char> buf(LOADER_CHUNK_SIZE);
+    bool first = true;
+    char last = '\0';
+    for ( ;; ) {
+        // Stop as soon as possible if loading was cancelled.
+        if ( TestDestroy() )
+            return false;
+
+        const ssize_t count = m_file.Read(buf.get(), LOADER_CHUNK_SIZE);
+        if ( count == wxInvalidOffset )
+            return false;
+        if ( !count )
+            return true;
+
+        char* data = buf.get();
+        size_t length = count;
+        if ( first ) {
+            // Skip the UTF-8 BOM, as wxConvAuto used by LoadFile() does.
+            if ( length >= 3 && memcmp(data, "\xef\xbb\xbf", 3) == 0 ) {
+                data += 3;
+                length -= 3;
+            }
+
+            first = false;
+        }
+
+        // Detect the EOL in the same way as LoadFile() does, i.e. using the
+        // first line only.
+        if ( m_eolMode == -1 ) {
+            const char* const
+                lf = static_cast<const char *>(memchr(data, '\n', length));
+            if ( lf ) {
+                const char prev = lf > data ? lf[-1] : last;
+                m_eolMode = prev == '\r' ? SC_EOL_CRLF : SC_EOL_LF;
+            }
+        }
+
+        if ( length ) {
+            last = data[length - 1];
+
+            if ( m_loader->AddData(data, length) != SC_STATUS_OK )
+                return false;
+        }
+    }
+}
+
+#endif // wxHAS_STC_BACKGROUND_LOADING
+
 
 #if wxUSE_DRAG_AND_DROP
 bool wxSTCDropTarget::OnDropText(wxCoord x, wxCoord y, const wxString& data) {
@@ -251,6 +898,25 @@ ScintillaWX::ScintillaWX(wxStyledTextCtrl* win) {
     stc   = win;
     wheelVRotation = 0;
     wheelHRotation = 0;
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+    lexerLanguage = SCLEX_CONTAINER;
+    lexerConfigKnown = true;
+    lexerConfigVersion = 0;
+    backgroundLexing = false;
+    lexerInstance = NULL;
+    lexerInstanceVersion = 0;
+    lexerModifiedFrom = INT_MAX;
+    lexerDoc = NULL;
+    lexerThread = NULL;
+    lexerTimeWorker =
+    lexerTimeMain = 0;
+    lexerEvtHandler.Bind(wxEVT_THREAD, &ScintillaWX::OnBackgroundLexingDone, this);
+#endif // wxHAS_STC_BACKGROUND_LEXING
+#ifdef wxHAS_STC_BACKGROUND_LOADING
+    loader = NULL;
+    loaderThread = NULL;
+    loaderEvtHandler.Bind(wxEVT_THREAD, &ScintillaWX::OnLoadingFileDone, this);
+#endif // wxHAS_STC_BACKGROUND_LOADING
     Initialise();
 #ifdef __WXMSW__
     sysCaretBitmap = 0;
@@ -279,6 +945,16 @@ ScintillaWX::ScintillaWX(wxStyledTextCtrl* win) {
 
 
 ScintillaWX::~ScintillaWX() {
+#ifdef wxHAS_STC_BACKGROUND_LOADING
+    StopLoadingFile();
+#endif // wxHAS_STC_BACKGROUND_LOADING
+
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+    StopBackgroundLexing();
+    if ( lexerInstance )
+        lexerInstance->Release();
+#endif // wxHAS_STC_BACKGROUND_LEXING
+
     for ( TimersHash::iterator i=timers.begin(); i!=timers.end(); ++i ) {
         delete i->second;
     }
@@ -485,6 +1161,18 @@ bool ScintillaWX::ModifyScrollBars(int nMax, int nPage) {
 }
 
 
+void ScintillaWX::NotifyModified(Document *document, DocModification mh, void *userData) {
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+    if ( mh.modificationType & (SC_MOD_INSERTTEXT | SC_MOD_DELETETEXT) ) {
+        if ( mh.position < lexerModifiedFrom )
+            lexerModifiedFrom = mh.position;
+    }
+#endif // wxHAS_STC_BACKGROUND_LEXING
+
+    ScintillaBase::NotifyModified(document, mh, userData);
+}
+
+
 void ScintillaWX::NotifyChange() {
     stc->NotifyChange();
 }
@@ -864,6 +1552,24 @@ sptr_t ScintillaWX::WndProc(unsigned int iMessage, uptr_t wParam, sptr_t lParam)
             LexerManager::GetInstance()->Load((const char*)lParam);
             break;
 #endif
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+      case SCI_SETLEXER:
+      case SCI_SETLEXERLANGUAGE:
+      case SCI_SETPROPERTY:
+      case SCI_SETKEYWORDS:
+      case SCI_SETDOCPOINTER:
+      case SCI_SETCODEPAGE:
+      case SCI_SETLINEENDTYPESALLOWED:
+      case SCI_PRIVATELEXERCALL:
+      case SCI_ALLOCATESUBSTYLES:
+      case SCI_SETIDENTIFIERS:
+      case SCI_FREESUBSTYLES: {
+            const sptr_t rc = ScintillaBase::WndProc(iMessage, wParam, lParam);
+            UpdateLexerConfig(iMessage, wParam, lParam);
+            return rc;
+      }
+#endif // wxHAS_STC_BACKGROUND_LEXING
+
       case SCI_GETDIRECTFUNCTION:
             return reinterpret_cast<sptr_t>(DirectFunction);
 
@@ -1233,12 +1939,413 @@ void ScintillaWX::DoMouseCaptureLost()
 
 void ScintillaWX::DoOnIdle(wxIdleEvent& evt) {
 
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+    // Do the styling which Scintilla would do in idle time in the background
+    // thread instead, if possible.
+    if ( needIdleStyling && CanLexInBackground() ) {
+        needIdleStyling = false;
+        StartBackgroundLexing();
+    }
+#endif // wxHAS_STC_BACKGROUND_LEXING
+
     if ( Idle() )
         evt.RequestMore();
     else
         SetIdle(false);
 }
 
+//----------------------------------------------------------------------
+// Background lexing
+
+void ScintillaWX::EnableBackgroundLexing(bool enable) {
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+    if ( enable == backgroundLexing )
+        return;
+
+    backgroundLexing = enable;
+    if ( !enable ) {
+        StopBackgroundLexing();
+
+        // Let Scintilla finish styling the document itself, if necessary.
+        StartIdleStyling(false);
+    }
+#else
+    wxUnusedVar(enable);
+#endif
+}
+
+bool ScintillaWX::IsBackgroundLexingEnabled() const {
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+    return backgroundLexing;
+#else
+    return false;
+#endif
+}
+
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+
+void ScintillaWX::UpdateLexerConfig(unsigned int iMessage, uptr_t wParam, sptr_t lParam) {
+    switch ( iMessage ) {
+        case SCI_SETLEXER:
+        case SCI_SETLEXERLANGUAGE: {
+            // Changing the lexer creates its new instance, which doesn't have
+            // any properties nor keywords, but setting the same lexer again
+            // doesn't do anything.
+            const int language = ScintillaBase::WndProc(SCI_GETLEXER, 0, 0);
+            if ( language != lexerLanguage ) {
+                lexerLanguage = language;
+                lexerProperties.clear();
+                for ( int n = 0; n <= KEYWORDSET_MAX; n++ )
+                    lexerKeyWords[n].clear();
+                lexerConfigKnown = true;
+            }
+            break;
+        }
+
+        case SCI_SETPROPERTY:
+            lexerProperties[reinterpret_cast<const char *>(wParam)] =
+                lParam ? reinterpret_cast<const char *>(lParam) : "";
+            break;
+
+        case SCI_SETKEYWORDS:
+            if ( wParam <= KEYWORDSET_MAX ) {
+                lexerKeyWords[wParam] =
+                    lParam ? reinterpret_cast<const char *>(lParam) : "";
+            }
+            break;
+
+        case SCI_SETDOCPOINTER:
+            // The lexer is associated with the document and we don't know
+            // how it was configured for the new one.
+            lexerLanguage = ScintillaBase::WndProc(SCI_GETLEXER, 0, 0);
+            lexerConfigKnown = false;
+            break;
+
+        case SCI_PRIVATELEXERCALL:
+        case SCI_ALLOCATESUBSTYLES:
+        case SCI_SETIDENTIFIERS:
+        case SCI_FREESUBSTYLES:
+            // We can't replicate the effect of these calls on another lexer
+            // instance.
+            lexerConfigKnown = false;
+            break;
+    }
+
+    // Any results obtained with the old configuration are invalid now.
+    lexerConfigVersion++;
+}
+
+bool ScintillaWX::CanLexInBackground() {
+    if ( !backgroundLexing || !lexerConfigKnown )
+        return false;
+
+    // Only single byte and UTF-8 encodings are supported by
+    // wxSTCLexerDocument.
+    if ( pdoc->dbcsCodePage && pdoc->dbcsCodePage != SC_CP_UTF8 )
+        return false;
+
+    // This excludes the container lexer too.
+    return Catalogue::Find(lexerLanguage) != NULL;
+}
+
+void ScintillaWX::StartBackgroundLexing() {
+    // If the thread is already running, we'll continue when it's done.
+    if ( lexerThread )
+        return;
+
+    const int endGoal = idleStyling >= SC_IDLESTYLING_AFTERVISIBLE
+                            ? pdoc->Length()
+                            : PositionAfterArea(GetClientRectangle());
+    if ( pdoc->GetEndStyled() >= endGoal ) {
+        if ( lexerTimeWorker || lexerTimeMain ) {
+            wxLogTrace(TRACE_STC_LEXING,
+                       "Lexing took %ldms in the background thread and "
+                       "%ldms in the main one.",
+                       lexerTimeWorker, lexerTimeMain);
+
+            lexerTimeWorker =
+            lexerTimeMain = 0;
+        }
+        return;
+    }
+
+    if ( !CanLexInBackground() ) {
+        // Let Scintilla do it in the main thread as usual.
+        StartIdleStyling(false);
+        return;
+    }
+
+    if ( !lexerInstance || lexerInstanceVersion != lexerConfigVersion ) {
+        if ( lexerInstance )
+            lexerInstance->Release();
+
+        lexerInstance = Catalogue::Find(lexerLanguage)->Create();
+        for ( LexerProperties::const_iterator it = lexerProperties.begin();
+              it != lexerProperties.end();
+              ++it ) {
+            lexerInstance->PropertySet(it->first.c_str(), it->second.c_str());
+        }
+        for ( int n = 0; n <= KEYWORDSET_MAX; n++ ) {
+            if ( !lexerKeyWords[n].empty() )
+                lexerInstance->WordListSet(n, lexerKeyWords[n].c_str());
+        }
+
+        lexerInstanceVersion = lexerConfigVersion;
+    }
+
+    // Lex the document from the first unstyled line, whether the preceding
+    // text was styled by our lexer instance or by the one used by Scintilla,
+    // in chunks consisting of whole lines: as for Scintilla own idle styling,
+    // the lexer only depends on the styles and line states before the start.
+    const int start = pdoc->LineStart(pdoc->LineFromPosition(pdoc->GetEndStyled()));
+    int end = pdoc->Length();
+    if ( end - start > LEXER_CHUNK_SIZE )
+        end = pdoc->LineStart(pdoc->LineFromPosition(start + LEXER_CHUNK_SIZE) + 1);
+
+    wxStopWatch sw;
+    lexerDoc = new wxSTCLexerDocument(pdoc, start, end);
+    lexerTimeMain += sw.Time();
+
+    lexerModifiedFrom = INT_MAX;
+
+    lexerThread = new wxSTCLexerThread(&lexerEvtHandler, lexerInstance, lexerDoc);
+    if ( lexerThread->Run() != wxTHREAD_NO_ERROR ) {
+        wxLogDebug("Failed to start the lexer thread.");
+
+        delete lexerThread;
+        lexerThread = NULL;
+        delete lexerDoc;
+        lexerDoc = NULL;
+
+        backgroundLexing = false;
+        StartIdleStyling(false);
+    }
+}
+
+void ScintillaWX::StopBackgroundLexing() {
+    if ( lexerThread ) {
+        lexerThread->Wait();
+        delete lexerThread;
+        lexerThread = NULL;
+
+        delete lexerDoc;
+        lexerDoc = NULL;
+
+        // Don't process the notification from the thread we've just stopped.
+        lexerEvtHandler.DeletePendingEvents();
+    }
+}
+
+void ScintillaWX::OnBackgroundLexingDone(wxThreadEvent& event) {
+    if ( !lexerThread )
+        return;
+
+    lexerThread->Wait();
+    delete lexerThread;
+    lexerThread = NULL;
+
+    lexerTimeWorker += event.GetInt();
+
+    wxScopedPtr<wxSTCLexerDocument> doc(lexerDoc);
+    lexerDoc = NULL;
+
+    if ( lexerInstanceVersion != lexerConfigVersion ) {
+        wxLogTrace(TRACE_STC_LEXING,
+                   "Discarding lexing results after configuration change.");
+    } else {
+        // The results are valid only for the lines before the first one
+        // modified since we started.
+        int upTo = doc->GetEnd();
+        if ( lexerModifiedFrom < upTo ) {
+            upTo = lexerModifiedFrom > doc->GetStart()
+                    ? doc->GetLineStartOf(lexerModifiedFrom)
+                    : doc->GetStart();
+
+            wxLogTrace(TRACE_STC_LEXING,
+                       "Discarding lexing results after %d because of "
+                       "modification at %d.",
+                       upTo, lexerModifiedFrom);
+        }
+
+        if ( upTo > doc->GetStart() ) {
+            wxStopWatch sw;
+            doc->Merge(pdoc, upTo);
+            lexerTimeMain += sw.Time();
+        }
+    }
+
+    doc.reset();
+
+    // Continue with the next chunk, if necessary.
+    StartBackgroundLexing();
+}
+
+#endif // wxHAS_STC_BACKGROUND_LEXING
+
+//----------------------------------------------------------------------
+// Background loading
+
+bool ScintillaWX::LoadFileInBackground(const wxString& filename) {
+#ifdef wxHAS_STC_BACKGROUND_LOADING
+    StopLoadingFile();
+
+    wxFile file;
+    if ( !file.Open(filename) )
+        return false;
+
+    // The file contents is used as is, so the files starting with a BOM
+    // indicating that they need to be converted are loaded in the usual way
+    // below, as are the files too big for Scintilla to handle.
+    char bom[4];
+    const ssize_t bomLength = file.Read(bom, WXSIZEOF(bom));
+    const wxBOM bomType = bomLength == wxInvalidOffset
+                            ? wxBOM_Unknown
+                            : wxConvAuto::DetectBOM(bom, bomLength);
+    const wxFileOffset length = file.Length();
+    if ( (bomType == wxBOM_None || bomType == wxBOM_UTF8) &&
+            length != wxInvalidOffset && length < INT_MAX &&
+                file.Seek(0) == 0 ) {
+        loader = reinterpret_cast<ILoader *>(
+                    WndProc(SCI_CREATELOADER, static_cast<uptr_t>(length), 0));
+        loaderFileName = filename;
+
+        loaderThread = new wxSTCLoaderThread(&loaderEvtHandler, loader, file);
+        if ( loaderThread->Run() == wxTHREAD_NO_ERROR )
+            return true;
+
+        wxLogDebug("Failed to start the loader thread.");
+
+        delete loaderThread;
+        loaderThread = NULL;
+
+        loader->Release();
+        loader = NULL;
+    }
+
+    file.Close();
+#endif // wxHAS_STC_BACKGROUND_LOADING
+
+    if ( !stc->LoadFile(filename) )
+        return false;
+
+    SendFileLoadedEvent(filename, true);
+    return true;
+}
+
+bool ScintillaWX::IsLoadingFile() const {
+#ifdef wxHAS_STC_BACKGROUND_LOADING
+    return loaderThread != NULL;
+#else
+    return false;
+#endif
+}
+
+void ScintillaWX::SendFileLoadedEvent(const wxString& filename, bool ok) {
+    // This event is always sent asynchronously, even when the file was loaded
+    // synchronously, for consistency.
+    wxStyledTextEvent evt(wxEVT_STC_FILE_LOADED, stc->GetId());
+    evt.SetEventObject(stc);
+    evt.SetString(filename);
+    evt.SetInt(ok);
+    wxPostEvent(stc->GetEventHandler(), evt);
+}
+
+#ifdef wxHAS_STC_BACKGROUND_LOADING
+
+void ScintillaWX::StopLoadingFile() {
+    if ( loaderThread ) {
+        // This makes TestDestroy() return true in the thread and waits until
+        // it exits.
+        loaderThread->Delete();
+        delete loaderThread;
+        loaderThread = NULL;
+
+        loader->Release();
+        loader = NULL;
+
+        // Don't process the notification from the thread we've just stopped.
+        loaderEvtHandler.DeletePendingEvents();
+    }
+}
+
+void ScintillaWX::OnLoadingFileDone(wxThreadEvent& event) {
+    if ( !loaderThread )
+        return;
+
+    loaderThread->Wait();
+    const int eolMode = loaderThread->GetEOLMode();
+    delete loaderThread;
+    loaderThread = NULL;
+
+    Document* const doc = static_cast<Document *>(loader->ConvertToDocument());
+    loader = NULL;
+
+    const bool ok = event.GetInt() != 0;
+    if ( ok ) {
+        wxStopWatch sw;
+
+        // Preserve the settings stored in the document being replaced.
+        doc->SetDBCSCodePage(pdoc->dbcsCodePage);
+        doc->eolMode = eolMode == -1 ? pdoc->eolMode : eolMode;
+        doc->tabInChars = pdoc->tabInChars;
+        doc->indentInChars = pdoc->indentInChars;
+        doc->actualIndentInChars = pdoc->actualIndentInChars;
+        doc->useTabs = pdoc->useTabs;
+        doc->tabIndents = pdoc->tabIndents;
+        doc->backspaceUnindents = pdoc->backspaceUnindents;
+        doc->SetUndoCollection(pdoc->IsCollectingUndo());
+        doc->SetReadOnly(pdoc->IsReadOnly());
+
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+        // The lexer is associated with the document too, so configure it in
+        // the same way for the new one, if we know how to do it.
+        const bool lexerKnown = lexerConfigKnown;
+        const int language = lexerLanguage;
+        const LexerProperties properties(lexerProperties);
+        std::string keyWords[KEYWORDSET_MAX + 1];
+        for ( int n = 0; n <= KEYWORDSET_MAX; n++ )
+            keyWords[n] = lexerKeyWords[n];
+#endif // wxHAS_STC_BACKGROUND_LEXING
+
+        WndProc(SCI_SETDOCPOINTER, 0, reinterpret_cast<sptr_t>(doc));
+
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+        if ( lexerKnown ) {
+            WndProc(SCI_SETLEXER, language, 0);
+            for ( LexerProperties::const_iterator it = properties.begin();
+                  it != properties.end();
+                  ++it ) {
+                WndProc(SCI_SETPROPERTY,
+                        reinterpret_cast<uptr_t>(it->first.c_str()),
+                        reinterpret_cast<sptr_t>(it->second.c_str()));
+            }
+            for ( int n = 0; n <= KEYWORDSET_MAX; n++ ) {
+                if ( !keyWords[n].empty() ) {
+                    WndProc(SCI_SETKEYWORDS, n,
+                            reinterpret_cast<sptr_t>(keyWords[n].c_str()));
+                }
+            }
+
+            lexerConfigKnown = true;
+        }
+#endif // wxHAS_STC_BACKGROUND_LEXING
+
+        WndProc(SCI_SETSAVEPOINT, 0, 0);
+
+        wxLogTrace(TRACE_STC_LOADING,
+                   "Loading \"%s\" took %ldms in the background thread and "
+                   "%ldms in the main one.",
+                   loaderFileName, event.GetExtraLong(), sw.Time());
+    }
+
+    // The document is referenced by the editor now, if it was used at all.
+    doc->Release();
+
+    SendFileLoadedEvent(loaderFileName, ok);
+}
+
+#endif // wxHAS_STC_BACKGROUND_LOADING
+
 //----------------------------------------------------------------------
 
 #if wxUSE_DRAG_AND_DROP
@@ -74,6 +74,24 @@
 #include "wx/timer.h"
 #endif
 
+// Lexing in a background thread requires both threads and the lexers.
+#if wxUSE_THREADS && defined(SCI_LEXER)
+    #define wxHAS_STC_BACKGROUND_LEXING
+
+    #include "wx/thread.h"
+
+    #include <map>
+    #include <string>
+#endif
+
+// Loading files in a background thread only requires threads.
+#if wxUSE_THREADS && wxUSE_FILE
+    #define wxHAS_STC_BACKGROUND_LOADING
+
+    #include "wx/file.h"
+    #include "wx/thread.h"
+#endif
+
 // Define this if there is a standard clipboard format for rectangular
 // text selection under the current platform.
 #if defined(__WXMSW__) || defined(__WXGTK__)
@@ -88,6 +106,13 @@ class WXDLLIMPEXP_FWD_STC wxStyledTextCtrl;           // forward
 class ScintillaWX;
 class wxSTCTimer;
 class SurfaceData;
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+class wxSTCLexerDocument;
+class wxSTCLexerThread;
+#endif
+#ifdef wxHAS_STC_BACKGROUND_LOADING
+class wxSTCLoaderThread;
+#endif
 
 //----------------------------------------------------------------------
 // Helper classes
@@ -143,6 +168,7 @@ public:
                            uptr_t wParam,
                            sptr_t lParam) wxOVERRIDE;
 
+    virtual void NotifyModified(Document *document, DocModification mh, void *userData) wxOVERRIDE;
     virtual void NotifyChange() wxOVERRIDE;
     virtual void NotifyParent(SCNotification scn) wxOVERRIDE;
 
@@ -201,6 +227,10 @@ public:
     void SetPaintAbandoned(){paintState = paintAbandoned;}
     void DoMarkerDefineBitmap(int markerNumber, const wxBitmap& bmp);
     void DoRegisterImage(int type, const wxBitmap& bmp);
+    void EnableBackgroundLexing(bool enable);
+    bool IsBackgroundLexingEnabled() const;
+    bool LoadFileInBackground(const wxString& filename);
+    bool IsLoadingFile() const;
 
 private:
     bool                capturedMouse;
@@ -226,6 +256,55 @@ private:
 
     static sptr_t DirectFunction(ScintillaWX* swx, unsigned int iMessage,
                                  uptr_t wParam, sptr_t lParam);
+
+    void SendFileLoadedEvent(const wxString& filename, bool ok);
+
+#ifdef wxHAS_STC_BACKGROUND_LEXING
+    // Background lexing helpers.
+    void UpdateLexerConfig(unsigned int iMessage, uptr_t wParam, sptr_t lParam);
+    bool CanLexInBackground();
+    void StartBackgroundLexing();
+    void StopBackgroundLexing();
+    void OnBackgroundLexingDone(wxThreadEvent& event);
+
+    // The lexer used in the background thread is a different instance of
+    // the lexer used by the document, configured in the same way, so we need
+    // to remember its configuration.
+    typedef std::map<std::string, std::string> LexerProperties;
+    int                 lexerLanguage;
+    LexerProperties     lexerProperties;
+    std::string         lexerKeyWords[KEYWORDSET_MAX + 1];
+    bool                lexerConfigKnown;
+    int                 lexerConfigVersion;
+
+    bool                backgroundLexing;
+    ILexer*             lexerInstance;
+    int                 lexerInstanceVersion;
+
+    // The smallest position modified since the current lexerDoc creation.
+    int                 lexerModifiedFrom;
+
+    wxSTCLexerDocument* lexerDoc;
+    wxSTCLexerThread*   lexerThread;
+    wxEvtHandler        lexerEvtHandler;
+
+    // Time spent lexing the document during the current pass, in ms.
+    long                lexerTimeWorker;
+    long                lexerTimeMain;
+#endif // wxHAS_STC_BACKGROUND_LEXING
+
+#ifdef wxHAS_STC_BACKGROUND_LOADING
+    // Background loading helpers.
+    void StopLoadingFile();
+    void OnLoadingFileDone(wxThreadEvent& event);
+
+    // The document being loaded, its file name and the thread loading it.
+    ILoader*            loader;
+    wxString            loaderFileName;
+    wxSTCLoaderThread*  loaderThread;
+    wxEvtHandler        loaderEvtHandler;
+#endif // wxHAS_STC_BACKGROUND_LOADING
+
 #ifdef __WXMSW__
     HBITMAP sysCaretBitmap;
     int sysCaretWidth;
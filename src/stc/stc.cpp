@@ -136,6 +136,7 @@ wxDEFINE_EVENT( wxEVT_STC_CLIPBOARD_COPY, wxStyledTextEvent );
 wxDEFINE_EVENT( wxEVT_STC_CLIPBOARD_PASTE, wxStyledTextEvent );
 wxDEFINE_EVENT( wxEVT_STC_AUTOCOMP_COMPLETED, wxStyledTextEvent );
 wxDEFINE_EVENT( wxEVT_STC_MARGIN_RIGHT_CLICK, wxStyledTextEvent );
+wxDEFINE_EVENT( wxEVT_STC_FILE_LOADED, wxStyledTextEvent );
 
 
 wxBEGIN_EVENT_TABLE(wxStyledTextCtrl, wxControl)
@@ -5032,6 +5033,25 @@ bool wxStyledTextCtrl::GetUseAntiAliasing() {
     return m_swx->GetUseAntiAliasing();
 }
 
+void wxStyledTextCtrl::EnableBackgroundLexing(bool enable) {
+    m_swx->EnableBackgroundLexing(enable);
+}
+
+bool wxStyledTextCtrl::IsBackgroundLexingEnabled() const {
+    return m_swx->IsBackgroundLexingEnabled();
+}
+
+bool wxStyledTextCtrl::LoadFileInBackground(const wxString& filename) {
+    if ( filename.empty() )
+        return false;
+
+    return m_swx->LoadFileInBackground(filename);
+}
+
+bool wxStyledTextCtrl::IsLoadingFile() const {
+    return m_swx->IsLoadingFile();
+}
+
 void wxStyledTextCtrl::AnnotationClearLine(int line) {
     SendMsg(SCI_ANNOTATIONSETTEXT, line, (sptr_t)NULL);
 }
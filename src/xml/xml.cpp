@@ -30,6 +30,7 @@
 #include "wx/strconv.h"
 #include "wx/scopedptr.h"
 #include "wx/versioninfo.h"
+#include "wx/vector.h"
 
 #include "expat.h" // from Expat
 
@@ -668,7 +669,8 @@ bool wxIsWhiteOnly(const wxString& buf)
 struct wxXmlParsingContext
 {
     wxXmlParsingContext()
-        : conv(NULL),
+        : doc(NULL),
+          conv(NULL),
           node(NULL),
           lastChild(NULL),
           lastAsText(NULL),
@@ -677,10 +679,13 @@ struct wxXmlParsingContext
     {}
 
     XML_Parser parser;
+    wxXmlDocument *doc;                 // the document being loaded
     wxMBConv  *conv;
     wxXmlNode *node;                    // the node being parsed
     wxXmlNode *lastChild;               // the last child of "node"
     wxXmlNode *lastAsText;              // the last _text_ child of "node"
+    wxVector<wxXmlNode*> prevSiblings;  // the previous siblings of "node"
+                                        // and of all its ancestors
     wxString   encoding;
     wxString   version;
     wxXmlDoctype *doctype;
@@ -713,6 +718,7 @@ static void StartElementHnd(void *userData, const char *name, const char **atts)
 
     ASSERT_LAST_CHILD_OK(ctx);
     ctx->node->InsertChildAfter(node, ctx->lastChild);
+    ctx->prevSiblings.push_back(ctx->lastChild);
     ctx->lastAsText = NULL;
     ctx->lastChild = NULL; // our new node "node" has no children yet
 
@@ -726,10 +732,29 @@ static void EndElementHnd(void *userData, const char* WXUNUSED(name))
     // we're exiting the last children of ctx->node->GetParent() and going
     // back one level up, so current value of ctx->node points to the last
     // child of ctx->node->GetParent()
-    ctx->lastChild = ctx->node;
+    wxXmlNode * const node = ctx->node;
+    ctx->lastChild = node;
 
-    ctx->node = ctx->node->GetParent();
+    wxXmlNode * const prev = ctx->prevSiblings.back();
+    ctx->prevSiblings.pop_back();
+
+    ctx->node = node->GetParent();
     ctx->lastAsText = NULL;
+
+    if ( ctx->doc->OnElementLoaded(node) )
+    {
+        // the node was processed and is not needed any more, so remove it
+        // and make its previous sibling the last child again, without
+        // walking over all of them as RemoveChild() would do
+        if ( prev )
+            prev->SetNext(NULL);
+        else
+            ctx->node->SetChildren(NULL);
+
+        delete node;
+
+        ctx->lastChild = prev;
+    }
 }
 
 static void TextHnd(void *userData, const char *s, int len)
@@ -896,6 +921,7 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
     wxXmlNode *root = new wxXmlNode(wxXML_DOCUMENT_NODE, wxEmptyString);
 
     ctx.encoding = wxS("UTF-8"); // default in absence of encoding=""
+    ctx.doc = this;
     ctx.conv = NULL;
 #if !wxUSE_UNICODE
     if ( encoding.CmpNoCase(wxS("UTF-8")) != 0 )
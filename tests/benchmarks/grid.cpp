@@ -0,0 +1,245 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/grid.cpp
+// Purpose:     wxGrid benchmarks
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/bitmap.h"
+#include "wx/dcmemory.h"
+#include "wx/grid.h"
+
+#include "bench.h"
+
+namespace
+{
+
+// The grid used by the benchmarks below has this many cells with custom
+// attributes.
+const int NUM_ROWS = 1000;
+const int NUM_COLS = 100;
+
+// The size of the viewport "painted" by the benchmarks, in cells.
+const int VIEW_ROWS = 40;
+const int VIEW_COLS = 15;
+
+wxGrid *gs_grid = NULL;
+
+bool InitGridWithAttrs()
+{
+    gs_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+    gs_grid->CreateGrid(NUM_ROWS, NUM_COLS);
+
+    for ( int row = 0; row < NUM_ROWS; row++ )
+    {
+        for ( int col = 0; col < NUM_COLS; col++ )
+        {
+            gs_grid->SetCellBackgroundColour(row, col,
+                                             (row + col) % 2 ? *wxLIGHT_GREY
+                                                             : *wxWHITE);
+        }
+    }
+
+    return true;
+}
+
+// The grid used for the selection benchmarks is bigger but doesn't have any
+// attributes.
+const int NUM_ROWS_SEL = 100000;
+const int NUM_COLS_SEL = 10;
+
+bool InitGridForSelection()
+{
+    gs_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+    gs_grid->CreateGrid(NUM_ROWS_SEL, NUM_COLS_SEL);
+
+    return true;
+}
+
+// The grid used for the auto-sizing benchmarks has many rows with values of
+// different lengths, some of which occur many times.
+const int NUM_ROWS_AUTOSIZE = 100000;
+const int NUM_COLS_AUTOSIZE = 5;
+
+bool InitGridForAutoSize()
+{
+    gs_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+    gs_grid->CreateGrid(NUM_ROWS_AUTOSIZE, NUM_COLS_AUTOSIZE);
+
+    for ( int row = 0; row < NUM_ROWS_AUTOSIZE; row++ )
+    {
+        for ( int col = 0; col < NUM_COLS_AUTOSIZE; col++ )
+        {
+            gs_grid->SetCellValue(row, col,
+                                  wxString('x', (row * (col + 1)) % 37));
+        }
+    }
+
+    return true;
+}
+
+// The grid used for the row geometry benchmarks uses a virtual table with a
+// huge number of rows.
+const int NUM_ROWS_HUGE = 10000000;
+
+class HugeGridTable : public wxGridTableBase
+{
+public:
+    HugeGridTable() { }
+
+    virtual int GetNumberRows() wxOVERRIDE { return NUM_ROWS_HUGE; }
+    virtual int GetNumberCols() wxOVERRIDE { return 5; }
+    virtual wxString GetValue(int WXUNUSED(row), int WXUNUSED(col)) wxOVERRIDE
+        { return wxString(); }
+    virtual void SetValue(int WXUNUSED(row), int WXUNUSED(col),
+                          const wxString& WXUNUSED(value)) wxOVERRIDE { }
+};
+
+bool InitHugeGrid()
+{
+    gs_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+    gs_grid->SetTable(new HugeGridTable, true /* take ownership */);
+
+    return true;
+}
+
+void DoneGrid()
+{
+    delete gs_grid;
+    gs_grid = NULL;
+}
+
+} // anonymous namespace
+
+// Retrieve the attributes of all the cells of a viewport in the middle of the
+// grid, as is done when painting it.
+BENCHMARK_FUNC_WITH_INIT(GridGetCellAttr, InitGridWithAttrs, DoneGrid)
+{
+    const int top = NUM_ROWS / 2;
+    const int left = NUM_COLS / 2;
+
+    bool ok = true;
+    for ( int row = top; row < top + VIEW_ROWS; row++ )
+    {
+        for ( int col = left; col < left + VIEW_COLS; col++ )
+        {
+            wxGridCellAttr* const attr = gs_grid->GetOrCreateCellAttr(row, col);
+            ok &= attr->HasBackgroundColour();
+            attr->DecRef();
+        }
+    }
+
+    return ok;
+}
+
+// Really draw all the cells of the viewport.
+BENCHMARK_FUNC_WITH_INIT(GridDrawViewport, InitGridWithAttrs, DoneGrid)
+{
+    const int top = NUM_ROWS / 2;
+    const int left = NUM_COLS / 2;
+
+    wxBitmap bmp(gs_grid->GetColSize(0)*VIEW_COLS,
+                 gs_grid->GetRowSize(0)*VIEW_ROWS);
+    wxMemoryDC dc(bmp);
+    const wxRect rectTopLeft = gs_grid->CellToRect(top, left);
+    dc.SetDeviceOrigin(-rectTopLeft.x, -rectTopLeft.y);
+
+    for ( int row = top; row < top + VIEW_ROWS; row++ )
+    {
+        for ( int col = left; col < left + VIEW_COLS; col++ )
+        {
+            gs_grid->DrawCell(dc, wxGridCellCoords(row, col));
+        }
+    }
+
+    return dc.IsOk();
+}
+
+// Select many individual cells, as if ctrl-clicking them, and check which
+// cells of a viewport are selected.
+BENCHMARK_FUNC_WITH_INIT(GridSelectCells, InitGridForSelection, DoneGrid)
+{
+    gs_grid->ClearSelection();
+
+    for ( int row = 0; row < NUM_ROWS_SEL; row += 10 )
+    {
+        gs_grid->SelectBlock(row, row % NUM_COLS_SEL,
+                             row, row % NUM_COLS_SEL,
+                             true /* add to selection */);
+    }
+
+    int numSelected = 0;
+    for ( int row = NUM_ROWS_SEL / 2; row < NUM_ROWS_SEL / 2 + VIEW_ROWS; row++ )
+    {
+        for ( int col = 0; col < NUM_COLS_SEL; col++ )
+        {
+            if ( gs_grid->IsInSelection(row, col) )
+                numSelected++;
+        }
+    }
+
+    return numSelected == VIEW_ROWS / 10;
+}
+
+// Select all rows of a big grid in row selection mode and check that the
+// cells of a viewport are selected.
+BENCHMARK_FUNC_WITH_INIT(GridSelectRows, InitGridForSelection, DoneGrid)
+{
+    gs_grid->SetSelectionMode(wxGrid::wxGridSelectRows);
+    gs_grid->ClearSelection();
+
+    gs_grid->SelectBlock(0, 0, NUM_ROWS_SEL - 1, 0);
+
+    bool ok = true;
+    for ( int row = NUM_ROWS_SEL / 2; row < NUM_ROWS_SEL / 2 + VIEW_ROWS; row++ )
+    {
+        for ( int col = 0; col < NUM_COLS_SEL; col++ )
+        {
+            ok &= gs_grid->IsInSelection(row, col);
+        }
+    }
+
+    return ok;
+}
+
+// Auto-size all columns of a big grid measuring all cells.
+BENCHMARK_FUNC_WITH_INIT(GridAutoSizeColumns, InitGridForAutoSize, DoneGrid)
+{
+    gs_grid->SetAutoSizeSampling(0);
+    gs_grid->AutoSizeColumns(false);
+
+    return gs_grid->GetColSize(0) > 0;
+}
+
+// Same as above but only measure a sample of the cells.
+BENCHMARK_FUNC_WITH_INIT(GridAutoSizeColumnsSampled, InitGridForAutoSize, DoneGrid)
+{
+    gs_grid->SetAutoSizeSampling(1000);
+    gs_grid->AutoSizeColumns(false);
+
+    return gs_grid->GetColSize(0) > 0;
+}
+
+// Resize rows scattered over a huge grid, as when the user resizes them
+// interactively, and find the rows at the given positions after each change.
+BENCHMARK_FUNC_WITH_INIT(GridSetRowSize, InitHugeGrid, DoneGrid)
+{
+    const int h = gs_grid->GetDefaultRowSize();
+
+    gs_grid->BeginBatch();
+
+    bool ok = true;
+    for ( int n = 0; n < 100; n++ )
+    {
+        const int row = (n * 7919) % NUM_ROWS_HUGE;
+        gs_grid->SetRowSize(row, h + n % 10);
+
+        const int y = gs_grid->CellToRect(row, 0).y;
+        ok &= gs_grid->YToRow(y) == row;
+    }
+
+    gs_grid->EndBatch();
+
+    return ok;
+}
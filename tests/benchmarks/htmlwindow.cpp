@@ -0,0 +1,254 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/htmlwindow.cpp
+// Purpose:     wxHtmlWindow benchmarks
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/dcmemory.h"
+#include "wx/mstream.h"
+#include "wx/html/htmlwin.h"
+#include "wx/html/htmlcell.h"
+#include "wx/html/winpars.h"
+
+#include "bench.h"
+
+namespace
+{
+
+// The number of paragraphs in the document used by the benchmarks.
+const int NUM_PARAGRAPHS = 20000;
+
+// The size of the window showing the document.
+const int WINDOW_WIDTH = 600;
+const int WINDOW_HEIGHT = 400;
+
+wxHtmlWindow *gs_html = NULL;
+
+wxString CreatePage()
+{
+    wxString page("<html><body>");
+    for ( int n = 0; n < NUM_PARAGRAPHS; n++ )
+    {
+        page += wxString::Format
+                (
+                    "<p>Paragraph %d with <b>bold</b>, <i>italic</i> and "
+                    "<font color=\"#%06x\">coloured</font> words in it, "
+                    "long enough to wrap over more than a single line of "
+                    "the window showing it.</p>",
+                    n,
+                    (n * 7919) & 0xffffff
+                );
+    }
+    page += "</body></html>";
+
+    return page;
+}
+
+bool InitHtmlWindow()
+{
+    gs_html = new wxHtmlWindow(wxTheApp->GetTopWindow(), wxID_ANY,
+                               wxDefaultPosition,
+                               wxSize(WINDOW_WIDTH, WINDOW_HEIGHT));
+
+    return gs_html->SetPage(CreatePage());
+}
+
+void DoneHtmlWindow()
+{
+    delete gs_html;
+    gs_html = NULL;
+}
+
+// Resize the window showing the document, as when the user changes its size
+// interactively.
+bool DoResize()
+{
+    for ( int n = 0; n < 10; n++ )
+    {
+        gs_html->SetSize(400 + 20*n, WINDOW_HEIGHT);
+        gs_html->Update();
+    }
+
+    return gs_html->GetInternalRepresentation()->GetHeight() > 0;
+}
+
+// The parser benchmarks parse the same document, either as a string or as a
+// stream of UTF-8 bytes.
+wxString gs_page;
+wxCharBuffer gs_pageUTF8;
+
+wxMemoryDC *gs_dc = NULL;
+wxHtmlWinParser *gs_parser = NULL;
+
+bool InitHtmlParser()
+{
+    gs_page = CreatePage();
+    gs_pageUTF8 = gs_page.utf8_str();
+
+    gs_dc = new wxMemoryDC;
+    gs_parser = new wxHtmlWinParser;
+    gs_parser->SetDC(gs_dc);
+
+    return true;
+}
+
+void DoneHtmlParser()
+{
+    delete gs_parser;
+    gs_parser = NULL;
+
+    delete gs_dc;
+    gs_dc = NULL;
+
+    gs_page.clear();
+    gs_pageUTF8.reset();
+}
+
+// The document used by the tags parsing benchmark consists almost entirely of
+// tags with parameters.
+bool InitHtmlParserTags()
+{
+    InitHtmlParser();
+
+    gs_page = "<html><body>";
+    for ( int n = 0; n < NUM_PARAGRAPHS; n++ )
+    {
+        gs_page += wxString::Format
+                   (
+                    "<p align=\"%s\"><a name=\"p%d\" href=\"#p%d\">"
+                    "<font color=\"#%06x\" size=\"+1\" face=\"Arial\">"
+                    "<b><i><tt>%d</tt></i></b></font></a><br></p>",
+                    n % 2 ? "left" : "center",
+                    n, n + 1,
+                    (n * 7919) & 0xffffff,
+                    n
+                   );
+    }
+    gs_page += "</body></html>";
+
+    return true;
+}
+
+} // anonymous namespace
+
+// Scroll to the positions scattered over a very long document, repainting
+// the window each time.
+BENCHMARK_FUNC_WITH_INIT(HtmlWindowScroll, InitHtmlWindow, DoneHtmlWindow)
+{
+    int unitX, unitY;
+    gs_html->GetScrollPixelsPerUnit(&unitX, &unitY);
+    if ( !unitY )
+        return false;
+
+    const int height = gs_html->GetInternalRepresentation()->GetHeight();
+
+    for ( int n = 0; n < 100; n++ )
+    {
+        gs_html->Scroll(0, ((n * 7919) % height) / unitY);
+        gs_html->Update();
+    }
+
+    return true;
+}
+
+// Find the cells at the positions scattered over a very long document, as is
+// done when the mouse moves over the window.
+BENCHMARK_FUNC_WITH_INIT(HtmlWindowFindCell, InitHtmlWindow, DoneHtmlWindow)
+{
+    const wxHtmlContainerCell* const cell = gs_html->GetInternalRepresentation();
+    const int height = cell->GetHeight();
+
+    bool ok = true;
+    for ( int n = 0; n < 1000; n++ )
+    {
+        const int y = (n * 7919) % height;
+
+        ok &= cell->FindCellByPos(20, y, wxHTML_FIND_NEAREST_AFTER) != NULL;
+        cell->FindCellByPos(20, y);
+    }
+
+    return ok;
+}
+
+// Show the same document again, which destroys all the cells of the old one
+// before parsing it and creating the new ones.
+BENCHMARK_FUNC_WITH_INIT(HtmlWindowSetPage, InitHtmlWindow, DoneHtmlWindow)
+{
+    const wxString page = *gs_html->GetParser()->GetSource();
+
+    return gs_html->SetPage(page);
+}
+
+BENCHMARK_FUNC_WITH_INIT(HtmlWindowResize, InitHtmlWindow, DoneHtmlWindow)
+{
+    return DoResize();
+}
+
+// Same as above but with incremental layout, only laying out the part of the
+// document shown in the window.
+BENCHMARK_FUNC_WITH_INIT(HtmlWindowResizeIncremental, InitHtmlWindow, DoneHtmlWindow)
+{
+    gs_html->EnableIncrementalLayout();
+
+    return DoResize();
+}
+
+// Parse the entire document at once: this has to be done before showing any
+// of it.
+BENCHMARK_FUNC_WITH_INIT(HtmlParserParse, InitHtmlParser, DoneHtmlParser)
+{
+    wxObject* const top = gs_parser->Parse(gs_page);
+    const bool ok = top != NULL;
+    delete top;
+
+    return ok;
+}
+
+// Parse the entire document read from a stream in chunks.
+BENCHMARK_FUNC_WITH_INIT(HtmlParserStream, InitHtmlParser, DoneHtmlParser)
+{
+    wxMemoryInputStream stream(gs_pageUTF8.data(), gs_pageUTF8.length());
+
+    wxObject* const top = gs_parser->Parse(stream);
+    const bool ok = top != NULL;
+    delete top;
+
+    return ok;
+}
+
+// Parse the document read from a stream only until the part of it shown in
+// the window is available.
+BENCHMARK_FUNC_WITH_INIT(HtmlParserFirstScreen, InitHtmlParser, DoneHtmlParser)
+{
+    wxMemoryInputStream stream(gs_pageUTF8.data(), gs_pageUTF8.length());
+
+    gs_parser->BeginStreaming();
+    while ( gs_parser->ParseChunk(stream) )
+    {
+        wxHtmlContainerCell* top = gs_parser->GetContainer();
+        while ( top->GetParent() )
+            top = top->GetParent();
+
+        if ( !top->LayoutPartially(WINDOW_WIDTH, WINDOW_HEIGHT) ||
+                top->GetHeight() >= WINDOW_HEIGHT )
+            break;
+    }
+
+    wxObject* const top = gs_parser->EndStreaming();
+    const bool ok = top != NULL;
+    delete top;
+
+    return ok;
+}
+
+// Parse a document consisting mostly of tags.
+BENCHMARK_FUNC_WITH_INIT(HtmlParserTags, InitHtmlParserTags, DoneHtmlParser)
+{
+    wxObject* const top = gs_parser->Parse(gs_page);
+    const bool ok = top != NULL;
+    delete top;
+
+    return ok;
+}
@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/listctrl.cpp
+// Purpose:     wxGenericListCtrl benchmarks
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/listctrl.h"
+#include "wx/generic/listctrl.h"
+
+#include "bench.h"
+
+namespace
+{
+
+// The number of items in the list control used by the benchmarks.
+const int NUM_ITEMS = 200000;
+
+wxGenericListCtrl *gs_list = NULL;
+
+// The values the items are sorted on, indexed by the item data.
+wxArrayString gs_values;
+
+bool InitList()
+{
+    gs_list = new wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                    wxDefaultPosition, wxSize(400, 600),
+                                    wxLC_REPORT);
+    gs_list->InsertColumn(0, "Value");
+
+    gs_list->Freeze();
+
+    for ( int n = 0; n < NUM_ITEMS; n++ )
+    {
+        // Use values with many duplicates and in pseudo-random order.
+        gs_values.push_back(wxString::Format("Item %d", (n * 7919) % 10007));
+
+        gs_list->InsertItem(n, gs_values.back());
+        gs_list->SetItemData(n, n);
+    }
+
+    gs_list->Thaw();
+
+    return true;
+}
+
+void DoneList()
+{
+    delete gs_list;
+    gs_list = NULL;
+
+    gs_values.clear();
+}
+
+int wxCALLBACK CompareItems(wxIntPtr item1, wxIntPtr item2, wxIntPtr sortData)
+{
+    const int rc = gs_values[item1].compare(gs_values[item2]);
+    return sortData ? rc : -rc;
+}
+
+wxString wxCALLBACK GetItemKey(wxIntPtr item, wxIntPtr WXUNUSED(sortData))
+{
+    return gs_values[item];
+}
+
+// Check that the items at the top of the control are correctly sorted.
+bool CheckSorted(bool ascending)
+{
+    bool ok = true;
+    for ( long n = 1; n < 100; n++ )
+    {
+        const int rc = gs_values[gs_list->GetItemData(n - 1)].
+                        compare(gs_values[gs_list->GetItemData(n)]);
+        ok &= ascending ? rc <= 0 : rc >= 0;
+    }
+
+    return ok;
+}
+
+} // anonymous namespace
+
+// Sort a big list control using a comparison function, then in the reverse
+// order, and show its first page each time.
+BENCHMARK_FUNC_WITH_INIT(ListCtrlSortItems, InitList, DoneList)
+{
+    gs_list->SortItems(CompareItems, true);
+    gs_list->Update();
+    bool ok = CheckSorted(true);
+
+    gs_list->SortItems(CompareItems, false);
+    gs_list->Update();
+    ok &= CheckSorted(false);
+
+    return ok;
+}
+
+// Same as above but sorting using the item keys.
+BENCHMARK_FUNC_WITH_INIT(ListCtrlSortItemsByKey, InitList, DoneList)
+{
+    bool ok = gs_list->SortItemsByKey(GetItemKey, 0, true);
+    gs_list->Update();
+    ok &= CheckSorted(true);
+
+    ok &= gs_list->SortItemsByKey(GetItemKey, 0, false);
+    gs_list->Update();
+    ok &= CheckSorted(false);
+
+    return ok;
+}
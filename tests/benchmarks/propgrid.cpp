@@ -0,0 +1,201 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/propgrid.cpp
+// Purpose:     wxPropertyGrid benchmarks
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/propgrid/propgrid.h"
+#include "wx/propgrid/props.h"
+
+#include "bench.h"
+
+namespace
+{
+
+// The grid used by the benchmarks has this many categories, each of which
+// contains the given number of properties, for the total of 50500 rows.
+const int NUM_CATEGORIES = 500;
+const int NUM_PROPERTIES = 100;
+
+wxPropertyGrid *gs_propgrid = NULL;
+
+bool InitPropGrid()
+{
+    gs_propgrid = new wxPropertyGrid(wxTheApp->GetTopWindow(), wxID_ANY,
+                                     wxDefaultPosition, wxSize(400, 600));
+
+    gs_propgrid->Freeze();
+
+    for ( int n = 0; n < NUM_CATEGORIES; n++ )
+    {
+        wxPGProperty* const
+            cat = gs_propgrid->Append(new wxPropertyCategory(
+                                        wxString::Format("Category %d", n)));
+
+        for ( int m = 0; m < NUM_PROPERTIES; m++ )
+        {
+            gs_propgrid->AppendIn(cat, new wxIntProperty(
+                                        wxString::Format("Property %d.%d", n, m),
+                                        wxPG_LABEL,
+                                        m));
+        }
+    }
+
+    gs_propgrid->Thaw();
+
+    return true;
+}
+
+// The grid populated by the benchmarks has this many categories, each of which
+// contains the given number of properties and a property with the value
+// composed from the values of this number of children.
+const int NUM_CATEGORIES_POPULATE = 100;
+const int NUM_PROPERTIES_POPULATE = 100;
+const int NUM_CHILDREN_POPULATE = 100;
+
+bool InitEmptyPropGrid()
+{
+    gs_propgrid = new wxPropertyGrid(wxTheApp->GetTopWindow(), wxID_ANY,
+                                     wxDefaultPosition, wxSize(400, 600));
+
+    return true;
+}
+
+void DoPopulate()
+{
+    gs_propgrid->Clear();
+
+    for ( int n = 0; n < NUM_CATEGORIES_POPULATE; n++ )
+    {
+        wxPGProperty* const
+            cat = gs_propgrid->Append(new wxPropertyCategory(
+                                        wxString::Format("Category %d", n)));
+
+        for ( int m = 0; m < NUM_PROPERTIES_POPULATE; m++ )
+        {
+            gs_propgrid->AppendIn(cat, new wxIntProperty(
+                                        wxString::Format("Property %d.%d", n, m),
+                                        wxPG_LABEL,
+                                        m));
+        }
+
+        wxPGProperty* const
+            composed = gs_propgrid->AppendIn(cat, new wxStringProperty(
+                                        wxString::Format("Composed %d", n),
+                                        wxPG_LABEL,
+                                        "<composed>"));
+
+        for ( int m = 0; m < NUM_CHILDREN_POPULATE; m++ )
+        {
+            gs_propgrid->AppendIn(composed, new wxIntProperty(
+                                        wxString::Format("Child %d", m),
+                                        wxPG_LABEL,
+                                        m));
+        }
+    }
+}
+
+bool CheckPopulated()
+{
+    wxPGProperty* const p = gs_propgrid->GetPropertyByName(
+                                wxString::Format("Composed %d",
+                                                 NUM_CATEGORIES_POPULATE - 1));
+
+    return p && p->GetChildCount() == NUM_CHILDREN_POPULATE &&
+                !p->GetValueAsString().empty();
+}
+
+void DonePropGrid()
+{
+    delete gs_propgrid;
+    gs_propgrid = NULL;
+}
+
+} // anonymous namespace
+
+// Find the properties at the positions scattered over a big grid, as is done
+// when the mouse moves over it.
+BENCHMARK_FUNC_WITH_INIT(PropGridGetItemAtY, InitPropGrid, DonePropGrid)
+{
+    const int height = gs_propgrid->GetState()->GetVirtualHeight();
+
+    bool ok = true;
+    for ( int n = 0; n < 1000; n++ )
+    {
+        const int y = (n * 7919) % height;
+
+        ok &= gs_propgrid->GetItemAtY(y) != NULL;
+        ok &= gs_propgrid->HitTest(wxPoint(10, y)).GetProperty() != NULL;
+    }
+
+    return ok;
+}
+
+// Scroll to the positions scattered over a big grid, repainting the window
+// each time.
+BENCHMARK_FUNC_WITH_INIT(PropGridScroll, InitPropGrid, DonePropGrid)
+{
+    int unitX, unitY;
+    gs_propgrid->GetScrollPixelsPerUnit(&unitX, &unitY);
+    if ( !unitY )
+        return false;
+
+    const int height = gs_propgrid->GetState()->GetVirtualHeight();
+
+    for ( int n = 0; n < 100; n++ )
+    {
+        gs_propgrid->Scroll(0, ((n * 7919) % height) / unitY);
+        gs_propgrid->Refresh();
+        gs_propgrid->Update();
+    }
+
+    return true;
+}
+
+// Collapse and expand back categories of a big grid, finding the last property
+// after each change.
+BENCHMARK_FUNC_WITH_INIT(PropGridToggle, InitPropGrid, DonePropGrid)
+{
+    wxPropertyGridPageState* const state = gs_propgrid->GetState();
+    const int rowHeight = gs_propgrid->GetRowHeight();
+
+    bool ok = true;
+    for ( int n = 0; n < 100; n++ )
+    {
+        const wxString
+            name = wxString::Format("Category %d", (n * 7919) % NUM_CATEGORIES);
+
+        gs_propgrid->Collapse(name);
+        ok &= gs_propgrid->GetItemAtY(state->GetVirtualHeight() - rowHeight) != NULL;
+
+        gs_propgrid->Expand(name);
+        ok &= gs_propgrid->GetItemAtY(state->GetVirtualHeight() - rowHeight) != NULL;
+    }
+
+    return ok;
+}
+
+// Populate a big grid, freezing it to avoid refreshing it after adding each
+// property.
+BENCHMARK_FUNC_WITH_INIT(PropGridPopulate, InitEmptyPropGrid, DonePropGrid)
+{
+    gs_propgrid->Freeze();
+    DoPopulate();
+    gs_propgrid->Thaw();
+
+    return CheckPopulated();
+}
+
+// Same as above but also using the bulk load mode.
+BENCHMARK_FUNC_WITH_INIT(PropGridPopulateBulk, InitEmptyPropGrid, DonePropGrid)
+{
+    gs_propgrid->Freeze();
+    gs_propgrid->BeginBulkLoad();
+    DoPopulate();
+    gs_propgrid->EndBulkLoad();
+    gs_propgrid->Thaw();
+
+    return CheckPopulated();
+}
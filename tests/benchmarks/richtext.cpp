@@ -0,0 +1,187 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/richtext.cpp
+// Purpose:     wxRichTextCtrl benchmarks
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/mstream.h"
+#include "wx/richtext/richtextctrl.h"
+#include "wx/richtext/richtextxml.h"
+
+#include "bench.h"
+
+namespace
+{
+
+// The number of paragraphs in the buffer used by the benchmarks.
+const int NUM_PARAGRAPHS = 50000;
+
+wxRichTextCtrl *gs_richtext = NULL;
+
+bool InitRichText()
+{
+    gs_richtext = new wxRichTextCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                     wxString(),
+                                     wxDefaultPosition, wxSize(600, 400));
+
+    wxString text;
+    for ( int n = 0; n < NUM_PARAGRAPHS; n++ )
+    {
+        text += wxString::Format("Paragraph %d of a long document typed "
+                                 "into by the benchmark.\n", n);
+    }
+
+    gs_richtext->SetValue(text);
+    gs_richtext->LayoutContent();
+
+    return true;
+}
+
+void DoneRichText()
+{
+    delete gs_richtext;
+    gs_richtext = NULL;
+}
+
+// The buffer used by the XML benchmarks has this many paragraphs with a few
+// differently styled runs of text in each of them, for about 20MB of XML.
+const int NUM_PARAGRAPHS_XML = 100000;
+
+wxRichTextBuffer *gs_buffer = NULL;
+wxMemoryOutputStream *gs_xml = NULL;
+
+bool InitRichTextXML()
+{
+    gs_buffer = new wxRichTextBuffer;
+
+    wxRichTextAttr bold;
+    bold.SetFontWeight(wxFONTWEIGHT_BOLD);
+
+    wxRichTextAttr coloured;
+    coloured.SetTextColour(*wxBLUE);
+
+    for ( int n = 0; n < NUM_PARAGRAPHS_XML; n++ )
+    {
+        wxRichTextParagraph* const para = new wxRichTextParagraph
+            (
+                wxString::Format("Paragraph %d of a long document ", n),
+                gs_buffer
+            );
+        para->AppendChild(new wxRichTextPlainText("with bold", para, &bold));
+        para->AppendChild(new wxRichTextPlainText(" and ", para));
+        para->AppendChild(new wxRichTextPlainText("coloured", para, &coloured));
+        para->AppendChild(new wxRichTextPlainText(" words in it.", para));
+
+        gs_buffer->AppendChild(para);
+    }
+    gs_buffer->UpdateRanges();
+
+    gs_xml = new wxMemoryOutputStream;
+
+    wxRichTextXMLHandler handler;
+    return handler.SaveFile(gs_buffer, *gs_xml);
+}
+
+void DoneRichTextXML()
+{
+    delete gs_buffer;
+    gs_buffer = NULL;
+
+    delete gs_xml;
+    gs_xml = NULL;
+}
+
+} // anonymous namespace
+
+// Type text in the middle of a big buffer, moving the caret between the lines
+// as the user would do.
+BENCHMARK_FUNC_WITH_INIT(RichTextType, InitRichText, DoneRichText)
+{
+    gs_richtext->SetInsertionPoint(gs_richtext->GetLastPosition() / 2);
+
+    for ( int n = 0; n < 100; n++ )
+    {
+        gs_richtext->WriteText("x");
+        gs_richtext->LayoutContent(true /* only visible */);
+
+        if ( n % 10 == 9 )
+            gs_richtext->MoveDown();
+    }
+
+    return gs_richtext->IsModified();
+}
+
+// Find the lines at the positions scattered over a big buffer, as is done
+// when moving the caret or hit testing it.
+BENCHMARK_FUNC_WITH_INIT(RichTextFindLine, InitRichText, DoneRichText)
+{
+    wxRichTextBuffer& buffer = gs_richtext->GetBuffer();
+    const long last = gs_richtext->GetLastPosition();
+    const int height = buffer.GetCachedSize().y;
+
+    bool ok = true;
+    for ( int n = 0; n < 1000; n++ )
+    {
+        ok &= buffer.GetLineAtPosition((n * 7919) % last) != NULL;
+        ok &= buffer.GetLineAtYPosition((n * 7919) % height) != NULL;
+    }
+
+    return ok;
+}
+
+// Scroll to the positions scattered over a big buffer, repainting the window
+// each time.
+BENCHMARK_FUNC_WITH_INIT(RichTextScroll, InitRichText, DoneRichText)
+{
+    const long last = gs_richtext->GetLastPosition();
+
+    for ( int n = 0; n < 100; n++ )
+    {
+        gs_richtext->ShowPosition((n * 7919) % last);
+        gs_richtext->Refresh();
+        gs_richtext->Update();
+    }
+
+    return true;
+}
+
+// Lay out the entire buffer after changing its contents, as is done before
+// showing a document for the first time.
+BENCHMARK_FUNC_WITH_INIT(RichTextLayout, InitRichText, DoneRichText)
+{
+    gs_richtext->GetBuffer().Invalidate(wxRICHTEXT_ALL);
+
+    return gs_richtext->LayoutContent();
+}
+
+// Same as above but with the background layout, only laying out the part of
+// the buffer shown in the window.
+BENCHMARK_FUNC_WITH_INIT(RichTextLayoutBackground, InitRichText, DoneRichText)
+{
+    gs_richtext->EnableBackgroundLayout();
+    gs_richtext->GetBuffer().Invalidate(wxRICHTEXT_ALL);
+
+    return gs_richtext->LayoutContent();
+}
+
+// Save a big buffer with some styles in it in XML format.
+BENCHMARK_FUNC_WITH_INIT(RichTextXMLSave, InitRichTextXML, DoneRichTextXML)
+{
+    wxMemoryOutputStream stream;
+
+    wxRichTextXMLHandler handler;
+    return handler.SaveFile(gs_buffer, stream);
+}
+
+// Load the document saved by the benchmark above.
+BENCHMARK_FUNC_WITH_INIT(RichTextXMLLoad, InitRichTextXML, DoneRichTextXML)
+{
+    wxMemoryInputStream stream(*gs_xml);
+
+    wxRichTextBuffer buffer;
+    wxRichTextXMLHandler handler;
+    return handler.LoadFile(&buffer, stream) &&
+            buffer.GetChildCount() == NUM_PARAGRAPHS_XML;
+}
@@ -0,0 +1,193 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/stc.cpp
+// Purpose:     wxStyledTextCtrl benchmarks
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/ffile.h"
+#include "wx/filename.h"
+#include "wx/stc/stc.h"
+
+#include "bench.h"
+
+namespace
+{
+
+// The number of lines in the document used by the benchmarks.
+const int NUM_LINES = 100000;
+
+wxStyledTextCtrl *gs_stc = NULL;
+
+bool DoInitSTC(const wxString& word)
+{
+    gs_stc = new wxStyledTextCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                  wxDefaultPosition, wxSize(600, 400));
+
+    wxString text;
+    for ( int n = 0; n < NUM_LINES; n++ )
+    {
+        text += wxString::Format("    int %s%d = compute(%d, \"%s\"); "
+                                 "// line %d of a long file\n",
+                                 word, n, n * 7919, word, n);
+    }
+
+    gs_stc->SetText(text);
+
+    return gs_stc->GetLineCount() > NUM_LINES;
+}
+
+// The text of this document is pure ASCII.
+bool InitSTC()
+{
+    return DoInitSTC("value");
+}
+
+// And this one contains some non-ASCII characters in every line.
+bool InitSTCNonASCII()
+{
+    return DoInitSTC(wxString::FromUTF8("gr\xc3\xb6\xc3\x9f" "e"));
+}
+
+// This one is the same as the ASCII one but uses the C++ lexer.
+bool InitSTCLexer()
+{
+    if ( !InitSTC() )
+        return false;
+
+    gs_stc->SetLexer(wxSTC_LEX_CPP);
+    gs_stc->SetKeyWords(0, "int return");
+    gs_stc->SetProperty("fold", "1");
+
+    return true;
+}
+
+void DoneSTC()
+{
+    delete gs_stc;
+    gs_stc = NULL;
+}
+
+// The file used by the loading benchmarks has this many lines, for about 60MB
+// of text.
+const int NUM_LINES_FILE = 1000000;
+
+wxString gs_fileName;
+
+bool InitSTCFile()
+{
+    gs_stc = new wxStyledTextCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                  wxDefaultPosition, wxSize(600, 400));
+
+    gs_fileName = wxFileName::CreateTempFileName("stcbench");
+
+    wxFFile file(gs_fileName, "wb");
+    for ( int n = 0; n < NUM_LINES_FILE; n++ )
+    {
+        if ( !file.Write(wxString::Format("%08d: a line of a big log file "
+                                          "loaded by the benchmark\n", n)) )
+            return false;
+    }
+
+    return file.Close();
+}
+
+void DoneSTCFile()
+{
+    DoneSTC();
+
+    wxRemoveFile(gs_fileName);
+    gs_fileName.clear();
+}
+
+// Scroll to the lines scattered over a big document, repainting the window
+// each time, which requires measuring the text of all the lines shown.
+bool DoScroll()
+{
+    for ( int n = 0; n < 100; n++ )
+    {
+        gs_stc->ScrollToLine((n * 7919) % NUM_LINES);
+        gs_stc->Refresh();
+        gs_stc->Update();
+    }
+
+    return gs_stc->GetFirstVisibleLine() > 0;
+}
+
+// Show the end of the document after clearing all its styles, which requires
+// lexing all of it.
+bool DoShowEnd()
+{
+    // Clearing the styles marks the document as styled, so reset the end of
+    // the styled text to its beginning too.
+    gs_stc->ClearDocumentStyle();
+    gs_stc->StartStyling(0);
+    gs_stc->ScrollToLine(NUM_LINES);
+    gs_stc->Refresh();
+    gs_stc->Update();
+
+    return gs_stc->GetFirstVisibleLine() > 0;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(STCScroll, InitSTC, DoneSTC)
+{
+    return DoScroll();
+}
+
+BENCHMARK_FUNC_WITH_INIT(STCScrollNonASCII, InitSTCNonASCII, DoneSTC)
+{
+    return DoScroll();
+}
+
+BENCHMARK_FUNC_WITH_INIT(STCLexShowEnd, InitSTCLexer, DoneSTC)
+{
+    return DoShowEnd();
+}
+
+// Same as above but with the styling done in the background thread, so that
+// the main thread doesn't have to wait until the whole document is lexed.
+BENCHMARK_FUNC_WITH_INIT(STCLexShowEndBackground, InitSTCLexer, DoneSTC)
+{
+    gs_stc->SetIdleStyling(wxSTC_IDLESTYLING_ALL);
+    gs_stc->EnableBackgroundLexing();
+
+    if ( !DoShowEnd() )
+        return false;
+
+    // Wait until the rest of the document is styled too, as this is what the
+    // benchmark above does in the main thread.
+    while ( gs_stc->GetEndStyled() < gs_stc->GetLength() )
+    {
+        wxMilliSleep(1);
+        wxTheApp->ProcessPendingEvents();
+        wxTheApp->ProcessIdle();
+    }
+
+    return true;
+}
+
+// Load a big file, blocking until it's done.
+BENCHMARK_FUNC_WITH_INIT(STCLoadFile, InitSTCFile, DoneSTCFile)
+{
+    return gs_stc->LoadFile(gs_fileName) &&
+            gs_stc->GetLineCount() > NUM_LINES_FILE;
+}
+
+// Same as above but load it in the background thread, only waiting for it to
+// be loaded to check the result.
+BENCHMARK_FUNC_WITH_INIT(STCLoadFileBackground, InitSTCFile, DoneSTCFile)
+{
+    if ( !gs_stc->LoadFileInBackground(gs_fileName) )
+        return false;
+
+    while ( gs_stc->IsLoadingFile() )
+    {
+        wxMilliSleep(1);
+        wxTheApp->ProcessPendingEvents();
+    }
+
+    return gs_stc->GetLineCount() > NUM_LINES_FILE;
+}
@@ -0,0 +1,101 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/textextent.cpp
+// Purpose:     Text measuring benchmarks
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/dcclient.h"
+#include "wx/window.h"
+
+#ifdef __WXGTK20__
+    #include "wx/private/textmeasure.h"
+#endif
+
+#include "bench.h"
+
+namespace
+{
+
+// The labels measured by the benchmarks, as the controls typically measure
+// the same small set of strings (e.g. their items labels) repeatedly.
+const int NUM_LABELS = 200;
+
+wxArrayString gs_labels;
+
+bool InitLabels()
+{
+    for ( int n = 0; n < NUM_LABELS; n++ )
+        gs_labels.push_back(wxString::Format("Item label number %d", n));
+
+    return true;
+}
+
+void DoneLabels()
+{
+    gs_labels.clear();
+}
+
+// Measure all the labels a number of times using either wxDC or wxWindow
+// and check that the results are consistent.
+template <typename T>
+bool MeasureLabels(const T& measurer)
+{
+    wxCoord widthFirst = 0;
+    for ( int iteration = 0; iteration < 50; iteration++ )
+    {
+        for ( int n = 0; n < NUM_LABELS; n++ )
+        {
+            const wxSize size = measurer.GetTextExtent(gs_labels[n]);
+
+            if ( n == 0 )
+            {
+                if ( iteration == 0 )
+                    widthFirst = size.x;
+                else if ( size.x != widthFirst )
+                    return false;
+            }
+        }
+    }
+
+    return widthFirst > 0;
+}
+
+#ifdef __WXGTK20__
+
+unsigned long GetCacheHits()
+{
+    unsigned long hits;
+    wxTextMeasure::GetExtentCacheStats(&hits, NULL);
+    return hits;
+}
+
+#endif // __WXGTK20__
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(DCGetTextExtent, InitLabels, DoneLabels)
+{
+    wxClientDC dc(wxTheApp->GetTopWindow());
+
+    return MeasureLabels(dc);
+}
+
+BENCHMARK_FUNC_WITH_INIT(WindowGetTextExtent, InitLabels, DoneLabels)
+{
+#ifdef __WXGTK20__
+    const unsigned long hitsBefore = GetCacheHits();
+#endif
+
+    if ( !MeasureLabels(*wxTheApp->GetTopWindow()) )
+        return false;
+
+#ifdef __WXGTK20__
+    // Repeated measurements should be served from the cache.
+    if ( GetCacheHits() == hitsBefore )
+        return false;
+#endif
+
+    return true;
+}
@@ -0,0 +1,117 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/treectrl.cpp
+// Purpose:     wxGenericTreeCtrl benchmarks
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/treectrl.h"
+#include "wx/generic/treectlg.h"
+
+#include "bench.h"
+
+namespace
+{
+
+// The tree used by the benchmarks has this many top level items, each of
+// which has the given number of children, for the total of 202000 items.
+const int NUM_TOP_ITEMS = 2000;
+const int NUM_CHILDREN = 100;
+
+wxGenericTreeCtrl *gs_tree = NULL;
+
+// All the leaf items of the tree.
+wxArrayTreeItemIds gs_leaves;
+
+bool InitTree()
+{
+    gs_tree = new wxGenericTreeCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                    wxDefaultPosition, wxSize(400, 600),
+                                    wxTR_DEFAULT_STYLE | wxTR_HIDE_ROOT);
+
+    gs_tree->Freeze();
+
+    const wxTreeItemId root = gs_tree->AddRoot("Root");
+    for ( int n = 0; n < NUM_TOP_ITEMS; n++ )
+    {
+        const wxTreeItemId
+            item = gs_tree->AppendItem(root, wxString::Format("Item %d", n));
+
+        for ( int m = 0; m < NUM_CHILDREN; m++ )
+        {
+            gs_leaves.push_back(
+                gs_tree->AppendItem(item, wxString::Format("Child %d.%d", n, m)));
+        }
+    }
+
+    gs_tree->Thaw();
+
+    return true;
+}
+
+void DoneTree()
+{
+    delete gs_tree;
+    gs_tree = NULL;
+
+    gs_leaves.clear();
+}
+
+} // anonymous namespace
+
+// Expand and collapse all items of a big tree, updating its layout each time.
+BENCHMARK_FUNC_WITH_INIT(TreeCtrlExpandAll, InitTree, DoneTree)
+{
+    wxRect rect;
+
+    gs_tree->ExpandAll();
+    bool ok = gs_tree->GetBoundingRect(gs_leaves.back(), rect);
+
+    gs_tree->CollapseAll();
+    ok &= gs_tree->GetBoundingRect(gs_tree->GetLastChild(gs_tree->GetRootItem()),
+                                   rect);
+
+    return ok;
+}
+
+// Toggle top level items of a big fully expanded tree, updating its layout
+// after each change.
+BENCHMARK_FUNC_WITH_INIT(TreeCtrlToggle, InitTree, DoneTree)
+{
+    gs_tree->ExpandAll();
+
+    bool ok = true;
+    for ( int n = 0; n < 100; n++ )
+    {
+        gs_tree->Toggle(gs_tree->GetItemParent(gs_leaves[n * NUM_CHILDREN]));
+
+        wxRect rect;
+        ok &= gs_tree->GetBoundingRect(gs_leaves.back(), rect);
+    }
+
+    return ok;
+}
+
+// Scroll to items scattered over a big fully expanded tree and find the items
+// at their new positions.
+BENCHMARK_FUNC_WITH_INIT(TreeCtrlScroll, InitTree, DoneTree)
+{
+    gs_tree->ExpandAll();
+
+    bool ok = true;
+    for ( int n = 0; n < 100; n++ )
+    {
+        const wxTreeItemId item = gs_leaves[(n * 7919) % gs_leaves.size()];
+        gs_tree->ScrollTo(item);
+        gs_tree->Update();
+
+        wxRect rect;
+        gs_tree->GetBoundingRect(item, rect);
+
+        int flags;
+        ok &= gs_tree->HitTest(rect.GetPosition() + wxPoint(1, 1), flags) == item;
+    }
+
+    return ok;
+}
@@ -19,6 +19,7 @@
 #endif // WX_PRECOMP
 
 #include "wx/grid.h"
+#include "wx/generic/gridsel.h"
 #include "testableframe.h"
 #include "asserthelper.h"
 #include "wx/uiaction.h"
@@ -59,6 +60,7 @@ private:
         CPPUNIT_TEST( AddRowCol );
         CPPUNIT_TEST( ColumnOrder );
         CPPUNIT_TEST( ColumnVisibility );
+        CPPUNIT_TEST( RowSizes );
         CPPUNIT_TEST( LineFormatting );
         CPPUNIT_TEST( SortSupport );
         CPPUNIT_TEST( Labels );
@@ -88,6 +90,7 @@ private:
     void AddRowCol();
     void ColumnOrder();
     void ColumnVisibility();
+    void RowSizes();
     void LineFormatting();
     void SortSupport();
     void Labels();
@@ -546,6 +549,73 @@ void GridTestCase::ColumnVisibility()
     CPPUNIT_ASSERT( m_grid->IsColShown(1) );
 }
 
+void GridTestCase::RowSizes()
+{
+    const int h = m_grid->GetDefaultRowSize();
+
+    m_grid->SetRowSize(2, 2*h);
+    m_grid->SetRowSize(5, 3*h);
+
+    CPPUNIT_ASSERT_EQUAL( 2*h, m_grid->GetRowSize(2) );
+    CPPUNIT_ASSERT_EQUAL( h, m_grid->GetRowSize(3) );
+    CPPUNIT_ASSERT_EQUAL( 6*h, m_grid->CellToRect(5, 0).y );
+    CPPUNIT_ASSERT_EQUAL( 9*h, m_grid->CellToRect(6, 0).y );
+    CPPUNIT_ASSERT_EQUAL( 2, m_grid->YToRow(3*h) );
+    CPPUNIT_ASSERT_EQUAL( 5, m_grid->YToRow(8*h) );
+    CPPUNIT_ASSERT_EQUAL( 6, m_grid->YToRow(9*h) );
+
+    m_grid->HideRow(2);
+    CPPUNIT_ASSERT( !m_grid->IsRowShown(2) );
+    CPPUNIT_ASSERT_EQUAL( 4*h, m_grid->CellToRect(5, 0).y );
+    CPPUNIT_ASSERT_EQUAL( 3, m_grid->YToRow(2*h) );
+
+    m_grid->ShowRow(2);
+    CPPUNIT_ASSERT_EQUAL( 2*h, m_grid->GetRowSize(2) );
+
+    // Rows inserted before or deleted after a custom sized row should shift
+    // it accordingly.
+    m_grid->InsertRows(1, 2);
+    CPPUNIT_ASSERT_EQUAL( h, m_grid->GetRowSize(2) );
+    CPPUNIT_ASSERT_EQUAL( 2*h, m_grid->GetRowSize(4) );
+    CPPUNIT_ASSERT_EQUAL( 3*h, m_grid->GetRowSize(7) );
+
+    m_grid->DeleteRows(3, 2);
+    CPPUNIT_ASSERT_EQUAL( h, m_grid->GetRowSize(3) );
+    CPPUNIT_ASSERT_EQUAL( 3*h, m_grid->GetRowSize(5) );
+    CPPUNIT_ASSERT_EQUAL( 10, m_grid->GetNumberRows() );
+
+    const wxGridSizesInfo sizes = m_grid->GetRowSizes();
+    CPPUNIT_ASSERT_EQUAL( 1, (int)sizes.m_customSizes.size() );
+    CPPUNIT_ASSERT_EQUAL( 3*h, sizes.GetSize(5) );
+
+    // Changing the default height without resizing the existing rows only
+    // affects the rows added later.
+    m_grid->SetDefaultRowSize(2*h);
+    m_grid->AppendRows(5);
+    m_grid->InsertRows(3, 2);
+    CPPUNIT_ASSERT_EQUAL( 17, m_grid->GetNumberRows() );
+    CPPUNIT_ASSERT_EQUAL( h, m_grid->GetRowSize(2) );
+    CPPUNIT_ASSERT_EQUAL( 2*h, m_grid->GetRowSize(3) );
+    CPPUNIT_ASSERT_EQUAL( 2*h, m_grid->GetRowSize(4) );
+    CPPUNIT_ASSERT_EQUAL( h, m_grid->GetRowSize(5) );
+    CPPUNIT_ASSERT_EQUAL( 3*h, m_grid->GetRowSize(7) );
+    CPPUNIT_ASSERT_EQUAL( h, m_grid->GetRowSize(11) );
+    CPPUNIT_ASSERT_EQUAL( 2*h, m_grid->GetRowSize(12) );
+    CPPUNIT_ASSERT_EQUAL( 2*h, m_grid->GetRowSize(16) );
+    CPPUNIT_ASSERT_EQUAL( 16*h, m_grid->CellToRect(12, 0).y );
+    CPPUNIT_ASSERT_EQUAL( 12, m_grid->YToRow(17*h) );
+
+    const wxGridSizesInfo sizesNew = m_grid->GetRowSizes();
+    CPPUNIT_ASSERT_EQUAL( 2*h, sizesNew.m_sizeDefault );
+    CPPUNIT_ASSERT_EQUAL( 10, (int)sizesNew.m_customSizes.size() );
+    CPPUNIT_ASSERT_EQUAL( 3*h, sizesNew.GetSize(7) );
+    CPPUNIT_ASSERT_EQUAL( 2*h, sizesNew.GetSize(3) );
+
+    m_grid->SetDefaultRowSize(h, true /* resize existing */);
+    CPPUNIT_ASSERT_EQUAL( h, m_grid->GetRowSize(7) );
+    CPPUNIT_ASSERT_EQUAL( 7*h, m_grid->CellToRect(7, 0).y );
+}
+
 void GridTestCase::LineFormatting()
 {
     CPPUNIT_ASSERT(m_grid->GridLinesEnabled());
@@ -742,4 +812,138 @@ void GridTestCase::ReadOnly()
 #endif
 }
 
+TEST_CASE("GridLineRangeSet", "[grid][selection]")
+{
+    wxGridLineRangeSet lines;
+    CHECK( lines.IsEmpty() );
+
+    // Adjacent and overlapping ranges are merged.
+    lines.Add(10, 19);
+    lines.Add(20, 29);
+    lines.Add(5, 12);
+    CHECK( lines.GetRangesCount() == 1 );
+    CHECK( lines.GetRangeFrom(0) == 5 );
+    CHECK( lines.GetRangeTo(0) == 29 );
+
+    lines.Add(40, 49);
+    CHECK( lines.GetRangesCount() == 2 );
+    CHECK( lines.Contains(5) );
+    CHECK( lines.Contains(29) );
+    CHECK( !lines.Contains(30) );
+    CHECK( !lines.Contains(39) );
+    CHECK( lines.Contains(45) );
+
+    // Adding a range covering several existing ones merges all of them.
+    lines.Add(0, 100);
+    CHECK( lines.GetRangesCount() == 1 );
+    CHECK( lines.AsArray().size() == 101 );
+
+    // Removing lines in the middle splits the range.
+    lines.Remove(50, 59);
+    CHECK( lines.GetRangesCount() == 2 );
+    CHECK( lines.Contains(49) );
+    CHECK( !lines.Contains(50) );
+    CHECK( !lines.Contains(59) );
+    CHECK( lines.Contains(60) );
+
+    // Deleting the lines around the gap joins the ranges again.
+    lines.UpdateLines(45, -20);
+    CHECK( lines.GetRangesCount() == 1 );
+    CHECK( lines.GetRangeTo(0) == 80 );
+
+    // Inserting lines splits them, as the new lines are not selected.
+    lines.UpdateLines(10, 5);
+    CHECK( lines.GetRangesCount() == 2 );
+    CHECK( lines.Contains(9) );
+    CHECK( !lines.Contains(10) );
+    CHECK( !lines.Contains(14) );
+    CHECK( lines.Contains(15) );
+    CHECK( lines.GetRangeTo(1) == 85 );
+
+    lines.Clear();
+    CHECK( lines.IsEmpty() );
+}
+
+TEST_CASE("GridSelectionBlocks", "[grid][selection]")
+{
+    wxGrid* const grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+    grid->CreateGrid(1000, 20);
+
+    // Select many small blocks, as if by Ctrl-dragging the mouse, and a tall
+    // one overlapping many of them.
+    for ( int row = 0; row < 1000; row += 10 )
+        grid->SelectBlock(row, row % 20, row + 2, row % 20 + 1, true);
+    grid->SelectBlock(95, 15, 505, 15, true);
+
+    CHECK( grid->GetSelectionBlockTopLeft().size() == 101 );
+    CHECK( grid->IsInSelection(500, 0) );
+    CHECK( grid->IsInSelection(502, 1) );
+    CHECK( !grid->IsInSelection(503, 0) );
+    CHECK( !grid->IsInSelection(500, 2) );
+    CHECK( grid->IsInSelection(510, 11) );
+    CHECK( grid->IsInSelection(300, 15) );
+    CHECK( !grid->IsInSelection(94, 15) );
+    CHECK( !grid->IsInSelection(506, 15) );
+
+    // Deleting rows updates the blocks below them.
+    grid->DeleteRows(0, 10);
+    CHECK( grid->GetSelectionBlockTopLeft().size() == 100 );
+    CHECK( grid->IsInSelection(490, 0) );
+    CHECK( !grid->IsInSelection(500, 0) );
+    CHECK( grid->IsInSelection(500, 10) );
+    CHECK( grid->IsInSelection(495, 15) );
+    CHECK( !grid->IsInSelection(496, 15) );
+
+    // Selecting a row adjacent to a full width block extends the block.
+    grid->ClearSelection();
+    grid->SelectBlock(600, 0, 609, 19);
+    CHECK( grid->IsInSelection(609, 5) );
+    CHECK( !grid->IsInSelection(610, 5) );
+
+    grid->SelectRow(610, true);
+    CHECK( grid->GetSelectionBlockTopLeft().size() == 1 );
+    CHECK( grid->IsInSelection(610, 5) );
+
+    grid->SelectRow(599, true);
+    CHECK( grid->GetSelectionBlockTopLeft().size() == 1 );
+    CHECK( grid->IsInSelection(599, 5) );
+    CHECK( !grid->IsInSelection(598, 5) );
+
+    delete grid;
+}
+
+TEST_CASE("GridAutoSizeSampling", "[grid][autosize]")
+{
+    wxGrid* const grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+    grid->CreateGrid(10000, 2);
+
+    for ( int row = 0; row < 10000; row++ )
+    {
+        grid->SetCellValue(row, 0, "x");
+        grid->SetCellValue(row, 1, "x");
+    }
+
+    // This row is neither visible nor at the edges of the grid, so it's only
+    // measured if the longest values are included in the sample.
+    const wxString longValue(wxString('W', 100));
+    grid->SetCellValue(5000, 0, longValue);
+    grid->SetCellValue(5000, 1, longValue);
+
+    grid->AutoSizeColumn(0);
+    const int widthFull = grid->GetColSize(0);
+    CHECK( widthFull > grid->GetColSize(1) );
+
+    grid->SetAutoSizeSampling(20, 1000);
+    CHECK( grid->GetAutoSizeSampleSize() == 20 );
+    CHECK( grid->GetAutoSizeTimeLimit() == 1000 );
+
+    grid->AutoSizeColumn(1);
+    CHECK( grid->GetColSize(1) == widthFull );
+
+    // The extents cache only exists while auto-sizing.
+    CHECK( !grid->GetAutoSizeExtentCache() );
+
+    delete grid;
+}
+
 #endif //wxUSE_GRID
@@ -24,10 +24,14 @@
 #endif // WX_PRECOMP
 
 #include "wx/listctrl.h"
+#include "wx/generic/listctrl.h"
+#include "wx/math.h"
 #include "listbasetest.h"
 #include "testableframe.h"
 #include "wx/uiaction.h"
 
+#include <limits>
+
 // ----------------------------------------------------------------------------
 // test class
 // ----------------------------------------------------------------------------
@@ -46,11 +50,13 @@ private:
     CPPUNIT_TEST_SUITE( ListCtrlTestCase );
         wxLIST_BASE_TESTS();
         CPPUNIT_TEST( EditLabel );
+        CPPUNIT_TEST( SortByKey );
         WXUISIM_TEST( ColumnClick );
         WXUISIM_TEST( ColumnDrag );
     CPPUNIT_TEST_SUITE_END();
 
     void EditLabel();
+    void SortByKey();
 #if wxUSE_UIACTIONSIMULATOR
     // Column events are only supported in wxListCtrl currently so we test them
     // here rather than in ListBaseTest
@@ -93,6 +99,97 @@ void ListCtrlTestCase::EditLabel()
     m_list->EditLabel(0);
 }
 
+namespace
+{
+
+// Every 7th item has no numeric key and the others only have a few distinct
+// keys, to check that the sort is stable.
+double wxCALLBACK GetNumericKey(wxIntPtr item, wxIntPtr WXUNUSED(sortData))
+{
+    if ( item % 7 == 3 )
+        return std::numeric_limits<double>::quiet_NaN();
+
+    return item % 100;
+}
+
+wxString wxCALLBACK GetStringKey(wxIntPtr item, wxIntPtr WXUNUSED(sortData))
+{
+    return wxString::Format("%02d", int(item % 100));
+}
+
+inline bool wxListSortTestIsNaN(const wxString& WXUNUSED(key)) { return false; }
+inline bool wxListSortTestIsNaN(double key) { return wxIsNaN(key) != 0; }
+
+// Check that the items of the list are sorted by the given key in the given
+// order, with the items with the same key in the order of their data, and
+// that NaN keys come last.
+template <typename Key>
+void CheckSortedByKey(wxGenericListCtrl* list,
+                      Key (wxCALLBACK *fn)(wxIntPtr, wxIntPtr),
+                      bool ascending)
+{
+    const int count = list->GetItemCount();
+    for ( int n = 1; n < count; n++ )
+    {
+        const wxIntPtr prev = list->GetItemData(n - 1),
+                       item = list->GetItemData(n);
+
+        const Key keyPrev = fn(prev, 0),
+                  key = fn(item, 0);
+
+        if ( wxListSortTestIsNaN(keyPrev) )
+        {
+            INFO("Item " << n);
+            CHECK( wxListSortTestIsNaN(key) );
+            CHECK( prev < item );
+        }
+        else if ( !wxListSortTestIsNaN(key) )
+        {
+            INFO("Item " << n);
+            if ( keyPrev == key )
+                CHECK( prev < item );
+            else
+                CHECK( (ascending ? keyPrev < key : key < keyPrev) );
+        }
+    }
+}
+
+} // anonymous namespace
+
+void ListCtrlTestCase::SortByKey()
+{
+    // Sorting by key is only implemented in the generic version, so test it
+    // independently of the control used by the other tests. Use enough items
+    // to sort them in several threads.
+    wxGenericListCtrl* const list =
+        new wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                              wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    list->InsertColumn(0, "Column 0");
+
+    const int count = 20000;
+    for ( int n = 0; n < count; n++ )
+    {
+        // Insert the items in reverse order to check that the data, and not
+        // the item index, is used.
+        list->InsertItem(0, wxString::Format("Item %d", count - 1 - n));
+        list->SetItemData(0, count - 1 - n);
+    }
+
+    CPPUNIT_ASSERT( list->SortItemsByKey(GetStringKey, 0) );
+    CheckSortedByKey(list, GetStringKey, true);
+    CPPUNIT_ASSERT_EQUAL( "Item 0", list->GetItemText(0) );
+
+    CPPUNIT_ASSERT( list->SortItemsByKey(GetNumericKey, 0) );
+    CheckSortedByKey(list, GetNumericKey, true);
+    CPPUNIT_ASSERT_EQUAL( "Item 0", list->GetItemText(0) );
+
+    CPPUNIT_ASSERT( list->SortItemsByKey(GetNumericKey, 0, false) );
+    CheckSortedByKey(list, GetNumericKey, false);
+    CPPUNIT_ASSERT_EQUAL( "Item 99", list->GetItemText(0) );
+
+    delete list;
+}
+
 #if wxUSE_UIACTIONSIMULATOR
 void ListCtrlTestCase::ColumnDrag()
 {
@@ -0,0 +1,217 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/controls/propgridtest.cpp
+// Purpose:     wxPropertyGrid unit tests
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#if wxUSE_PROPGRID
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#ifndef WX_PRECOMP
+    #include "wx/app.h"
+#endif // WX_PRECOMP
+
+#include "wx/scopedptr.h"
+
+#include "wx/propgrid/propgrid.h"
+
+// ----------------------------------------------------------------------------
+// helpers
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+const int NUM_CATEGORIES = 5;
+const int NUM_ITEMS = 20;
+const int NUM_SUBITEMS = 3;
+
+// Create a grid with several categories containing properties, some of
+// which have children.
+wxPropertyGrid* CreateGrid()
+{
+    wxPropertyGrid* const pg = new wxPropertyGrid(wxTheApp->GetTopWindow(),
+                                                  wxID_ANY,
+                                                  wxDefaultPosition,
+                                                  wxSize(400, 200));
+
+    for ( int c = 0; c < NUM_CATEGORIES; c++ )
+    {
+        wxPGProperty* const cat =
+            pg->Append(new wxPropertyCategory(wxString::Format("Category %d", c)));
+
+        for ( int i = 0; i < NUM_ITEMS; i++ )
+        {
+            wxPGProperty* const p =
+                pg->AppendIn(cat, new wxStringProperty(wxString::Format("Item %d-%d", c, i),
+                                                       wxPG_LABEL,
+                                                       "<composed>"));
+            if ( i % 4 == 0 )
+            {
+                for ( int j = 0; j < NUM_SUBITEMS; j++ )
+                {
+                    pg->AppendIn(p, new wxIntProperty(wxString::Format("Sub %d", j),
+                                                      wxPG_LABEL,
+                                                      j));
+                }
+            }
+        }
+    }
+
+    return pg;
+}
+
+// Check that finding the properties by their position and the height of all
+// of them give the same results as walking over the properties tree.
+void CheckVisibleRows(wxPropertyGrid* pg)
+{
+    wxPropertyGridPageState* const state = pg->GetState();
+    const unsigned int lh = pg->GetRowHeight();
+    REQUIRE( lh > 0 );
+
+    const unsigned int height = state->GetActualVirtualHeight();
+    CHECK( state->GetVirtualHeight() == height );
+
+    // Also check a couple of rows after the last one.
+    for ( unsigned int y = 0; y < height + 2*lh; y += lh )
+    {
+        INFO( "y=" << y );
+
+        unsigned int nextItemY = 0;
+        CHECK( pg->GetItemAtY(y) == pg->GetRoot()->GetItemAtY(y, lh, &nextItemY) );
+
+        nextItemY = 0;
+        CHECK( pg->GetItemAtY(y + lh - 1) == pg->GetRoot()->GetItemAtY(y + lh - 1, lh, &nextItemY) );
+    }
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST_CASE("wxPropertyGrid::VisibleRows", "[propgrid]")
+{
+    wxScopedPtr<wxPropertyGrid> pg(CreateGrid());
+
+    CheckVisibleRows(pg.get());
+
+    SECTION("Expand")
+    {
+        REQUIRE( pg->Collapse("Category 1") );
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->Collapse("Item 2-4") );
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->Expand("Category 1") );
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->CollapseAll() );
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->ExpandAll() );
+        CheckVisibleRows(pg.get());
+
+        // Changing the flags directly must be taken into account too.
+        pg->GetProperty("Category 3")->SetExpanded(false);
+        CheckVisibleRows(pg.get());
+
+        pg->GetProperty("Item 0-8")->SetFlagsFromString("COLLAPSED");
+        CheckVisibleRows(pg.get());
+
+        pg->GetProperty("Category 3")->ChangeFlag(wxPG_PROP_COLLAPSED, false);
+        CheckVisibleRows(pg.get());
+    }
+
+    SECTION("Hide")
+    {
+        REQUIRE( pg->HideProperty("Item 0-3") );
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->HideProperty("Category 2") );
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->HideProperty("Item 4-4") );
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->HideProperty("Category 2", false) );
+        CheckVisibleRows(pg.get());
+
+        pg->GetProperty("Item 1-7")->Hide(true);
+        CheckVisibleRows(pg.get());
+
+        pg->GetProperty("Item 4-4")->SetFlagsFromString("");
+        CheckVisibleRows(pg.get());
+    }
+
+    SECTION("InsertDelete")
+    {
+        pg->Insert("Item 1-5", new wxStringProperty("New 1"));
+        CheckVisibleRows(pg.get());
+
+        pg->AppendIn("Item 3-0", new wxIntProperty("New 2"));
+        CheckVisibleRows(pg.get());
+
+        pg->DeleteProperty("Item 1-6");
+        CheckVisibleRows(pg.get());
+
+        // Delete a property with children.
+        pg->DeleteProperty("Item 4-8");
+        CheckVisibleRows(pg.get());
+
+        pg->DeleteProperty("Category 0");
+        CheckVisibleRows(pg.get());
+
+        // Adding children directly must be taken into account too.
+        pg->GetProperty("Item 2-0")->AppendChild(new wxIntProperty("New 3"));
+        CheckVisibleRows(pg.get());
+
+        // Sorting changes the order of the rows.
+        pg->SortChildren("Item 3-0");
+        CheckVisibleRows(pg.get());
+
+        pg->SortChildren("Category 3");
+        CheckVisibleRows(pg.get());
+    }
+
+    SECTION("EnableCategories")
+    {
+        REQUIRE( pg->Collapse("Item 1-4") );
+        REQUIRE( pg->EnableCategories(false) );
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->Expand("Item 1-4") );
+        REQUIRE( pg->Collapse("Item 2-8") );
+        REQUIRE( pg->HideProperty("Item 3-3") );
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->EnableCategories(true) );
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->Collapse("Category 4") );
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->EnableCategories(false) );
+        CheckVisibleRows(pg.get());
+
+        pg->Insert("Item 0-0", new wxStringProperty("New"));
+        CheckVisibleRows(pg.get());
+
+        REQUIRE( pg->EnableCategories(true) );
+        CheckVisibleRows(pg.get());
+    }
+}
+
+#endif // wxUSE_PROPGRID
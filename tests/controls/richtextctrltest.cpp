@@ -62,6 +62,8 @@ private:
         CPPUNIT_TEST( Delete );
         CPPUNIT_TEST( Url );
         CPPUNIT_TEST( Table );
+        CPPUNIT_TEST( BackgroundLayout );
+        CPPUNIT_TEST( CachedAttributes );
     CPPUNIT_TEST_SUITE_END();
 
     void CharacterEvent();
@@ -92,6 +94,8 @@ private:
     void Delete();
     void Url();
     void Table();
+    void BackgroundLayout();
+    void CachedAttributes();
 
     wxRichTextCtrl* m_rich;
 
@@ -888,4 +892,113 @@ void RichTextCtrlTestCase::Table()
     m_rich->SetFocusObject(NULL);
 }
 
+void RichTextCtrlTestCase::BackgroundLayout()
+{
+    m_rich->EnableBackgroundLayout();
+    m_rich->SetDelayedLayoutThreshold(100);
+
+    // Use empty paragraphs and the ones wrapped over several lines.
+    wxString text;
+    for ( int n = 0; n < 500; n++ )
+    {
+        for ( int i = 0; i < (n % 3)*(n % 7)*5; i++ )
+            text += "word ";
+        text += "\n";
+    }
+
+    m_rich->SetValue(text);
+    m_rich->LayoutContent();
+
+    wxRichTextBuffer& buffer = m_rich->GetBuffer();
+    CPPUNIT_ASSERT( buffer.HasEstimatedLayout() );
+
+    wxRichTextObjectList::compatibility_iterator node;
+    for ( node = buffer.GetChildren().GetFirst(); node; node = node->GetNext() )
+    {
+        wxRichTextParagraph* para = wxDynamicCast(node->GetData(), wxRichTextParagraph);
+        CPPUNIT_ASSERT( para );
+        if ( para->IsLayoutEstimated() )
+        {
+            const wxRichTextRange range = para->GetLines().GetFirst()->GetData()->GetRange();
+            CPPUNIT_ASSERT( range.GetStart() <= range.GetEnd() );
+        }
+    }
+
+    for ( int n = 0; m_rich->DoBackgroundLayout(); n++ )
+        CPPUNIT_ASSERT( n < 10000 );
+
+    CPPUNIT_ASSERT( !buffer.HasEstimatedLayout() );
+
+    // The result must be the same as when laying out everything at once.
+    wxVector<wxRect> rects;
+    int y = buffer.GetChildren().GetFirst()->GetData()->GetPosition().y;
+    for ( node = buffer.GetChildren().GetFirst(); node; node = node->GetNext() )
+    {
+        wxRichTextParagraph* para = wxDynamicCast(node->GetData(), wxRichTextParagraph);
+        CPPUNIT_ASSERT( !para->IsLayoutEstimated() );
+        CPPUNIT_ASSERT_EQUAL( y, para->GetPosition().y );
+
+        y += para->GetCachedSize().y;
+        rects.push_back(wxRect(para->GetPosition(), para->GetCachedSize()));
+    }
+
+    m_rich->EnableBackgroundLayout(false);
+    buffer.Invalidate(wxRICHTEXT_ALL);
+    m_rich->LayoutContent();
+
+    size_t n = 0;
+    for ( node = buffer.GetChildren().GetFirst(); node; node = node->GetNext(), n++ )
+        CPPUNIT_ASSERT_EQUAL( rects[n], wxRect(node->GetData()->GetPosition(), node->GetData()->GetCachedSize()) );
+}
+
+void RichTextCtrlTestCase::CachedAttributes()
+{
+    m_rich->SetValue("cached attributes");
+
+    wxRichTextBuffer& buffer = m_rich->GetBuffer();
+    wxRichTextParagraph* para = buffer.GetParagraphAtLine(0);
+    CPPUNIT_ASSERT( para );
+    const wxRichTextObject* child = para->GetChildren().GetFirst()->GetData();
+    CPPUNIT_ASSERT( para->GetCachedCombinedAttributes(child).GetAlignment() != wxTEXT_ALIGNMENT_CENTRE );
+
+    // Changing the paragraph style must be taken into account.
+    wxRichTextAttr paraAttr;
+    paraAttr.SetAlignment(wxTEXT_ALIGNMENT_CENTRE);
+    m_rich->SetStyle(para, paraAttr);
+    CPPUNIT_ASSERT_EQUAL( wxTEXT_ALIGNMENT_CENTRE,
+                          para->GetCachedCombinedAttributes(child).GetAlignment() );
+
+    // And so must changing the buffer style.
+    const wxRichTextAttr oldBasicStyle = buffer.GetBasicStyle();
+    wxRichTextAttr basicStyle = oldBasicStyle;
+    basicStyle.SetFontPointSize(31);
+    buffer.SetBasicStyle(basicStyle);
+    CPPUNIT_ASSERT_EQUAL( 31, para->GetCachedCombinedAttributes(child).GetFontSize() );
+
+    // As must modifying the attributes in place.
+    para->GetAttributes().SetFontWeight(wxFONTWEIGHT_BOLD);
+    CPPUNIT_ASSERT_EQUAL( wxFONTWEIGHT_BOLD,
+                          para->GetCachedCombinedAttributes(child).GetFontWeight() );
+
+    buffer.GetAttributes().SetFontPointSize(32);
+    CPPUNIT_ASSERT_EQUAL( 32, para->GetCachedCombinedAttributes(child).GetFontSize() );
+
+    // Modifying them later through a kept reference requires invalidating
+    // them explicitly.
+    wxRichTextAttr& attrRef = para->GetAttributes();
+    CPPUNIT_ASSERT( !para->GetCachedCombinedAttributes(child).GetFontUnderlined() );
+    attrRef.SetFontUnderlined(true);
+    para->InvalidateCachedAttributes();
+    CPPUNIT_ASSERT( para->GetCachedCombinedAttributes(child).GetFontUnderlined() );
+
+    // The child own style still takes precedence.
+    m_rich->SetStyle(wxRichTextRange(0, 6), wxRichTextAttr(*wxBLUE));
+    child = para->GetChildren().GetFirst()->GetData();
+    CPPUNIT_ASSERT_EQUAL( *wxBLUE, para->GetCachedCombinedAttributes(child).GetTextColour() );
+    CPPUNIT_ASSERT_EQUAL( 31, para->GetCachedCombinedAttributes(child).GetFontSize() );
+
+    m_rich->Clear();
+    buffer.SetBasicStyle(oldBasicStyle);
+}
+
 #endif //wxUSE_RICHTEXT
@@ -0,0 +1,254 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/controls/styledtextctrltest.cpp
+// Purpose:     wxStyledTextCtrl unit tests
+// Copyright:   (c) wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#if wxUSE_STC
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#ifndef WX_PRECOMP
+    #include "wx/app.h"
+#endif // WX_PRECOMP
+
+#include "wx/file.h"
+#include "wx/scopedptr.h"
+#include "wx/stopwatch.h"
+
+#include "wx/stc/stc.h"
+
+#include "testfile.h"
+
+// ----------------------------------------------------------------------------
+// helpers
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+wxStyledTextCtrl* CreateCppCtrl(const wxString& text)
+{
+    wxStyledTextCtrl* const stc = new wxStyledTextCtrl(wxTheApp->GetTopWindow(),
+                                                       wxID_ANY,
+                                                       wxDefaultPosition,
+                                                       wxSize(400, 200));
+    stc->SetLexer(wxSTC_LEX_CPP);
+    stc->SetKeyWords(0, "int return");
+    stc->SetProperty("fold", "1");
+    stc->SetText(text);
+
+    return stc;
+}
+
+// Let the control style the document in idle time, giving up after some time.
+void WaitUntilStyled(wxStyledTextCtrl* stc)
+{
+    wxStopWatch sw;
+    while ( stc->GetEndStyled() < stc->GetLength() && sw.Time() < 10000 )
+    {
+        wxMilliSleep(1);
+        wxTheApp->ProcessPendingEvents();
+        wxTheApp->ProcessIdle();
+    }
+}
+
+// Write the given text to a new temporary file.
+wxString CreateTextFile(const wxString& text)
+{
+    wxFile file;
+    const wxString name = wxFileName::CreateTempFileName("stctest", &file);
+    REQUIRE( file.Write(text) );
+
+    return name;
+}
+
+// Remember the wxEVT_STC_FILE_LOADED events generated by the control.
+class FileLoadedHandler
+{
+public:
+    explicit FileLoadedHandler(wxStyledTextCtrl* stc)
+        : m_stc(stc),
+          m_count(0),
+          m_ok(false)
+    {
+        m_stc->Bind(wxEVT_STC_FILE_LOADED, &FileLoadedHandler::OnFileLoaded, this);
+    }
+
+    ~FileLoadedHandler()
+    {
+        m_stc->Unbind(wxEVT_STC_FILE_LOADED, &FileLoadedHandler::OnFileLoaded, this);
+    }
+
+    // Wait for the next event for up to the given time and return true if it
+    // was received.
+    bool Wait(int timeInMs = 10000)
+    {
+        const int count = m_count;
+
+        wxStopWatch sw;
+        while ( m_count == count && sw.Time() < timeInMs )
+        {
+            wxMilliSleep(1);
+            wxTheApp->ProcessPendingEvents();
+        }
+
+        return m_count != count;
+    }
+
+    int GetCount() const { return m_count; }
+    const wxString& GetFileName() const { return m_fileName; }
+    bool IsOk() const { return m_ok; }
+
+private:
+    void OnFileLoaded(wxStyledTextEvent& event)
+    {
+        m_count++;
+        m_fileName = event.GetString();
+        m_ok = event.GetInt() != 0;
+    }
+
+    wxStyledTextCtrl* const m_stc;
+    int m_count;
+    wxString m_fileName;
+    bool m_ok;
+
+    wxDECLARE_NO_COPY_CLASS(FileLoadedHandler);
+};
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+TEST_CASE("wxStyledTextCtrl::BackgroundLexing", "[stc]")
+{
+    // Make the document big enough to be lexed in several chunks and use the
+    // multiline comments to make the styles depend on the preceding lines.
+    wxString text;
+    for ( int n = 0; n < 40000; n++ )
+    {
+        if ( n % 100 == 0 )
+            text += "/* a comment\n   spanning two lines */\n";
+        text += wxString::Format("int value%d = compute(%d); // line %d\n",
+                                 n, n * 7919, n);
+    }
+
+    wxScopedPtr<wxStyledTextCtrl> stc(CreateCppCtrl(text));
+    stc->SetIdleStyling(wxSTC_IDLESTYLING_ALL);
+    stc->EnableBackgroundLexing();
+    REQUIRE( stc->IsBackgroundLexingEnabled() );
+
+    // Clearing the styles marks the document as styled, so reset the end of
+    // the styled text to its beginning too.
+    stc->ClearDocumentStyle();
+    stc->StartStyling(0);
+    REQUIRE( stc->GetEndStyled() == 0 );
+
+    // Only the visible part of the document is styled when it's painted and
+    // the rest of it is lexed in the background in idle time.
+    stc->Refresh();
+    stc->Update();
+    wxTheApp->ProcessIdle();
+
+    // Modify the document while lexing is in progress: first right after the
+    // already styled text, which is where the chunk being lexed in the
+    // background starts, and then before it.
+    REQUIRE( stc->GetEndStyled() < stc->GetLength() );
+
+    int pos = wxMin(stc->GetEndStyled() + 100, stc->GetLength());
+    stc->InsertText(pos, "/* unterminated ");
+    text.insert(pos, "/* unterminated ");
+
+    wxTheApp->ProcessPendingEvents();
+    wxTheApp->ProcessIdle();
+
+    REQUIRE( stc->GetEndStyled() < stc->GetLength() );
+
+    pos = stc->GetEndStyled() / 2;
+    stc->InsertText(pos, "*/ return ");
+    text.insert(pos, "*/ return ");
+
+    WaitUntilStyled(stc.get());
+    REQUIRE( stc->GetEndStyled() == stc->GetLength() );
+
+    // The styles must be the same as if the whole text were lexed at once.
+    wxScopedPtr<wxStyledTextCtrl> ref(CreateCppCtrl(text));
+    ref->Colourise(0, -1);
+
+    REQUIRE( stc->GetLength() == ref->GetLength() );
+
+    const wxMemoryBuffer styled = stc->GetStyledText(0, stc->GetLength());
+    const wxMemoryBuffer expected = ref->GetStyledText(0, ref->GetLength());
+    REQUIRE( styled.GetDataLen() == expected.GetDataLen() );
+    CHECK( memcmp(styled.GetData(), expected.GetData(), styled.GetDataLen()) == 0 );
+}
+
+TEST_CASE("wxStyledTextCtrl::LoadFileInBackground", "[stc]")
+{
+    // Make the file big enough to be read in several chunks and use DOS EOLs
+    // in it to check that they're detected.
+    wxString text;
+    for ( int n = 0; n < 50000; n++ )
+        text += wxString::Format("line %d of the file loaded in background\r\n", n);
+
+    TempFile file(CreateTextFile(text));
+    TempFile other(CreateTextFile("another file\nwith Unix EOLs\n"));
+
+    wxScopedPtr<wxStyledTextCtrl> stc(CreateCppCtrl("initial text"));
+    stc->SetEOLMode(wxSTC_EOL_LF);
+
+    FileLoadedHandler handler(stc.get());
+
+    SECTION("Load")
+    {
+        REQUIRE( stc->LoadFileInBackground(file.GetName()) );
+        REQUIRE( handler.Wait() );
+
+        CHECK( handler.GetCount() == 1 );
+        CHECK( handler.GetFileName() == file.GetName() );
+        CHECK( handler.IsOk() );
+        CHECK( !stc->IsLoadingFile() );
+        CHECK( !stc->IsModified() );
+
+        // The result must be the same as when loading the file synchronously.
+        wxScopedPtr<wxStyledTextCtrl> ref(CreateCppCtrl(wxString()));
+        REQUIRE( ref->LoadFile(file.GetName()) );
+
+        CHECK( stc->GetEOLMode() == wxSTC_EOL_CRLF );
+        CHECK( stc->GetEOLMode() == ref->GetEOLMode() );
+        CHECK( stc->GetLineCount() == ref->GetLineCount() );
+        CHECK( stc->GetText() == ref->GetText() );
+    }
+
+    SECTION("Cancel")
+    {
+        // Loading another file must cancel loading the first one.
+        REQUIRE( stc->LoadFileInBackground(file.GetName()) );
+        REQUIRE( stc->LoadFileInBackground(other.GetName()) );
+        REQUIRE( handler.Wait() );
+
+        // Leave the time for the first file to be (wrongly) loaded too.
+        CHECK( !handler.Wait(500) );
+
+        CHECK( handler.GetCount() == 1 );
+        CHECK( handler.GetFileName() == other.GetName() );
+        CHECK( handler.IsOk() );
+        CHECK( !stc->IsLoadingFile() );
+
+        CHECK( stc->GetEOLMode() == wxSTC_EOL_LF );
+        CHECK( stc->GetText() == "another file\nwith Unix EOLs\n" );
+    }
+}
+
+#endif // wxUSE_STC
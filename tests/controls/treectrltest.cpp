@@ -25,7 +25,9 @@
 
 #include "wx/artprov.h"
 #include "wx/imaglist.h"
+#include "wx/scopedptr.h"
 #include "wx/treectrl.h"
+#include "wx/generic/treectlg.h"
 #include "wx/uiaction.h"
 #include "testableframe.h"
 
@@ -65,6 +67,8 @@ private:
         CPPUNIT_TEST( Sort );
         WXUISIM_TEST( KeyNavigation );
         CPPUNIT_TEST( HasChildren );
+        CPPUNIT_TEST( Virtual );
+        CPPUNIT_TEST( VirtualWidth );
         CPPUNIT_TEST( SelectItemSingle );
         CPPUNIT_TEST( PseudoTest_MultiSelect );
         CPPUNIT_TEST( SelectItemMulti );
@@ -94,6 +98,8 @@ private:
     void Sort();
     void KeyNavigation();
     void HasChildren();
+    void Virtual();
+    void VirtualWidth();
     void SelectItemSingle();
     void SelectItemMulti();
     void PseudoTest_MultiSelect() { ms_multiSelect = true; }
@@ -175,6 +181,120 @@ void TreeCtrlTestCase::HasChildren()
     CPPUNIT_ASSERT( !m_tree->HasChildren(m_grandchild) );
 }
 
+namespace
+{
+
+// Virtual tree in which the root has a million children, each of which has as
+// many children as its index modulo 3, and the grand children have none.
+class VirtualTreeCtrl : public wxGenericTreeCtrl
+{
+public:
+    enum { NUM_CHILDREN = 1000000 };
+
+    explicit VirtualTreeCtrl(wxWindow* parent)
+        : wxGenericTreeCtrl(parent, wxID_ANY,
+                            wxDefaultPosition, wxSize(400, 200),
+                            wxTR_DEFAULT_STYLE | wxTR_HIDE_ROOT | wxTR_VIRTUAL),
+          m_childIndex(0)
+    {
+    }
+
+    // Use the given label for the child of the root with the given index.
+    void SetChildText(unsigned int index, const wxString& text)
+    {
+        m_childIndex = index;
+        m_childText = text;
+    }
+
+protected:
+    virtual unsigned int
+    OnGetChildrenCount(const wxTreeItemId& item) const wxOVERRIDE
+    {
+        if ( item == GetRootItem() )
+            return NUM_CHILDREN;
+
+        if ( GetItemParent(item) == GetRootItem() )
+            return GetItemIndex(item) % 3;
+
+        return 0;
+    }
+
+    virtual wxString OnGetItemText(const wxTreeItemId& item) const wxOVERRIDE
+    {
+        wxString text = wxString::Format("%u", GetItemIndex(item));
+
+        const wxTreeItemId parent = GetItemParent(item);
+        if ( parent != GetRootItem() )
+            text = GetItemText(parent) + "." + text;
+        else if ( !m_childText.empty() && GetItemIndex(item) == m_childIndex )
+            text = m_childText;
+
+        return text;
+    }
+
+private:
+    unsigned int m_childIndex;
+    wxString m_childText;
+};
+
+} // anonymous namespace
+
+void TreeCtrlTestCase::Virtual()
+{
+    VirtualTreeCtrl* const tree = new VirtualTreeCtrl(wxTheApp->GetTopWindow());
+    wxScopedPtr<VirtualTreeCtrl> cleanup(tree);
+
+    const wxTreeItemId root = tree->AddRoot("root");
+    CPPUNIT_ASSERT_EQUAL( VirtualTreeCtrl::NUM_CHILDREN,
+                          (int)tree->GetChildrenCount(root, false) );
+
+    tree->Refresh();
+    tree->Update();
+
+    wxTreeItemIdValue cookie;
+    const wxTreeItemId child0 = tree->GetFirstChild(root, cookie);
+    const wxTreeItemId child1 = tree->GetNextSibling(child0);
+    const wxTreeItemId child2 = tree->GetNextSibling(child1);
+    CPPUNIT_ASSERT_EQUAL( "0", tree->GetItemText(child0) );
+    CPPUNIT_ASSERT_EQUAL( 2, (int)tree->GetItemIndex(child2) );
+    CPPUNIT_ASSERT( !tree->ItemHasChildren(child0) );
+    CPPUNIT_ASSERT( tree->ItemHasChildren(child1) );
+
+    // The children are only created when the item is expanded, but they are
+    // counted even before this.
+    CPPUNIT_ASSERT_EQUAL( 2, (int)tree->GetChildrenCount(child2) );
+    CPPUNIT_ASSERT_EQUAL( 2, (int)tree->GetChildrenCount(child2, false) );
+    CPPUNIT_ASSERT_EQUAL( 1, (int)tree->GetChildrenCount(child1) );
+    tree->Expand(child2);
+    CPPUNIT_ASSERT( tree->IsExpanded(child2) );
+    CPPUNIT_ASSERT_EQUAL( 2, (int)tree->GetChildrenCount(child2) );
+    CPPUNIT_ASSERT_EQUAL( "2.1", tree->GetItemText(tree->GetLastChild(child2)) );
+
+    tree->CollapseAndReset(child2);
+    CPPUNIT_ASSERT( !tree->IsExpanded(child2) );
+    CPPUNIT_ASSERT_EQUAL( 2, (int)tree->GetChildrenCount(child2) );
+    CPPUNIT_ASSERT_EQUAL( 2, (int)tree->GetChildrenCount(child2, false) );
+    CPPUNIT_ASSERT( tree->ItemHasChildren(child2) );
+}
+
+void TreeCtrlTestCase::VirtualWidth()
+{
+    VirtualTreeCtrl* const tree = new VirtualTreeCtrl(wxTheApp->GetTopWindow());
+    wxScopedPtr<VirtualTreeCtrl> cleanup(tree);
+
+    const wxString text(wxString('W', 200));
+    tree->SetChildText(3, text);
+    tree->AddRoot("root");
+
+    // The virtual items are only measured when they're painted, but the
+    // width of the tree must still take the visible long label into account.
+    tree->Refresh();
+    tree->Update();
+    wxYield();
+
+    CPPUNIT_ASSERT( tree->GetVirtualSize().x > tree->GetTextExtent(text).x );
+}
+
 void TreeCtrlTestCase::SelectItemSingle()
 {
     // this test should be only ran in single-selection control
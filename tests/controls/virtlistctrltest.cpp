@@ -23,6 +23,8 @@
 #endif // WX_PRECOMP
 
 #include "wx/listctrl.h"
+#include "wx/generic/listctrl.h"
+#include "wx/generic/private/prefetch.h"
 
 // ----------------------------------------------------------------------------
 // test class
@@ -39,9 +41,13 @@ public:
 private:
     CPPUNIT_TEST_SUITE( VirtListCtrlTestCase );
         CPPUNIT_TEST( UpdateSelection );
+        CPPUNIT_TEST( VariableItemHeight );
+        CPPUNIT_TEST( PrefetchHint );
     CPPUNIT_TEST_SUITE_END();
 
     void UpdateSelection();
+    void VariableItemHeight();
+    void PrefetchHint();
 
     wxListCtrl *m_list;
 
@@ -105,4 +111,252 @@ void VirtListCtrlTestCase::UpdateSelection()
     CPPUNIT_ASSERT_EQUAL( 1, m_list->GetSelectedItemCount() );
 }
 
+void VirtListCtrlTestCase::VariableItemHeight()
+{
+    // Variable item heights are only supported by the generic version, so
+    // test it independently of the native control used by the other tests.
+    class VarHeightListCtrl : public wxGenericListCtrl
+    {
+    public:
+        VarHeightListCtrl()
+            : wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                wxPoint(0, 0), wxSize(400, 200),
+                                wxLC_REPORT | wxLC_VIRTUAL | wxLC_NO_HEADER),
+              m_extra(10),
+              m_numHeightCalls(0)
+        {
+            InsertColumn(0, "Column");
+        }
+
+        static int GetBaseHeight() { return 30; }
+
+        int GetExpectedHeight(long item) const
+        {
+            return item % 2 ? GetBaseHeight() + m_extra : GetBaseHeight();
+        }
+
+        void SetExtra(int extra) { m_extra = extra; }
+
+        int GetNumHeightCalls() const { return m_numHeightCalls; }
+
+    protected:
+        virtual wxString OnGetItemText(long item, long WXUNUSED(column)) const wxOVERRIDE
+        {
+            return wxString::Format("Item %ld", item);
+        }
+
+        virtual int OnGetItemHeight(long item) const wxOVERRIDE
+        {
+            m_numHeightCalls++;
+
+            return GetExpectedHeight(item);
+        }
+
+    private:
+        int m_extra;
+        mutable int m_numHeightCalls;
+    };
+
+    VarHeightListCtrl* const list = new VarHeightListCtrl;
+    list->SetItemCount(100);
+
+    CPPUNIT_ASSERT( !list->HasVariableItemHeight() );
+    CPPUNIT_ASSERT( list->EnableVariableItemHeight() );
+    CPPUNIT_ASSERT( list->HasVariableItemHeight() );
+
+    wxRect rect0;
+    CPPUNIT_ASSERT( list->GetItemRect(0, rect0) );
+
+    int y = rect0.y;
+    for ( long n = 0; n < 10; n++ )
+    {
+        wxRect rect;
+        CPPUNIT_ASSERT( list->GetItemRect(n, rect) );
+        CPPUNIT_ASSERT_EQUAL( y, rect.y );
+        CPPUNIT_ASSERT_EQUAL( list->GetExpectedHeight(n), rect.height );
+
+        int flags;
+        CPPUNIT_ASSERT_EQUAL( n, list->HitTest(rect.GetPosition() + wxPoint(2, 1),
+                                               flags) );
+        CPPUNIT_ASSERT_EQUAL( n, list->HitTest(rect.GetBottomLeft() + wxPoint(2, 0),
+                                               flags) );
+
+        y += rect.height;
+    }
+
+    // Changing the height of some items must update the positions of all the
+    // subsequent ones after refreshing them.
+    list->SetExtra(20);
+    list->RefreshItems(0, 99);
+
+    wxRect rect;
+    CPPUNIT_ASSERT( list->GetItemRect(10, rect) );
+    CPPUNIT_ASSERT_EQUAL( rect0.y + 10*VarHeightListCtrl::GetBaseHeight() + 5*20,
+                          rect.y );
+
+    // Refreshing a single item only retrieves its own height.
+    const int numHeightCalls = list->GetNumHeightCalls();
+    list->RefreshItem(50);
+    CPPUNIT_ASSERT( list->GetItemRect(60, rect) );
+    CPPUNIT_ASSERT_EQUAL( numHeightCalls + 1, list->GetNumHeightCalls() );
+
+    // Only changing the number of items retrieves all of them again.
+    list->SetItemCount(100);
+    CPPUNIT_ASSERT( list->GetItemRect(60, rect) );
+    CPPUNIT_ASSERT_EQUAL( numHeightCalls + 1, list->GetNumHeightCalls() );
+
+    list->SetItemCount(101);
+    CPPUNIT_ASSERT( list->GetItemRect(60, rect) );
+    CPPUNIT_ASSERT_EQUAL( numHeightCalls + 102, list->GetNumHeightCalls() );
+
+    delete list;
+}
+
+void VirtListCtrlTestCase::PrefetchHint()
+{
+    // Prefetching is only implemented in the generic version.
+    class PrefetchListCtrl : public wxGenericListCtrl
+    {
+    public:
+        PrefetchListCtrl()
+            : wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                wxPoint(0, 0), wxSize(400, 200),
+                                wxLC_REPORT | wxLC_VIRTUAL),
+              m_numHints(0),
+              m_from(-1),
+              m_to(-1),
+              m_direction(0)
+        {
+            InsertColumn(0, "Column");
+
+            Bind(wxEVT_LIST_PREFETCH_HINT, &PrefetchListCtrl::OnPrefetch, this);
+        }
+
+        int m_numHints;
+        long m_from,
+             m_to;
+        int m_direction;
+
+    protected:
+        virtual wxString OnGetItemText(long item, long WXUNUSED(column)) const wxOVERRIDE
+        {
+            return wxString::Format("Item %ld", item);
+        }
+
+    private:
+        void OnPrefetch(wxListEvent& event)
+        {
+            m_numHints++;
+            m_from = event.GetCacheFrom();
+            m_to = event.GetCacheTo();
+            m_direction = event.GetPrefetchDirection();
+        }
+    };
+
+    PrefetchListCtrl* const list = new PrefetchListCtrl;
+    list->SetItemCount(1000);
+
+    // No events are sent by default.
+    list->Refresh();
+    list->Update();
+    wxYield();
+    CPPUNIT_ASSERT_EQUAL( 0, list->m_numHints );
+
+    CPPUNIT_ASSERT( list->SetPrefetchLookAhead(10) );
+    list->Refresh();
+    list->Update();
+    wxYield();
+    CPPUNIT_ASSERT_EQUAL( 1, list->m_numHints );
+    CPPUNIT_ASSERT_EQUAL( 0, list->m_direction );
+    CPPUNIT_ASSERT_EQUAL( 0L, list->m_from );
+
+    // The hint is only sent again when the visible items change.
+    const long lastVisible = list->m_to - 10;
+    list->Refresh();
+    list->Update();
+    wxYield();
+    CPPUNIT_ASSERT_EQUAL( 1, list->m_numHints );
+
+    list->EnsureVisible(500);
+    list->Update();
+    wxYield();
+    CPPUNIT_ASSERT_EQUAL( 2, list->m_numHints );
+    CPPUNIT_ASSERT_EQUAL( 1, list->m_direction );
+    CPPUNIT_ASSERT( list->m_from > lastVisible );
+    CPPUNIT_ASSERT_EQUAL( list->m_from + 9, list->m_to );
+
+    delete list;
+}
+
+// ----------------------------------------------------------------------------
+// wxPrefetchTracker tests
+// ----------------------------------------------------------------------------
+
+TEST_CASE("wxPrefetchTracker", "[listctrl][prefetch]")
+{
+    wxPrefetchTracker tracker;
+
+    long from, to;
+    int direction;
+
+    // Prefetching is disabled by default.
+    CHECK( !tracker.Update(0, 9, 100, &from, &to, &direction) );
+
+    tracker.SetLookAhead(5);
+    CHECK( !tracker.Update(0, 9, 0, &from, &to, &direction) );
+
+    SECTION("Initial")
+    {
+        // Without knowing the direction, both sides are prefetched.
+        REQUIRE( tracker.Update(20, 29, 100, &from, &to, &direction) );
+        CHECK( direction == 0 );
+        CHECK( from == 15 );
+        CHECK( to == 34 );
+
+        // Nothing happens if the visible items don't change.
+        CHECK( !tracker.Update(20, 29, 100, &from, &to, &direction) );
+    }
+
+    SECTION("Down")
+    {
+        REQUIRE( tracker.Update(0, 9, 100, &from, &to, &direction) );
+        CHECK( from == 0 );
+        CHECK( to == 14 );
+
+        REQUIRE( tracker.Update(3, 12, 100, &from, &to, &direction) );
+        CHECK( direction == 1 );
+        CHECK( from == 13 );
+        CHECK( to == 17 );
+
+        // The range is limited by the number of items.
+        REQUIRE( tracker.Update(90, 99, 100, &from, &to, &direction) );
+        CHECK( direction == 1 );
+        CHECK( !tracker.Update(91, 99, 100, &from, &to, &direction) );
+    }
+
+    SECTION("Up")
+    {
+        REQUIRE( tracker.Update(50, 59, 100, &from, &to, &direction) );
+
+        REQUIRE( tracker.Update(40, 49, 100, &from, &to, &direction) );
+        CHECK( direction == -1 );
+        CHECK( from == 35 );
+        CHECK( to == 39 );
+
+        REQUIRE( tracker.Update(2, 11, 100, &from, &to, &direction) );
+        CHECK( direction == -1 );
+        CHECK( from == 0 );
+        CHECK( to == 1 );
+    }
+
+    SECTION("Reset")
+    {
+        REQUIRE( tracker.Update(50, 59, 100, &from, &to, &direction) );
+
+        tracker.Reset();
+        REQUIRE( tracker.Update(50, 59, 100, &from, &to, &direction) );
+        CHECK( direction == 0 );
+    }
+}
+
 #endif // wxUSE_LISTCTRL
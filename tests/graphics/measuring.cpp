@@ -33,6 +33,8 @@
 #include "wx/dcps.h"
 #include "wx/metafile.h"
 
+#include "wx/private/textmeasure.h"
+
 // ----------------------------------------------------------------------------
 // test class
 // ----------------------------------------------------------------------------
@@ -48,6 +50,7 @@ private:
         CPPUNIT_TEST( LeadingAndDescent );
         CPPUNIT_TEST( WindowGetTextExtent );
         CPPUNIT_TEST( GetPartialTextExtent );
+        CPPUNIT_TEST( GetTextExtents );
 #ifdef TEST_GC
         CPPUNIT_TEST( GraphicsGetTextExtent );
 #endif // TEST_GC
@@ -58,6 +61,7 @@ private:
     void WindowGetTextExtent();
 
     void GetPartialTextExtent();
+    void GetTextExtents();
 
 #ifdef TEST_GC
     void GraphicsGetTextExtent();
@@ -170,6 +174,36 @@ void MeasuringTextTestCase::GetPartialTextExtent()
     CPPUNIT_ASSERT_EQUAL( widths[4], dc.GetTextExtent("Hello").x );
 }
 
+void MeasuringTextTestCase::GetTextExtents()
+{
+    wxClientDC dc(wxTheApp->GetTopWindow());
+
+    wxArrayString strings;
+    strings.push_back("Hello");
+    strings.push_back("");
+    strings.push_back("Hello, world");
+    strings.push_back("Two\nlines");
+    strings.push_back("Hello");
+
+    wxArrayInt widths,
+               heights;
+    wxTextMeasure(&dc).GetTextExtents(strings, widths, &heights);
+    CPPUNIT_ASSERT_EQUAL( strings.size(), widths.size() );
+    CPPUNIT_ASSERT_EQUAL( strings.size(), heights.size() );
+
+    const wxSize sizeHello = dc.GetTextExtent("Hello");
+    CPPUNIT_ASSERT_EQUAL( sizeHello.x, widths[0] );
+    CPPUNIT_ASSERT_EQUAL( sizeHello.y, heights[0] );
+    CPPUNIT_ASSERT_EQUAL( 0, widths[1] );
+    CPPUNIT_ASSERT_EQUAL( dc.GetTextExtent("Hello, world").x, widths[2] );
+    CPPUNIT_ASSERT_EQUAL( dc.GetTextExtent("Two\nlines").x, widths[3] );
+    CPPUNIT_ASSERT_EQUAL( sizeHello.x, widths[4] );
+
+    // Only the widths may be retrieved too.
+    wxTextMeasure(&dc).GetTextExtents(strings, widths);
+    CPPUNIT_ASSERT_EQUAL( sizeHello.x, widths[0] );
+}
+
 #ifdef TEST_GC
 
 void MeasuringTextTestCase::GraphicsGetTextExtent()
@@ -23,6 +23,9 @@
 #endif // WX_PRECOMP
 
 #include "wx/html/winpars.h"
+#include "wx/log.h"
+#include "wx/mstream.h"
+#include "wx/vector.h"
 
 // Test that parsing invalid HTML simply fails but doesn't crash for example.
 TEST_CASE("wxHtmlParser::ParseInvalid", "[html][parser][error]")
@@ -46,6 +49,200 @@ TEST_CASE("wxHtmlParser::ParseInvalid", "[html][parser][error]")
     p.Parse("<!---");
 }
 
+// Check that both the standard and the custom tags and parameters are found.
+TEST_CASE("wxHtmlParser::TagParams", "[html][parser]")
+{
+    class TestTagHandler : public wxHtmlTagHandler
+    {
+    public:
+        explicit TestTagHandler(wxString& log) : m_log(log) { }
+
+        virtual wxString GetSupportedTags() wxOVERRIDE
+        {
+            return "FONT,MY-TAG,br";
+        }
+
+        virtual bool HandleTag(const wxHtmlTag& tag) wxOVERRIDE
+        {
+            m_log << tag.GetName() << ":"
+                  << tag.GetParam("COLOR") << ","
+                  << tag.GetParam("size") << ","
+                  << tag.GetParam("My-Param") << ","
+                  << tag.HasParam("FACE") << ","
+                  << tag.GetAllParams() << ";";
+            return false;
+        }
+
+    private:
+        wxString& m_log;
+    };
+
+    class TestParser : public wxHtmlParser
+    {
+    public:
+        virtual wxObject* GetProduct() wxOVERRIDE { return NULL; }
+
+    protected:
+        virtual void AddText(const wxString& WXUNUSED(txt)) wxOVERRIDE { }
+    };
+
+    wxString log;
+
+    TestParser p;
+    p.AddTagHandler(new TestTagHandler(log));
+
+    p.Parse("<font color=red Size=\"+1\">x</font>"
+            "<my-tag my-param=\"value\" face>y</my-tag>"
+            "<br>");
+
+    CHECK( log ==
+           "FONT:RED,+1,,0,color=\"RED\"Size=\"+1\";"
+           "MY-TAG:,,value,1,my-param=\"value\"face=\"\";" );
+}
+
+// Return a string describing all terminal cells of the given container.
+static wxString DescribeCells(const wxHtmlContainerCell* top)
+{
+    wxString desc;
+    for ( wxHtmlTerminalCellsInterator i(top->GetFirstTerminal(),
+                                         top->GetLastTerminal());
+          i;
+          ++i )
+    {
+        const wxString text = i->ConvertToText(NULL);
+        desc << (text.empty() ? wxString(i->GetClassInfo()->GetClassName()) : text)
+             << "|";
+    }
+
+    return desc;
+}
+
+// Check that parsing the document in chunks gives the same result as parsing
+// it all at once.
+TEST_CASE("wxHtmlParser::ParseChunk", "[html][parser]")
+{
+    const wxString doc =
+        "<html><head><title>Streaming</title></head>"
+        "<body text=\"#000080\"><p>Some <b>bold</b> text<br>and more</p>"
+        "<!-- <p>comment</p> -->"
+        "<ul><li>first<li>second</ul>"
+        "<script>if (a<b) s = '</p>';</script>"
+        "<pre>pre\nformatted</pre>"
+        "<p>Unclosed <i>paragraph<p>and <tt>another</tt> one</p>"
+        "</body></html>";
+
+    wxMemoryDC dc;
+    wxHtmlWinParser p;
+    p.SetDC(&dc);
+
+    wxHtmlContainerCell* top = static_cast<wxHtmlContainerCell*>(p.Parse(doc));
+    const wxString expected = DescribeCells(top);
+    delete top;
+
+    SECTION("chunks")
+    {
+        for ( size_t size = 1; size <= 64; size *= 4 )
+        {
+            INFO("Chunk size " << size);
+
+            p.BeginStreaming();
+            for ( size_t pos = 0; pos < doc.length(); pos += size )
+                p.ParseChunk(doc.substr(pos, size));
+            top = static_cast<wxHtmlContainerCell*>(p.EndStreaming());
+
+            CHECK( DescribeCells(top) == expected );
+            CHECK( *p.GetSource() == doc );
+            CHECK( !p.IsStreaming() );
+
+            delete top;
+        }
+    }
+
+    SECTION("stream")
+    {
+        const wxScopedCharBuffer utf8 = doc.utf8_str();
+        wxMemoryInputStream stream(utf8.data(), utf8.length());
+
+        top = static_cast<wxHtmlContainerCell*>(p.Parse(stream));
+
+        CHECK( DescribeCells(top) == expected );
+
+        delete top;
+    }
+}
+
+// Return the description of the cells created by the parser so far.
+static wxString DescribeParsedCells(wxHtmlWinParser& p)
+{
+    const wxHtmlContainerCell* top = p.GetContainer();
+    while ( top->GetParent() )
+        top = top->GetParent();
+
+    return DescribeCells(top);
+}
+
+// Check that the elements whose ending tags are omitted don't prevent parsing
+// the document before its end.
+TEST_CASE("wxHtmlParser::ParseChunk::Unclosed", "[html][parser]")
+{
+    wxMemoryDC dc;
+    wxHtmlWinParser p;
+    p.SetDC(&dc);
+
+    p.BeginStreaming();
+
+    p.ParseChunk("<html><body><p>First paragraph");
+    CHECK( DescribeParsedCells(p).Find("First") == wxNOT_FOUND );
+
+    p.ParseChunk("<p>Second paragraph<ul><li>item<li>other</ul>");
+    CHECK( DescribeParsedCells(p).Find("First") != wxNOT_FOUND );
+    CHECK( DescribeParsedCells(p).Find("Second") != wxNOT_FOUND );
+    CHECK( DescribeParsedCells(p).Find("item") == wxNOT_FOUND );
+
+    p.ParseChunk("<table><tr><td>cell<td>another</table>");
+    CHECK( DescribeParsedCells(p).Find("item") != wxNOT_FOUND );
+    CHECK( DescribeParsedCells(p).Find("other") != wxNOT_FOUND );
+    CHECK( DescribeParsedCells(p).Find("cell") == wxNOT_FOUND );
+
+    p.ParseChunk("<dl><dt>term<dd>definition</dl>");
+    CHECK( DescribeParsedCells(p).Find("cell") != wxNOT_FOUND );
+    CHECK( DescribeParsedCells(p).Find("another") != wxNOT_FOUND );
+
+    p.ParseChunk("<p>Last</body>");
+    CHECK( DescribeParsedCells(p).Find("term") != wxNOT_FOUND );
+    CHECK( DescribeParsedCells(p).Find("definition") != wxNOT_FOUND );
+
+    p.ParseChunk("</html>");
+
+    wxHtmlContainerCell* const top =
+        static_cast<wxHtmlContainerCell*>(p.EndStreaming());
+    CHECK( DescribeCells(top).Find("Last") != wxNOT_FOUND );
+
+    delete top;
+}
+
+TEST_CASE("wxHtmlParser::ParseChunk::Invalid", "[html][parser][error]")
+{
+    wxMemoryDC dc;
+    wxHtmlWinParser p;
+    p.SetDC(&dc);
+
+    // This is not valid UTF-8.
+    const char doc[] = "<html><body><p>\xff\xfe\xfd<p>end</body></html>";
+    wxMemoryInputStream stream(doc, strlen(doc));
+
+    wxLogNull noLog;
+
+    p.BeginStreaming();
+    CHECK( !p.ParseChunk(stream) );
+    CHECK( p.HasStreamingError() );
+    delete p.EndStreaming();
+
+    stream.SeekI(0);
+    CHECK( p.Parse(stream) == NULL );
+    CHECK( !p.IsStreaming() );
+}
+
 TEST_CASE("wxHtmlCell::Detach", "[html][cell]")
 {
     wxMemoryDC dc;
@@ -106,4 +303,39 @@ TEST_CASE("wxHtmlCell::Detach", "[html][cell]")
     }
 }
 
+TEST_CASE("wxHtmlContainerCell::FindCellByPos", "[html][cell]")
+{
+    wxMemoryDC dc;
+
+    // Use enough cells for their positions to be indexed and make the
+    // container too narrow for more than one of them to fit on a line.
+    wxHtmlContainerCell top(NULL);
+    wxVector<wxHtmlCell*> cells;
+    for ( int n = 0; n < 100; n++ )
+    {
+        cells.push_back(new wxHtmlWordCell(wxString::Format("word%d", n), dc));
+        top.InsertCell(cells.back());
+    }
+
+    top.Layout(1);
+
+    for ( size_t n = 0; n < cells.size(); n++ )
+    {
+        const wxHtmlCell* const cell = cells[n];
+        const int x = cell->GetPosX() + 1,
+                  y = cell->GetPosY() + 1;
+
+        INFO("Cell #" << n);
+        CHECK( top.FindCellByPos(x, y) == cell );
+        CHECK( top.FindCellByPos(x, y, wxHTML_FIND_NEAREST_AFTER) == cell );
+        CHECK( top.FindCellByPos(x, y, wxHTML_FIND_NEAREST_BEFORE) == cell );
+    }
+
+    CHECK( top.FindCellByPos(1, -1) == NULL );
+    CHECK( top.FindCellByPos(1, -1, wxHTML_FIND_NEAREST_AFTER) == cells.front() );
+    CHECK( top.FindCellByPos(1, top.GetHeight()) == NULL );
+    CHECK( top.FindCellByPos(1, top.GetHeight(), wxHTML_FIND_NEAREST_BEFORE)
+            == cells.back() );
+}
+
 #endif //wxUSE_HTML
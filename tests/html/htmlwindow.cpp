@@ -23,6 +23,7 @@
 #endif // WX_PRECOMP
 
 #include "wx/html/htmlwin.h"
+#include "wx/sstream.h"
 #include "wx/uiaction.h"
 #include "testableframe.h"
 
@@ -47,6 +48,7 @@ private:
         WXUISIM_TEST( LinkClick );
 #endif // wxUSE_UIACTIONSIMULATOR
         CPPUNIT_TEST( AppendToPage );
+        CPPUNIT_TEST( IncrementalLayout );
     CPPUNIT_TEST_SUITE_END();
 
     void SelectionToText();
@@ -54,6 +56,7 @@ private:
     void CellClick();
     void LinkClick();
     void AppendToPage();
+    void IncrementalLayout();
 
     wxHtmlWindow *m_win;
 
@@ -117,6 +120,12 @@ void HtmlWindowTestCase::Title()
     m_win->SetPage(TEST_MARKUP);
 
     CPPUNIT_ASSERT_EQUAL("Page", m_win->GetOpenedPageTitle());
+
+    // Loading a page without title from a stream must reset it.
+    wxStringInputStream stream("<html><body>No title</body></html>");
+    m_win->LoadStream(stream);
+
+    CPPUNIT_ASSERT_EQUAL("", m_win->GetOpenedPageTitle());
 }
 
 #if wxUSE_UIACTIONSIMULATOR
@@ -169,4 +178,64 @@ void HtmlWindowTestCase::AppendToPage()
 #endif // wxUSE_CLIPBOARD
 }
 
+// Return the string describing the positions and sizes of all the containers
+// in the given one, used for comparing different layouts.
+static wxString DumpLayout(const wxHtmlCell* cell)
+{
+    wxString s = wxString::Format("(%d,%d %dx%d",
+                                  cell->GetPosX(), cell->GetPosY(),
+                                  cell->GetWidth(), cell->GetHeight());
+    for ( const wxHtmlCell* c = cell->GetFirstChild(); c; c = c->GetNext() )
+    {
+        if ( !c->IsTerminalCell() )
+            s += DumpLayout(c);
+    }
+    s += ")";
+
+    return s;
+}
+
+void HtmlWindowTestCase::IncrementalLayout()
+{
+    wxString page;
+    for ( int n = 0; n < 1000; n++ )
+        page += wxString::Format("<p>Paragraph %d</p>", n);
+
+    m_win->SetPage(page);
+    const int height = m_win->GetInternalRepresentation()->GetHeight();
+
+    m_win->EnableIncrementalLayout();
+    m_win->SetPage(page);
+    m_win->CompleteLayout();
+
+    CPPUNIT_ASSERT_EQUAL( height, m_win->GetInternalRepresentation()->GetHeight() );
+
+    // Changing the size must still result in the same layout as usual.
+    m_win->SetSize(300, 200);
+    m_win->CompleteLayout();
+    const int heightIncremental = m_win->GetInternalRepresentation()->GetHeight();
+
+    m_win->EnableIncrementalLayout(false);
+    m_win->SetPage(page);
+
+    CPPUNIT_ASSERT_EQUAL( heightIncremental,
+                          m_win->GetInternalRepresentation()->GetHeight() );
+
+    // Laying out the page in many small steps, each of them continuing the
+    // previous one, must give the same result as doing it at once.
+    wxHtmlContainerCell* const top = m_win->GetInternalRepresentation();
+    const int width = top->GetWidth();
+    top->Layout(width);
+    const wxString layout = DumpLayout(top);
+
+    top->Layout(width / 2);
+    for ( int y = 0; y < 1000000; y += 50 )
+    {
+        if ( top->LayoutPartially(width, y) )
+            break;
+    }
+
+    CPPUNIT_ASSERT_EQUAL( layout, DumpLayout(top) );
+}
+
 #endif //wxUSE_HTML
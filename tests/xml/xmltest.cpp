@@ -84,6 +84,7 @@ private:
         CPPUNIT_TEST( CopyNode );
         CPPUNIT_TEST( CopyDocument );
         CPPUNIT_TEST( Doctype );
+        CPPUNIT_TEST( ElementLoaded );
     CPPUNIT_TEST_SUITE_END();
 
     void InsertChild();
@@ -98,6 +99,7 @@ private:
     void CopyNode();
     void CopyDocument();
     void Doctype();
+    void ElementLoaded();
 
     wxDECLARE_NO_COPY_CLASS(XmlTestCase);
 };
@@ -613,3 +615,53 @@ void XmlTestCase::Doctype()
     dt = wxXmlDoctype( "root", "O'Reilly (\"editor\")", "Public-ID" );
     CPPUNIT_ASSERT( !dt.IsValid() );
 }
+
+namespace
+{
+
+// Document deleting all "item" elements as soon as they're loaded, after
+// remembering their values.
+class ItemsDocument : public wxXmlDocument
+{
+public:
+    ItemsDocument() { }
+
+    virtual bool OnElementLoaded(wxXmlNode *node) wxOVERRIDE
+    {
+        if ( node->GetName() != "item" )
+            return false;
+
+        m_items.push_back(node->GetAttribute("value") + node->GetNodeContent());
+        return true;
+    }
+
+    wxArrayString m_items;
+};
+
+} // anon namespace
+
+void XmlTestCase::ElementLoaded()
+{
+    const char *xmlText =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<root>\n"
+        "  <first/>\n"
+        "  <item value=\"1\">one</item>\n"
+        "  <item value=\"2\"><sub>two</sub></item>\n"
+        "  <middle/>\n"
+        "  <item value=\"3\"/>\n"
+        "  <last/>\n"
+        "</root>\n"
+    ;
+
+    wxStringInputStream sis(xmlText);
+    ItemsDocument doc;
+    CPPUNIT_ASSERT( doc.Load(sis) );
+
+    CPPUNIT_ASSERT_EQUAL( 3, doc.m_items.size() );
+    CPPUNIT_ASSERT_EQUAL( "1one", doc.m_items[0] );
+    CPPUNIT_ASSERT_EQUAL( "2", doc.m_items[1] );
+    CPPUNIT_ASSERT_EQUAL( "3", doc.m_items[2] );
+
+    CheckXml(doc.GetRoot(), "first", "middle", "last", NULL);
+}